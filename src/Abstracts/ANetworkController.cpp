@@ -17,6 +17,8 @@ ANetworkController::ANetworkController(
     NvsService& nvsService,
     HttpService& httpService,
     TelnetService& telnetService,
+    SdService& sdService,
+    LittleFsService& littleFsService,
     ArgTransformer& argTransformer,
     JsonTransformer& jsonTransformer,
     UserInputManager& userInputManager,
@@ -35,6 +37,8 @@ ANetworkController::ANetworkController(
   nvsService(nvsService),
   httpService(httpService),
   telnetService(telnetService),
+  sdService(sdService),
+  littleFsService(littleFsService),
   argTransformer(argTransformer),
   jsonTransformer(jsonTransformer),
   userInputManager(userInputManager),
@@ -222,26 +226,41 @@ void ANetworkController::handleNetcat(const TerminalCommand& cmd)
 
     terminalView.println("Netcat：已连接。Shell已启动... 按下[任意ESP32按键]停止。\n"); // 汉化
 
+    std::string rx;
+    rx.reserve(SessionIoManager::RX_MAX_POLL);
+    std::string echo;
     while (true) {
         char deviceKey = deviceInput.readChar();
         if (deviceKey != KEY_NONE)
             break;
 
-        char terminalKey = terminalInput.readChar();
-        if (terminalKey == KEY_NONE) {
-            std::string out = netcatService.readOutputNonBlocking();
-            if (!out.empty()) terminalView.print(out);
-            delay(10);
-            continue;
+        // Everything typed or pasted since the last pass
+        bool active = false;
+        for (size_t i = 0; i < SESSION_MAX_KEYS; ++i) {
+            char terminalKey = terminalInput.readChar();
+            if (terminalKey == KEY_NONE) break;
+            active = true;
+
+            netcatService.writeChar(terminalKey);
+            echo.push_back(terminalKey); // local echo
+            if (terminalKey == '\r' || terminalKey == '\n') {
+                terminalView.print(echo);
+                terminalView.println("");
+                echo.clear();
+            }
+        }
+        if (!echo.empty()) {
+            terminalView.print(echo);
+            echo.clear();
         }
 
-        netcatService.writeChar(terminalKey);
-        terminalView.print(std::string(1, terminalKey)); // local echo
-        if (terminalKey == '\r' || terminalKey == '\n') terminalView.println("");
-
-        std::string output = netcatService.readOutputNonBlocking();
-        if (!output.empty()) terminalView.print(output);
-        delay(10);
+        netcatService.poll();
+        if (netcatService.readOutputNonBlocking(rx) > 0) {
+            terminalView.print(rx);
+            rx.clear();
+            active = true;
+        }
+        if (!active) delay(10);
     }
 
     netcatService.close();
@@ -382,21 +401,30 @@ void ANetworkController::handleSsh(const TerminalCommand &cmd)
 
     // Connected, start the bridge loop
     terminalView.println("SSH：已连接。Shell已启动... 按下[任意ESP32按键]停止。\n"); // 汉化
+    std::string output;
+    output.reserve(SessionIoManager::RX_MAX_POLL);
     while (true)
     {
-        char terminalKey = terminalInput.readChar();
-        if (terminalKey != KEY_NONE)
+        bool active = false;
+        for (size_t i = 0; i < SESSION_MAX_KEYS; ++i) {
+            char terminalKey = terminalInput.readChar();
+            if (terminalKey == KEY_NONE) break;
             sshService.writeChar(terminalKey);
+            active = true;
+        }
 
         char deviceKey = deviceInput.readChar();
         if (deviceKey != KEY_NONE)
             break;
 
-        std::string output = sshService.readOutputNonBlocking();
-        if (!output.empty())
+        sshService.poll();
+        if (sshService.readOutputNonBlocking(output) > 0) {
             terminalView.print(output);
+            output.clear();
+            active = true;
+        }
 
-        delay(10);
+        if (!active) delay(10);
     }
 
     // Close SSH
@@ -428,6 +456,14 @@ void ANetworkController::handleHttp(const TerminalCommand &cmd)
     } else if (sub == "post" || sub == "put" || sub == "delete") {
         terminalView.println("HTTP：目前仅实现GET方法。"); // 汉化
         return;
+    // http stream <url> [filter]
+    } else if (sub == "stream") {
+        handleHttpStream(cmd);
+        return;
+    // http download <url> [file] [sd]
+    } else if (sub == "download") {
+        handleHttpDownload(cmd);
+        return;
     // http analyze <url>
     } else if (sub == "analyze") {
         handleHttpAnalyze(cmd);
@@ -437,7 +473,7 @@ void ANetworkController::handleHttp(const TerminalCommand &cmd)
         handleHttpGet(cmd);
         return;
     } else {
-        terminalView.println("使用方法：http <get|post|put|delete> <网址>"); // 汉化
+        terminalView.println("使用方法：http <get|stream|download|analyze> <网址>"); // 汉化
     }
 
     #else
@@ -483,6 +519,153 @@ void ANetworkController::handleHttpGet(const TerminalCommand &cmd)
     httpService.reset();
 }
 
+/*
+HTTP Stream
+*/
+void ANetworkController::handleHttpStream(const TerminalCommand &cmd)
+{
+    auto args = argTransformer.splitArgs(cmd.getArgs());
+    if (args.empty() || args.size() > 2) {
+        terminalView.println("使用方法：http stream <网址> [JSON路径，如 items[*].id]"); // 汉化
+        return;
+    }
+
+    const std::string url = argTransformer.ensureHttpScheme(args[0]);
+    const std::string filter = args.size() > 1 ? args[1] : "";
+    std::vector<std::string> segments;
+    if (!HttpStreamManager::parseFilter(filter, segments)) {
+        terminalView.println("HTTP：无效的JSON路径 '" + filter + "'，例如 items[*].id 或 data.user.name"); // 汉化
+        return;
+    }
+
+    terminalView.println("HTTP：正在流式读取 " + url + " ...按[ENTER]停止。\n"); // 汉化
+    httpService.startStreamTask(url, 10000, true, filter);
+
+    // Lines are printed as they arrive, the service queue stays small
+    const unsigned long start = millis();
+    bool done = false;
+    while (!done) {
+        done = httpService.streamStatus().done;
+        for (const auto& line : httpService.fetchStreamLines()) {
+            terminalView.println(line);
+        }
+        if (done) break;
+
+        int terminalKey = terminalInput.readChar();
+        char deviceKey = deviceInput.readChar();
+        if (terminalKey == '\n' || terminalKey == '\r' || deviceKey == KEY_OK) {
+            httpService.stopStream();
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    const auto status = httpService.streamStatus();
+    const unsigned long elapsed = std::max<unsigned long>(millis() - start, 1);
+    std::string summary = "\nHTTP：已读取 " + std::to_string(status.bodyBytes) + " 字节"; // 汉化
+    if (status.values) summary += "，" + std::to_string(status.values) + " 个JSON值"; // 汉化
+    summary += "，" + std::to_string(elapsed) + " 毫秒"; // 汉化
+    terminalView.println(summary);
+
+    if (status.cancelled)          terminalView.println("HTTP：已停止。"); // 汉化
+    else if (!status.error.empty()) terminalView.println("HTTP：错误，" + status.error); // 汉化
+}
+
+/*
+HTTP Download
+*/
+void ANetworkController::handleHttpDownload(const TerminalCommand &cmd)
+{
+    auto args = argTransformer.splitArgs(cmd.getArgs());
+    bool toSd = false;
+    std::string path;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "sd") toSd = true;
+        else if (args[i] == "littlefs") toSd = false;
+        else if (path.empty()) path = args[i];
+    }
+    if (args.empty()) {
+        terminalView.println("使用方法：http download <网址> [文件路径] [sd|littlefs]"); // 汉化
+        return;
+    }
+    const std::string url = argTransformer.ensureHttpScheme(args[0]);
+
+    // File name from the URL when none is given, as wget does
+    if (path.empty()) {
+        std::string name = url.substr(url.find("://") + 3);
+        name = name.substr(0, name.find_first_of("?#"));
+        const size_t slash = name.find('/');
+        name = slash == std::string::npos ? "" : name.substr(name.find_last_of('/') + 1);
+        path = name.empty() ? "index.html" : name;
+    }
+    if (path[0] != '/') path = "/" + path;
+
+    // Open the destination
+    File file;
+    uint64_t maxBytes = 0;
+    if (toSd) {
+        auto sdMounted = sdService.configure(globalState.getSpiCLKPin(), globalState.getSpiMISOPin(),
+                                             globalState.getSpiMOSIPin(), globalState.getSpiCSPin());
+        if (!sdMounted) {
+            terminalView.println("HTTP：未检测到SD卡。请检查SPI引脚"); // 汉化
+            return;
+        }
+        file = sdService.openFileWrite(path);
+    } else {
+        if (!littleFsService.mounted()) littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("HTTP：LittleFS未挂载。终止操作。"); // 汉化
+            return;
+        }
+        maxBytes = littleFsService.freeBytes();
+        file = littleFsService.openFileWrite(path);
+    }
+    if (!file) {
+        terminalView.println("HTTP：无法创建文件 " + path); // 汉化
+        if (toSd) sdService.end();
+        return;
+    }
+
+    terminalView.println("HTTP：正在下载 " + url + " 到 " + (toSd ? "SD:" : "LittleFS:") + path + " ...按[ENTER]停止。"); // 汉化
+    httpService.startDownloadTask(url, 10000, true,
+        [&file](const uint8_t* data, size_t len) { return file.write(data, len) == len; },
+        maxBytes);
+
+    // The task writes the file, progress once per second
+    const unsigned long start = millis();
+    unsigned long lastReport = start;
+    HttpService::StreamStatus status;
+    while (!(status = httpService.streamStatus()).done) {
+        int terminalKey = terminalInput.readChar();
+        char deviceKey = deviceInput.readChar();
+        if (terminalKey == '\n' || terminalKey == '\r' || deviceKey == KEY_OK) {
+            httpService.stopStream();
+        }
+
+        if (millis() - lastReport >= 1000) {
+            lastReport = millis();
+            std::string line = "  " + std::to_string(status.bodyBytes / 1024) + " KB";
+            if (status.contentLength > 0) {
+                line += " / " + std::to_string(status.contentLength / 1024) + " KB (" +
+                        std::to_string(status.bodyBytes * 100 / status.contentLength) + "%)";
+            }
+            terminalView.println(line);
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    file.close();
+    if (toSd) sdService.end();
+
+    const unsigned long elapsed = std::max<unsigned long>(millis() - start, 1);
+    const uint64_t rate = status.bodyBytes * 1000 / elapsed / 1024;
+    if (status.error.empty() && !status.cancelled) {
+        terminalView.println("HTTP：已保存 " + path + "，" + std::to_string(status.bodyBytes) + " 字节，" + // 汉化
+                             std::to_string(rate) + " KB/s"); // 汉化
+    } else {
+        terminalView.println(std::string("HTTP：") + (status.cancelled ? "已停止" : "错误，" + status.error) + // 汉化
+                             "，" + path + " 不完整（" + std::to_string(status.bodyBytes) + " 字节）"); // 汉化
+    }
+}
+
 /*
 HTTP Analayze
 */
@@ -661,21 +844,31 @@ void ANetworkController::handleTelnet(const TerminalCommand &cmd)
 
     // Connection success
     terminalView.println("TELNET：已连接。Shell已启动... 按下[任意ESP32按键]停止。\n"); // 汉化
+    std::string out;
+    out.reserve(SessionIoManager::RX_MAX_POLL);
     while (true)
     {
         // terminal to telnet
-        char k = terminalInput.readChar();
-        if (k != KEY_NONE) telnetService.writeChar(k);
+        bool active = false;
+        for (size_t i = 0; i < SESSION_MAX_KEYS; ++i) {
+            char k = terminalInput.readChar();
+            if (k == KEY_NONE) break;
+            telnetService.writeChar(k);
+            active = true;
+        }
 
         // device button press to stop
         if (deviceInput.readChar() != KEY_NONE) break;
 
         // telnet to terminal
         telnetService.poll();
-        std::string out = telnetService.readOutputNonBlocking();
-        if (!out.empty()) terminalView.print(out);
+        if (telnetService.readOutputNonBlocking(out) > 0) {
+            terminalView.print(out);
+            out.clear();
+            active = true;
+        }
 
-        delay(5);
+        if (!active) delay(5);
     }
 
     telnetService.close();
@@ -711,6 +904,180 @@ void ANetworkController::handleModbus(const TerminalCommand &cmd)
     modbusShell.run(host, port);
 }
 
+/*
+Bench
+*/
+void ANetworkController::handleBench(const TerminalCommand &cmd)
+{
+    if (!wifiService.isConnected() && !ethernetService.isConnected()) {
+        terminalView.println("Bench：你必须先连接Wi-Fi或以太网，请先使用'connect'命令。"); // 汉化
+        return;
+    }
+
+    const std::string proto = cmd.getSubcommand();
+    auto args = argTransformer.splitArgs(cmd.getArgs());
+    if ((proto != "tcp" && proto != "udp") || args.empty() || (args[0] != "send" && args[0] != "recv")) {
+        terminalView.println("使用方法：bench <tcp|udp> send <目标地址> [选项]"); // 汉化
+        terminalView.println("          bench <tcp|udp> recv [选项]"); // 汉化
+        terminalView.println("  -t <秒>       发送时长，默认 10"); // 汉化
+        terminalView.println("  -l <字节>     每次写入/数据报长度，默认 TCP 8192，UDP 1470"); // 汉化
+        terminalView.println("  -w <字节>     套接字缓冲区 (SO_SNDBUF/SO_RCVBUF)"); // 汉化
+        terminalView.println("  -b <Mbit/s>   UDP 发送速率，默认 10，0 为不限"); // 汉化
+        terminalView.println("  -p <端口>     默认 5001"); // 汉化
+        terminalView.println("  -i <秒>       报告间隔，默认 1"); // 汉化
+        terminalView.println("  -N            TCP_NODELAY"); // 汉化
+        terminalView.println("对端：iperf 2 (iperf -s [-u] / iperf -c <设备IP> [-u -b 20M])，或 tools/netbench_peer.py"); // 汉化
+        return;
+    }
+
+    NetBenchManager::Config config;
+    config.protocol = proto == "udp" ? NetBenchManager::Protocol::Udp : NetBenchManager::Protocol::Tcp;
+    config.role = args[0] == "send" ? NetBenchManager::Role::Send : NetBenchManager::Role::Receive;
+
+    std::string host;
+    size_t i = 1;
+    if (config.role == NetBenchManager::Role::Send) {
+        if (args.size() < 2 || args[1].empty() || args[1][0] == '-') {
+            terminalView.println("Bench：缺少目标地址。"); // 汉化
+            return;
+        }
+        host = args[1];
+        i = 2;
+    }
+
+    // Options
+    for (; i < args.size(); ++i) {
+        const std::string& opt = args[i];
+        if (opt.empty()) continue;
+        if (opt == "-N") { config.noDelay = true; continue; }
+        if (i + 1 >= args.size()) {
+            terminalView.println("Bench：选项 " + opt + " 缺少数值。"); // 汉化
+            return;
+        }
+        const std::string& value = args[++i];
+
+        int n = 0;
+        if (opt == "-b") {
+            char* end = nullptr;
+            const float mbit = std::strtof(value.c_str(), &end);
+            if (end == value.c_str() || mbit < 0.f) { terminalView.println("Bench：无效的速率。"); return; } // 汉化
+            config.bandwidth = static_cast<uint32_t>(mbit * 1000000.f);
+            continue;
+        }
+        if (!argTransformer.parseInt(value, n) || n < 0) {
+            terminalView.println("Bench：无效的数值 " + value); // 汉化
+            return;
+        }
+        if      (opt == "-t") config.durationMs = static_cast<uint32_t>(n) * 1000;
+        else if (opt == "-l") config.length = static_cast<size_t>(n);
+        else if (opt == "-w") config.window = n;
+        else if (opt == "-p") config.port = static_cast<uint16_t>(n);
+        else if (opt == "-i") config.intervalMs = static_cast<uint32_t>(n) * 1000;
+        else {
+            terminalView.println("Bench：未知选项 " + opt); // 汉化
+            return;
+        }
+    }
+
+    const bool udp = config.protocol == NetBenchManager::Protocol::Udp;
+    const bool sending = config.role == NetBenchManager::Role::Send;
+    NetBenchManager bench;
+    if (!bench.begin(config, host)) {
+        terminalView.println("Bench：" + bench.error()); // 汉化
+        return;
+    }
+
+    // Header
+    const auto& cfg = bench.config();
+    const std::string localIp = globalState.getCurrentMode() == ModeEnum::ETHERNET
+                                ? ethernetService.getLocalIP() : wifiService.getLocalIP();
+    char line[160];
+    if (sending) {
+        snprintf(line, sizeof(line), "Bench：%s 发送到 %s:%u，%u 秒，长度 %u 字节", // 汉化
+                 udp ? "UDP" : "TCP", host.c_str(), (unsigned)cfg.port,
+                 (unsigned)(cfg.durationMs / 1000), (unsigned)cfg.length);
+    } else {
+        snprintf(line, sizeof(line), "Bench：%s 在 %s:%u 等待对端发送", // 汉化
+                 udp ? "UDP" : "TCP", localIp.c_str(), (unsigned)cfg.port);
+    }
+    terminalView.println(line);
+    if (udp && sending) {
+        terminalView.println("  速率 " + (cfg.bandwidth ? std::to_string(cfg.bandwidth / 1000) + " kbit/s" : std::string("不限"))); // 汉化
+    }
+    const int window = bench.result().window;
+    if (cfg.window > 0 && window < 0) {
+        terminalView.println(std::string("  ") + (sending ? "SO_SNDBUF" : "SO_RCVBUF") + " 不受协议栈支持，使用默认值"); // 汉化
+    } else if (window >= 0) {
+        terminalView.println(std::string("  ") + (sending ? "发送" : "接收") + "缓冲区 " + std::to_string(window) + " 字节"); // 汉化
+    }
+    terminalView.println("  按[ENTER]停止。\n"); // 汉化
+
+    // Run, intervals are printed as they close
+    auto printInterval = [&](const NetBenchManager::Interval& iv) {
+        const uint32_t ms = std::max<uint32_t>(iv.endMs - iv.startMs, 1);
+        int n = snprintf(line, sizeof(line), "[%5.1f-%5.1f 秒] %8.1f KB %7.2f Mbit/s", // 汉化
+                         iv.startMs / 1000.f, iv.endMs / 1000.f, iv.bytes / 1024.f,
+                         NetBenchManager::mbps(iv.bytes, ms));
+        if (udp && !sending && n > 0 && n < (int)sizeof(line)) {
+            snprintf(line + n, sizeof(line) - n, "  抖动 %.3f ms  丢包 %u  乱序 %u", // 汉化
+                     iv.jitterUs / 1000.f, (unsigned)iv.lost, (unsigned)iv.outOfOrder);
+        }
+        terminalView.println(line);
+    };
+
+    bool stopped = false;
+    NetBenchManager::Interval iv;
+    while (bench.step(50)) {
+        while (bench.takeInterval(iv)) printInterval(iv);
+
+        int terminalKey = terminalInput.readChar();
+        char deviceKey = deviceInput.readChar();
+        if (terminalKey == '\n' || terminalKey == '\r' || deviceKey == KEY_OK) {
+            bench.cancel();
+            stopped = true;
+            break;
+        }
+    }
+    while (bench.takeInterval(iv)) printInterval(iv);
+
+    // Summary
+    const auto& r = bench.result();
+    if (bench.state() == NetBenchManager::State::Failed) {
+        terminalView.println("Bench：" + bench.error()); // 汉化
+    }
+    if (!r.durationMs) {
+        terminalView.println(stopped ? "Bench：已停止。" : "Bench：没有数据。"); // 汉化
+        return;
+    }
+
+    snprintf(line, sizeof(line), "\n总计：%.2f MB，%.2f 秒，%.2f Mbit/s", // 汉化
+             r.bytes / 1048576.f, r.durationMs / 1000.f, NetBenchManager::mbps(r.bytes, r.durationMs));
+    terminalView.println(line);
+    if (!r.peerAddr.empty()) terminalView.println("对端：" + r.peerAddr); // 汉化
+
+    if (udp && sending) {
+        snprintf(line, sizeof(line), "已发送 %u 个数据报，缓冲区不足重试 %u 次", // 汉化
+                 (unsigned)r.datagrams, (unsigned)r.sendErrors);
+        terminalView.println(line);
+        if (!r.peerReport) {
+            terminalView.println(stopped ? "Bench：已停止。" : "未收到接收端报告。"); // 汉化
+            return;
+        }
+        const auto& p = r.peer;
+        snprintf(line, sizeof(line), "接收端：%.2f Mbit/s，抖动 %.3f ms，丢包 %u/%u (%.1f%%)，乱序 %u", // 汉化
+                 NetBenchManager::mbps(p.bytes, p.durationMs), p.jitterUs / 1000.f, (unsigned)p.lost,
+                 (unsigned)p.datagrams, p.datagrams ? 100.f * p.lost / p.datagrams : 0.f, (unsigned)p.outOfOrder);
+        terminalView.println(line);
+    } else if (udp) {
+        const uint32_t expected = r.datagrams + r.lost;
+        snprintf(line, sizeof(line), "抖动 %.3f ms，丢包 %u/%u (%.1f%%)，乱序 %u", // 汉化
+                 r.jitterUs / 1000.f, (unsigned)r.lost, (unsigned)expected,
+                 expected ? 100.f * r.lost / expected : 0.f, (unsigned)r.outOfOrder);
+        terminalView.println(line);
+    }
+    if (stopped) terminalView.println("Bench：已停止。"); // 汉化
+}
+
 /*
 Help
 */
@@ -721,9 +1088,12 @@ void ANetworkController::handleHelp()
     terminalView.println("  ssh <目标地址> <用户名> <密码> [端口号]"); // 汉化
     terminalView.println("  telnet <目标地址> [端口号]"); // 汉化
     terminalView.println("  nc <目标地址> <端口号>"); // 汉化
-    terminalView.println("  nmap <目标地址> [-p 端口范围]"); // 汉化
+    terminalView.println("  nmap <目标地址/范围/网段> [-p 端口范围] [-Pn]"); // 汉化
     terminalView.println("  modbus <目标地址> [端口号]"); // 汉化
+    terminalView.println("  bench <tcp|udp> <send <目标地址>|recv> [-t 秒] [-w 缓冲] [-b Mbit/s]"); // 汉化
     terminalView.println("  http get <网址>"); // 汉化
+    terminalView.println("  http stream <网址> [JSON路径]"); // 汉化
+    terminalView.println("  http download <网址> [文件路径] [sd]"); // 汉化
     terminalView.println("  http analyze <网址>"); // 汉化
     terminalView.println("  lookup mac <MAC地址>"); // 汉化
     terminalView.println("  lookup ip <地址或网址>"); // 汉化
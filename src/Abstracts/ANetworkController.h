@@ -16,9 +16,12 @@
 #include "Services/TelnetService.h"
 #include "Services/HttpService.h"
 #include "Services/ModbusService.h"
+#include "Services/SdService.h"
+#include "Services/LittleFsService.h"
 #include "Transformers/ArgTransformer.h"
 #include "Transformers/JsonTransformer.h"
 #include "Managers/UserInputManager.h"
+#include "Managers/NetBenchManager.h"
 #include "States/GlobalState.h"
 #include "Models/TerminalCommand.h"
 #include "Shells/ModbusShell.h"
@@ -40,6 +43,8 @@ public:
         NvsService& nvsService,
         HttpService& httpService,
         TelnetService& telnetService,
+        SdService& sdService,
+        LittleFsService& littleFsService,
         ArgTransformer& argTransformer,
         JsonTransformer& jsonTransformer,
         UserInputManager& userInputManager,
@@ -54,11 +59,14 @@ protected:
     void handleDiscovery(const TerminalCommand& cmd);
     void handleTelnet(const TerminalCommand& cmd);
     void handleModbus(const TerminalCommand& cmd);
+    void handleBench(const TerminalCommand& cmd);
     void handleHelp();
 
     // HTTP
     void handleHttp(const TerminalCommand &cmd);
     void handleHttpGet(const TerminalCommand &cmd);
+    void handleHttpStream(const TerminalCommand &cmd);
+    void handleHttpDownload(const TerminalCommand &cmd);
     void handleHttpAnalyze(const TerminalCommand &cmd);
     
     // Lookup
@@ -66,6 +74,9 @@ protected:
     void handleLookupMac(const TerminalCommand& cmd);
     void handleLookupIp(const TerminalCommand& cmd);
 
+    // Keys forwarded per pass of a session loop, a paste goes out together
+    static constexpr size_t SESSION_MAX_KEYS = 256;
+
 
 protected:
     ITerminalView&     terminalView;
@@ -84,6 +95,8 @@ protected:
     ICMPService&       icmpService;
     HttpService&       httpService;
     TelnetService&     telnetService;
+    SdService&         sdService;
+    LittleFsService&   littleFsService;
 
     ModbusShell&       modbusShell;
 
@@ -1,4 +1,5 @@
 #include "Controllers/BluetoothController.h"
+#include <algorithm>
 
 /*
 Constructor
@@ -23,7 +24,7 @@ Entry point for BT command
 void BluetoothController::handleCommand(const TerminalCommand& cmd) {
     const auto& root = cmd.getRoot();
 
-    if      (root == "scan")     handleScan();
+    if      (root == "scan")     handleScan(cmd);
     else if (root == "pair")     handlePair(cmd);
     else if (root == "spoof")    handleSpoof(cmd);
     else if (root == "sniff")    handleSniff(cmd);
@@ -38,17 +39,72 @@ void BluetoothController::handleCommand(const TerminalCommand& cmd) {
 /*
 Scan
 */
-void BluetoothController::handleScan() {
-    terminalView.println("蓝牙扫描：正在扫描 10秒内完成...\n"); // 汉化
-    auto lines = bluetoothService.scanDevices(10);
-    if (lines.empty()) {
-        terminalView.println("蓝牙扫描：未发现设备"); // 汉化
+void BluetoothController::handleScan(const TerminalCommand& cmd) {
+    // scan [seconds, 0 = until ENTER] [passive] [interval <ms>] [window <ms>] [duty <%>]
+    auto tokens = argTransformer.splitArgs(cmd.getSubcommand() + " " + cmd.getArgs());
+    int seconds = 10;
+    bool active = true;
+    int interval = BluetoothService::SCAN_INTERVAL_MS;
+    int window = BluetoothService::SCAN_WINDOW_MS;
+    int duty = -1;
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const std::string& t = tokens[i];
+        const bool hasValue = i + 1 < tokens.size();
+        int value = 0;
+        if (argTransformer.parseInt(t, value) && value >= 0) {
+            seconds = value;
+        } else if (t == "passive") {
+            active = false;
+        } else if (t == "active") {
+            active = true;
+        } else if ((t == "interval" || t == "window" || t == "duty") && hasValue &&
+                   argTransformer.parseInt(tokens[i + 1], value) && value > 0 && value <= 10240) {
+            if (t == "interval") interval = value;
+            else if (t == "window") window = value;
+            else duty = value;
+            ++i;
+        } else {
+            terminalView.println("使用方法：scan [秒数, 0=持续] [passive] [interval <ms>] [window <ms>] [duty <%>]"); // 汉化
+            return;
+        }
+    }
+    if (duty > 0) window = std::max(3, interval * std::min(duty, 100) / 100);
+    if (window > interval) window = interval;
+
+    if (!bluetoothService.startScan(active, interval, window)) {
+        terminalView.println("蓝牙扫描：参数无效，间隔和窗口须为3-10240ms且窗口不大于间隔"); // 汉化
         return;
     }
 
-    for (const auto& line : lines) {
-        terminalView.println("  " + line + "\n");
+    terminalView.println("蓝牙扫描：" + std::string(active ? "主动" : "被动") + "扫描, 间隔 " + std::to_string(interval) +
+                         "ms, 窗口 " + std::to_string(window) + "ms (" + std::to_string(window * 100 / interval) + "%)" +
+                         (seconds ? ", " + std::to_string(seconds) + "秒" : std::string()) + "... 按下[ENTER键]停止\n"); // 汉化
+
+    // Devices printed as they are discovered
+    const unsigned long start = millis();
+    unsigned long firstMs = 0;
+    size_t found = 0;
+    while (seconds == 0 || millis() - start < static_cast<unsigned long>(seconds) * 1000UL) {
+        char key = terminalInput.readChar();
+        if (key == '\r' || key == '\n') break;
+
+        for (const auto& row : BluetoothService::takeNewDevices()) {
+            const auto& d = row.device;
+            if (found++ == 0) firstMs = millis() - start;
+            terminalView.println("  " + BluetoothDeviceManager::formatAddress(d.addr) + " | " +
+                                 (d.name[0] ? d.name : "(未知设备)") + " | RSSI: " + std::to_string(d.rssi) +
+                                 " | 类型: " + (d.connectable ? "可连接" : "不可连接")); // 汉化
+        }
+        delay(20);
     }
+    bluetoothService.stopScan();
+
+    if (found == 0) {
+        terminalView.println("蓝牙扫描：未发现设备"); // 汉化
+        return;
+    }
+    terminalView.println("\n蓝牙扫描：发现 " + std::to_string(found) + " 个设备, 首个结果 " + std::to_string(firstMs) + "ms"); // 汉化
 }
 
 /*
@@ -106,27 +162,52 @@ void BluetoothController::handleSniff(const TerminalCommand& cmd) {
     bluetoothService.switchToMode(BluetoothMode::CLIENT);
     BluetoothService::startPassiveBluetoothSniffing();
 
-    unsigned long lastPull = 0;
+    // Sorted device table instead of one line per advertisement
+    unsigned long lastRefresh = millis();
     while (true) {
         // Enter press
         char key = terminalInput.readChar();
         if (key == '\r' || key == '\n') break;
 
-        // Show paquets if any
-        if (millis() - lastPull > 200) { 
-            auto logs = BluetoothService::getBluetoothSniffLog();
-            for (const auto& line : logs) {
-                terminalView.println(line);
-            }
-            lastPull = millis();
+        if (millis() - lastRefresh > SNIFF_REFRESH_MS) {
+            printDeviceTable();
+            lastRefresh = millis();
         }
         delay(10);
     }
 
     BluetoothService::stopPassiveBluetoothSniffing();
+    printDeviceTable();
     terminalView.println("蓝牙嗅探：用户已停止\n"); // 汉化
 }
 
+/*
+Sniff device table
+*/
+void BluetoothController::printDeviceTable() {
+    size_t total = 0;
+    uint32_t adverts = 0;
+    auto rows = BluetoothService::getDeviceView(SNIFF_MAX_ROWS, total, adverts);
+    const uint32_t now = millis();
+
+    terminalView.println("");
+    for (const auto& row : rows) {
+        const auto& d = row.device;
+        char line[160];
+        snprintf(line, sizeof(line), "[蓝牙] %s | %s | RSSI: %d (%d/%d) | 间隔: %lums | 广播: %lu | %lus前 | %s", // 汉化
+                 BluetoothDeviceManager::formatAddress(d.addr).c_str(),
+                 d.name[0] ? d.name : "(未知设备)",
+                 d.rssiAvg(), d.rssiMin, d.rssiMax,
+                 (unsigned long)d.intervalMs, (unsigned long)d.adverts,
+                 (unsigned long)((now - d.lastMs) / 1000),
+                 d.connectable ? "可连接" : "不可连接"); // 汉化
+        terminalView.println(line);
+        if (!row.ad.empty()) terminalView.println("       " + row.ad);
+    }
+    terminalView.println("  共 " + std::to_string(total) + " 个设备, " + std::to_string(adverts) + " 条广播" +
+                         (total > rows.size() ? ", 显示信号最强的 " + std::to_string(rows.size()) + " 个" : std::string())); // 汉化
+}
+
 /*
 Server
 */
@@ -342,7 +423,8 @@ Help
 */
 void BluetoothController::handleHelp() {
     terminalView.println("蓝牙命令："); // 汉化
-    terminalView.println("  scan");
+    terminalView.println("  scan [sec] [passive|active]");
+    terminalView.println("  scan [interval <ms>] [window <ms>] [duty <%>]");
     terminalView.println("  pair <mac>");
     terminalView.println("  spoof <mac>");
     terminalView.println("  sniff");
@@ -35,9 +35,11 @@ private:
     UserInputManager& userInputManager;
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
+    static constexpr unsigned long SNIFF_REFRESH_MS = 2000;
+    static constexpr size_t SNIFF_MAX_ROWS = 15;
     
-    // Scan for BT devices
-    void handleScan();
+    // Scan for BT devices, results streamed as they are heard
+    void handleScan(const TerminalCommand& cmd);
 
     // Pair with BT device
     void handlePair(const TerminalCommand& cmd);
@@ -66,6 +68,9 @@ private:
     // Sniff BT server I/O
     void handleSniff(const TerminalCommand& cmd);
 
+    // Print the sniffed devices, strongest first
+    void printDeviceTable();
+
     // Available BT commands
     void handleHelp();
 
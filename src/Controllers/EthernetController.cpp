@@ -15,6 +15,7 @@ void EthernetController::handleCommand(const TerminalCommand& cmd) {
     else if (root == "ssh")       handleSsh(cmd);
     else if (root == "telnet")    handleTelnet(cmd);
     else if (root == "modbus")    handleModbus(cmd);
+    else if (root == "bench")     handleBench(cmd);
     else if (root == "http")      handleHttp(cmd);
     else if (root == "lookup")    handleLookup(cmd);
     else if (root == "status")    handleStatus();
@@ -34,7 +34,9 @@ void InfraredController::handleCommand(const TerminalCommand& command) {
     else if (command.getRoot() == "remote")       handleRemote();
     else if (command.getRoot() == "replay")       handleReplay(command);
     else if (command.getRoot() == "record")       handleRecord();
+    else if (command.getRoot() == "learn")        handleLearn();
     else if (command.getRoot() == "load")         handleLoad(command);
+    else if (command.getRoot() == "identify")     handleIdentify();
     else if (command.getRoot() == "jam")          handleJam();
     else if (command.getRoot() == "setprotocol")  handleSetProtocol();
     else handleHelp();
@@ -270,22 +272,7 @@ void InfraredController::handleRecord() {
         if (funcName.empty()) funcName = defFunc;
 
         // Build cmd
-        InfraredFileRemoteCommand cmd;
-        cmd.functionName = funcName;
-        cmd.protocol     = decoded.getProtocol();
-
-        // Address
-        uint8_t device = static_cast<uint8_t>(decoded.getDevice() & 0xFF);
-        uint8_t sub    = static_cast<uint8_t>((decoded.getSubdevice() < 0 ? 0 : decoded.getSubdevice()) & 0xFF);
-        cmd.address     = (static_cast<uint16_t>(sub) << 8) | device;
-
-        cmd.function    = static_cast<uint8_t>(decoded.getFunction() & 0xFF);
-
-        // Unused for non-RAW
-        cmd.rawData = nullptr;
-        cmd.rawDataSize = 0;
-        cmd.frequency = 0;
-        cmd.dutyCycle = 0.0f;
+        InfraredFileRemoteCommand cmd = toFileCommand(decoded, funcName);
 
         cmds.push_back(cmd);
 
@@ -323,6 +310,149 @@ void InfraredController::handleRecord() {
     terminalView.println("可使用'load'命令或连接Web终端获取该文件.\n"); // 汉化
 }
 
+/*
+Learn a whole remote in one pass
+*/
+void InfraredController::handleLearn() {
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("红外学习: LittleFS未挂载. 终止操作."); // 汉化
+            return;
+        }
+    }
+
+    constexpr size_t MIN_FREE_BYTES = 8 * 1024;
+    size_t free = littleFsService.freeBytes();
+    if (free < MIN_FREE_BYTES) {
+        terminalView.println("红外学习: LittleFS空间不足. 需要至少8KB可用空间, 当前仅有 " + std::to_string(free) + " 字节."); // 汉化
+        return;
+    }
+
+    // Target file, appended if it already exists
+    std::string defName = "ir_learn_" + std::to_string(millis() % 1000000);
+    std::string fileBase = userInputManager.readSanitizedString("输入文件名", defName, false); // 汉化
+    if (fileBase.empty()) fileBase = defName;
+    std::string path = "/" + fileBase;
+    if (path.size() < 4 || path.substr(path.size() - 3) != ".ir") {
+        path += ".ir";
+    }
+
+    std::string header;
+    const bool append = littleFsService.exists(path) &&
+                        littleFsService.readRange(path, 0, 12, header) && header == "Filetype: IR";
+    if (littleFsService.exists(path) && !append) {
+        terminalView.println("红外学习: 文件已存在且不是.ir格式: " + path); // 汉化
+        return;
+    }
+
+    // Button names, in the order they will be pressed
+    terminalView.print("按键名称, 逗号分隔 (留空自动命名): "); // 汉化
+    auto names = InfraredLearnManager::splitNames(userInputManager.getLine(false));
+    for (auto& n : names) std::replace(n.begin(), n.end(), ' ', '_');
+
+    InfraredLearnManager session;
+    session.begin(names);
+
+    terminalView.println("\n红外学习: 依次按下遥控器按键, 每个按键按一次. 按下[ENTER]结束并保存.\n"); // 汉化
+    terminalView.println("  请按: " + session.nextName()); // 汉化
+
+    infraredService.startReceiver();
+    const uint32_t startMs = millis();
+    std::vector<uint16_t> timings;
+    while (true) {
+        char c = terminalInput.readChar();
+        if (c == '\r' || c == '\n') break;
+
+        if (session.buttons().size() >= MAX_LEARNED_BUTTONS) {
+            terminalView.println("\n红外学习: 已达到上限 " + std::to_string(MAX_LEARNED_BUTTONS) + " 个按键."); // 汉化
+            break;
+        }
+
+        InfraredCommand decoded;
+        bool repeat = false;
+        uint32_t khz = 0;
+        if (!infraredService.receiveFrame(decoded, repeat, timings, khz)) continue;
+
+        size_t duplicateOf = 0;
+        auto outcome = session.feed(millis(), decoded, repeat, timings.data(), timings.size(), khz, &duplicateOf);
+
+        if (outcome == InfraredLearnManager::Outcome::Learned) {
+            const auto& b = session.buttons().back();
+            if (b.command.getProtocol() != RAW) {
+                terminalView.println("  ✅ " + b.name + " : " + InfraredProtocolMapper::toString(b.command.getProtocol()) +
+                                     " 设备=" + std::to_string(b.command.getDevice()) +
+                                     " 指令=" + std::to_string(b.command.getFunction())); // 汉化
+            } else {
+                terminalView.println("  ✅ " + b.name + " : 原始信号 (" + std::to_string(b.timings.size()) + " 个时序)"); // 汉化
+            }
+
+            // Stop once every named button is learned
+            if (!names.empty() && session.buttons().size() == names.size()) break;
+            terminalView.println("  请按: " + session.nextName()); // 汉化
+        } else if (outcome == InfraredLearnManager::Outcome::Duplicate) {
+            terminalView.println("  ⚠️  已学习过: " + session.buttons()[duplicateOf].name + ", 请按: " + session.nextName()); // 汉化
+        }
+    }
+    infraredService.stopReceiver();
+
+    const auto& buttons = session.buttons();
+    if (buttons.empty()) {
+        terminalView.println("\n红外学习: 未学习到任何按键.\n"); // 汉化
+        return;
+    }
+
+    // Entries written in one go
+    std::vector<InfraredFileRemoteCommand> cmds;
+    cmds.reserve(buttons.size());
+    for (const auto& b : buttons) {
+        InfraredFileRemoteCommand cmd = toFileCommand(b.command, b.name);
+        if (b.command.getProtocol() == RAW) {
+            cmd.rawData = const_cast<uint16_t*>(b.timings.data());
+            cmd.rawDataSize = b.timings.size();
+            cmd.frequency = static_cast<int>(b.khz);
+            cmd.dutyCycle = 0.33f;
+        }
+        cmds.push_back(cmd);
+    }
+
+    bool written = append
+        ? littleFsService.write(path, "\n" + infraredRemoteTransformer.transformEntriesToFileFormat(cmds) + "\n", true)
+        : littleFsService.write(path, infraredRemoteTransformer.transformToFileFormat(fileBase, cmds));
+    if (!written) {
+        terminalView.println("红外学习: 写入文件失败: " + path); // 汉化
+        return;
+    }
+
+    const uint32_t seconds = (millis() - startMs) / 1000;
+    terminalView.println("\n✅ 红外学习: " + std::to_string(buttons.size()) + " 个按键" +
+                         (append ? "已追加到 " : "已保存到 ") + path + // 汉化
+                         " (" + std::to_string(session.frames()) + " 帧, " + std::to_string(seconds) + " 秒)\n"); // 汉化
+}
+
+/*
+Decoded command to a .ir entry
+*/
+InfraredFileRemoteCommand InfraredController::toFileCommand(const InfraredCommand& decoded, const std::string& name) {
+    InfraredFileRemoteCommand cmd;
+    cmd.functionName = name;
+    cmd.protocol     = decoded.getProtocol();
+
+    // Address
+    uint8_t device = static_cast<uint8_t>(decoded.getDevice() & 0xFF);
+    uint8_t sub    = static_cast<uint8_t>((decoded.getSubdevice() < 0 ? 0 : decoded.getSubdevice()) & 0xFF);
+    cmd.address     = (static_cast<uint16_t>(sub) << 8) | device;
+
+    cmd.function    = static_cast<uint8_t>(decoded.getFunction() & 0xFF);
+
+    // Unused for non-RAW
+    cmd.rawData = nullptr;
+    cmd.rawDataSize = 0;
+    cmd.frequency = 0;
+    cmd.dutyCycle = 0.0f;
+    return cmd;
+}
+
 bool InfraredController::recordFrames(std::vector<IRFrame>& tape) {
     tape.clear();
     tape.reserve(MAX_IR_FRAMES);
@@ -483,63 +613,204 @@ void InfraredController::handleLoad(TerminalCommand const& command) {
         return;
     }
 
-    // Get IR files from LittleFS
-    auto files = littleFsService.listFiles(/*root*/ "/", ".ir");
-    if (files.empty()) {
+    // Signal library, only new or modified files are parsed
+    SignalLibraryManager library;
+    refreshLibrary(library);
+    const auto kind = SignalLibraryManager::Kind::Infrared;
+    if (library.filter(kind, "", false).empty()) {
         terminalView.println("红外: LittleFS根目录('/')下未找到.ir文件."); // 汉化
         return;
     }
 
-    // Select file
-    terminalView.println("\n=== LittleFS中的.ir文件 ==="); // 汉化
-    uint16_t idxFile = userInputManager.readValidatedChoiceIndex("文件编号", files, 0); // 汉化
-    const std::string& chosen = files[idxFile];
-
-    // Check size
-    int MAX_FILE_SIZE = 32 * 1024; // 32 KB
-    auto fileSize = littleFsService.getFileSize("/" + chosen);
-    if (fileSize == 0 || fileSize > MAX_FILE_SIZE) {
-        terminalView.println("\n红外: 文件大小无效(>32KB): " + chosen); // 汉化
+    // Filter and dedupe
+    bool hideDuplicates = false;
+    size_t duplicates = library.duplicateCount(kind);
+    if (duplicates) {
+        hideDuplicates = userInputManager.readYesNo("红外: 发现 " + std::to_string(duplicates) + " 个内容重复的文件，是否隐藏?", true); // 汉化
+    }
+    std::string query = userInputManager.readSanitizedString("过滤(名称/协议，留空显示全部)", "", false); // 汉化
+    auto matches = library.filter(kind, query, hideDuplicates);
+    if (matches.empty()) {
+        terminalView.println("红外: 没有匹配 '" + query + "' 的文件."); // 汉化
         return;
     }
 
-    // Load file content
-    std::string text;
-    if (!littleFsService.readAll("/" + chosen, text)) {
+    std::vector<std::string> files;
+    files.reserve(matches.size());
+    for (size_t i : matches) files.push_back(SignalLibraryManager::summary(library.entries()[i]));
+
+    // Select file
+    terminalView.println("\n=== LittleFS中的.ir文件 ==="); // 汉化
+    uint16_t idxFile = userInputManager.readValidatedChoiceIndex("文件编号", files, 0); // 汉化
+    const std::string chosen = library.entries()[matches[idxFile]].file;
+
+    // Index the buttons, the file is read chunk by chunk and never held in memory
+    const std::string path = "/" + chosen;
+    infraredRemoteTransformer.beginIndex();
+    bool read = littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+        return infraredRemoteTransformer.feedIndex(data, len);
+    });
+    auto buttons = infraredRemoteTransformer.endIndex();
+    if (!read) {
         terminalView.println("\n红外: 读取文件失败: " + chosen); // 汉化
         return;
     }
 
     // Verify format
-    if (!infraredRemoteTransformer.isValidInfraredFile(text)) {
+    if (!infraredRemoteTransformer.indexLooksValid()) {
         terminalView.println("\n红外: 无法识别的.ir格式或文件为空: " + chosen); // 汉化
         return;
     }
-
-    // Extract commands
-    auto cmds = infraredRemoteTransformer.transformFromFileFormat(text);
-    if (cmds.empty()) {
+    if (buttons.empty()) {
         terminalView.println("\n红外: 文件中未找到任何指令: " + chosen); // 汉化
         return;
     }
 
     // Cmds names
-    auto cmdStrings = infraredRemoteTransformer.extractFunctionNames(cmds);
+    std::vector<std::string> cmdStrings;
+    cmdStrings.reserve(buttons.size() + 1);
+    for (const auto& b : buttons) cmdStrings.push_back(b.name);
     cmdStrings.push_back("退出文件"); // 汉化 - for exit option
 
+    std::string block;
+    std::vector<uint16_t> rawStorage;
     while (true) {
         // Select command
         terminalView.println("\n=== 文件'" + chosen + "'中的指令 ==="); // 汉化
-        uint8_t idxCmd = userInputManager.readValidatedChoiceIndex("指令编号", cmdStrings, 0); // 汉化
+        uint16_t idxCmd = userInputManager.readValidatedChoiceIndex("指令编号", cmdStrings, 0); // 汉化
         if (idxCmd == cmdStrings.size()-1) {
             terminalView.println("退出指令发送...\n"); // 汉化
             break;
         }
 
+        // Decode the selected button only
+        InfraredFileRemoteCommand cmd;
+        const auto& button = buttons[idxCmd];
+        if (!littleFsService.readRange(path, button.offset, button.length, block) ||
+            !infraredRemoteTransformer.parseButton(block, cmd, rawStorage)) {
+            terminalView.println("\n红外: 读取指令失败: " + button.name); // 汉化
+            continue;
+        }
+
         // Send
-        infraredService.sendInfraredFileCommand(cmds[idxCmd]);
-        terminalView.println("\n ✅  已发送文件'" + chosen + "'中的指令'" + cmds[idxCmd].functionName + "'"); // 汉化
+        infraredService.sendInfraredFileCommand(cmd);
+        terminalView.println("\n ✅  已发送文件'" + chosen + "'中的指令'" + cmd.functionName + "'"); // 汉化
+    }
+}
+
+/*
+Signal library catalog, rebuilt for new or modified files only
+*/
+void InfraredController::refreshLibrary(SignalLibraryManager& library) {
+    // Library directory is the root directory
+    SignalLibraryManager::Storage storage;
+    storage.readAll = [this](const std::string& path, std::string& out) {
+        return littleFsService.exists(path) && littleFsService.readAll(path, out);
+    };
+    storage.write = [this](const std::string& path, const std::string& text) {
+        return littleFsService.write(path, text);
+    };
+    storage.list = [this]() {
+        std::vector<SignalLibraryManager::FileStat> files;
+        for (const auto& e : littleFsService.list("/")) {
+            if (!e.isDir) files.push_back({e.name, static_cast<uint32_t>(e.size), e.mtime});
+        }
+        return files;
+    };
+    storage.read = [this](const std::string& name, const SignalLibraryManager::ChunkSink& sink) {
+        return littleFsService.readChunks("/" + name, sink);
+    };
+
+    size_t changed = library.sync(storage);
+    if (changed) {
+        terminalView.println("红外: 信号库已更新 " + std::to_string(changed) + " 项"); // 汉化
+    }
+}
+
+/*
+Identify
+*/
+void InfraredController::handleIdentify() {
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        return;
+    }
+
+    InfraredMatchManager index;
+    size_t files = indexRawCaptures(index);
+    if (index.entries().empty()) {
+        terminalView.println("红外: .ir文件中没有可用的原始信号."); // 汉化
+        return;
+    }
+    terminalView.println("红外: 已索引 " + std::to_string(index.entries().size()) + " 个原始信号, " +
+                         std::to_string(files) + " 个文件, " +
+                         std::to_string(index.memoryBytes() / 1024) + " KB"); // 汉化
+
+    terminalView.println("红外识别: 等待信号..."); // 汉化
+    terminalView.println("按下[ENTER]停止.\n");
+
+    infraredService.startReceiver();
+    std::vector<uint16_t> timings;
+    while (true) {
+        // Stop on ENTER
+        char c = terminalInput.readChar();
+        if (c == '\r' || c == '\n') {
+            terminalView.println("\n红外识别: 已被用户停止."); // 汉化
+            break;
+        }
+
+        uint32_t khz = 0;
+        if (!infraredService.receiveRaw(timings, khz)) continue;
+
+        const uint32_t start = micros();
+        auto matches = index.match(timings.data(), timings.size());
+        const uint32_t elapsed = micros() - start;
+
+        if (matches.empty()) {
+            terminalView.println("\n红外识别: 未找到匹配 (" + std::to_string(timings.size()) + " 个时序)"); // 汉化
+            continue;
+        }
+
+        terminalView.println("\n红外识别: " + std::to_string(matches.size()) + " 个候选, 用时 " +
+                             std::to_string(elapsed / 1000) + "." + std::to_string((elapsed % 1000) / 100) + " ms"); // 汉化
+        for (const auto& m : matches) {
+            const auto& e = index.entries()[m.entry];
+            terminalView.println("  " + index.files()[e.file] + " / " + e.name +
+                                 "  相似度 " + std::to_string(static_cast<int>(m.score * 100.f + 0.5f)) + "%"); // 汉化
+        }
+    }
+    infraredService.stopReceiver();
+}
+
+/*
+Raw captures of the .ir files at the root, returns the number of files read
+*/
+size_t InfraredController::indexRawCaptures(InfraredMatchManager& index) {
+    size_t files = 0;
+    std::string block;
+    std::vector<uint16_t> rawStorage;
+
+    for (const auto& name : littleFsService.listFiles("/", ".ir")) {
+        const std::string path = "/" + name;
+
+        infraredRemoteTransformer.beginIndex();
+        bool read = littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+            return infraredRemoteTransformer.feedIndex(data, len);
+        });
+        auto buttons = infraredRemoteTransformer.endIndex();
+        if (!read || !infraredRemoteTransformer.indexLooksValid()) continue;
+
+        // Only the raw buttons are decoded
+        for (const auto& button : buttons) {
+            if (!button.raw) continue;
+            InfraredFileRemoteCommand cmd;
+            if (!littleFsService.readRange(path, button.offset, button.length, block) ||
+                !infraredRemoteTransformer.parseButton(block, cmd, rawStorage)) continue;
+            index.add(name, cmd.functionName, cmd.rawData, cmd.rawDataSize);
+        }
+        files++;
     }
+    return files;
 }
 
 /*
@@ -615,7 +886,9 @@ void InfraredController::handleHelp() {
     terminalView.println("  remote");
     terminalView.println("  replay");
     terminalView.println("  record");
+    terminalView.println("  learn");
     terminalView.println("  load");
+    terminalView.println("  identify");
     terminalView.println("  jam");
     terminalView.println("  config");
 }
@@ -14,6 +14,9 @@
 #include "Transformers/ArgTransformer.h"
 #include "Transformers/InfraredRemoteTransformer.h"
 #include "Managers/UserInputManager.h"
+#include "Managers/SignalLibraryManager.h"
+#include "Managers/InfraredMatchManager.h"
+#include "Managers/InfraredLearnManager.h"
 #include "States/GlobalState.h"
 #include "Shells/UniversalRemoteShell.h"
 
@@ -43,6 +46,7 @@ private:
     LittleFsService& littleFsService;
     bool configured = false;
     uint8_t MAX_IR_FRAMES = 64; // Maximum frames to record
+    static constexpr size_t MAX_LEARNED_BUTTONS = 128;
 
 
     // Frames
@@ -77,10 +81,19 @@ private:
 
     // Load commands from .ir files (littlefs)
     void handleLoad(const TerminalCommand& command);
+    void refreshLibrary(SignalLibraryManager& library);
+
+    // Recognize received raw signals against the .ir files
+    void handleIdentify();
+    size_t indexRawCaptures(InfraredMatchManager& index);
 
     // Record raw IR frames to littlefs
     void handleRecord();
 
+    // Learn a whole remote, segmented by press and appended to a .ir file
+    void handleLearn();
+    static InfraredFileRemoteCommand toFileCommand(const InfraredCommand& decoded, const std::string& name);
+
     // Send IR jamming signals
     void handleJam();
 
@@ -7,15 +7,17 @@ void SubGhzController::handleCommand(const TerminalCommand& cmd) {
     const std::string root = cmd.getRoot();
 
     if (root == "sniff")             handleSniff(cmd);
+    else if (root == "record")       handleRecord();
     else if (root == "scan")         handleScan(cmd);
     else if (root == "sweep")        handleSweep();
+    else if (root == "waterfall")    handleWaterfall();
     else if (root == "setfrequency") handleSetFrequency();
     else if (root == "setfreq")      handleSetFrequency();
     else if (root == "replay")       handleReplay(cmd);
     else if (root == "jam")          handleJam(cmd);
     else if (root == "bruteforce")   handleBruteforce();
     else if (root == "decode")       handleDecode(cmd);
-    else if (root == "trace")        handleTrace();
+    else if (root == "trace")        handleTrace(cmd);
     else if (root == "listen")       handleListen();
     else if (root == "load")         handleLoad();
     else if (root == "config")       handleConfig();
@@ -37,6 +39,7 @@ void SubGhzController::handleSniff(const TerminalCommand&) {
     terminalView.println("SUBGHZ 嗅探: 频率 @ " + std::to_string(f) + " MHz... 按下[ENTER]停止\n"); // 汉化
     
     subGhzService.startRawSniffer(state.getSubGhzGdoPin());
+    uint32_t lastOverflows = 0;
     while (true) {
         char c = terminalInput.readChar();
         if (c == '\n' || c == '\r') {
@@ -49,14 +52,157 @@ void SubGhzController::handleSniff(const TerminalCommand&) {
             terminalView.println(line);
         }
 
-        if (subGhzService.isSnifferOverflowing()) {
-            terminalView.println("\n[警告] SUBGHZ 嗅探器: 检测到缓冲区溢出！正在清空缓冲区...\n"); // 汉化
-            subGhzService.drainSniffer();
+        // Frames dropped by the consumer task, backlog full
+        uint32_t overflows = subGhzService.getSnifferOverflowCount();
+        if (overflows != lastOverflows) {
+            terminalView.println("\n[警告] SUBGHZ 嗅探器: 积压缓冲区已满，已丢弃 " + std::to_string(overflows) + " 帧\n"); // 汉化
+            lastOverflows = overflows;
         }
     }
     subGhzService.stopRawSniffer();
 
-    terminalView.println("\nSUBGHZ 嗅探: 已被用户停止。共捕获 " + std::to_string(count) + " 个脉冲\n"); // 汉化
+    terminalView.println("\nSUBGHZ 嗅探: 已被用户停止。共捕获 " + std::to_string(count) + " 个脉冲，丢弃 " +
+                         std::to_string(lastOverflows) + " 帧\n"); // 汉化
+}
+
+/*
+Record raw frames
+*/
+void SubGhzController::handleRecord() {
+    const float f = state.getSubGhzFrequency();
+
+    // Mount LittleFS
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("SUBGHZ 录制: LittleFS未挂载。终止操作。"); // 汉化
+            return;
+        }
+    }
+
+    // Output format
+    std::vector<std::string> formats = { " 二进制 (.rmt, 最紧凑)", " Flipper RAW (.sub, 可用'load'重放)" }; // 汉化
+    int formatIndex = userInputManager.readValidatedChoiceIndex("录制格式", formats, 0); // 汉化
+    auto format = formatIndex == 0 ? SubGhzRecordManager::Format::Binary : SubGhzRecordManager::Format::Flipper;
+
+    std::string defName = "subghz_" + std::to_string(millis() % 1000000);
+    std::string fileBase = userInputManager.readSanitizedString("输入文件名", defName, false); // 汉化
+    if (fileBase.empty()) fileBase = defName;
+    std::string path = "/" + fileBase + (format == SubGhzRecordManager::Format::Binary ? ".rmt" : ".sub");
+
+    // Keep some room for the filesystem, free space is read once and writes are counted against it
+    constexpr size_t MIN_FREE_BYTES = 8 * 1024;
+    const size_t freeBytes = littleFsService.freeBytes();
+    if (freeBytes < MIN_FREE_BYTES) {
+        terminalView.println("SUBGHZ 录制: LittleFS空间不足（至少需要8KB）。"); // 汉化
+        return;
+    }
+    const size_t budget = freeBytes - MIN_FREE_BYTES;
+
+    if (!subGhzService.applySniffProfile(f)) {
+        terminalView.println("SUBGHZ: 未检测到模块。请先执行'config'命令。"); // 汉化
+        return;
+    }
+
+    // Sniffer first, so a failed start leaves no empty file behind
+    if (!subGhzService.startRawSniffer(state.getSubGhzGdoPin())) {
+        terminalView.println("SUBGHZ: 启动原始嗅探器失败。"); // 汉化
+        return;
+    }
+
+    // Frames are written as received, without text formatting
+    SubGhzRecordManager recorder;
+    size_t written = 0;
+    auto writer = [&](const uint8_t* data, size_t len) {
+        if (written + len > budget) return false;
+        bool ok = littleFsService.write(path, data, len, written > 0);
+        if (ok) written += len;
+        return ok;
+    };
+
+    if (!recorder.begin(format, static_cast<uint32_t>(f * 1000000.0f), RMT_1US_TICKS, writer)) {
+        subGhzService.stopRawSniffer();
+        littleFsService.removeFile(path);
+        terminalView.println("SUBGHZ 录制: 创建文件失败: " + path); // 汉化
+        return;
+    }
+
+    terminalView.println("SUBGHZ 录制: " + argTransformer.toFixed2(f) + " MHz -> " + path + "... 按下[ENTER]停止。\n"); // 汉化
+
+    const uint32_t t0 = micros();
+    unsigned long lastStatus = millis();
+    while (true) {
+        char c = terminalInput.readChar();
+        if (c == '\n' || c == '\r') break;
+
+        // Drain every pending frame before polling the terminal again
+        size_t n = 0;
+        uint32_t ts = 0;
+        const rmt_item32_t* items = nullptr;
+        while ((items = subGhzService.receiveRawItems(n, &ts)) != nullptr) {
+            if (n > 8) { // ignore too short frames, likely noise
+                recorder.record(ts - t0, items, n);
+            }
+            subGhzService.returnRawItems(items);
+        }
+
+        if (recorder.failed()) {
+            terminalView.println("\nSUBGHZ 录制: 写入失败（空间不足？）。"); // 汉化
+            break;
+        }
+
+        // Status line, cheap compared to printing every pulse
+        if (millis() - lastStatus >= 500) {
+            lastStatus = millis();
+            terminalView.print("\r 帧=" + std::to_string(recorder.framesRecorded()) +
+                               " 脉冲=" + std::to_string(recorder.pulsesRecorded()) +
+                               " 字节=" + std::to_string(recorder.bytesWritten()) +
+                               " 丢弃=" + std::to_string(subGhzService.getSnifferOverflowCount()) + "   "); // 汉化
+        }
+    }
+
+    subGhzService.stopRawSniffer();
+    recorder.end();
+
+    terminalView.println("\n\nSUBGHZ 录制: 共 " + std::to_string(recorder.framesRecorded()) + " 帧, " +
+                         std::to_string(recorder.pulsesRecorded()) + " 个脉冲, " +
+                         std::to_string(recorder.bytesWritten()) + " 字节已保存到 " + path + "\n"); // 汉化
+
+    if (recorder.framesRecorded() == 0) return;
+
+    // Formatting only happens here, on demand
+    if (format == SubGhzRecordManager::Format::Binary) {
+        if (userInputManager.readYesNo("是否查看录制的帧？", false)) { // 汉化
+            viewRecording(path);
+        }
+    } else {
+        terminalView.println("使用'load'命令可重放该文件。\n"); // 汉化
+    }
+}
+
+/*
+View a binary recording
+*/
+void SubGhzController::viewRecording(const std::string& path) {
+    SubGhzRecordManager reader;
+    reader.beginParse();
+    uint32_t index = 0;
+    bool stopped = false;
+
+    bool ok = littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+        return reader.parseChunk(data, len, [&](uint32_t ts, const rmt_item32_t* items, size_t n) {
+            terminalView.println(" #" + std::to_string(++index) + " @ " + std::to_string(ts / 1000) + " ms");
+            terminalView.println(subGhzService.formatRawPulses(items, n));
+
+            char c = terminalInput.readChar();
+            if (c == '\n' || c == '\r') { stopped = true; return false; }
+            return true;
+        });
+    });
+
+    if (!ok && !stopped) {
+        terminalView.println("SUBGHZ: 读取录制文件失败: " + path + "\n"); // 汉化
+    }
 }
 
 /*
@@ -72,7 +218,7 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
     std::vector<float> freqs = subGhzService.getSupportedFreq(bands[bandIndex]);
 
     // RSSI threshold / hold time selection
-    int holdMs = userInputManager.readValidatedInt("输入每个频率的驻留时间（毫秒）：", 4, 1, 5000); // 汉化
+    int holdUs = userInputManager.readValidatedInt("输入每个频率的驻留时间（微秒）：", 500, 50, 1000000); // 汉化
     int rssiThr = userInputManager.readValidatedInt("输入RSSI检测阈值（dBm）：", -67, -127, 0); // 汉化
 
     // Prepare the scan
@@ -81,26 +227,36 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
         return;
     }
 
-    terminalView.println("SUBGHZ 扫描: 已启动。驻留时间=" + std::to_string(holdMs) +
-                         " 毫秒, 阈值=" + std::to_string(rssiThr) + " dBm.... 按下[ENTER]停止。\n"); // 汉化
+    // Calibrate every channel once, hops then reuse the cached values
+    unsigned long calStart = millis();
+    size_t calibrated = subGhzService.calibrateChannels(freqs);
+    if (calibrated > 0) {
+        terminalView.println("SUBGHZ 扫描: 已校准 " + std::to_string(calibrated) + " 个频率，耗时 " +
+                             std::to_string(millis() - calStart) + " 毫秒"); // 汉化
+    }
+
+    terminalView.println("SUBGHZ 扫描: 已启动。驻留时间=" + std::to_string(holdUs) +
+                         " 微秒, 阈值=" + std::to_string(rssiThr) + " dBm.... 按下[ENTER]停止。\n"); // 汉化
 
     std::vector<int>  best(freqs.size(), -127);
     std::vector<bool> wasAbove(freqs.size(), false);
     bool stopRequested = false;
+    bool passReported = false;
 
     // Scanning
     while (!stopRequested) {
+        unsigned long passStart = micros();
         for (size_t i = 0; i < freqs.size(); ++i) {
             // User enter press
             int c = terminalInput.readChar();
             if (c == '\n' || c == '\r') { stopRequested = true; break; }
 
-            // Set the freq
+            // Hop to the freq, no recalibration
             float f = freqs[i];
-            subGhzService.tune(f);
+            subGhzService.hopTo(f);
 
-            // Measure peak on freq for ms
-            int peak = subGhzService.measurePeakRssi(holdMs);
+            // Measure peak on freq for us
+            int peak = subGhzService.measurePeakRssiUs(holdUs);
             if (peak > best[i]) best[i] = peak;
 
             // Log spike if any
@@ -111,7 +267,16 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
                 wasAbove[i] = false;
             }
         }
+
+        // Report the duration of the first full pass
+        if (!stopRequested && !passReported) {
+            unsigned long passUs = micros() - passStart;
+            terminalView.println(" [信息] 单轮扫描 " + std::to_string(freqs.size()) + " 个频率耗时 " +
+                                 argTransformer.toFixed2(passUs / 1000.0f) + " 毫秒"); // 汉化
+            passReported = true;
+        }
     }
+    subGhzService.endHopping();
 
     // Summary
     std::vector<size_t> idx(freqs.size());
@@ -197,6 +362,7 @@ void SubGhzController::handleReplay(const TerminalCommand&) {
 
     std::vector<std::vector<rmt_item32_t>> frames;
     frames.reserve(64);
+    uint32_t lastOverflows = 0;
 
     bool stop = false;
     while (!stop && frames.size() < 64) {
@@ -212,9 +378,11 @@ void SubGhzController::handleReplay(const TerminalCommand&) {
         frames.push_back(std::move(items));
         terminalView.println(" [已捕获第 " + std::to_string(frames.size()) + " 帧]"); // 汉化
 
-        if (subGhzService.isSnifferOverflowing()) {
-            terminalView.println("\n[警告] SUBGHZ 嗅探器: 检测到缓冲区溢出！正在清空缓冲区...\n"); // 汉化
-            subGhzService.drainSniffer();
+        // Frames dropped by the consumer task, backlog full
+        uint32_t overflows = subGhzService.getSnifferOverflowCount();
+        if (overflows != lastOverflows) {
+            terminalView.println("\n[警告] SUBGHZ 嗅探器: 积压缓冲区已满，已丢弃 " + std::to_string(overflows) + " 帧\n"); // 汉化
+            lastOverflows = overflows;
         }
     }
 
@@ -397,6 +565,7 @@ void SubGhzController::handleDecode(const TerminalCommand&) {
                          std::to_string(f) + " MHz... 按下[ENTER]停止。\n"); // 汉化
 
     std::vector<rmt_item32_t> frame;
+    uint32_t lastOverflows = 0;
     bool stop = false;
     while (!stop) {
         // Cancel
@@ -410,9 +579,11 @@ void SubGhzController::handleDecode(const TerminalCommand&) {
             terminalView.println(result);
         }
 
-        if (subGhzService.isSnifferOverflowing()) {
-            terminalView.println("\n[警告] SUBGHZ 嗅探器: 检测到缓冲区溢出！正在清空缓冲区...\n"); // 汉化
-            subGhzService.drainSniffer();
+        // Frames dropped by the consumer task, backlog full
+        uint32_t overflows = subGhzService.getSnifferOverflowCount();
+        if (overflows != lastOverflows) {
+            terminalView.println("\n[警告] SUBGHZ 嗅探器: 积压缓冲区已满，已丢弃 " + std::to_string(overflows) + " 帧\n"); // 汉化
+            lastOverflows = overflows;
         }
     }
 
@@ -423,7 +594,7 @@ void SubGhzController::handleDecode(const TerminalCommand&) {
 /*
 Trace
 */
-void SubGhzController::handleTrace() {
+void SubGhzController::handleTrace(const TerminalCommand& cmd) {
     const float f = state.getSubGhzFrequency();
 
     // Sniff profile
@@ -432,6 +603,12 @@ void SubGhzController::handleTrace() {
         return;
     }
 
+    // Continuous GPIO trace unless one screen per RMT frame is asked for
+    if (cmd.getSubcommand() == "frame") {
+        handleTraceFrames(f);
+        return;
+    }
+
     terminalView.println("\nSUBGHZ 信号追踪: 在ESP32屏幕上显示 " + argTransformer.toFixed2(f) + " MHz 信号... 按下[ENTER]停止。\n"); // 汉化
 
     const uint8_t gdo = state.getSubGhzGdoPin();
@@ -472,6 +649,78 @@ void SubGhzController::handleTrace() {
     }
 }
 
+/*
+Trace, one screen per received frame
+*/
+void SubGhzController::handleTraceFrames(float f) {
+    // Frames come from the sniffer backlog, nothing is sampled in this loop
+    const uint8_t gdo = state.getSubGhzGdoPin();
+    if (!subGhzService.startRawSniffer(gdo)) {
+        terminalView.println("SUBGHZ: 启动原始嗅探器失败。"); // 汉化
+        return;
+    }
+
+    terminalView.println("\nSUBGHZ 帧追踪: 在ESP32屏幕上逐帧显示 " + argTransformer.toFixed2(f) + " MHz 信号... 按下[ENTER]停止。\n"); // 汉化
+
+    const uint32_t sampleUs = 150;
+    const size_t screenWidth = 240;
+
+    // Update device view
+    deviceView.clear();
+    deviceView.topBar("SubGHz Trace", false, false);
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(screenWidth);
+    uint32_t frames = 0;
+    uint32_t lastOverflows = 0;
+
+    while (true) {
+        // Cancel
+        const char c = terminalInput.readChar();
+        if (c == '\n' || c == '\r') {
+            terminalView.println("SUBGHZ 信号追踪: 已被用户停止。共显示 " + std::to_string(frames) + " 帧\n"); // 汉化
+            break;
+        }
+
+        size_t n = 0;
+        const rmt_item32_t* items = subGhzService.receiveRawItems(n);
+        if (!items) {
+            delay(5);
+            continue;
+        }
+
+        // Expand the frame into fixed width samples, one screen per frame
+        buffer.clear();
+        uint32_t carry = 0;
+        for (size_t i = 0; i < n && buffer.size() < screenWidth; ++i) {
+            const uint32_t durations[2] = { items[i].duration0 / RMT_1US_TICKS, items[i].duration1 / RMT_1US_TICKS };
+            const uint8_t levels[2] = { (uint8_t)items[i].level0, (uint8_t)items[i].level1 };
+            for (int k = 0; k < 2 && buffer.size() < screenWidth; ++k) {
+                carry += durations[k];
+                while (carry >= sampleUs && buffer.size() < screenWidth) {
+                    buffer.push_back(levels[k]);
+                    carry -= sampleUs;
+                }
+            }
+        }
+        subGhzService.returnRawItems(items);
+
+        if (n <= 8) continue; // ignore too short frames, likely noise
+
+        buffer.resize(screenWidth, 0);
+        deviceView.drawLogicTrace(gdo, buffer, 1);
+        frames++;
+
+        uint32_t overflows = subGhzService.getSnifferOverflowCount();
+        if (overflows != lastOverflows) {
+            terminalView.println("[警告] SUBGHZ 信号追踪: 积压缓冲区已满，已丢弃 " + std::to_string(overflows) + " 帧"); // 汉化
+            lastOverflows = overflows;
+        }
+    }
+
+    subGhzService.stopRawSniffer();
+}
+
 /*
 Sweep
 */
@@ -497,6 +746,8 @@ void SubGhzController::handleSweep() {
         return;
     }
 
+    subGhzService.calibrateChannels(freqs);
+
     terminalView.println("\nSUBGHZ 扫频: " + bands[bandIndex] +
                          " | 驻留时间=" + std::to_string(dwellMs) + " 毫秒" +
                          " | 检测窗口=" + std::to_string(windowMs) + " 毫秒" +
@@ -510,9 +761,9 @@ void SubGhzController::handleSweep() {
             char c = terminalInput.readChar();
             if (c == '\n' || c == '\r') { run = false; break; }
 
-            // Tune
+            // Hop, calibration cached
             float f = freqs[i];
-            subGhzService.tune(f);
+            subGhzService.hopTo(f);
 
             // Analyze
             auto line = subGhzAnalyzeManager.analyzeFrequencyActivity(dwellMs, windowMs, thrDbm,
@@ -533,9 +784,117 @@ void SubGhzController::handleSweep() {
         }
     }
 
+    subGhzService.endHopping();
     terminalView.println("\nSUBGHZ 扫频: 已被用户停止。\n"); // 汉化
 }
 
+/*
+Waterfall
+*/
+void SubGhzController::handleWaterfall() {
+    // Band selection
+    auto bands = subGhzService.getSupportedBand();
+    int bandIndex = userInputManager.readValidatedChoiceIndex("选择频段：", bands, 0); // 汉化
+    subGhzService.setScanBand(bands[bandIndex]);
+    std::vector<float> freqs = subGhzService.getSupportedFreq(bands[bandIndex]);
+    if (freqs.empty()) {
+        terminalView.println("SUBGHZ 瀑布图: 所选频段无可用频率。"); // 汉化
+        return;
+    }
+
+    // Params
+    int dwellUs  = userInputManager.readValidatedInt("每个频率的驻留时间（微秒）", 300, 50, 100000); // 汉化
+    int floorDbm = userInputManager.readValidatedInt("热图底噪（dBm）", -100, -127, -20); // 汉化
+    int depth    = userInputManager.readValidatedInt("历史行数", 120, 16, 480); // 汉化
+    const int spanDb = 70;
+
+    // History ring, one byte per channel and per sweep
+    SubGhzWaterfallManager waterfall;
+    if (!waterfall.begin(freqs.size(), depth)) {
+        terminalView.println("SUBGHZ 瀑布图: 内存不足。"); // 汉化
+        return;
+    }
+
+    // Scan profile
+    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true)) {
+        terminalView.println("SUBGHZ: 未配置。请先执行'config'命令。"); // 汉化
+        return;
+    }
+    subGhzService.calibrateChannels(freqs);
+
+    // Terminal heatmap, channels folded into columns
+    const size_t cols = std::min<size_t>(freqs.size(), 64);
+    terminalView.println("\nSUBGHZ 瀑布图: " + argTransformer.toFixed2(freqs.front()) + " - " +
+                         argTransformer.toFixed2(freqs.back()) + " MHz, " + std::to_string(freqs.size()) +
+                         " 个频率, 驻留=" + std::to_string(dwellUs) + " 微秒, 历史=" +
+                         std::to_string(waterfall.memoryBytes()) + " 字节... 按下[ENTER]停止。"); // 汉化
+    terminalView.println(" 强度: '" + std::string(SubGhzWaterfallManager::HEAT_CHARS) + "' = " +
+                         std::to_string(floorDbm) + " .. " + std::to_string(floorDbm + spanDb) + " dBm\n"); // 汉化
+
+    // Device view
+    deviceView.clear();
+    deviceView.topBar("SubGHz Waterfall", false, false);
+
+    std::vector<uint8_t> display;
+    uint16_t line = 0;
+    uint32_t printedSweeps = 0;
+    const unsigned long start = millis();
+    unsigned long lastPrint = start;
+    bool run = true;
+
+    while (run) {
+        // One sweep = one row
+        for (size_t i = 0; i < freqs.size(); ++i) {
+            char c = terminalInput.readChar();
+            if (c == '\n' || c == '\r') { run = false; break; }
+
+            subGhzService.hopTo(freqs[i]);
+            waterfall.setCell(i, subGhzService.measurePeakRssiUs(dwellUs));
+        }
+        if (!run) break;
+
+        waterfall.commitRow(millis());
+
+        // Incremental device rendering, only the new row is drawn
+        waterfall.normalizeRow(waterfall.row(0), display, floorDbm, spanDb);
+        deviceView.drawWaterfallRow(display, line++);
+
+        // Terminal, max hold of the sweeps since the last printed line
+        if (millis() - lastPrint >= 500) {
+            size_t rowsBack = waterfall.sweeps() - printedSweeps;
+            float t = (millis() - start) / 1000.0f;
+            terminalView.println(" " + argTransformer.toFixed2(t) + "s |" +
+                                 waterfall.heatmap(rowsBack, cols, floorDbm, spanDb) + "|");
+            printedSweeps = waterfall.sweeps();
+            lastPrint = millis();
+        }
+    }
+    subGhzService.endHopping();
+
+    // Stats
+    float sps = waterfall.sweepsPerSecond();
+    terminalView.println("\nSUBGHZ 瀑布图: 已被用户停止。"); // 汉化
+    terminalView.println(" 扫描次数: " + std::to_string(waterfall.sweeps()) +
+                         "  每秒扫描: " + argTransformer.toFixed2(sps) +
+                         "  单轮耗时: " + (sps > 0 ? argTransformer.toFixed2(1000.0f / sps) : std::string("-")) + " 毫秒"); // 汉化
+    terminalView.println(" 历史: " + std::to_string(waterfall.rows()) + "/" + std::to_string(waterfall.depth()) +
+                         " 行, 内存 " + std::to_string(waterfall.memoryBytes()) + " 字节, 时间跨度 " +
+                         (sps > 0 ? argTransformer.toFixed2(waterfall.rows() / sps) : std::string("-")) + " 秒"); // 汉化
+
+    // Strongest channels over the whole history
+    std::vector<size_t> idx(freqs.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    std::vector<int> peaks(freqs.size());
+    for (size_t i = 0; i < freqs.size(); ++i) peaks[i] = waterfall.peakDbm(i, waterfall.rows());
+    std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b){ return peaks[a] > peaks[b]; });
+
+    terminalView.println(" [历史峰值]"); // 汉化
+    for (size_t k = 0; k < idx.size() && k < 5; ++k) {
+        terminalView.println("   " + argTransformer.toFixed2(freqs[idx[k]]) + " MHz  RSSI=" + std::to_string(peaks[idx[k]]) + " dBm");
+    }
+    terminalView.println("");
+}
+
 /*
 Load
 */
@@ -544,44 +903,65 @@ void SubGhzController::handleLoad() {
         littleFsService.begin();
     }
 
-    // List .sub files
-    auto files = littleFsService.listFiles(/*root*/ "/", ".sub");
-    if (files.empty()) {
+    // Signal library, only new or modified files are parsed
+    SignalLibraryManager library;
+    refreshLibrary(library);
+    const auto kind = SignalLibraryManager::Kind::SubGhz;
+    if (library.filter(kind, "", false).empty()) {
         terminalView.println("SUBGHZ: 在LittleFS根目录（'/'）中未找到.sub文件。\n"); // 汉化
         return;
     }
 
+    // Filter and dedupe
+    bool hideDuplicates = false;
+    size_t duplicates = library.duplicateCount(kind);
+    if (duplicates) {
+        hideDuplicates = userInputManager.readYesNo("SUBGHZ: 发现 " + std::to_string(duplicates) + " 个内容重复的文件，是否隐藏？", true); // 汉化
+    }
+    std::string query = userInputManager.readSanitizedString("过滤（名称/协议/MHz，留空显示全部）", "", false); // 汉化
+    auto matches = library.filter(kind, query, hideDuplicates);
+    if (matches.empty()) {
+        terminalView.println("SUBGHZ: 没有匹配 '" + query + "' 的文件。\n"); // 汉化
+        return;
+    }
+
+    std::vector<std::string> files;
+    files.reserve(matches.size());
+    for (size_t i : matches) files.push_back(SignalLibraryManager::summary(library.entries()[i]));
+
     // Select file
     terminalView.println("\n=== LittleFS中的.sub文件 ==="); // 汉化
     int fileIndex = userInputManager.readValidatedChoiceIndex("文件序号", files, 0); // 汉化
-    std::string filename = files[fileIndex];
+    std::string filename = library.entries()[matches[fileIndex]].file;
 
-    // Check size
-    int MAX_FILE_SIZE = 32 * 1024; // 32 KB
-    auto fileSize = littleFsService.getFileSize("/" + filename);
-    if (fileSize == 0 || fileSize > MAX_FILE_SIZE) {
-        terminalView.println("\nSUBGHZ: 文件大小无效（>32KB）: " + filename + " (" + std::to_string(fileSize) + " 字节)\n"); // 汉化
+    // Check size, the file is streamed so only empty files are rejected
+    const std::string path = "/" + filename;
+    auto fileSize = littleFsService.getFileSize(path);
+    if (fileSize == 0) {
+        terminalView.println("\nSUBGHZ: 文件为空: " + filename + "\n"); // 汉化
         return;
     }
-    
+
     terminalView.println("\nSUBGHZ: 正在加载文件 '" + filename + "' (" + std::to_string(fileSize) + " 字节)..."); // 汉化
 
-    // Load file
-    std::string fileContent;
-    fileContent.reserve(fileSize + 1);
-    if (!littleFsService.readAll("/" + filename, fileContent)) {
+    // Parse, chunk by chunk, RAW timings are only counted here
+    subGhzTransformer.beginStream([](const int32_t*, size_t) { return true; }, path);
+    bool readOk = littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+        return subGhzTransformer.feedStream(data, len);
+    });
+    auto frames = subGhzTransformer.endStream();
+
+    if (!readOk) {
         terminalView.println("\nSUBGHZ: 读取文件 " + filename + " 失败\n"); // 汉化
         return;
     }
 
     // Validate
-    if (!subGhzTransformer.isValidSubGhzFile(fileContent)) {
+    if (!subGhzTransformer.streamLooksValid()) {
         terminalView.println("\nSUBGHZ: 无效的.sub文件: " + filename + "\n"); // 汉化
         return;
     }
 
-    // Parse
-    auto frames = subGhzTransformer.transformFromFileFormat(fileContent);
     if (frames.empty()) {
         terminalView.println("\nSUBGHZ: 解析.sub文件失败: " + filename + "\n"); // 汉化
         return; 
@@ -605,7 +985,24 @@ void SubGhzController::handleLoad() {
         // Send
         terminalView.println("\n 正在发送第 #" + std::to_string(idx + 1) + " 帧..."); // 汉化
         const auto& cmd = frames[idx];
-        if (subGhzService.send(cmd)) {
+        bool sent = false;
+        if (cmd.protocol == SubGhzProtocolEnum::RAW && cmd.raw_timings.empty() && cmd.raw_count > 0) {
+            // RAW timings are read again from the file and sent batch by batch
+            if (subGhzService.beginRawStream(cmd)) {
+                subGhzTransformer.beginStream([&](const int32_t* timings, size_t count) {
+                    return subGhzService.streamRawTimings(timings, count);
+                }, path);
+                sent = littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+                    return subGhzTransformer.feedStream(data, len);
+                });
+                subGhzTransformer.endStream();
+                subGhzService.endRawStream();
+            }
+        } else {
+            sent = subGhzService.send(cmd);
+        }
+
+        if (sent) {
             terminalView.println(" ✅ " + summaries[idx]);
         } else {
             terminalView.println(" ❌ 第 #" + std::to_string(idx + 1) + " 帧发送失败"); // 汉化
@@ -613,6 +1010,35 @@ void SubGhzController::handleLoad() {
     }
 }
 
+/*
+Signal library catalog, rebuilt for new or modified files only
+*/
+void SubGhzController::refreshLibrary(SignalLibraryManager& library) {
+    // Library directory is the root directory
+    SignalLibraryManager::Storage storage;
+    storage.readAll = [this](const std::string& path, std::string& out) {
+        return littleFsService.exists(path) && littleFsService.readAll(path, out);
+    };
+    storage.write = [this](const std::string& path, const std::string& text) {
+        return littleFsService.write(path, text);
+    };
+    storage.list = [this]() {
+        std::vector<SignalLibraryManager::FileStat> files;
+        for (const auto& e : littleFsService.list("/")) {
+            if (!e.isDir) files.push_back({e.name, static_cast<uint32_t>(e.size), e.mtime});
+        }
+        return files;
+    };
+    storage.read = [this](const std::string& name, const SignalLibraryManager::ChunkSink& sink) {
+        return littleFsService.readChunks("/" + name, sink);
+    };
+
+    size_t changed = library.sync(storage);
+    if (changed) {
+        terminalView.println("SUBGHZ: 信号库已更新 " + std::to_string(changed) + " 项"); // 汉化
+    }
+}
+
 /*
 Listen
 */
@@ -843,12 +1269,14 @@ void SubGhzController::handleHelp() {
     terminalView.println("SubGHz 命令列表:"); // 汉化
     terminalView.println("  scan");
     terminalView.println("  sweep");
+    terminalView.println("  waterfall");
     terminalView.println("  sniff");
+    terminalView.println("  record");
     terminalView.println("  decode");
     terminalView.println("  replay");
     terminalView.println("  jam");
     terminalView.println("  bruteforce");
-    terminalView.println("  trace");
+    terminalView.println("  trace [frame]");
     terminalView.println("  load");
     terminalView.println("  listen");
     terminalView.println("  setfrequency");
@@ -14,6 +14,9 @@
 #include "Transformers/SubGhzTransformer.h"
 #include "Managers/UserInputManager.h"
 #include "Managers/SubGhzAnalyzeManager.h"
+#include "Managers/SubGhzRecordManager.h"
+#include "Managers/SubGhzWaterfallManager.h"
+#include "Managers/SignalLibraryManager.h"
 #include "States/GlobalState.h"
 #include "Services/SubGhzService.h"
 #include "Services/PinService.h"
@@ -56,6 +59,12 @@ private:
     // Sniff for signals
     void handleSniff(const TerminalCommand& cmd);
 
+    // Record raw frames to a file
+    void handleRecord();
+
+    // Print a recorded binary file
+    void viewRecording(const std::string& path);
+
     // Scan for frequencies
     void handleScan(const TerminalCommand& cmd);
 
@@ -75,16 +84,23 @@ private:
     void handleDecode(const TerminalCommand& cmd);
 
     // Show signal trace
-    void handleTrace();
+    void handleTrace(const TerminalCommand& cmd);
+
+    // Show signal trace, one screen per RMT frame
+    void handleTraceFrames(float f);
 
     // Sweep and analyze signals
     void handleSweep();
 
+    // Rolling RSSI history, frequency x time
+    void handleWaterfall();
+
     // Bruteforce attack
     void handleBruteforce();
 
     // Load .sub files
     void handleLoad();
+    void refreshLibrary(SignalLibraryManager& library);
 
     // Convert RSSI to audio
     void handleListen();
@@ -546,7 +546,9 @@ void UtilityController::handleHelp() {
     terminalView.println("  remote               - 万能遥控器命令"); // 汉化
     terminalView.println("  replay [count]       - 重放录制的红外帧"); // 汉化
     terminalView.println("  record               - 将红外信号录制到文件"); // 汉化
+    terminalView.println("  learn                - 连续学习整个遥控器"); // 汉化
     terminalView.println("  load                 - 从文件系统加载.ir文件"); // 汉化
+    terminalView.println("  identify             - 识别信号对应的已存按键"); // 汉化
     terminalView.println("  jam                  - 发送随机红外信号"); // 汉化
     terminalView.println("  config               - 配置参数"); // 汉化
 
@@ -563,7 +565,8 @@ void UtilityController::handleHelp() {
 
     terminalView.println("");
     terminalView.println(" 13. 蓝牙（BLUETOOTH）："); // 汉化
-    terminalView.println("  scan                 - 发现设备"); // 汉化
+    terminalView.println("  scan [sec] [passive] - 发现设备 (0=持续扫描)"); // 汉化
+    terminalView.println("  scan duty <%>        - 扫描窗口占空比"); // 汉化
     terminalView.println("  pair <mac>           - 与设备配对"); // 汉化
     terminalView.println("  sniff                - 嗅探蓝牙数据"); // 汉化
     terminalView.println("  spoof <mac>          - 伪造MAC地址"); // 汉化
@@ -582,6 +585,11 @@ void UtilityController::handleHelp() {
     terminalView.println("  ping <host>          - 探测远程主机"); // 汉化
     terminalView.println("  discovery            - 发现网络设备"); // 汉化
     terminalView.println("  sniff                - 监控Wi-Fi数据包"); // 汉化
+    terminalView.println("  sniff raw            - 逐帧显示而非设备汇总表"); // 汉化
+    terminalView.println("  sniff pcap [path]    - 嗅探并保存为PCAP到SD卡"); // 汉化
+    terminalView.println("  sniff fixed|adaptive - 固定/按流量自适应跳频"); // 汉化
+    terminalView.println("  sniff ch <us|eu|jp>  - 跳频信道集合 (或 1,6,11)"); // 汉化
+    terminalView.println("  sniff pin <channel>  - 固定在单个信道"); // 汉化
     terminalView.println("  probe                - 搜索网络接入点"); // 汉化
     terminalView.println("  spoof ap <mac>       - 伪造AP MAC地址"); // 汉化
     terminalView.println("  spoof sta <mac>      - 伪造终端MAC地址"); // 汉化
@@ -593,9 +601,12 @@ void UtilityController::handleHelp() {
     terminalView.println("  ssh <h> <u> <p> [p]  - 打开SSH会话"); // 汉化
     terminalView.println("  telnet <host> [port] - 打开telnet会话"); // 汉化
     terminalView.println("  nc <host> <port>     - 打开netcat会话"); // 汉化
-    terminalView.println("  nmap <h> [-p ports]  - 扫描主机端口"); // 汉化
+    terminalView.println("  nmap <h> [-p ports]  - 扫描主机端口 (可用范围/网段)"); // 汉化
     terminalView.println("  modbus <host> [port] - Modbus TCP操作"); // 汉化
+    terminalView.println("  bench tcp|udp ...    - 吞吐量测试 (iperf2兼容)"); // 汉化
     terminalView.println("  http get <url>       - HTTP(s) GET请求"); // 汉化
+    terminalView.println("  http stream <url>    - 流式读取 (可按JSON路径过滤)"); // 汉化
+    terminalView.println("  http download <url>  - 下载到LittleFS/SD"); // 汉化
     terminalView.println("  http analyze <url>   - 获取分析报告"); // 汉化
     terminalView.println("  lookup mac|ip <addr> - 查找MAC或IP地址"); // 汉化
     terminalView.println("  webui                - 显示Web UI的IP地址"); // 汉化
@@ -632,9 +643,12 @@ void UtilityController::handleHelp() {
     terminalView.println("  ssh <h> <u> <p> [p]  - 打开SSH会话"); // 汉化
     terminalView.println("  telnet <host> [port] - 打开telnet会话"); // 汉化
     terminalView.println("  nc <host> <port>     - 打开netcat会话"); // 汉化
-    terminalView.println("  nmap <h> [-p ports]  - 扫描主机端口"); // 汉化
+    terminalView.println("  nmap <h> [-p ports]  - 扫描主机端口 (可用范围/网段)"); // 汉化
     terminalView.println("  modbus <host> [port] - Modbus TCP操作"); // 汉化
+    terminalView.println("  bench tcp|udp ...    - 吞吐量测试 (iperf2兼容)"); // 汉化
     terminalView.println("  http get <url>       - HTTP(s) GET请求"); // 汉化
+    terminalView.println("  http stream <url>    - 流式读取 (可按JSON路径过滤)"); // 汉化
+    terminalView.println("  http download <url>  - 下载到LittleFS/SD"); // 汉化
     terminalView.println("  http analyze <url>   - 获取分析报告"); // 汉化
     terminalView.println("  lookup mac|ip <addr> - 查找MAC或IP地址"); // 汉化
     terminalView.println("  reset                - 重置接口"); // 汉化
@@ -644,12 +658,14 @@ void UtilityController::handleHelp() {
     terminalView.println(" 19. 亚千兆（SUBGHZ）："); // 汉化
     terminalView.println("  scan                 - 搜索最佳频率"); // 汉化
     terminalView.println("  sniff                - 原始帧嗅探"); // 汉化
+    terminalView.println("  record               - 录制原始帧到文件"); // 汉化
     terminalView.println("  sweep                - 分析频段"); // 汉化
+    terminalView.println("  waterfall            - 频谱瀑布图"); // 汉化
     terminalView.println("  decode               - 接收并解码帧"); // 汉化
     terminalView.println("  replay               - 录制并重放帧"); // 汉化
     terminalView.println("  jam                  - 干扰选定频率"); // 汉化
     terminalView.println("  bruteforce           - 暴力破解12位密钥"); // 汉化
-    terminalView.println("  trace                - 观察RX信号轨迹"); // 汉化
+    terminalView.println("  trace [frame]        - 观察RX信号轨迹 (frame: 逐帧显示)"); // 汉化
     terminalView.println("  load                 - 从文件系统加载.sub文件"); // 汉化
     terminalView.println("  listen               - RSSI转音频映射"); // 汉化
     terminalView.println("  setfrequency         - 设置工作频率"); // 汉化
@@ -1,5 +1,6 @@
 #include "Controllers/WifiController.h"
 #include "Vendors/wifi_atks.h"
+#include <algorithm>
 
 /*
 Entry point for command
@@ -23,6 +24,7 @@ void WifiController::handleCommand(const TerminalCommand &cmd)
     else if (root == "nc") handleNetcat(cmd);
     else if (root == "nmap") handleNmap(cmd);
     else if (root == "modbus") handleModbus(cmd);
+    else if (root == "bench") handleBench(cmd);
     else if (root == "http") handleHttp(cmd);
     else if (root == "lookup") handleLookup(cmd);
     else if (root == "discovery") handleDiscovery(cmd);
@@ -377,14 +379,89 @@ Sniff
 */
 void WifiController::handleSniff(const TerminalCommand &cmd)
 {
-    terminalView.println("WiFi嗅探已启动... 按下[ENTER]停止。\n"); // 汉化
+    // sniff [raw] [pcap [path]] [fixed|adaptive] [ch <us|eu|jp|list>] [pin <channel>]
+    auto tokens = argTransformer.splitArgs(cmd.getSubcommand() + " " + cmd.getArgs());
+    bool raw = false;
+    bool pcap = false;
+    std::string path;
+    auto mode = WifiChannelManager::Mode::Adaptive;
+    std::vector<uint8_t> channels;
+    WifiChannelManager::parseChannels("eu", channels);
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const std::string& t = tokens[i];
+        const bool hasValue = i + 1 < tokens.size();
+        if (t == "raw") {
+            raw = true;
+        } else if (t == "pcap") {
+            pcap = true;
+            if (hasValue && (tokens[i + 1][0] == '/' || tokens[i + 1].find(".pcap") != std::string::npos)) path = tokens[++i];
+        } else if (t == "fixed") {
+            mode = WifiChannelManager::Mode::Fixed;
+        } else if (t == "adaptive") {
+            mode = WifiChannelManager::Mode::Adaptive;
+        } else if (t == "ch" && hasValue && WifiChannelManager::parseChannels(tokens[i + 1], channels)) {
+            ++i;
+        } else if (t == "pin" && hasValue && WifiChannelManager::parseChannels(tokens[i + 1], channels) && channels.size() == 1) {
+            mode = WifiChannelManager::Mode::Pinned;
+            ++i;
+        } else {
+            terminalView.println("使用方法: sniff [raw] [pcap [路径]] [fixed|adaptive] [ch <us|eu|jp|1,6,11>] [pin <信道>]"); // 汉化
+            return;
+        }
+    }
+    if (pcap && path.empty()) path = "/sniff_" + std::to_string(millis()) + ".pcap";
+    if (pcap && path[0] != '/') path = "/" + path;
+
+    File file;
+    if (pcap) {
+        auto sdMounted = sdService.configure(state.getSpiCLKPin(), state.getSpiMISOPin(),
+                        state.getSpiMOSIPin(), state.getSpiCSPin());
+        if (!sdMounted) {
+            terminalView.println("WiFi嗅探: 未检测到SD卡。请检查SPI引脚"); // 汉化
+            return;
+        }
+        file = sdService.openFileWrite(path);
+        if (!file) {
+            terminalView.println("WiFi嗅探: 无法创建文件 " + path); // 汉化
+            sdService.end();
+            return;
+        }
+    }
 
-    wifiService.startPassiveSniffing();
-    wifiService.switchChannel(1);
+    if (!wifiService.startPassiveSniffing(pcap)) {
+        terminalView.println("WiFi嗅探: 内存不足，无法分配缓冲区。"); // 汉化
+        if (pcap) {
+            file.close();
+            sdService.end();
+        }
+        return;
+    }
+    if (pcap && !wifiService.startPcapStream(file)) {
+        terminalView.println("WiFi嗅探: 无法启动PCAP写入任务。"); // 汉化
+        wifiService.stopPassiveSniffing();
+        sdService.end();
+        return;
+    }
+    if (!wifiService.startChannelHopper(channels, mode)) {
+        const bool has14 = std::find(channels.begin(), channels.end(), 14) != channels.end();
+        terminalView.println(has14 ? "WiFi嗅探: 无法设置允许信道14的国家码(JP)，请去掉信道14。" // 汉化
+                                   : "WiFi嗅探: 无法启动跳频任务。"); // 汉化
+        wifiService.stopPassiveSniffing();
+        if (pcap) sdService.end();
+        return;
+    }
+
+    std::string hopping = mode == WifiChannelManager::Mode::Pinned
+        ? "固定信道 " + std::to_string(channels[0]) // 汉化
+        : std::string(WifiChannelManager::modeName(mode)) + " 跳频, " + std::to_string(channels.size()) + " 个信道"; // 汉化
+    terminalView.println(pcap ? "WiFi嗅探已启动 (" + hopping + ")，保存到 " + path + " ... 按下[ENTER]停止。\n" // 汉化
+                              : "WiFi嗅探已启动 (" + hopping + ")... 按下[ENTER]停止。\n"); // 汉化
 
-    uint8_t channel = 1;
-    unsigned long lastHop = 0;
     unsigned long lastPull = 0;
+    unsigned long lastSummary = millis();
+    uint32_t hidden = 0;
+    std::vector<std::string> lines;
 
     while (true)
     {
@@ -393,30 +470,96 @@ void WifiController::handleSniff(const TerminalCommand &cmd)
         if (key == '\r' || key == '\n')
             break;
 
-        // Read sniff data
-        if (millis() - lastPull > 20)
+        // Frames are drained by the service task, the terminal only shows part of a busy channel
+        if (raw && millis() - lastPull > 20)
         {
-            auto logs = wifiService.getSniffLog();
-            for (const auto &line : logs)
+            lines.clear();
+            size_t drained = wifiService.takeSniffLines(lines, MAX_SNIFF_LINES_PER_PULL);
+            for (const auto &line : lines)
             {
                 terminalView.println(line);
             }
+            hidden += drained - lines.size();
             lastPull = millis();
         }
 
-        // Switch channel every 100ms
-        if (millis() - lastHop > 100)
+        // Table of the transmitters instead of one line per frame
+        if (!raw && millis() - lastSummary > SNIFF_SUMMARY_MS)
         {
-            channel = (channel % 13) + 1; // channel 1 to 13
-            wifiService.switchChannel(channel);
-            lastHop = millis();
+            printStationSummary();
+            lastSummary = millis();
         }
 
         delay(5);
     }
 
+    // Frames still in the ring go to the file
+    wifiService.stopChannelHopper();
+    wifiService.stopSniffDrain();
+    wifiService.stopPcapStream();
+    auto stats = wifiService.getSniffStats();
+    uint32_t elapsedMs = 0;
+    auto channelStats = wifiService.getChannelStats(elapsedMs);
     wifiService.stopPassiveSniffing();
-    terminalView.println("WiFi嗅探已停止。\n"); // 汉化
+    if (pcap) sdService.end();
+
+    if (!raw) printStationSummary();
+    terminalView.println("WiFi嗅探已停止。"); // 汉化
+    terminalView.println("  接收帧: " + std::to_string(stats.received) +
+                         "  缓冲区满丢弃: " + std::to_string(stats.dropped) +
+                         (raw ? "  未显示: " + std::to_string(hidden) : std::string())); // 汉化
+    if (pcap) {
+        terminalView.println("  PCAP: " + std::to_string(stats.pcapFrames) + " 帧, " +
+                             std::to_string(stats.pcapBytes / 1024) + " KB, 丢弃 " +
+                             std::to_string(stats.pcapDropped) + ", 写入错误 " +
+                             std::to_string(stats.writeErrors) + " -> " + path); // 汉化
+    }
+
+    // Per channel capture, to compare the hopping strategies
+    uint32_t total = 0;
+    for (const auto& c : channelStats) total += c.frames;
+    const uint32_t seconds10 = elapsedMs / 100;
+    terminalView.println("  模式: " + std::string(WifiChannelManager::modeName(mode)) +
+                         "  平均: " + (elapsedMs ? std::to_string(total * 1000ULL / elapsedMs) : std::string("0")) + " 帧/秒" +
+                         "  时长: " + std::to_string(seconds10 / 10) + "." + std::to_string(seconds10 % 10) + " 秒"); // 汉化
+    for (const auto& c : channelStats) {
+        if (c.visits == 0 && c.failed == 0) continue;
+        char row[128];
+        snprintf(row, sizeof(row), "  信道 %2u: %7lu 帧  驻留 %5.1f%%  %6.1f 帧/秒", // 汉化
+                 c.channel, (unsigned long)c.frames,
+                 elapsedMs ? c.dwellMs * 100.0f / elapsedMs : 0.0f,
+                 c.dwellMs ? c.frames * 1000.0f / c.dwellMs : 0.0f);
+        std::string line = row;
+        if (c.failed) line += "  切换失败 " + std::to_string(c.failed) + " 次"; // 汉化
+        terminalView.println(line);
+    }
+    terminalView.println("");
+}
+
+/*
+Sniff summary
+*/
+void WifiController::printStationSummary()
+{
+    size_t total = 0;
+    uint32_t evicted = 0;
+    const auto rows = wifiService.getStationView(MAX_SNIFF_SUMMARY_ROWS, total, evicted);
+    const uint32_t now = millis();
+
+    terminalView.println("");
+    terminalView.println("  MAC                类型 信道  RSSI 最小/平均/最大   管理/控制/数据     最近  SSID"); // 汉化
+    for (const auto& s : rows) {
+        char row[128];
+        snprintf(row, sizeof(row), "  %-18s %-4s %3u  %4d/%4d/%4d  %6lu/%5lu/%6lu %4lus  %s",
+                 WifiService::formatMac(s.mac).c_str(), s.ap ? "AP" : "STA", s.channel,
+                 s.rssiMin, s.rssiAvg(), s.rssiMax,
+                 (unsigned long)s.frames[0], (unsigned long)s.frames[1], (unsigned long)s.frames[2],
+                 (unsigned long)((now - s.lastMs) / 1000), s.ssid);
+        terminalView.println(row);
+    }
+    terminalView.println("  共 " + std::to_string(total) + " 个设备" +
+                         (total > rows.size() ? ", 显示前 " + std::to_string(rows.size()) + " 个" : std::string()) +
+                         (evicted ? ", 淘汰 " + std::to_string(evicted) : std::string())); // 汉化
 }
 
 /*
@@ -514,6 +657,11 @@ void WifiController::handleHelp()
     terminalView.println("  scan                - 扫描周边Wi-Fi网络"); // 补充说明
     terminalView.println("  connect             - 连接到Wi-Fi网络"); // 补充说明
     terminalView.println("  sniff               - 嗅探Wi-Fi数据包"); // 补充说明
+    terminalView.println("  sniff raw           - 逐帧显示而非设备汇总表"); // 补充说明
+    terminalView.println("  sniff pcap [path]   - 嗅探并保存为PCAP到SD卡"); // 补充说明
+    terminalView.println("  sniff fixed|adaptive- 固定/按流量自适应跳频"); // 补充说明
+    terminalView.println("  sniff ch <us|eu|jp> - 跳频信道集合 (或 1,6,11)"); // 补充说明
+    terminalView.println("  sniff pin <channel> - 固定在单个信道"); // 补充说明
     terminalView.println("  probe               - 探测开放网络的互联网访问权限"); // 补充说明
     terminalView.println("  spoof sta <mac>     - 伪造STA端MAC地址"); // 补充说明
     terminalView.println("  spoof ap <mac>      - 伪造AP端MAC地址"); // 补充说明
@@ -33,6 +33,9 @@ private:
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
     Preferences preferences;
+    static constexpr size_t MAX_SNIFF_LINES_PER_PULL = 16;
+    static constexpr size_t MAX_SNIFF_SUMMARY_ROWS = 20;
+    static constexpr unsigned long SNIFF_SUMMARY_MS = 2000;
 
     // Handle connection to a Wi-Fi network
     void handleConnect(const TerminalCommand& cmd);
@@ -58,6 +61,9 @@ private:
     // Start packet sniffing
     void handleSniff(const TerminalCommand& cmd);
 
+    // Sorted table of the access points and stations heard
+    void printStationSummary();
+
     // Show WebUI IP
     void handleWebUi(const TerminalCommand& cmd);
 
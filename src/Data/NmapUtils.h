@@ -24,6 +24,8 @@ struct NmapOptions {
     bool hasTrash = false;  // Did user pass non-option tokens?
     bool help = false;      // -h or --help
     bool pingOnly = false;  // -sn
+    bool skipPing = false;  // -Pn
+    int parallelism = 0;    // --max-parallelism, 0 = SCAN_WINDOW
 };
 
 enum class Layer4Protocol
@@ -41,6 +43,12 @@ struct PortService {
 
 static const int CONNECT_TIMEOUT_MS = 600;
 static const int SMALL_DELAY_MS = 5;
+static const int SCAN_WINDOW = 8;        // sockets in flight, lwIP has 16 for the whole firmware
+static const int MAX_SCAN_WINDOW = 12;
+static const int UDP_RETRIES = 1;
+static const int PING_ROUNDS = 2;        // echo requests per host, all hosts swept from one socket
+static const int PING_RATE = 200;        // echo requests per second
+static const int PING_TIMEOUT_MS = 1000;
 
 static constexpr PortService TOP100_TCP_MAP[] = {
     {7,    Layer4Protocol::TCP, "echo"},
@@ -38,6 +38,9 @@ public:
     // Analogic plotter
     virtual void drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>& buffer, uint8_t step) = 0;
 
+    // Waterfall, one row of 0..255 intensities per call, line wraps on the screen height
+    virtual void drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) = 0;
+
     // Set screen rotation
     virtual void setRotation(uint8_t rotation) = 0;
 
@@ -0,0 +1,199 @@
+#include "BluetoothDeviceManager.h"
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+void BluetoothDeviceManager::begin(size_t maxDevices, Decoder decoder) {
+    maxDevices_ = maxDevices;
+    decoder_ = std::move(decoder);
+    clear();
+    devices_.reserve(maxDevices);
+}
+
+void BluetoothDeviceManager::clear() {
+    devices_.clear();
+    cache_.clear();
+    cacheOrder_.clear();
+    fresh_.clear();
+    adverts_ = evicted_ = aged_ = 0;
+    cacheHits_ = cacheMisses_ = 0;
+}
+
+uint64_t BluetoothDeviceManager::key(const uint8_t addr[6]) {
+    uint64_t k = 0;
+    for (int i = 0; i < 6; ++i) k = (k << 8) | addr[i];
+    return k;
+}
+
+uint32_t BluetoothDeviceManager::hash(const uint8_t* payload, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) h = (h ^ payload[i]) * 16777619u;
+    return h;
+}
+
+std::string BluetoothDeviceManager::formatAddress(const uint8_t addr[6]) {
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x",
+             addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+    return buf;
+}
+
+bool BluetoothDeviceManager::update(const uint8_t addr[6], int8_t rssi, const uint8_t* payload, size_t len, uint32_t nowMs) {
+    if (maxDevices_ == 0) return false;
+    if (!payload) len = 0;
+    if (len > MAX_PAYLOAD) len = MAX_PAYLOAD;
+    adverts_++;
+
+    const uint64_t k = key(addr);
+    auto it = devices_.find(k);
+    bool isNew = it == devices_.end();
+
+    if (isNew) {
+        // Full, the device heard the longest ago makes room
+        if (devices_.size() >= maxDevices_) {
+            auto oldest = devices_.begin();
+            for (auto d = devices_.begin(); d != devices_.end(); ++d) {
+                if (nowMs - d->second.lastMs > nowMs - oldest->second.lastMs) oldest = d;
+            }
+            devices_.erase(oldest);
+            evicted_++;
+        }
+
+        Device d;
+        memcpy(d.addr, addr, 6);
+        d.firstMs = nowMs;
+        d.rssiMin = d.rssiMax = rssi;
+        it = devices_.emplace(k, d).first;
+        // Not taken yet and full, the evicted ones are dropped first
+        if (fresh_.size() >= maxDevices_) {
+            fresh_.erase(std::remove_if(fresh_.begin(), fresh_.end(),
+                                        [this](uint64_t f) { return devices_.count(f) == 0; }),
+                         fresh_.end());
+        }
+        if (fresh_.size() < maxDevices_) fresh_.push_back(k);
+    }
+
+    Device& d = it->second;
+    if (!isNew) {
+        const uint32_t delta = nowMs - d.lastMs;
+        if (delta > 0 && delta <= MAX_INTERVAL_MS) {
+            d.intervalMs = d.intervalMs == 0 ? delta : (d.intervalMs * 3 + delta) / 4;
+            if (d.minIntervalMs == 0 || delta < d.minIntervalMs) d.minIntervalMs = delta;
+        }
+    }
+    d.lastMs = nowMs;
+    d.adverts++;
+    d.rssi = rssi;
+    d.rssiSum += rssi;
+    if (rssi < d.rssiMin) d.rssiMin = rssi;
+    if (rssi > d.rssiMax) d.rssiMax = rssi;
+
+    // Same payload as last time, nothing to parse
+    const uint32_t h = hash(payload, len);
+    if (!isNew && h == d.payloadHash && len == d.payloadLen) return false;
+
+    if (!isNew) d.payloadChanges++;
+    d.payloadHash = h;
+    d.payloadLen = static_cast<uint8_t>(len);
+    if (len) memcpy(d.payload, payload, len);
+    parsePayload(d);
+    return true;
+}
+
+void BluetoothDeviceManager::parsePayload(Device& d) {
+    // A scan response has no flags and often no name, what is known is kept
+    for (size_t i = 0; i + 1 < d.payloadLen;) {
+        const uint8_t fieldLen = d.payload[i];
+        if (fieldLen == 0 || i + fieldLen + 1 > d.payloadLen) break;
+
+        const uint8_t type = d.payload[i + 1];
+        const uint8_t* data = d.payload + i + 2;
+        const size_t dataLen = fieldLen - 1;
+
+        if (type == 0x01 && dataLen >= 1) {
+            d.connectable = (data[0] & 0x02) != 0;     // general discoverable
+        } else if ((type == 0x09 || (type == 0x08 && d.name[0] == '\0')) && dataLen > 0) {
+            // Complete name wins over the shortened one
+            const size_t n = std::min(dataLen, NAME_MAX);
+            memcpy(d.name, data, n);
+            d.name[n] = '\0';
+        }
+        i += fieldLen + 1;
+    }
+}
+
+size_t BluetoothDeviceManager::age(uint32_t nowMs, uint32_t staleMs) {
+    size_t removed = 0;
+    for (auto it = devices_.begin(); it != devices_.end();) {
+        if (nowMs - it->second.lastMs > staleMs) {
+            it = devices_.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    aged_ += removed;
+    return removed;
+}
+
+const BluetoothDeviceManager::Device* BluetoothDeviceManager::find(const uint8_t addr[6]) const {
+    auto it = devices_.find(key(addr));
+    return it == devices_.end() ? nullptr : &it->second;
+}
+
+const std::string& BluetoothDeviceManager::decoded(const Device& d) {
+    auto it = cache_.find(d.payloadHash);
+    if (it != cache_.end()) {
+        cacheHits_++;
+        return it->second;
+    }
+    cacheMisses_++;
+
+    // Bounded, the oldest decoded payload goes first
+    if (cache_.size() >= CACHE_ENTRIES && !cacheOrder_.empty()) {
+        cache_.erase(cacheOrder_.front());
+        cacheOrder_.erase(cacheOrder_.begin());
+    }
+    cacheOrder_.push_back(d.payloadHash);
+    return cache_[d.payloadHash] = decoder_ ? decoder_(d.payload, d.payloadLen) : std::string();
+}
+
+std::vector<BluetoothDeviceManager::View> BluetoothDeviceManager::view(size_t max) {
+    std::vector<const Device*> order;
+    order.reserve(devices_.size());
+    for (const auto& entry : devices_) order.push_back(&entry.second);
+
+    auto stronger = [](const Device* a, const Device* b) {
+        if (a->rssiAvg() != b->rssiAvg()) return a->rssiAvg() > b->rssiAvg();
+        return key(a->addr) < key(b->addr);
+    };
+    const size_t n = std::min(max, order.size());
+    std::partial_sort(order.begin(), order.begin() + n, order.end(), stronger);
+
+    std::vector<View> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        View v;
+        v.device = *order[i];
+        v.ad = decoded(*order[i]);
+        out.push_back(std::move(v));
+    }
+    return out;
+}
+
+std::vector<BluetoothDeviceManager::View> BluetoothDeviceManager::takeNew() {
+    std::vector<View> out;
+    out.reserve(fresh_.size());
+    for (uint64_t k : fresh_) {
+        // Evicted or aged out meanwhile
+        auto it = devices_.find(k);
+        if (it == devices_.end()) continue;
+
+        View v;
+        v.device = it->second;
+        v.ad = decoded(it->second);
+        out.push_back(std::move(v));
+    }
+    fresh_.clear();
+    return out;
+}
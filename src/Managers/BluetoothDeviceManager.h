@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+/*
+Table of the BLE advertisers heard by the sniffer, keyed by address.
+
+An advertisement only updates counters: RSSI min/avg/max, smoothed and
+minimum advertising interval, last payload. The payload is parsed again
+(name, connectable flag) only when its hash changes, and the readable AD
+dump is made by the decoder when a device is displayed, then cached by
+payload hash so devices sending the same payload share it. Devices not
+heard for staleMs are aged out, the least recently heard one makes room
+when the table is full. No Arduino dependency.
+*/
+class BluetoothDeviceManager {
+public:
+    static constexpr size_t   MAX_PAYLOAD      = 62;      // advertising data + scan response
+    static constexpr size_t   NAME_MAX         = 29;
+    static constexpr uint32_t STALE_MS         = 60000;
+    static constexpr uint32_t MAX_INTERVAL_MS  = 10240;   // longest legal advertising interval
+    static constexpr size_t   CACHE_ENTRIES    = 64;
+
+    struct Device {
+        uint8_t  addr[6]       = {};
+        uint8_t  payload[MAX_PAYLOAD] = {};
+        uint8_t  payloadLen    = 0;
+        uint32_t payloadHash   = 0;
+        bool     connectable   = false;
+        char     name[NAME_MAX + 1] = {};
+        int8_t   rssi          = 0;       // last
+        int8_t   rssiMin       = 0;
+        int8_t   rssiMax       = 0;
+        int32_t  rssiSum       = 0;
+        uint32_t adverts       = 0;
+        uint32_t payloadChanges = 0;
+        uint32_t firstMs       = 0;
+        uint32_t lastMs        = 0;
+        uint32_t intervalMs    = 0;       // smoothed, 0 until two adverts are heard
+        uint32_t minIntervalMs = 0;
+
+        int rssiAvg() const { return adverts ? static_cast<int>(rssiSum / static_cast<int32_t>(adverts)) : 0; }
+    };
+
+    struct View {
+        Device      device;
+        std::string ad;                   // decoded AD structures
+    };
+
+    using Decoder = std::function<std::string(const uint8_t* payload, size_t len)>;
+
+    void begin(size_t maxDevices, Decoder decoder);
+    void clear();
+
+    // One advertisement, true for a new device or a new payload
+    bool update(const uint8_t addr[6], int8_t rssi, const uint8_t* payload, size_t len, uint32_t nowMs);
+
+    // Remove the devices not heard for staleMs, returns how many
+    size_t age(uint32_t nowMs, uint32_t staleMs = STALE_MS);
+
+    // Strongest first, AD decoded through the cache
+    std::vector<View> view(size_t max);
+
+    // Devices heard for the first time since the last call, in discovery order
+    std::vector<View> takeNew();
+
+    const Device* find(const uint8_t addr[6]) const;
+    size_t   size()        const { return devices_.size(); }
+    uint32_t adverts()     const { return adverts_; }
+    uint32_t evicted()     const { return evicted_; }
+    uint32_t aged()        const { return aged_; }
+    uint32_t cacheHits()   const { return cacheHits_; }
+    uint32_t cacheMisses() const { return cacheMisses_; }
+
+    static uint32_t hash(const uint8_t* payload, size_t len);
+    static std::string formatAddress(const uint8_t addr[6]);
+
+private:
+    std::unordered_map<uint64_t, Device>      devices_;
+    std::unordered_map<uint32_t, std::string> cache_;
+    std::vector<uint32_t>                     cacheOrder_;    // insertion order, oldest first
+    std::vector<uint64_t>                     fresh_;         // keys not reported by takeNew() yet
+    Decoder  decoder_;
+    size_t   maxDevices_  = 0;
+    uint32_t adverts_     = 0;
+    uint32_t evicted_     = 0;
+    uint32_t aged_        = 0;
+    uint32_t cacheHits_   = 0;
+    uint32_t cacheMisses_ = 0;
+
+    const std::string& decoded(const Device& d);
+    static uint64_t key(const uint8_t addr[6]);
+    static void parsePayload(Device& d);
+};
@@ -0,0 +1,555 @@
+#include "HttpStreamManager.h"
+#include <algorithm>
+
+namespace {
+int hexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+}
+
+void HttpStreamManager::begin(Mode mode, bool chunked, int64_t contentLength,
+                              LineSink lines, DataSink data, const std::string& filter) {
+    mode_ = mode;
+    chunked_ = chunked;
+    length_ = chunked ? -1 : contentLength;
+    lineSink_ = std::move(lines);
+    dataSink_ = std::move(data);
+    if (!parseFilter(filter, filter_)) filter_.clear();
+
+    chunk_ = Chunk::Size;
+    chunkLeft_ = 0;
+    sizeSeen_ = false;
+    trailerLen_ = 0;
+    bodyBytes_ = 0;
+
+    json_ = Json::Value;
+    inKey_ = false;
+    stack_.clear();
+    stack_.reserve(8);
+    path_.clear();
+    token_.clear();
+    token_.reserve(MAX_TOKEN);
+    tokenCut_ = false;
+    unicode_ = highSurrogate_ = 0;
+    unicodeDigits_ = 0;
+
+    line_.clear();
+
+    error_.clear();
+    stopped_ = false;
+    values_ = lines_ = truncated_ = 0;
+    offset_ = 0;
+}
+
+bool HttpStreamManager::complete() const {
+    if (chunked_) return chunk_ == Chunk::Done;
+    return length_ >= 0 && bodyBytes_ >= static_cast<uint64_t>(length_);
+}
+
+bool HttpStreamManager::feed(const uint8_t* data, size_t len) {
+    if (failed() || stopped_ || complete()) return false;
+
+    if (!chunked_) {
+        size_t n = len;
+        if (length_ >= 0) n = static_cast<size_t>(std::min<uint64_t>(len, static_cast<uint64_t>(length_) - bodyBytes_));
+        if (!body(data, n)) return false;
+        return !complete();
+    }
+
+    // Chunked transfer, "<hex size>[;ext]\r\n<data>\r\n" ... "0\r\n<trailers>\r\n"
+    size_t i = 0;
+    while (i < len && chunk_ != Chunk::Done) {
+        const uint8_t c = data[i];
+        switch (chunk_) {
+            case Chunk::Size: {
+                const int v = hexValue(c);
+                if (v >= 0) {
+                    if (chunkLeft_ >> 56) return fail("分块长度过大"); // 汉化
+                    chunkLeft_ = chunkLeft_ * 16 + static_cast<uint64_t>(v);
+                    sizeSeen_ = true;
+                } else if (sizeSeen_ && (c == ';' || c == ' ' || c == '\t')) {
+                    chunk_ = Chunk::Ext;
+                } else if (sizeSeen_ && c == '\r') {
+                    chunk_ = Chunk::SizeLf;
+                } else if (sizeSeen_ && c == '\n') {
+                    chunk_ = chunkLeft_ ? Chunk::Data : Chunk::Trailer;
+                    sizeSeen_ = false;
+                    trailerLen_ = 0;
+                } else {
+                    return fail("分块格式错误"); // 汉化
+                }
+                i++;
+                break;
+            }
+            case Chunk::Ext:
+                if (c == '\r') chunk_ = Chunk::SizeLf;
+                else if (c == '\n') { chunk_ = chunkLeft_ ? Chunk::Data : Chunk::Trailer; sizeSeen_ = false; }
+                i++;
+                break;
+            case Chunk::SizeLf:
+                if (c != '\n') return fail("分块格式错误"); // 汉化
+                chunk_ = chunkLeft_ ? Chunk::Data : Chunk::Trailer;
+                sizeSeen_ = false;
+                trailerLen_ = 0;
+                i++;
+                break;
+            case Chunk::Data: {
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(chunkLeft_, len - i));
+                if (!body(data + i, n)) return false;
+                chunkLeft_ -= n;
+                i += n;
+                if (chunkLeft_ == 0) chunk_ = Chunk::DataCr;
+                break;
+            }
+            case Chunk::DataCr:
+                if (c == '\r') chunk_ = Chunk::DataLf;
+                else if (c == '\n') chunk_ = Chunk::Size;
+                else return fail("分块格式错误"); // 汉化
+                i++;
+                break;
+            case Chunk::DataLf:
+                if (c != '\n') return fail("分块格式错误"); // 汉化
+                chunk_ = Chunk::Size;
+                i++;
+                break;
+            case Chunk::Trailer:
+                // Trailer fields are skipped, an empty line ends the message
+                if (c == '\n') {
+                    if (trailerLen_ == 0) chunk_ = Chunk::Done;
+                    trailerLen_ = 0;
+                } else if (c != '\r') {
+                    trailerLen_++;
+                }
+                i++;
+                break;
+            case Chunk::Done:
+                break;
+        }
+    }
+    return !complete();
+}
+
+void HttpStreamManager::finish() {
+    if (failed() || stopped_) return;
+
+    if (mode_ == Mode::Text && !line_.empty()) {
+        emitLine(line_);
+        line_.clear();
+    }
+    if (mode_ == Mode::Json) {
+        // A number at the very end of the body has no delimiter after it
+        if (json_ == Json::Literal && stack_.empty()) {
+            if (!validLiteral(token_)) { fail("JSON值无效，偏移 " + std::to_string(offset_)); return; } // 汉化
+            if (!emitToken(false) || !endValue()) return;
+        }
+        if (json_ != Json::Value || !stack_.empty()) {
+            fail("JSON内容不完整，已读取 " + std::to_string(bodyBytes_) + " 字节"); // 汉化
+            return;
+        }
+    }
+    if (!complete() && (chunked_ || length_ >= 0)) {
+        fail("连接提前关闭，已读取 " + std::to_string(bodyBytes_) + " 字节"); // 汉化
+    }
+}
+
+bool HttpStreamManager::body(const uint8_t* data, size_t len) {
+    const uint64_t start = bodyBytes_;
+    bodyBytes_ += len;
+
+    switch (mode_) {
+        case Mode::Raw:
+            if (len && dataSink_ && !dataSink_(data, len)) {
+                stopped_ = true;
+                return false;
+            }
+            return true;
+        case Mode::Json:
+            for (size_t i = 0; i < len; ++i) {
+                offset_ = start + i;
+                if (!jsonByte(static_cast<char>(data[i]))) return false;
+            }
+            return true;
+        case Mode::Text:
+            for (size_t i = 0; i < len; ++i) {
+                if (!textByte(static_cast<char>(data[i]))) return false;
+            }
+            return true;
+    }
+    return true;
+}
+
+bool HttpStreamManager::fail(const std::string& what) {
+    if (error_.empty()) error_ = what;
+    return false;
+}
+
+bool HttpStreamManager::textByte(char c) {
+    if (c == '\n') {
+        if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+        const bool ok = emitLine(line_);
+        line_.clear();
+        return ok;
+    }
+    if (line_.size() >= MAX_LINE) {
+        if (!emitLine(line_)) return false;
+        line_.clear();
+    }
+    line_.push_back(c);
+    return true;
+}
+
+bool HttpStreamManager::emitLine(const std::string& line) {
+    lines_++;
+    if (!lineSink_ || !lineSink_(line)) {
+        stopped_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool HttpStreamManager::jsonByte(char c) {
+    switch (json_) {
+        case Json::String:
+            if (c == '"') {
+                if (highSurrogate_) appendCodepoint(0xFFFD);
+                highSurrogate_ = 0;
+                if (!inKey_) return emitToken(true) && endValue();
+
+                // Member name, becomes the last path element
+                Frame& f = stack_.back();
+                f.key = token_;
+                path_.resize(f.base);
+                if (!path_.empty()) path_ += '.';
+                path_.append(token_, 0, MAX_PATH > path_.size() ? MAX_PATH - path_.size() : 0);
+                if (tokenCut_) truncated_++;
+                json_ = Json::Colon;
+                return true;
+            }
+            if (c == '\\') { json_ = Json::Escape; return true; }
+            if (static_cast<uint8_t>(c) < 0x20) return fail("JSON字符串含控制字符，偏移 " + std::to_string(offset_)); // 汉化
+            appendToken(c);
+            return true;
+
+        case Json::Escape:
+            switch (c) {
+                case '"': case '\\': case '/': appendToken(c); break;
+                case 'b': appendToken('\b'); break;
+                case 'f': appendToken('\f'); break;
+                case 'n': appendToken('\n'); break;
+                case 'r': appendToken('\r'); break;
+                case 't': appendToken('\t'); break;
+                case 'u':
+                    unicode_ = 0;
+                    unicodeDigits_ = 0;
+                    json_ = Json::Unicode;
+                    return true;
+                default:
+                    return fail("JSON转义无效，偏移 " + std::to_string(offset_)); // 汉化
+            }
+            json_ = Json::String;
+            return true;
+
+        case Json::Unicode: {
+            const int v = hexValue(static_cast<uint8_t>(c));
+            if (v < 0) return fail("JSON转义无效，偏移 " + std::to_string(offset_)); // 汉化
+            unicode_ = unicode_ * 16 + static_cast<uint32_t>(v);
+            if (++unicodeDigits_ < 4) return true;
+
+            if (unicode_ >= 0xD800 && unicode_ <= 0xDBFF) {
+                if (highSurrogate_) appendCodepoint(0xFFFD);
+                highSurrogate_ = unicode_;
+            } else if (unicode_ >= 0xDC00 && unicode_ <= 0xDFFF) {
+                appendCodepoint(highSurrogate_ ? 0x10000 + ((highSurrogate_ - 0xD800) << 10) + (unicode_ - 0xDC00) : 0xFFFD);
+                highSurrogate_ = 0;
+            } else {
+                // A high surrogate not followed by its low half, as in appendToken()
+                if (highSurrogate_) appendCodepoint(0xFFFD);
+                highSurrogate_ = 0;
+                appendCodepoint(unicode_);
+            }
+            json_ = Json::String;
+            return true;
+        }
+
+        case Json::Literal:
+            if (isDigit(c) || (c >= 'a' && c <= 'z') || c == '.' || c == '+' || c == '-' || c == 'E') {
+                appendToken(c);
+                return true;
+            }
+            if (!validLiteral(token_)) return fail("JSON值无效，偏移 " + std::to_string(offset_)); // 汉化
+            if (!emitToken(false) || !endValue()) return false;
+            return jsonByte(c);
+
+        case Json::Value:
+            if (isSpace(c)) return true;
+            return beginValue(c);
+
+        case Json::ObjectStart:
+        case Json::Key:
+            if (isSpace(c)) return true;
+            if (c == '"') {
+                token_.clear();
+                tokenCut_ = false;
+                inKey_ = true;
+                json_ = Json::String;
+                return true;
+            }
+            if (c == '}' && json_ == Json::ObjectStart) {
+                const size_t base = stack_.back().base;
+                stack_.pop_back();
+                path_.resize(base);
+                return emit("{}") && endValue();
+            }
+            return fail("JSON应为键名，偏移 " + std::to_string(offset_)); // 汉化
+
+        case Json::Colon:
+            if (isSpace(c)) return true;
+            if (c != ':') return fail("JSON应为':'，偏移 " + std::to_string(offset_)); // 汉化
+            json_ = Json::Value;
+            return true;
+
+        case Json::ArrayStart:
+            if (isSpace(c)) return true;
+            if (c == ']') {
+                const size_t base = stack_.back().base;
+                stack_.pop_back();
+                path_.resize(base);
+                return emit("[]") && endValue();
+            }
+            startElement();
+            return beginValue(c);
+
+        case Json::After: {
+            if (isSpace(c)) return true;
+            Frame& f = stack_.back();
+            if (c == ',') {
+                if (f.array) {
+                    f.index++;
+                    startElement();
+                    json_ = Json::Value;
+                } else {
+                    json_ = Json::Key;
+                }
+                return true;
+            }
+            if (c == (f.array ? ']' : '}')) {
+                path_.resize(f.base);
+                stack_.pop_back();
+                return endValue();
+            }
+            return fail("JSON应为','或结束符，偏移 " + std::to_string(offset_)); // 汉化
+        }
+    }
+    return true;
+}
+
+bool HttpStreamManager::beginValue(char c) {
+    if (c == '{' || c == '[') {
+        if (stack_.size() >= MAX_DEPTH) return fail("JSON嵌套过深，偏移 " + std::to_string(offset_)); // 汉化
+        stack_.emplace_back();
+        Frame& f = stack_.back();
+        f.array = (c == '[');
+        f.base = path_.size();
+        json_ = f.array ? Json::ArrayStart : Json::ObjectStart;
+        return true;
+    }
+    if (c == '"') {
+        token_.clear();
+        tokenCut_ = false;
+        inKey_ = false;
+        json_ = Json::String;
+        return true;
+    }
+    if (c == '-' || isDigit(c) || c == 't' || c == 'f' || c == 'n') {
+        token_.assign(1, c);
+        tokenCut_ = false;
+        json_ = Json::Literal;
+        return true;
+    }
+    return fail("JSON意外字符，偏移 " + std::to_string(offset_)); // 汉化
+}
+
+bool HttpStreamManager::endValue() {
+    if (stack_.empty()) {
+        // Top level value done, another document may follow
+        json_ = Json::Value;
+        path_.clear();
+    } else {
+        json_ = Json::After;
+    }
+    return true;
+}
+
+void HttpStreamManager::startElement() {
+    Frame& f = stack_.back();
+    path_.resize(f.base);
+    if (path_.size() < MAX_PATH) {
+        path_ += '[';
+        path_ += std::to_string(f.index);
+        path_ += ']';
+    }
+}
+
+bool HttpStreamManager::matches() const {
+    if (filter_.empty()) return true;
+    if (stack_.size() < filter_.size()) return false;
+
+    for (size_t i = 0; i < filter_.size(); ++i) {
+        const std::string& seg = filter_[i];
+        if (seg == "*") continue;
+        const Frame& f = stack_[i];
+        if (f.array ? seg != std::to_string(f.index) : seg != f.key) return false;
+    }
+    return true;
+}
+
+bool HttpStreamManager::emit(const std::string& value) {
+    values_++;
+    if (!matches()) return true;
+
+    std::string line;
+    line.reserve(path_.size() + value.size() + 4);
+    line = path_.empty() ? "$" : path_;
+    line += " = ";
+    line += value;
+    return emitLine(line);
+}
+
+bool HttpStreamManager::emitToken(bool quoted) {
+    if (tokenCut_) {
+        truncated_++;
+        // Do not leave half of a UTF-8 sequence at the cut
+        size_t i = token_.size();
+        while (i > 0 && (static_cast<uint8_t>(token_[i - 1]) & 0xC0) == 0x80) --i;
+        if (i > 0 && (static_cast<uint8_t>(token_[i - 1]) & 0x80)) {
+            const uint8_t lead = static_cast<uint8_t>(token_[i - 1]);
+            const size_t need = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : 2;
+            if (token_.size() - (i - 1) < need) token_.resize(i - 1);
+        }
+    }
+    if (!quoted) return emit(token_);
+
+    std::string v;
+    quote(token_, v);
+    if (tokenCut_) v.insert(v.size() - 1, "...");
+    return emit(v);
+}
+
+void HttpStreamManager::appendToken(char c) {
+    if (highSurrogate_) {
+        highSurrogate_ = 0;
+        appendCodepoint(0xFFFD);
+    }
+    if (token_.size() < MAX_TOKEN) token_.push_back(c);
+    else tokenCut_ = true;
+}
+
+void HttpStreamManager::appendCodepoint(uint32_t cp) {
+    char buf[4];
+    size_t n;
+    if (cp < 0x80) { buf[0] = static_cast<char>(cp); n = 1; }
+    else if (cp < 0x800) {
+        buf[0] = static_cast<char>(0xC0 | (cp >> 6));
+        buf[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        buf[0] = static_cast<char>(0xE0 | (cp >> 12));
+        buf[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = static_cast<char>(0xF0 | (cp >> 18));
+        buf[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    if (token_.size() + n <= MAX_TOKEN) token_.append(buf, n);
+    else tokenCut_ = true;
+}
+
+bool HttpStreamManager::validLiteral(const std::string& s) {
+    if (s == "true" || s == "false" || s == "null") return true;
+
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t i = 0;
+    if (i < s.size() && s[i] == '-') i++;
+    if (i >= s.size() || !isDigit(s[i])) return false;
+    if (s[i] == '0') i++;
+    else while (i < s.size() && isDigit(s[i])) i++;
+    if (i < s.size() && s[i] == '.') {
+        if (++i >= s.size() || !isDigit(s[i])) return false;
+        while (i < s.size() && isDigit(s[i])) i++;
+    }
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        if (++i < s.size() && (s[i] == '+' || s[i] == '-')) i++;
+        if (i >= s.size() || !isDigit(s[i])) return false;
+        while (i < s.size() && isDigit(s[i])) i++;
+    }
+    return i == s.size();
+}
+
+void HttpStreamManager::quote(const std::string& in, std::string& out) {
+    // One line per value, control characters stay escaped
+    out.clear();
+    out.reserve(in.size() + 2);
+    out += '"';
+    for (char c : in) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<uint8_t>(c) < 0x20) {
+                    static const char hex[] = "0123456789abcdef";
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0x0F];
+                    out += hex[c & 0x0F];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+bool HttpStreamManager::parseFilter(const std::string& filter, std::vector<std::string>& out) {
+    out.clear();
+    size_t i = 0;
+    if (!filter.empty() && filter[0] == '$') i = (filter.size() > 1 && filter[1] == '.') ? 2 : 1;
+
+    std::string seg;
+    bool closed = false;    // just after "]"
+    for (; i < filter.size(); ++i) {
+        const char c = filter[i];
+        if (c == '.') {
+            if (seg.empty() && !closed) return false;
+            if (!seg.empty()) out.push_back(seg);
+            seg.clear();
+            closed = false;
+        } else if (c == '[') {
+            if (!seg.empty()) out.push_back(seg);
+            seg.clear();
+            const size_t end = filter.find(']', i);
+            if (end == std::string::npos || end == i + 1) return false;
+            const std::string index = filter.substr(i + 1, end - i - 1);
+            if (index != "*" && !std::all_of(index.begin(), index.end(), isDigit)) return false;
+            out.push_back(index);
+            i = end;
+            closed = true;
+        } else {
+            if (closed) return false;
+            seg += c;
+        }
+    }
+    if (!seg.empty()) out.push_back(seg);
+    else if (!out.empty() && !closed) return false;     // trailing '.'
+    return out.size() <= MAX_DEPTH;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/*
+Incremental HTTP body handling, fed with socket reads as they come.
+
+The transfer framing is undone on the fly (Content-Length, chunked, or
+until the connection closes), then the body goes one of three ways:
+JSON is parsed byte by byte and every scalar comes out as one line
+"path = value" (results[0].page.url = "..."), optionally only the paths
+under a filter; text is cut into lines; raw bytes go to a sink, for a
+download to a file. Tokens, path depth and lines have fixed limits,
+memory does not grow with the response size. Several JSON documents in
+a row (NDJSON) are accepted. No Arduino dependency.
+*/
+class HttpStreamManager {
+public:
+    enum class Mode : uint8_t { Json, Text, Raw };
+
+    // Return false to stop, the body is then left unread
+    using LineSink = std::function<bool(const std::string& line)>;
+    using DataSink = std::function<bool(const uint8_t* data, size_t len)>;
+
+    static constexpr size_t MAX_DEPTH = 32;
+    static constexpr size_t MAX_TOKEN = 160;    // longer keys and strings are cut
+    static constexpr size_t MAX_PATH  = 192;
+    static constexpr size_t MAX_LINE  = 256;    // text lines are wrapped
+
+    // contentLength < 0 when unknown, the body then ends with the last chunk or the connection
+    void begin(Mode mode, bool chunked, int64_t contentLength,
+               LineSink lines, DataSink data = nullptr, const std::string& filter = "");
+
+    // Bytes read from the socket, false once the body is complete, a sink stopped or on error
+    bool feed(const uint8_t* data, size_t len);
+
+    // Connection closed or read loop left, emits what is still pending
+    void finish();
+
+    bool complete() const;
+    bool failed()   const { return !error_.empty(); }
+    bool stopped()  const { return stopped_; }
+    const std::string& error() const { return error_; }
+
+    uint64_t bodyBytes() const { return bodyBytes_; }
+    uint32_t values()    const { return values_; }     // JSON scalars seen
+    uint32_t lines()     const { return lines_; }       // lines emitted
+    uint32_t truncated() const { return truncated_; }   // tokens that were cut
+
+    // "a.b[2].c", "items[*].id" or "items.*.id", paths under it are emitted
+    static bool parseFilter(const std::string& filter, std::vector<std::string>& out);
+
+private:
+    enum class Chunk : uint8_t { Size, Ext, SizeLf, Data, DataCr, DataLf, Trailer, Done };
+    enum class Json  : uint8_t { Value, ObjectStart, Key, Colon, ArrayStart, After, String, Escape, Unicode, Literal };
+
+    struct Frame {
+        bool        array = false;
+        uint32_t    index = 0;
+        size_t      base  = 0;      // path_ length of the container itself
+        std::string key;            // current member, objects only
+    };
+
+    Mode     mode_    = Mode::Raw;
+    bool     chunked_ = false;
+    int64_t  length_  = -1;
+    LineSink lineSink_;
+    DataSink dataSink_;
+    std::vector<std::string> filter_;
+
+    // Framing
+    Chunk    chunk_     = Chunk::Size;
+    uint64_t chunkLeft_ = 0;
+    bool     sizeSeen_  = false;
+    size_t   trailerLen_ = 0;
+    uint64_t bodyBytes_ = 0;
+
+    // JSON
+    Json               json_ = Json::Value;
+    bool               inKey_ = false;
+    std::vector<Frame> stack_;
+    std::string        path_;
+    std::string        token_;
+    bool               tokenCut_ = false;
+    uint32_t           unicode_ = 0;
+    uint8_t            unicodeDigits_ = 0;
+    uint32_t           highSurrogate_ = 0;
+
+    // Text
+    std::string line_;
+
+    std::string error_;
+    bool        stopped_   = false;
+    uint32_t    values_    = 0;
+    uint32_t    lines_     = 0;
+    uint32_t    truncated_ = 0;
+    uint64_t    offset_    = 0;     // body offset, for errors
+
+    bool body(const uint8_t* data, size_t len);
+    bool jsonByte(char c);
+    bool textByte(char c);
+    bool fail(const std::string& what);
+
+    bool beginValue(char c);
+    bool endValue();
+    void startElement();
+    bool emit(const std::string& value);
+    bool emitToken(bool quoted);
+    bool matches() const;
+    void appendToken(char c);
+    void appendCodepoint(uint32_t cp);
+    bool emitLine(const std::string& line);
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+    static bool validLiteral(const std::string& s);
+    static void quote(const std::string& in, std::string& out);
+};
@@ -0,0 +1,189 @@
+#include "ICMPSweepManager.h"
+#include <algorithm>
+
+namespace {
+constexpr uint8_t ICMP_ECHO_REPLY   = 0;
+constexpr uint8_t ICMP_ECHO_REQUEST = 8;
+}
+
+void ICMPSweepManager::Histogram::add(uint32_t us) {
+    uint16_t& b = buckets_[bucket(us)];
+    if (b != UINT16_MAX) b++;
+    count_++;
+}
+
+size_t ICMPSweepManager::Histogram::bucket(uint32_t us) {
+    if (us < 64) return 0;
+    int e = 31 - __builtin_clz(us);
+    const size_t sub = (us >> (e - 2)) & 0x03;
+    const size_t index = static_cast<size_t>(e - 6) * 4 + sub;
+    return std::min(index, HIST_BUCKETS - 1);
+}
+
+uint32_t ICMPSweepManager::Histogram::lower(size_t bucket) {
+    const uint32_t e = static_cast<uint32_t>(bucket / 4) + 6;
+    return static_cast<uint32_t>(4 + bucket % 4) << (e - 2);
+}
+
+uint32_t ICMPSweepManager::Histogram::percentile(float p) const {
+    if (count_ == 0) return 0;
+    const uint32_t rank = std::max<uint32_t>(1, static_cast<uint32_t>(p / 100.f * count_ + 0.5f));
+
+    uint32_t seen = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) return (lower(i) + lower(i + 1)) / 2;
+    }
+    return lower(HIST_BUCKETS);
+}
+
+uint16_t ICMPSweepManager::checksum(const uint8_t* data, size_t len) {
+    // RFC 1071, byte order independent
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) sum += (data[i] << 8) | data[i + 1];
+    if (len & 1) sum += data[len - 1] << 8;
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return static_cast<uint16_t>(~sum);
+}
+
+size_t ICMPSweepManager::buildEcho(uint8_t* buf, size_t cap, uint16_t identifier, uint16_t sequence, size_t payloadLen) {
+    const size_t len = ECHO_HEADER + payloadLen;
+    if (!buf || cap < len) return 0;
+
+    buf[0] = ICMP_ECHO_REQUEST;
+    buf[1] = 0;
+    buf[2] = buf[3] = 0;
+    buf[4] = identifier >> 8;
+    buf[5] = identifier & 0xFF;
+    buf[6] = sequence >> 8;
+    buf[7] = sequence & 0xFF;
+    for (size_t i = 0; i < payloadLen; ++i) buf[ECHO_HEADER + i] = static_cast<uint8_t>('a' + i % 23);
+
+    const uint16_t sum = checksum(buf, len);
+    buf[2] = sum >> 8;
+    buf[3] = sum & 0xFF;
+    return len;
+}
+
+bool ICMPSweepManager::begin(const Config& config, const std::vector<uint32_t>& targets, uint64_t nowUs) {
+    const uint32_t total = static_cast<uint32_t>(targets.size()) * config.rounds;
+    hosts_.clear();
+    histograms_.clear();
+    sentAt_.clear();
+    answered_.clear();
+    overall_ = Histogram();
+    next_ = answeredCount_ = stray_ = 0;
+    responders_ = 0;
+    total_ = 0;
+    if (targets.empty() || config.rounds == 0 || total > 0x10000) return false;
+
+    config_ = config;
+    config_.rate = std::max<uint32_t>(config.rate, 1);
+    total_ = total;
+    hosts_.resize(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) hosts_[i].addr = targets[i];
+    sentAt_.assign(total_, 0);
+    answered_.assign(total_, false);
+
+    intervalUs_ = 1000000 / config_.rate;
+    startUs_ = nextSendUs_ = lastSendUs_ = nowUs;
+    return true;
+}
+
+bool ICMPSweepManager::nextRequest(uint64_t nowUs, uint8_t* buf, size_t cap, size_t& len, uint32_t& addr) {
+    if (next_ >= total_ || nowUs < nextSendUs_) return false;
+
+    const uint16_t seq = static_cast<uint16_t>(next_);
+    const size_t host = next_ % hosts_.size();
+    len = buildEcho(buf, cap, config_.identifier, seq, config_.payloadLen);
+    if (len == 0) return false;
+
+    addr = hosts_[host].addr;
+    hosts_[host].sent++;
+    sentAt_[next_] = static_cast<uint32_t>(nowUs - startUs_);
+    next_++;
+
+    // Fixed rate, a late caller does not get a burst to catch up
+    nextSendUs_ += intervalUs_;
+    if (nextSendUs_ < nowUs) nextSendUs_ = nowUs;
+    lastSendUs_ = nowUs;
+    return true;
+}
+
+int ICMPSweepManager::onReply(const uint8_t* data, size_t len, uint32_t fromAddr, uint64_t nowUs) {
+    if (!data || total_ == 0) return -1;
+
+    // Raw sockets hand over the IPv4 header as well
+    if (len >= 20 && (data[0] >> 4) == 4) {
+        const size_t ihl = (data[0] & 0x0F) * 4u;
+        if (ihl < 20 || len < ihl) return -1;
+        data += ihl;
+        len -= ihl;
+    }
+    if (len < ECHO_HEADER || data[0] != ICMP_ECHO_REPLY || data[1] != 0) return -1;
+
+    const uint16_t id = (data[4] << 8) | data[5];
+    const uint16_t seq = (data[6] << 8) | data[7];
+    if (id != config_.identifier) return -1;                  // another ping session
+
+    if (seq >= next_ || hosts_[seq % hosts_.size()].addr != fromAddr || checksum(data, len) != 0) {
+        stray_++;
+        return -1;
+    }
+
+    const size_t host = seq % hosts_.size();
+    if (answered_[seq]) {
+        hosts_[host].duplicates++;
+        return -1;
+    }
+    answered_[seq] = true;
+    answeredCount_++;
+
+    const uint32_t rtt = static_cast<uint32_t>(nowUs - startUs_) - sentAt_[seq];
+    if (rtt > config_.timeoutMs * 1000u) {
+        hosts_[host].late++;
+        return -1;
+    }
+    record(host, rtt);
+    return static_cast<int>(host);
+}
+
+void ICMPSweepManager::record(size_t index, uint32_t rttUs) {
+    Host& h = hosts_[index];
+    if (h.received == 0) {
+        h.minUs = h.maxUs = rttUs;
+        h.histogram = static_cast<int16_t>(histograms_.size());
+        histograms_.emplace_back();
+        responders_++;
+    } else {
+        // RFC 3550: J += (|D| - J) / 16
+        const int32_t d = static_cast<int32_t>(rttUs > h.lastUs ? rttUs - h.lastUs : h.lastUs - rttUs);
+        h.jitterUs = static_cast<uint32_t>(static_cast<int32_t>(h.jitterUs) + (d - static_cast<int32_t>(h.jitterUs)) / 16);
+        h.minUs = std::min(h.minUs, rttUs);
+        h.maxUs = std::max(h.maxUs, rttUs);
+    }
+    h.received++;
+    h.lastUs = rttUs;
+    h.sumUs += rttUs;
+    histograms_[h.histogram].add(rttUs);
+    overall_.add(rttUs);
+}
+
+uint32_t ICMPSweepManager::percentileUs(size_t host, float p) const {
+    const Host& h = hosts_[host];
+    if (h.histogram < 0) return 0;
+
+    // Buckets are ~20% wide, the exact extremes are known
+    const uint32_t v = histograms_[h.histogram].percentile(p);
+    return std::min(std::max(v, h.minUs), h.maxUs);
+}
+
+bool ICMPSweepManager::done(uint64_t nowUs) const {
+    if (next_ < total_) return false;
+    return answeredCount_ >= total_ || nowUs >= nextEventUs();
+}
+
+uint64_t ICMPSweepManager::nextEventUs() const {
+    if (next_ < total_) return nextSendUs_;
+    return lastSendUs_ + static_cast<uint64_t>(config_.timeoutMs) * 1000;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Echo request sweep over many hosts from a single ICMP socket.
+
+Requests go out round after round over the whole target list at a fixed
+rate, the sequence number encodes round and host (round * hosts + host)
+so a reply is matched with no lookup: identifier, sequence, source
+address and checksum must all agree, duplicates and late replies are
+counted and dropped. Round trips go to per host min/max/mean, a jitter
+estimate (RFC 3550 smoothing of successive differences) and a streaming
+log histogram for percentiles, allocated only for hosts that answer.
+Time is given by the caller. No Arduino dependency.
+*/
+class ICMPSweepManager {
+public:
+    static constexpr size_t ECHO_HEADER  = 8;
+    static constexpr size_t HIST_BUCKETS = 64;
+
+    struct Config {
+        uint16_t identifier = 0x4250;
+        uint8_t  rounds     = 3;        // echo requests per host
+        uint32_t rate       = 200;      // requests per second, all hosts together
+        uint32_t timeoutMs  = 1000;     // after the request, later replies are dropped
+        uint8_t  payloadLen = 16;
+    };
+
+    // RTT histogram, 4 buckets per power of two from 64 us to about 4 s
+    class Histogram {
+    public:
+        void add(uint32_t us);
+        uint32_t percentile(float p) const;     // midpoint of the bucket, 0 when empty
+        uint32_t count() const { return count_; }
+
+        static size_t bucket(uint32_t us);
+        static uint32_t lower(size_t bucket);
+
+    private:
+        uint16_t buckets_[HIST_BUCKETS] = {};
+        uint32_t count_ = 0;
+    };
+
+    struct Host {
+        uint32_t addr       = 0;      // network byte order
+        uint16_t sent       = 0;
+        uint16_t received   = 0;
+        uint16_t late       = 0;
+        uint16_t duplicates = 0;
+        uint32_t minUs      = 0;
+        uint32_t maxUs      = 0;
+        uint32_t lastUs     = 0;
+        uint32_t jitterUs   = 0;
+        uint64_t sumUs      = 0;
+        int16_t  histogram  = -1;     // index in histograms_, -1 until the first reply
+
+        uint32_t meanUs() const { return received ? static_cast<uint32_t>(sumUs / received) : 0; }
+    };
+
+    // False when rounds x hosts does not fit the 16 bit sequence
+    bool begin(const Config& config, const std::vector<uint32_t>& targets, uint64_t nowUs);
+
+    // Next echo request if one is due, written to buf
+    bool nextRequest(uint64_t nowUs, uint8_t* buf, size_t cap, size_t& len, uint32_t& addr);
+
+    // Received datagram, with or without its IPv4 header; host index of a new reply or -1
+    int onReply(const uint8_t* data, size_t len, uint32_t fromAddr, uint64_t nowUs);
+
+    bool     done(uint64_t nowUs) const;
+    uint64_t nextEventUs() const;       // next request, or end of the last timeout
+
+    const std::vector<Host>& hosts() const { return hosts_; }
+    uint32_t percentileUs(size_t host, float p) const;
+    const Histogram& overall() const { return overall_; }
+    size_t   responders() const { return responders_; }
+    uint32_t sent()       const { return next_; }
+    uint32_t stray()      const { return stray_; }
+
+    static uint16_t checksum(const uint8_t* data, size_t len);
+    static size_t buildEcho(uint8_t* buf, size_t cap, uint16_t identifier, uint16_t sequence, size_t payloadLen);
+
+private:
+    Config                 config_;
+    std::vector<Host>      hosts_;
+    std::vector<Histogram> histograms_;
+    std::vector<uint32_t>  sentAt_;      // per sequence, us since begin
+    std::vector<bool>      answered_;
+    Histogram              overall_;
+    uint64_t startUs_      = 0;
+    uint64_t nextSendUs_   = 0;
+    uint64_t lastSendUs_   = 0;
+    uint32_t intervalUs_   = 0;
+    uint32_t total_        = 0;
+    uint32_t next_         = 0;
+    uint32_t answeredCount_ = 0;
+    uint32_t stray_        = 0;
+    size_t   responders_   = 0;
+
+    void record(size_t host, uint32_t rttUs);
+};
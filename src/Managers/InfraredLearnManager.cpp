@@ -0,0 +1,89 @@
+#include "InfraredLearnManager.h"
+
+void InfraredLearnManager::begin(const std::vector<std::string>& names) {
+    names_ = names;
+    buttons_.clear();
+    rawIndex_.clear();
+    rawButton_.clear();
+    lastFrameMs_ = 0;
+    hasFrame_ = false;
+    frames_ = 0;
+    presses_ = 0;
+}
+
+std::string InfraredLearnManager::nextName() const {
+    const size_t n = buttons_.size();
+    if (n < names_.size()) return names_[n];
+    return "button_" + std::to_string(n + 1);
+}
+
+InfraredLearnManager::Outcome InfraredLearnManager::feed(uint32_t nowMs, const InfraredCommand& decoded, bool repeatFlag,
+                                                         const uint16_t* timings, size_t count, uint32_t khz, size_t* duplicateOf) {
+    frames_++;
+
+    // Frames of a press follow each other closely, the gap is measured from the last one.
+    // Only an accepted press starts the timer, ignored noise must not swallow the next press
+    if (hasFrame_ && (nowMs - lastFrameMs_) < PRESS_GAP_MS) {
+        lastFrameMs_ = nowMs;
+        return Outcome::Repeat;
+    }
+    if (repeatFlag) return Outcome::Ignored;    // repeat code without its frame
+
+    const bool isDecoded = decoded.getProtocol() != InfraredProtocolEnum::RAW;
+    if (isDecoded) {
+        for (size_t i = 0; i < buttons_.size(); ++i) {
+            const InfraredCommand& c = buttons_[i].command;
+            if (c.getProtocol() == decoded.getProtocol() && c.getDevice() == decoded.getDevice() &&
+                c.getSubdevice() == decoded.getSubdevice() && c.getFunction() == decoded.getFunction()) {
+                if (duplicateOf) *duplicateOf = i;
+                startPress(nowMs);
+                return Outcome::Duplicate;
+            }
+        }
+    } else {
+        InfraredMatchManager::Signature sig;
+        if (!InfraredMatchManager::signature(timings, count, sig)) return Outcome::Ignored;
+
+        auto matches = rawIndex_.match(timings, count, DUPLICATE_SCORE, 1);
+        if (!matches.empty()) {
+            if (duplicateOf) *duplicateOf = rawButton_[matches[0].entry];
+            startPress(nowMs);
+            return Outcome::Duplicate;
+        }
+    }
+
+    Button b;
+    b.name = nextName();
+    b.command = decoded;
+    b.khz = khz;
+    if (!isDecoded) {
+        b.timings.assign(timings, timings + count);
+        if (rawIndex_.add("", b.name, timings, count)) rawButton_.push_back(buttons_.size());
+    }
+    buttons_.push_back(std::move(b));
+    startPress(nowMs);
+    return Outcome::Learned;
+}
+
+void InfraredLearnManager::startPress(uint32_t nowMs) {
+    lastFrameMs_ = nowMs;
+    hasFrame_ = true;
+    presses_++;
+}
+
+std::vector<std::string> InfraredLearnManager::splitNames(const std::string& list) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+
+        size_t i = start, j = comma;
+        while (i < j && (list[i] == ' ' || list[i] == '\t')) ++i;
+        while (j > i && (list[j - 1] == ' ' || list[j - 1] == '\t')) --j;
+        if (j > i) out.push_back(list.substr(i, j - i));
+
+        start = comma + 1;
+    }
+    return out;
+}
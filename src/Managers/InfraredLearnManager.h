@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Models/InfraredCommand.h"
+#include "Managers/InfraredMatchManager.h"
+
+/*
+Batch learning of a remote.
+
+Frames are fed as they are received. A press is the run of frames separated
+by less than PRESS_GAP_MS, only its first frame is kept and the others
+(repeat codes, held button) are dropped. Ignored frames do not start a press. A press equal to an already
+learned button, same decoded command or raw frame within the match
+tolerance, is reported as a duplicate. Each learned button takes the next
+name of the list given to begin(). No Arduino dependency.
+*/
+class InfraredLearnManager {
+public:
+    enum class Outcome : uint8_t {
+        Learned,        // new button
+        Repeat,         // same press as the previous frame
+        Duplicate,      // press of a button already learned
+        Ignored         // not decoded and too short to be kept raw
+    };
+
+    struct Button {
+        std::string           name;
+        InfraredCommand       command;     // protocol RAW if not decoded
+        std::vector<uint16_t> timings;     // kept only when not decoded
+        uint32_t              khz = 38;
+    };
+
+    static constexpr uint32_t PRESS_GAP_MS    = 300;
+    static constexpr float    DUPLICATE_SCORE = 0.9f;
+
+    // Names given to the learned buttons in order, then "button_N"
+    void begin(const std::vector<std::string>& names);
+
+    // One received frame, duplicateOf is set to the learned button on Duplicate
+    Outcome feed(uint32_t nowMs, const InfraredCommand& decoded, bool repeatFlag,
+                 const uint16_t* timings, size_t count, uint32_t khz, size_t* duplicateOf = nullptr);
+
+    // Name the next learned button will get
+    std::string nextName() const;
+
+    const std::vector<Button>& buttons() const { return buttons_; }
+    uint32_t frames()  const { return frames_; }
+    uint32_t presses() const { return presses_; }   // accepted presses, learned or duplicate
+
+    // Split a comma separated list, blanks trimmed, empty items dropped
+    static std::vector<std::string> splitNames(const std::string& list);
+
+private:
+    // Learned or duplicate frame, the following frames are its repeats
+    void startPress(uint32_t nowMs);
+
+    std::vector<std::string> names_;
+    std::vector<Button>      buttons_;
+    InfraredMatchManager     rawIndex_;       // raw buttons, for duplicates
+    std::vector<size_t>      rawButton_;      // rawIndex_ entry -> button
+    uint32_t                 lastFrameMs_ = 0;
+    bool                     hasFrame_    = false;
+    uint32_t                 frames_      = 0;
+    uint32_t                 presses_     = 0;
+};
@@ -0,0 +1,173 @@
+#include "InfraredMatchManager.h"
+#include <algorithm>
+#include <cmath>
+
+uint8_t InfraredMatchManager::level(uint32_t us) {
+    if (us <= LEVEL_BASE_US) return 0;
+    const float l = std::log2(static_cast<float>(us) / LEVEL_BASE_US) * LEVELS_PER_OCTAVE + 0.5f;
+    return l >= 255.f ? 255 : static_cast<uint8_t>(l);
+}
+
+uint32_t InfraredMatchManager::levelUs(uint8_t level) {
+    // Decoded once, used for the absolute tolerance
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (size_t i = 0; i < t.size(); ++i) {
+            t[i] = static_cast<uint32_t>(LEVEL_BASE_US * std::exp2(static_cast<float>(i) / LEVELS_PER_OCTAVE) + 0.5f);
+        }
+        return t;
+    }();
+    return table[level];
+}
+
+bool InfraredMatchManager::signature(const uint16_t* timings, size_t count, Signature& out) {
+    out.levels.clear();
+    out.hash = 0;
+    if (!timings) return false;
+
+    // First frame, a glitch is merged with its neighbours so marks and spaces keep alternating
+    std::vector<uint32_t> durations;
+    durations.reserve(count < MAX_SYMBOLS ? count : MAX_SYMBOLS);
+    for (size_t i = 0; i < count && durations.size() < MAX_SYMBOLS; ++i) {
+        const uint32_t d = timings[i];
+        if ((i & 1) && d >= FRAME_GAP_US) break;
+
+        if (d < MIN_PULSE_US && !durations.empty() && i + 1 < count) {
+            durations.back() += d + timings[i + 1];
+            ++i;
+            continue;
+        }
+        durations.push_back(d);
+    }
+
+    // Ends on a mark, the trailing space is the gap
+    if (!(durations.size() & 1)) durations.pop_back();
+    if (durations.size() < MIN_SYMBOLS) return false;
+
+    // Base unit, mean of the durations close to the shortest one
+    const uint32_t shortest = *std::min_element(durations.begin(), durations.end());
+    if (shortest == 0) return false;
+    uint64_t sum = 0;
+    uint32_t n = 0;
+    for (uint32_t d : durations) {
+        if (d * 2 <= shortest * 3) {
+            sum += d;
+            ++n;
+        }
+    }
+    const uint32_t unit = static_cast<uint32_t>(sum / n);
+
+    out.levels.reserve(durations.size());
+    uint32_t hash = FNV_OFFSET;
+    for (uint32_t d : durations) {
+        out.levels.push_back(level(d));
+
+        uint32_t u = (d + unit / 2) / unit;
+        if (u > 255) u = 255;
+        hash = (hash ^ u) * FNV_PRIME;
+    }
+    out.hash = hash;
+    return true;
+}
+
+float InfraredMatchManager::similarity(const Signature& sig, const Entry& entry, float* error) {
+    const size_t a = sig.levels.size();
+    const size_t b = entry.levels.size();
+    if (error) *error = 0.f;
+    if (a == 0 || b == 0) return 0.f;
+    if ((a > b ? a - b : b - a) > LENGTH_SLACK) return 0.f;
+
+    const size_t n = std::min(a, b);
+    size_t good = 0;
+    uint32_t levelDiff = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t x = sig.levels[i];
+        const uint8_t y = entry.levels[i];
+        const uint8_t diff = x > y ? x - y : y - x;
+        levelDiff += diff;
+        if (diff <= TOLERANCE_LEVELS) {
+            ++good;
+            continue;
+        }
+
+        // Short durations, the receiver jitter is absolute
+        const uint32_t us = levelUs(x);
+        const uint32_t ref = levelUs(y);
+        if ((us > ref ? us - ref : ref - us) <= TOLERANCE_US) ++good;
+    }
+    if (error) *error = static_cast<float>(levelDiff) / static_cast<float>(n);
+    return static_cast<float>(good) / static_cast<float>(std::max(a, b));
+}
+
+bool InfraredMatchManager::add(const std::string& file, const std::string& name, const uint16_t* timings, size_t count) {
+    Signature sig;
+    if (!signature(timings, count, sig)) return false;
+
+    // Entries of a file are added together
+    if (files_.empty() || files_.back() != file) files_.push_back(file);
+
+    Entry e;
+    e.file = static_cast<uint16_t>(files_.size() - 1);
+    e.name = name;
+    e.hash = sig.hash;
+    e.levels = std::move(sig.levels);
+    e.levels.shrink_to_fit();
+
+    const size_t index = entries_.size();
+    const size_t length = e.levels.size();
+    byHash_.emplace(e.hash, index);
+    if (byLength_.size() <= length) byLength_.resize(length + 1);
+    byLength_[length].push_back(index);
+    entries_.push_back(std::move(e));
+    return true;
+}
+
+void InfraredMatchManager::clear() {
+    entries_.clear();
+    files_.clear();
+    byHash_.clear();
+    byLength_.clear();
+}
+
+std::vector<InfraredMatchManager::Match> InfraredMatchManager::match(const uint16_t* timings, size_t count, float minScore, size_t maxResults) const {
+    std::vector<Match> results;
+    Signature sig;
+    if (!signature(timings, count, sig)) return results;
+
+    // Same frame in base units, the library is not scanned
+    auto range = byHash_.equal_range(sig.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Match m{it->second, 0.f, 0.f};
+        m.score = similarity(sig, entries_[it->second], &m.error);
+        if (m.score >= minScore) results.push_back(m);
+    }
+
+    // Otherwise score the entries of about the same length
+    if (results.empty()) {
+        const size_t length = sig.levels.size();
+        const size_t from = length > LENGTH_SLACK ? length - LENGTH_SLACK : 0;
+        for (size_t len = from; len <= length + LENGTH_SLACK && len < byLength_.size(); ++len) {
+            for (size_t index : byLength_[len]) {
+                Match m{index, 0.f, 0.f};
+                m.score = similarity(sig, entries_[index], &m.error);
+                if (m.score >= minScore) results.push_back(m);
+            }
+        }
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const Match& a, const Match& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.error < b.error;
+    });
+    if (results.size() > maxResults) results.resize(maxResults);
+    return results;
+}
+
+size_t InfraredMatchManager::memoryBytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry);
+    for (const auto& e : entries_) bytes += e.levels.capacity() + e.name.capacity();
+    for (const auto& f : files_) bytes += sizeof(std::string) + f.capacity();
+    bytes += byHash_.size() * (sizeof(size_t) + sizeof(uint32_t) + 2 * sizeof(void*));
+    for (const auto& bucket : byLength_) bytes += bucket.capacity() * sizeof(size_t);
+    return bytes;
+}
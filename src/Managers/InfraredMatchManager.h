@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+/*
+Index of stored IR raw captures, to find which saved button a new capture is.
+
+A capture is reduced to its first frame. Each mark/space is stored as a
+log scale level (1/24 octave, one byte), compared with a relative
+tolerance so receiver jitter does not matter. The frame is also quantized
+to multiples of its base unit (the mean of the shortest durations) and
+hashed, which finds the usual case, a capture of the same remote, without
+scoring the whole library. No Arduino dependency, the class builds on a host.
+*/
+class InfraredMatchManager {
+public:
+    struct Signature {
+        std::vector<uint8_t> levels;      // per duration, see level()
+        uint32_t             hash = 0;    // FNV-1a of the durations in base units
+    };
+
+    struct Entry {
+        uint16_t             file = 0;    // index in files()
+        std::string          name;
+        uint32_t             hash = 0;
+        std::vector<uint8_t> levels;
+    };
+
+    struct Match {
+        size_t entry = 0;
+        float  score = 0.f;               // durations within tolerance, 0..1
+        float  error = 0.f;               // mean level difference, tie break
+    };
+
+    static constexpr uint32_t FRAME_GAP_US       = 20000;  // a longer space ends the first frame
+    static constexpr uint16_t MIN_PULSE_US       = 80;     // shorter durations are glitches
+    static constexpr size_t   MIN_SYMBOLS        = 5;
+    static constexpr size_t   MAX_SYMBOLS        = 160;
+    static constexpr size_t   LENGTH_SLACK       = 2;      // candidates may differ by this many durations
+    static constexpr uint32_t LEVEL_BASE_US      = 16;
+    static constexpr uint32_t LEVELS_PER_OCTAVE  = 24;     // ~3% per level, 16us .. 25ms
+    static constexpr uint8_t  TOLERANCE_LEVELS   = 9;      // ~30%
+    static constexpr uint32_t TOLERANCE_US       = 120;    // absolute, for short durations
+
+    // Index a capture (mark first, microseconds), false if too short to be recognized
+    bool add(const std::string& file, const std::string& name, const uint16_t* timings, size_t count);
+    void clear();
+
+    // Best entries for a capture, best first
+    std::vector<Match> match(const uint16_t* timings, size_t count, float minScore = 0.85f, size_t maxResults = 3) const;
+
+    const std::vector<Entry>&       entries() const { return entries_; }
+    const std::vector<std::string>& files()   const { return files_; }
+    size_t memoryBytes() const;
+
+    // First frame, glitches merged
+    static bool signature(const uint16_t* timings, size_t count, Signature& out);
+
+    // Durations within tolerance over the longest length, 0 if the lengths differ too much
+    static float similarity(const Signature& sig, const Entry& entry, float* error = nullptr);
+
+    static uint8_t  level(uint32_t us);
+    static uint32_t levelUs(uint8_t level);
+
+private:
+    static constexpr uint32_t FNV_OFFSET = 2166136261u;
+    static constexpr uint32_t FNV_PRIME  = 16777619u;
+
+    std::vector<Entry>                         entries_;
+    std::vector<std::string>                   files_;
+    std::unordered_multimap<uint32_t, size_t>  byHash_;
+    std::vector<std::vector<size_t>>           byLength_;   // entries by number of durations
+};
@@ -0,0 +1,291 @@
+#include "ModbusScanManager.h"
+#include <algorithm>
+#include <cstdlib>
+
+void ModbusScanManager::beginDiscovery(uint8_t tableMask, uint16_t first, uint16_t last) {
+    work_.clear();
+    inFlight_.clear();
+    for (size_t t = 0; t < TABLES; ++t) {
+        valid_[t].clear();
+        silent_[t].clear();
+        unsupported_[t] = false;
+    }
+    probes_ = noReply_ = 0;
+    if (first > last) return;
+
+    // Largest reads first, most of a mapped area is confirmed in one request
+    for (size_t t = 0; t < TABLES; ++t) {
+        if (!(tableMask & (1u << t))) continue;
+        const Table table = static_cast<Table>(t);
+        const uint32_t step = maxQty(table);
+        for (uint32_t a = first; a <= last; a += step) {
+            const uint32_t qty = std::min<uint32_t>(step, static_cast<uint32_t>(last) - a + 1);
+            work_.push_back(Read{table, static_cast<uint16_t>(a), static_cast<uint16_t>(qty)});
+        }
+    }
+}
+
+bool ModbusScanManager::nextProbe(Read& probe, uint32_t& id) {
+    while (!work_.empty()) {
+        probe = work_.front();
+        work_.pop_front();
+        if (unsupported_[index(probe.table)]) continue;
+
+        id = ++nextId_;
+        inFlight_.push_back(Pending{id, probe});
+        probes_++;
+        return true;
+    }
+    return false;
+}
+
+void ModbusScanManager::onProbe(uint32_t id, Outcome outcome) {
+    auto it = std::find_if(inFlight_.begin(), inFlight_.end(),
+                           [id](const Pending& p) { return p.id == id; });
+    if (it == inFlight_.end()) return;
+    const Read probe = it->probe;
+    inFlight_.erase(it);
+
+    const size_t t = index(probe.table);
+    const Range range{probe.addr, static_cast<uint16_t>(probe.addr + probe.qty - 1)};
+
+    switch (outcome) {
+        case Outcome::Ok:
+            valid_[t].push_back(range);
+            break;
+
+        case Outcome::BadAddress:
+            // Some address in the block is not mapped, bisect; the halves go first so
+            // the probes in flight stay close together
+            if (probe.qty > 1 && probe.qty <= SINGLES) {
+                for (uint16_t i = probe.qty; i-- > 0;) {
+                    work_.push_front(Read{probe.table, static_cast<uint16_t>(probe.addr + i), 1});
+                }
+            } else if (probe.qty > 1) {
+                const uint16_t half = probe.qty / 2;
+                work_.push_front(Read{probe.table, static_cast<uint16_t>(probe.addr + half),
+                                      static_cast<uint16_t>(probe.qty - half)});
+                work_.push_front(Read{probe.table, probe.addr, half});
+            }
+            break;
+
+        case Outcome::Unsupported:
+            unsupported_[t] = true;
+            work_.erase(std::remove_if(work_.begin(), work_.end(),
+                                       [&](const Read& r) { return r.table == probe.table; }),
+                        work_.end());
+            break;
+
+        case Outcome::NoReply:
+            // Not split, a device that drops bad requests would cost a timeout per half
+            noReply_++;
+            silent_[t].push_back(range);
+            break;
+    }
+}
+
+std::vector<ModbusScanManager::Range> ModbusScanManager::ranges(Table table) const {
+    return merge(valid_[index(table)]);
+}
+
+std::vector<ModbusScanManager::Range> ModbusScanManager::silent(Table table) const {
+    return merge(silent_[index(table)]);
+}
+
+std::vector<ModbusScanManager::Range> ModbusScanManager::merge(std::vector<Range> ranges) {
+    std::sort(ranges.begin(), ranges.end(),
+              [](const Range& a, const Range& b) { return a.first < b.first; });
+
+    std::vector<Range> out;
+    for (const auto& r : ranges) {
+        if (!out.empty() && static_cast<uint32_t>(r.first) <= static_cast<uint32_t>(out.back().last) + 1) {
+            out.back().last = std::max(out.back().last, r.last);
+        } else {
+            out.push_back(r);
+        }
+    }
+    return out;
+}
+
+std::vector<ModbusScanManager::Read> ModbusScanManager::planRanges(Table table, const std::vector<Range>& ranges) {
+    std::vector<Read> out;
+    const uint32_t step = maxQty(table);
+    for (const auto& r : merge(ranges)) {
+        for (uint32_t a = r.first; a <= r.last; a += step) {
+            const uint32_t qty = std::min<uint32_t>(step, static_cast<uint32_t>(r.last) - a + 1);
+            out.push_back(Read{table, static_cast<uint16_t>(a), static_cast<uint16_t>(qty)});
+        }
+    }
+    return out;
+}
+
+std::vector<ModbusScanManager::Read> ModbusScanManager::planReads(Table table, std::vector<uint16_t> addrs,
+                                                                  uint16_t maxGap, const std::vector<Range>* valid) {
+    std::vector<Read> out;
+    if (addrs.empty()) return out;
+    std::sort(addrs.begin(), addrs.end());
+    addrs.erase(std::unique(addrs.begin(), addrs.end()), addrs.end());
+
+    // A gap is only read through when the whole span is known to be mapped
+    auto mapped = [valid](uint32_t from, uint32_t to) {
+        if (!valid) return true;
+        return std::any_of(valid->begin(), valid->end(),
+                           [&](const Range& r) { return r.first <= from && to <= r.last; });
+    };
+
+    const uint32_t limit = maxQty(table);
+    uint32_t start = addrs[0];
+    uint32_t end = start;
+    for (size_t i = 1; i < addrs.size(); ++i) {
+        const uint32_t a = addrs[i];
+        const bool join = (a - end - 1 <= maxGap) && (a - start + 1 <= limit) &&
+                          (a == end + 1 || mapped(end, a));
+        if (!join) {
+            out.push_back(Read{table, static_cast<uint16_t>(start), static_cast<uint16_t>(end - start + 1)});
+            start = a;
+        }
+        end = a;
+    }
+    out.push_back(Read{table, static_cast<uint16_t>(start), static_cast<uint16_t>(end - start + 1)});
+    return out;
+}
+
+void ModbusScanManager::Monitor::begin(const std::vector<Watch>& watched, uint16_t maxGap,
+                                       const std::vector<Range>* valid) {
+    watched_.clear();
+    reads_.clear();
+    for (const auto& w : watched) watched_.push_back(Slot{w, -1});
+
+    std::sort(watched_.begin(), watched_.end(), [](const Slot& a, const Slot& b) {
+        return a.watch.table != b.watch.table ? a.watch.table < b.watch.table : a.watch.addr < b.watch.addr;
+    });
+    watched_.erase(std::unique(watched_.begin(), watched_.end(), [](const Slot& a, const Slot& b) {
+        return a.watch.table == b.watch.table && a.watch.addr == b.watch.addr;
+    }), watched_.end());
+
+    // One plan per table, all tables go out in the same poll
+    for (size_t i = 0; i < watched_.size();) {
+        const Table table = watched_[i].watch.table;
+        std::vector<uint16_t> addrs;
+        for (; i < watched_.size() && watched_[i].watch.table == table; ++i) addrs.push_back(watched_[i].watch.addr);
+        const auto plan = planReads(table, addrs, maxGap, valid ? &valid[index(table)] : nullptr);
+        reads_.insert(reads_.end(), plan.begin(), plan.end());
+    }
+    bind();
+}
+
+void ModbusScanManager::Monitor::bind() {
+    slots_.clear();
+    for (const auto& r : reads_) {
+        auto before = [](const Slot& s, const Watch& w) {
+            return s.watch.table != w.table ? s.watch.table < w.table : s.watch.addr < w.addr;
+        };
+        const auto first = std::lower_bound(watched_.begin(), watched_.end(), Watch{r.table, r.addr}, before);
+        auto last = first;
+        while (last != watched_.end() && last->watch.table == r.table &&
+               static_cast<uint32_t>(last->watch.addr) < static_cast<uint32_t>(r.addr) + r.qty) ++last;
+        slots_.emplace_back(first - watched_.begin(), last - watched_.begin());
+    }
+}
+
+void ModbusScanManager::Monitor::onValues(size_t read, const std::vector<uint16_t>& values, std::vector<Change>& changes) {
+    if (read >= reads_.size()) return;
+    const Read& r = reads_[read];
+
+    for (size_t i = slots_[read].first; i < slots_[read].second; ++i) {
+        Slot& s = watched_[i];
+        const size_t offset = s.watch.addr - r.addr;
+        if (offset >= values.size()) continue;
+
+        const uint16_t v = values[offset];
+        if (s.value == static_cast<int32_t>(v)) continue;
+        changes.push_back(Change{s.watch.table, s.watch.addr,
+                                 static_cast<uint16_t>(s.value < 0 ? 0 : s.value), v, s.value < 0});
+        s.value = v;
+    }
+}
+
+bool ModbusScanManager::Monitor::split(size_t read) {
+    if (read >= reads_.size()) return false;
+    const Table table = reads_[read].table;
+
+    std::vector<uint16_t> addrs;
+    for (size_t i = slots_[read].first; i < slots_[read].second; ++i) addrs.push_back(watched_[i].watch.addr);
+    const auto runs = planReads(table, addrs, 0);
+    if (runs.size() <= 1) return false;
+
+    reads_.erase(reads_.begin() + read);
+    reads_.insert(reads_.begin() + read, runs.begin(), runs.end());
+    bind();
+    return true;
+}
+
+bool ModbusScanManager::parseWatch(const std::string& spec, std::vector<Watch>& out, size_t max) {
+    out.clear();
+    size_t i = 0;
+    while (i < spec.size()) {
+        // Separators
+        if (spec[i] == ',' || spec[i] == ' ') { ++i; continue; }
+
+        Table table = Table::Holding;
+        switch (spec[i] | 0x20) {
+            case 'h': table = Table::Holding;  ++i; break;
+            case 'i': table = Table::Input;    ++i; break;
+            case 'c': table = Table::Coils;    ++i; break;
+            case 'd': table = Table::Discrete; ++i; break;
+            default:
+                if (spec[i] < '0' || spec[i] > '9') return false;
+        }
+
+        char* end = nullptr;
+        const unsigned long a = std::strtoul(spec.c_str() + i, &end, 10);
+        if (end == spec.c_str() + i || a > 0xFFFF) return false;
+        unsigned long b = a;
+        i = end - spec.c_str();
+        if (i < spec.size() && spec[i] == '-') {
+            ++i;
+            b = std::strtoul(spec.c_str() + i, &end, 10);
+            if (end == spec.c_str() + i || b > 0xFFFF || b < a) return false;
+            i = end - spec.c_str();
+        }
+        if (i < spec.size() && spec[i] != ',' && spec[i] != ' ') return false;
+        if (out.size() + (b - a + 1) > max) return false;
+
+        for (unsigned long x = a; x <= b; ++x) out.push_back(Watch{table, static_cast<uint16_t>(x)});
+    }
+    return !out.empty();
+}
+
+uint16_t ModbusScanManager::maxQty(Table table) {
+    return (table == Table::Coils || table == Table::Discrete) ? MAX_BITS : MAX_REGS;
+}
+
+uint8_t ModbusScanManager::functionCode(Table table) {
+    switch (table) {
+        case Table::Coils:    return 0x01;
+        case Table::Discrete: return 0x02;
+        case Table::Holding:  return 0x03;
+        case Table::Input:    return 0x04;
+    }
+    return 0x03;
+}
+
+const char* ModbusScanManager::tableName(Table table) {
+    switch (table) {
+        case Table::Coils:    return "线圈"; // 汉化
+        case Table::Discrete: return "离散输入"; // 汉化
+        case Table::Holding:  return "保持寄存器"; // 汉化
+        case Table::Input:    return "输入寄存器"; // 汉化
+    }
+    return "";
+}
+
+char ModbusScanManager::tableLetter(Table table) {
+    switch (table) {
+        case Table::Coils:    return 'c';
+        case Table::Discrete: return 'd';
+        case Table::Holding:  return 'h';
+        case Table::Input:    return 'i';
+    }
+    return '?';
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Modbus register map discovery and batched polling plans.
+
+Discovery probes each table (coils, discrete inputs, holding and input
+registers) in blocks of the largest read the protocol allows. A block
+answered with an address exception is split in two and both halves are
+probed, down to a few addresses that are then probed one by one, so the
+edges of every valid range are found by bisection while a fully mapped
+block costs one request. Probes are handed out one at a time and may be
+answered in any order, the caller keeps several in flight. Valid blocks
+are merged into maximal ranges, then cut into the fewest reads.
+
+The monitor side groups watched addresses of a table into reads,
+bridging small gaps (only inside a known valid range when a map is
+given), and reports the values that changed between two polls.
+No Modbus library or Arduino dependency.
+*/
+class ModbusScanManager {
+public:
+    enum class Table : uint8_t { Coils, Discrete, Holding, Input };
+    enum class Outcome : uint8_t { Ok, BadAddress, Unsupported, NoReply };
+
+    static constexpr size_t   TABLES   = 4;
+    static constexpr uint16_t MAX_REGS = 125;     // FC03/FC04
+    static constexpr uint16_t MAX_BITS = 2000;    // FC01/FC02
+    static constexpr uint16_t SINGLES  = 4;       // a refused block this small is probed address by address
+
+    struct Read {
+        Table    table = Table::Holding;
+        uint16_t addr  = 0;
+        uint16_t qty   = 0;
+    };
+
+    struct Range {
+        uint16_t first = 0;
+        uint16_t last  = 0;
+        uint32_t count() const { return static_cast<uint32_t>(last) - first + 1; }
+    };
+
+    struct Watch {
+        Table    table = Table::Holding;
+        uint16_t addr  = 0;
+    };
+
+    struct Change {
+        Table    table;
+        uint16_t addr;
+        uint16_t before;
+        uint16_t after;
+        bool     first;     // no earlier value
+    };
+
+    // Discovery over [first, last] of the tables in mask (bit = 1 << Table)
+    void beginDiscovery(uint8_t tableMask, uint16_t first, uint16_t last);
+
+    // Next probe to send, id comes back with its outcome
+    bool nextProbe(Read& probe, uint32_t& id);
+    void onProbe(uint32_t id, Outcome outcome);
+
+    bool     discoveryDone() const { return work_.empty() && inFlight_.empty(); }
+    size_t   inFlight()  const { return inFlight_.size(); }
+    uint32_t probes()    const { return probes_; }
+    uint32_t noReply()   const { return noReply_; }
+    bool     supported(Table table) const { return !unsupported_[index(table)]; }
+
+    // Merged valid ranges, and the ones that never answered
+    std::vector<Range> ranges(Table table) const;
+    std::vector<Range> silent(Table table) const;
+
+    // Ranges cut into reads of at most maxQty(table)
+    static std::vector<Read> planRanges(Table table, const std::vector<Range>& ranges);
+
+    // Fewest reads covering addrs, gaps up to maxGap are read through
+    static std::vector<Read> planReads(Table table, std::vector<uint16_t> addrs, uint16_t maxGap,
+                                       const std::vector<Range>* valid = nullptr);
+
+    // Watch list for monitoring, changes between polls
+    class Monitor {
+    public:
+        // valid, when given, holds TABLES maps indexed by table
+        void begin(const std::vector<Watch>& watched, uint16_t maxGap,
+                   const std::vector<Range>* valid = nullptr);
+
+        const std::vector<Read>& reads() const { return reads_; }
+
+        // Reply to reads()[read], registers or one value per bit
+        void onValues(size_t read, const std::vector<uint16_t>& values, std::vector<Change>& changes);
+
+        // A read through a gap was refused, read only the watched runs instead
+        bool split(size_t read);
+
+        size_t watched() const { return watched_.size(); }
+
+    private:
+        struct Slot {
+            Watch   watch;
+            int32_t value = -1;     // -1 until read
+        };
+        std::vector<Slot>  watched_;
+        std::vector<Read>  reads_;
+        std::vector<std::pair<size_t, size_t>> slots_;     // per read, [first, last) in watched_
+
+        void bind();
+    };
+
+    // "h0-9,h100,i5,c0-15,d3", letters h i c d for the tables
+    static bool parseWatch(const std::string& spec, std::vector<Watch>& out, size_t max = 512);
+
+    static uint16_t    maxQty(Table table);
+    static uint8_t     functionCode(Table table);
+    static const char* tableName(Table table);
+    static char        tableLetter(Table table);
+
+private:
+    struct Pending {
+        uint32_t id;
+        Read     probe;
+    };
+
+    std::deque<Read>     work_;
+    std::vector<Pending> inFlight_;
+    std::vector<Range>   valid_[TABLES];
+    std::vector<Range>   silent_[TABLES];
+    bool     unsupported_[TABLES] = {};
+    uint32_t nextId_  = 0;
+    uint32_t probes_  = 0;
+    uint32_t noReply_ = 0;
+
+    static size_t index(Table table) { return static_cast<size_t>(table); }
+    static std::vector<Range> merge(std::vector<Range> ranges);
+};
@@ -0,0 +1,558 @@
+#include "NetBenchManager.h"
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+constexpr uint32_t REPORT_VERSION1 = 0x80000000u;   // iperf 2 HEADER_VERSION1 flag
+constexpr size_t   BURST           = 64;            // writes or datagrams per step
+
+void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+bool wouldBlock(int e) {
+    return e == EAGAIN || e == EWOULDBLOCK || e == ENOMEM || e == ENOBUFS;
+}
+}
+
+NetBenchManager::~NetBenchManager() {
+    closeSockets();
+}
+
+uint64_t NetBenchManager::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool NetBenchManager::begin(const Config& config, const std::string& host) {
+    closeSockets();
+    config_ = config;
+    result_ = Result{};
+    stats_ = UdpStats{};
+    report_ = Report{};
+    intervals_.clear();
+    error_.clear();
+    startUs_ = endUs_ = deadlineUs_ = nextSendUs_ = 0;
+    nextId_ = 0;
+    finTries_ = 0;
+    intervalBytes_ = 0;
+    intervalDatagrams_ = 0;
+    intervalLost_ = intervalOoo_ = 0;
+    peerAddr_ = 0;
+    peerPort_ = 0;
+    state_ = State::Idle;
+
+    const bool udp = config_.protocol == Protocol::Udp;
+    if (!config_.length) config_.length = udp ? UDP_LENGTH : TCP_LENGTH;
+    config_.length = std::min(std::max(config_.length, udp ? REPORT_LENGTH : size_t(1)), MAX_LENGTH);
+    if (!config_.intervalMs) config_.intervalMs = 1000;
+    // A receiver takes whatever datagram size the sender picked
+    buffer_.assign(udp && config_.role == Role::Receive ? std::max<size_t>(config_.length, 2048) : config_.length, 0);
+
+    // Datagram spacing for the target bandwidth
+    gapUs_ = config_.bandwidth ? static_cast<uint64_t>(config_.length) * 8 * 1000000ULL / config_.bandwidth : 0;
+
+    if (config_.role == Role::Send && !resolve(host)) return false;
+    if (!openSocket(udp)) return false;
+
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    if (config_.role == Role::Receive) {
+        int one = 1;
+        (void)setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sa.sin_port = htons(config_.port);
+        sa.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) < 0) {
+            return fail("端口 " + std::to_string(config_.port) + " 绑定失败"); // 汉化
+        }
+        if (!udp) {
+            if (::listen(fd_, 1) < 0) return fail("监听失败"); // 汉化
+            listenFd_ = fd_;
+            fd_ = -1;
+        }
+        state_ = State::Listening;
+        return true;
+    }
+
+    sa.sin_port = htons(config_.port);
+    sa.sin_addr.s_addr = peerAddr_;
+    const int rc = ::connect(fd_, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+    if (udp) {
+        if (rc < 0) return fail("UDP 连接失败"); // 汉化
+        start(nowUs());
+        return true;
+    }
+    if (rc == 0) {
+        start(nowUs());
+    } else if (errno == EINPROGRESS || errno == EALREADY) {
+        state_ = State::Connecting;
+        deadlineUs_ = nowUs() + static_cast<uint64_t>(config_.connectTimeoutMs) * 1000;
+    } else {
+        return fail(std::string("连接失败：") + strerror(errno)); // 汉化
+    }
+    return true;
+}
+
+bool NetBenchManager::resolve(const std::string& host) {
+    in_addr a{};
+    if (inet_aton(host.c_str(), &a)) {
+        peerAddr_ = a.s_addr;
+        return true;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    addrinfo* res = nullptr;
+    if (host.empty() || getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res) {
+        return fail("无法解析主机：" + host); // 汉化
+    }
+    peerAddr_ = reinterpret_cast<sockaddr_in*>(res->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(res);
+    return true;
+}
+
+bool NetBenchManager::openSocket(bool udp) {
+    fd_ = udp ? ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP) : ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd_ < 0) return fail("无法创建套接字"); // 汉化
+    if (fd_ >= FD_SETSIZE) return fail("套接字过多"); // 汉化
+
+    int nb = 1;
+    ioctl(fd_, FIONBIO, &nb);
+    // Set before listen() or connect(), the TCP window scale is agreed at the handshake
+    applyOptions(fd_);
+    return true;
+}
+
+void NetBenchManager::applyOptions(int fd) {
+    const int opt = config_.role == Role::Send ? SO_SNDBUF : SO_RCVBUF;
+    if (config_.window > 0 && setsockopt(fd, SOL_SOCKET, opt, &config_.window, sizeof(config_.window)) < 0) {
+        result_.window = -1;
+    } else {
+        int value = 0;
+        socklen_t len = sizeof(value);
+        result_.window = getsockopt(fd, SOL_SOCKET, opt, &value, &len) == 0 ? value : -1;
+    }
+    if (config_.protocol == Protocol::Tcp && config_.noDelay) {
+        int one = 1;
+        (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+}
+
+void NetBenchManager::cancel() {
+    if (state_ == State::Running || state_ == State::Finishing) finish(nowUs());
+    closeSockets();
+    if (state_ != State::Failed) state_ = State::Done;
+}
+
+void NetBenchManager::closeSockets() {
+    if (fd_ >= 0) ::close(fd_);
+    if (listenFd_ >= 0) ::close(listenFd_);
+    fd_ = listenFd_ = -1;
+}
+
+bool NetBenchManager::fail(const std::string& what) {
+    error_ = what;
+    closeSockets();
+    state_ = State::Failed;
+    return false;
+}
+
+void NetBenchManager::start(uint64_t nowUs) {
+    state_ = State::Running;
+    startUs_ = intervalUs_ = nextSendUs_ = nowUs;
+    deadlineUs_ = nowUs + static_cast<uint64_t>(config_.durationMs) * 1000;
+}
+
+void NetBenchManager::finish(uint64_t nowUs) {
+    if (!endUs_) endUs_ = nowUs;
+    if (intervalBytes_ || intervalDatagrams_) closeInterval(endUs_);
+    result_.durationMs = startUs_ ? static_cast<uint32_t>((endUs_ - startUs_) / 1000) : 0;
+    if (config_.protocol == Protocol::Udp && config_.role == Role::Receive) {
+        result_.lost = stats_.lost();
+        result_.outOfOrder = stats_.outOfOrder();
+        result_.jitterUs = stats_.jitterUs();
+    }
+}
+
+void NetBenchManager::account(uint64_t bytes, uint64_t nowUs) {
+    result_.bytes += bytes;
+    intervalBytes_ += bytes;
+    if (nowUs - intervalUs_ >= static_cast<uint64_t>(config_.intervalMs) * 1000) closeInterval(nowUs);
+}
+
+void NetBenchManager::closeInterval(uint64_t nowUs) {
+    Interval iv;
+    iv.startMs = static_cast<uint32_t>((intervalUs_ - startUs_) / 1000);
+    iv.endMs = static_cast<uint32_t>((nowUs - startUs_) / 1000);
+    iv.bytes = intervalBytes_;
+    iv.datagrams = intervalDatagrams_;
+    iv.lost = stats_.lost() - std::min(stats_.lost(), intervalLost_);
+    iv.outOfOrder = stats_.outOfOrder() - intervalOoo_;
+    iv.jitterUs = stats_.jitterUs();
+
+    if (intervals_.size() >= MAX_INTERVALS) intervals_.pop_front();
+    intervals_.push_back(iv);
+
+    intervalUs_ = nowUs;
+    intervalBytes_ = 0;
+    intervalDatagrams_ = 0;
+    intervalLost_ = stats_.lost();
+    intervalOoo_ = stats_.outOfOrder();
+}
+
+bool NetBenchManager::takeInterval(Interval& out) {
+    if (intervals_.empty()) return false;
+    out = intervals_.front();
+    intervals_.pop_front();
+    return true;
+}
+
+bool NetBenchManager::step(uint32_t maxWaitMs) {
+    const uint64_t now = nowUs();
+    const bool udp = config_.protocol == Protocol::Udp;
+
+    // An interval with nothing in it is reported as well
+    if (state_ == State::Running && now - intervalUs_ >= static_cast<uint64_t>(config_.intervalMs) * 1000) {
+        closeInterval(now);
+    }
+
+    switch (state_) {
+        case State::Connecting:
+            return stepConnect(maxWaitMs, now);
+        case State::Listening:
+            return udp ? stepUdpReceive(maxWaitMs) : stepAccept(maxWaitMs);
+        case State::Running:
+            if (config_.role == Role::Send) return udp ? stepUdpSend(maxWaitMs, now) : stepTcpSend(maxWaitMs, now);
+            return udp ? stepUdpReceive(maxWaitMs) : stepTcpReceive(maxWaitMs);
+        case State::Finishing:
+            return config_.role == Role::Send ? stepUdpFin(maxWaitMs, now) : stepUdpReceive(maxWaitMs);
+        default:
+            return false;
+    }
+}
+
+int NetBenchManager::waitFor(int fd, bool write, uint32_t waitMs) const {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    timeval tv{};
+    tv.tv_sec = waitMs / 1000;
+    tv.tv_usec = (waitMs % 1000) * 1000;
+    return ::select(fd + 1, write ? nullptr : &fds, write ? &fds : nullptr, nullptr, &tv);
+}
+
+bool NetBenchManager::stepConnect(uint32_t waitMs, uint64_t now) {
+    if (now >= deadlineUs_) return fail("连接超时"); // 汉化
+    const uint32_t left = static_cast<uint32_t>((deadlineUs_ - now + 999) / 1000);
+    if (waitFor(fd_, true, std::min(waitMs, left)) <= 0) return true;
+
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len) < 0) err = errno;
+    if (err) return fail(std::string("连接失败：") + strerror(err)); // 汉化
+    start(nowUs());
+    return true;
+}
+
+bool NetBenchManager::stepAccept(uint32_t waitMs) {
+    if (waitFor(listenFd_, false, waitMs) <= 0) return true;
+
+    sockaddr_in sa{};
+    socklen_t len = sizeof(sa);
+    const int fd = ::accept(listenFd_, reinterpret_cast<sockaddr*>(&sa), &len);
+    if (fd < 0) return true;
+    ::close(listenFd_);
+    listenFd_ = -1;
+
+    fd_ = fd;
+    int nb = 1;
+    ioctl(fd_, FIONBIO, &nb);
+    applyOptions(fd_);
+    char ip[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &sa.sin_addr, ip, sizeof(ip));
+    result_.peerAddr = std::string(ip) + ":" + std::to_string(ntohs(sa.sin_port));
+    start(nowUs());
+    return true;
+}
+
+bool NetBenchManager::stepTcpSend(uint32_t waitMs, uint64_t now) {
+    if (now >= deadlineUs_) {
+        finish(now);
+        ::shutdown(fd_, SHUT_WR);
+        closeSockets();
+        state_ = State::Done;
+        return false;
+    }
+    const uint32_t left = static_cast<uint32_t>((deadlineUs_ - now + 999) / 1000);
+    if (waitFor(fd_, true, std::min(waitMs, left)) <= 0) return true;
+
+    for (size_t n = 0; n < BURST; ++n) {
+        const ssize_t sent = ::send(fd_, buffer_.data(), buffer_.size(), 0);
+        if (sent > 0) {
+            account(static_cast<uint64_t>(sent), nowUs());
+            continue;
+        }
+        if (sent < 0 && wouldBlock(errno)) break;
+        finish(nowUs());
+        return fail(std::string("发送失败：") + strerror(errno)); // 汉化
+    }
+    return true;
+}
+
+bool NetBenchManager::stepTcpReceive(uint32_t waitMs) {
+    if (waitFor(fd_, false, waitMs) <= 0) return true;
+
+    for (size_t n = 0; n < BURST; ++n) {
+        const ssize_t got = ::recv(fd_, buffer_.data(), buffer_.size(), 0);
+        if (got > 0) {
+            account(static_cast<uint64_t>(got), nowUs());
+            continue;
+        }
+        if (got < 0 && wouldBlock(errno)) break;
+
+        // Sender closed, or reset after its last write
+        finish(nowUs());
+        closeSockets();
+        state_ = State::Done;
+        return false;
+    }
+    return true;
+}
+
+bool NetBenchManager::stepUdpSend(uint32_t waitMs, uint64_t now) {
+    if (now >= deadlineUs_) {
+        finish(now);
+        state_ = State::Finishing;
+        sendFin(now);
+        return true;
+    }
+
+    for (size_t n = 0; n < BURST && nextSendUs_ <= now; ++n) {
+        Datagram d;
+        d.id = nextId_;
+        d.sec = static_cast<uint32_t>(now / 1000000);
+        d.usec = static_cast<uint32_t>(now % 1000000);
+        encodeDatagram(d, buffer_.data());
+
+        const ssize_t sent = ::send(fd_, buffer_.data(), buffer_.size(), 0);
+        if (sent < 0) {
+            // Out of buffers, the same datagram goes again on the next step
+            if (wouldBlock(errno)) { result_.sendErrors++; break; }
+            finish(now);
+            return fail(std::string("发送失败：") + strerror(errno)); // 汉化
+        }
+        nextId_++;
+        result_.datagrams++;
+        intervalDatagrams_++;
+        account(static_cast<uint64_t>(sent), now);
+        nextSendUs_ += gapUs_;
+        if (!gapUs_) nextSendUs_ = now;
+    }
+
+    // Sleep until the next datagram is due
+    const uint64_t wake = std::min(nextSendUs_, deadlineUs_);
+    now = nowUs();
+    if (wake > now) {
+        const uint32_t ms = static_cast<uint32_t>(std::min<uint64_t>((wake - now) / 1000, waitMs));
+        if (ms) waitFor(fd_, false, ms);
+    }
+    return true;
+}
+
+void NetBenchManager::sendFin(uint64_t now) {
+    Datagram d;
+    d.id = -std::max<int32_t>(nextId_, 1);
+    d.sec = static_cast<uint32_t>(now / 1000000);
+    d.usec = static_cast<uint32_t>(now % 1000000);
+    encodeDatagram(d, buffer_.data());
+    (void)::send(fd_, buffer_.data(), buffer_.size(), 0);
+    finTries_++;
+    deadlineUs_ = now + FIN_WAIT_MS * 1000ULL;
+}
+
+bool NetBenchManager::stepUdpFin(uint32_t waitMs, uint64_t now) {
+    if (now >= deadlineUs_) {
+        if (finTries_ >= FIN_TRIES) {
+            closeSockets();
+            state_ = State::Done;
+            return false;
+        }
+        sendFin(now);
+    }
+    const uint32_t left = static_cast<uint32_t>((deadlineUs_ - now + 999) / 1000);
+    if (waitFor(fd_, false, std::min(waitMs, left)) <= 0) return true;
+
+    uint8_t reply[REPORT_LENGTH + 16];
+    const ssize_t got = ::recv(fd_, reply, sizeof(reply), 0);
+    if (got > 0 && decodeReport(reply, static_cast<size_t>(got), result_.peer)) {
+        result_.peerReport = true;
+        closeSockets();
+        state_ = State::Done;
+        return false;
+    }
+    return true;
+}
+
+bool NetBenchManager::stepUdpReceive(uint32_t waitMs) {
+    if (state_ == State::Finishing && nowUs() >= deadlineUs_) {
+        closeSockets();
+        state_ = State::Done;
+        return false;
+    }
+    if (waitFor(fd_, false, waitMs) <= 0) return true;
+
+    for (size_t n = 0; n < BURST; ++n) {
+        sockaddr_in sa{};
+        socklen_t len = sizeof(sa);
+        const ssize_t got = ::recvfrom(fd_, buffer_.data(), buffer_.size(), 0,
+                                       reinterpret_cast<sockaddr*>(&sa), &len);
+        if (got < 0) break;
+        const uint64_t now = nowUs();
+
+        Datagram d;
+        if (!decodeDatagram(buffer_.data(), static_cast<size_t>(got), d)) continue;
+
+        // The first sender is the peer, others are ignored
+        if (state_ == State::Listening) {
+            if (d.id < 0) continue;
+            peerAddr_ = sa.sin_addr.s_addr;
+            peerPort_ = sa.sin_port;
+            char ip[INET_ADDRSTRLEN] = {};
+            inet_ntop(AF_INET, &sa.sin_addr, ip, sizeof(ip));
+            result_.peerAddr = std::string(ip) + ":" + std::to_string(ntohs(sa.sin_port));
+            start(now);
+        } else if (sa.sin_addr.s_addr != peerAddr_ || sa.sin_port != peerPort_) {
+            continue;
+        }
+
+        if (d.id < 0) {
+            // Final datagram, answered with the report, repeats are answered again for a while
+            if (state_ == State::Running) {
+                finish(now);
+                report_.bytes = result_.bytes;
+                report_.durationMs = result_.durationMs;
+                report_.datagrams = stats_.expected();
+                report_.lost = stats_.lost();
+                report_.outOfOrder = stats_.outOfOrder();
+                report_.jitterUs = stats_.jitterUs();
+                state_ = State::Finishing;
+            }
+            deadlineUs_ = now + 2 * FIN_WAIT_MS * 1000ULL;
+            uint8_t out[REPORT_LENGTH];
+            encodeReport(d, report_, out);
+            (void)::sendto(fd_, out, sizeof(out), 0, reinterpret_cast<sockaddr*>(&sa), len);
+            continue;
+        }
+        if (state_ != State::Running) continue;
+
+        const int64_t sentUs = static_cast<int64_t>(d.sec) * 1000000 + d.usec;
+        stats_.add(d.id, sentUs, static_cast<int64_t>(now));
+        result_.datagrams++;
+        intervalDatagrams_++;
+        account(static_cast<uint64_t>(got), now);
+    }
+    return true;
+}
+
+void NetBenchManager::UdpStats::add(int32_t id, int64_t sentUs, int64_t arrivalUs) {
+    // Clocks of both ends differ by a constant, it cancels out in the difference
+    const int64_t transit = arrivalUs - sentUs;
+    if (received_) {
+        const int64_t d = transit > lastTransit_ ? transit - lastTransit_ : lastTransit_ - transit;
+        jitter16_ += d - ((jitter16_ + 8) >> 4);
+    }
+    lastTransit_ = transit;
+    received_++;
+
+    if (id > maxId_) {
+        if (id > maxId_ + 1) lost_ += static_cast<uint32_t>(id - maxId_ - 1);
+        maxId_ = id;
+    } else {
+        // Counted lost when the gap was seen
+        outOfOrder_++;
+        if (lost_) lost_--;
+    }
+}
+
+void NetBenchManager::encodeDatagram(const Datagram& d, uint8_t* out) {
+    put32(out, static_cast<uint32_t>(d.id));
+    put32(out + 4, d.sec);
+    put32(out + 8, d.usec);
+}
+
+bool NetBenchManager::decodeDatagram(const uint8_t* data, size_t len, Datagram& out) {
+    if (len < DATAGRAM_HEADER) return false;
+    out.id = static_cast<int32_t>(get32(data));
+    out.sec = get32(data + 4);
+    out.usec = get32(data + 8);
+    return true;
+}
+
+size_t NetBenchManager::encodeReport(const Datagram& fin, const Report& report, uint8_t* out) {
+    std::memset(out, 0, REPORT_LENGTH);
+    encodeDatagram(fin, out);
+    uint8_t* p = out + DATAGRAM_HEADER;
+    put32(p, REPORT_VERSION1);
+    put32(p + 4, static_cast<uint32_t>(report.bytes >> 32));
+    put32(p + 8, static_cast<uint32_t>(report.bytes));
+    put32(p + 12, report.durationMs / 1000);
+    put32(p + 16, (report.durationMs % 1000) * 1000);
+    put32(p + 20, report.lost);
+    put32(p + 24, report.outOfOrder);
+    put32(p + 28, report.datagrams);
+    put32(p + 32, report.jitterUs / 1000000);
+    put32(p + 36, report.jitterUs % 1000000);
+    return REPORT_LENGTH;
+}
+
+bool NetBenchManager::decodeReport(const uint8_t* data, size_t len, Report& out) {
+    // iperf 2.0 puts the report after a 12 byte datagram header, later versions after 16
+    size_t base = 0;
+    for (size_t header : {DATAGRAM_HEADER, DATAGRAM_HEADER + 4}) {
+        if (len >= header + 40 && (get32(data + header) & REPORT_VERSION1)) { base = header; break; }
+    }
+    if (!base) return false;
+
+    const uint8_t* p = data + base;
+    out.bytes = (static_cast<uint64_t>(get32(p + 4)) << 32) | get32(p + 8);
+    out.durationMs = get32(p + 12) * 1000 + get32(p + 16) / 1000;
+    out.lost = get32(p + 20);
+    out.outOfOrder = get32(p + 24);
+    out.datagrams = get32(p + 28);
+    out.jitterUs = get32(p + 32) * 1000000 + get32(p + 36);
+    return true;
+}
+
+float NetBenchManager::mbps(uint64_t bytes, uint32_t ms) {
+    return ms ? static_cast<float>(bytes) * 8.f / (ms * 1000.f) : 0.f;
+}
+
+const char* NetBenchManager::stateName(State state) {
+    switch (state) {
+        case State::Idle:       return "idle";
+        case State::Connecting: return "connecting";
+        case State::Listening:  return "listening";
+        case State::Running:    return "running";
+        case State::Finishing:  return "finishing";
+        case State::Done:       return "done";
+        case State::Failed:     return "failed";
+    }
+    return "";
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Network throughput benchmark over TCP or UDP, sending or receiving.
+
+Uses the iperf 2 wire format, so the other end can be iperf 2 or the host
+peer in tools/netbench_peer.py. A TCP sender writes zero filled buffers
+for the test duration. A UDP sender paces datagrams to the target
+bandwidth, each stamped with a sequence number and its send time, then
+repeats a negative sequence number until the receiver answers with its
+report (bytes, loss, out of order, jitter). The UDP receiver counts loss
+by sequence number and computes jitter as RFC 1889 does, from the
+transit time difference of consecutive datagrams, and answers the final
+datagram with that report. Throughput is kept per interval and for the
+whole run. Socket buffer sizes can be set, and the size the stack really
+applied is reported. Non-blocking sockets, stepped by the caller with
+select(). No Arduino dependency.
+*/
+class NetBenchManager {
+public:
+    enum class Protocol : uint8_t { Tcp, Udp };
+    enum class Role     : uint8_t { Send, Receive };
+    enum class State    : uint8_t { Idle, Connecting, Listening, Running, Finishing, Done, Failed };
+
+    static constexpr uint16_t DEFAULT_PORT    = 5001;   // iperf 2
+    static constexpr size_t   TCP_LENGTH      = 8192;
+    static constexpr size_t   UDP_LENGTH      = 1470;
+    static constexpr size_t   MAX_LENGTH      = 16384;
+    static constexpr size_t   DATAGRAM_HEADER = 12;     // id, tv_sec, tv_usec
+    static constexpr size_t   REPORT_LENGTH   = DATAGRAM_HEADER + 40;
+    static constexpr uint8_t  FIN_TRIES       = 10;
+    static constexpr uint32_t FIN_WAIT_MS     = 250;
+    static constexpr size_t   MAX_INTERVALS   = 16;     // oldest dropped when not taken
+
+    struct Config {
+        Protocol protocol   = Protocol::Tcp;
+        Role     role       = Role::Send;
+        uint16_t port       = DEFAULT_PORT;
+        uint32_t durationMs = 10000;        // sender, the receiver runs until the sender stops
+        uint32_t intervalMs = 1000;
+        size_t   length     = 0;            // write or datagram size, 0 for the protocol default
+        int      window     = 0;            // SO_SNDBUF / SO_RCVBUF, 0 keeps the stack default
+        uint32_t bandwidth  = 10000000;     // UDP sender, bit/s, 0 for as fast as the stack takes
+        bool     noDelay    = false;        // TCP_NODELAY
+        uint32_t connectTimeoutMs = 3000;
+    };
+
+    struct Datagram {
+        int32_t  id   = 0;      // negative on the last one
+        uint32_t sec  = 0;
+        uint32_t usec = 0;
+    };
+
+    // What a UDP receiver saw, sent back to the sender at the end
+    struct Report {
+        uint64_t bytes      = 0;
+        uint32_t durationMs = 0;
+        uint32_t datagrams  = 0;    // highest sequence number + 1
+        uint32_t lost       = 0;
+        uint32_t outOfOrder = 0;
+        uint32_t jitterUs   = 0;
+    };
+
+    // Loss by sequence number and RFC 1889 jitter, receiver side
+    class UdpStats {
+    public:
+        void add(int32_t id, int64_t sentUs, int64_t arrivalUs);
+
+        uint32_t received()   const { return received_; }
+        uint32_t expected()   const { return static_cast<uint32_t>(maxId_ + 1); }
+        uint32_t lost()       const { return lost_; }
+        uint32_t outOfOrder() const { return outOfOrder_; }
+        uint32_t jitterUs()   const { return static_cast<uint32_t>(jitter16_ >> 4); }
+
+    private:
+        int64_t  maxId_       = -1;
+        int64_t  lastTransit_ = 0;
+        int64_t  jitter16_    = 0;  // 16 * jitter, integer form of J += (|D| - J) / 16
+        uint32_t received_    = 0;
+        uint32_t lost_        = 0;
+        uint32_t outOfOrder_  = 0;
+    };
+
+    struct Interval {
+        uint32_t startMs    = 0;
+        uint32_t endMs      = 0;
+        uint64_t bytes      = 0;
+        uint32_t datagrams  = 0;
+        uint32_t lost       = 0;
+        uint32_t outOfOrder = 0;
+        uint32_t jitterUs   = 0;
+    };
+
+    struct Result {
+        uint64_t    bytes      = 0;
+        uint32_t    durationMs = 0;
+        uint32_t    datagrams  = 0;     // sent or received
+        uint32_t    sendErrors = 0;     // datagrams the stack refused, sent again later
+        uint32_t    lost       = 0;     // UDP receiver
+        uint32_t    outOfOrder = 0;
+        uint32_t    jitterUs   = 0;
+        bool        peerReport = false; // UDP sender got the receiver report
+        Report      peer;
+        int         window     = -1;    // buffer size in effect, -1 when the stack has no such option
+        std::string peerAddr;
+    };
+
+    NetBenchManager() = default;
+    ~NetBenchManager();
+    NetBenchManager(const NetBenchManager&) = delete;
+    NetBenchManager& operator=(const NetBenchManager&) = delete;
+
+    // host is needed by senders only, false with error() set when the socket cannot be set up
+    bool begin(const Config& config, const std::string& host = "");
+
+    // One select() round, false once done or failed
+    bool step(uint32_t maxWaitMs);
+
+    // Stops the run, what was measured so far is kept
+    void cancel();
+
+    bool takeInterval(Interval& out);
+
+    State              state()  const { return state_; }
+    const Result&      result() const { return result_; }
+    const std::string& error()  const { return error_; }
+    const Config&      config() const { return config_; }
+
+    static void encodeDatagram(const Datagram& d, uint8_t* out);
+    static bool decodeDatagram(const uint8_t* data, size_t len, Datagram& out);
+
+    // Receiver report after the final datagram, REPORT_LENGTH bytes
+    static size_t encodeReport(const Datagram& fin, const Report& report, uint8_t* out);
+    static bool   decodeReport(const uint8_t* data, size_t len, Report& out);
+
+    static float mbps(uint64_t bytes, uint32_t ms);
+    static const char* stateName(State state);
+
+private:
+    Config   config_;
+    State    state_ = State::Idle;
+    int      fd_       = -1;
+    int      listenFd_ = -1;
+    uint32_t peerAddr_ = 0;     // network byte order
+    uint16_t peerPort_ = 0;
+    std::vector<uint8_t> buffer_;
+    std::string error_;
+    Result   result_;
+
+    uint64_t startUs_    = 0;
+    uint64_t endUs_      = 0;
+    uint64_t deadlineUs_ = 0;   // connect, end of sending, next final datagram
+    uint64_t nextSendUs_ = 0;
+    uint64_t gapUs_      = 0;
+    int32_t  nextId_     = 0;
+    uint8_t  finTries_   = 0;
+    UdpStats stats_;
+    Report   report_;           // UDP receiver, kept to answer repeated final datagrams
+
+    // Current interval
+    uint64_t intervalUs_    = 0;
+    uint64_t intervalBytes_ = 0;
+    uint32_t intervalDatagrams_ = 0;
+    uint32_t intervalLost_  = 0;
+    uint32_t intervalOoo_   = 0;
+    std::deque<Interval> intervals_;
+
+    bool fail(const std::string& what);
+    bool openSocket(bool udp);
+    bool resolve(const std::string& host);
+    void applyOptions(int fd);
+    void start(uint64_t nowUs);
+    void finish(uint64_t nowUs);
+    void closeInterval(uint64_t nowUs);
+    void account(uint64_t bytes, uint64_t nowUs);
+    void closeSockets();
+
+    bool stepConnect(uint32_t waitMs, uint64_t nowUs);
+    bool stepAccept(uint32_t waitMs);
+    bool stepTcpSend(uint32_t waitMs, uint64_t nowUs);
+    bool stepTcpReceive(uint32_t waitMs);
+    bool stepUdpSend(uint32_t waitMs, uint64_t nowUs);
+    bool stepUdpReceive(uint32_t waitMs);
+    bool stepUdpFin(uint32_t waitMs, uint64_t nowUs);
+    void sendFin(uint64_t nowUs);
+
+    int  waitFor(int fd, bool write, uint32_t waitMs) const;
+    static uint64_t nowUs();
+};
@@ -0,0 +1,413 @@
+#include "NmapScanManager.h"
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+const char UDP_PROBE[] = "PING\n";
+}
+
+NmapScanManager::~NmapScanManager() {
+    cancel();
+}
+
+uint64_t NmapScanManager::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void NmapScanManager::begin(const Config& config, const std::vector<Target>& targets) {
+    cancel();
+    config_ = config;
+    window_ = std::min(std::max<size_t>(config.window, 1), MAX_WINDOW);
+    hosts_.clear();
+    hosts_.reserve(targets.size());
+    rr_ = total_ = done_ = peak_ = 0;
+
+    for (const auto& t : targets) {
+        Host h;
+        h.addr = t.addr;
+        h.ports = t.ports;
+        h.states.assign(t.ports.size(), State::Pending);
+        if (t.rttHintUs) sample(h, t.rttHintUs);
+        total_ += t.ports.size();
+        hosts_.push_back(std::move(h));
+    }
+
+    startUs_ = nowUs();
+    endUs_ = total_ ? 0 : startUs_;
+}
+
+void NmapScanManager::cancel() {
+    for (auto& p : probes_) ::close(p.fd);
+    probes_.clear();
+    for (auto& h : hosts_) h.inFlight = 0;
+    if (startUs_ && !endUs_) endUs_ = nowUs();
+}
+
+bool NmapScanManager::run(const std::function<bool()>& keepGoing) {
+    while (step(50)) {
+        if (keepGoing && !keepGoing()) {
+            cancel();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NmapScanManager::step(uint32_t maxWaitMs) {
+    fill(nowUs());
+    if (done_ >= total_) {
+        if (!endUs_) endUs_ = nowUs();
+        return false;
+    }
+    if (probes_.empty()) return true;
+
+    fd_set rfds, wfds, efds;
+    FD_ZERO(&rfds); FD_ZERO(&wfds); FD_ZERO(&efds);
+    int maxFd = -1;
+    uint64_t nextDeadline = UINT64_MAX;
+    for (const auto& p : probes_) {
+        if (config_.udp) {
+            FD_SET(p.fd, &rfds);
+        } else {
+            FD_SET(p.fd, &wfds);
+            FD_SET(p.fd, &efds);
+        }
+        maxFd = std::max(maxFd, p.fd);
+        nextDeadline = std::min(nextDeadline, deadlineUs(p));
+    }
+
+    // Until the first answer or the earliest timeout
+    uint64_t now = nowUs();
+    uint64_t waitUs = nextDeadline > now ? nextDeadline - now : 0;
+    waitUs = std::min<uint64_t>(waitUs, static_cast<uint64_t>(maxWaitMs) * 1000);
+    timeval tv{};
+    tv.tv_sec = static_cast<long>(waitUs / 1000000);
+    tv.tv_usec = static_cast<long>(waitUs % 1000000);
+
+    const int rc = ::select(maxFd + 1,
+                            config_.udp ? &rfds : nullptr,
+                            config_.udp ? nullptr : &wfds,
+                            config_.udp ? nullptr : &efds, &tv);
+
+    now = nowUs();
+    for (size_t i = 0; i < probes_.size();) {
+        const Probe& p = probes_[i];
+        const bool ready = rc > 0 && (config_.udp ? FD_ISSET(p.fd, &rfds)
+                                                  : (FD_ISSET(p.fd, &wfds) || FD_ISSET(p.fd, &efds)));
+        if (check(probes_[i], ready, now)) {
+            probes_[i] = probes_.back();
+            probes_.pop_back();
+        } else {
+            ++i;
+        }
+    }
+
+    fill(nowUs());
+    if (done_ >= total_) {
+        if (!endUs_) endUs_ = nowUs();
+        return false;
+    }
+    return true;
+}
+
+void NmapScanManager::fill(uint64_t nowUs) {
+    while (probes_.size() < window_) {
+        size_t host;
+        uint16_t index;
+        uint8_t attempt;
+        if (!pick(host, index, attempt)) return;
+
+        if (!launch(host, index, attempt, nowUs)) {
+            // Out of sockets, the window shrinks to what the stack can hold
+            if (probes_.empty()) {
+                finish(host, index, State::Error);
+            } else {
+                hosts_[host].retry.emplace_back(index, attempt);
+                window_ = probes_.size();
+            }
+            return;
+        }
+    }
+}
+
+bool NmapScanManager::pick(size_t& host, uint16_t& index, uint8_t& attempt) {
+    size_t active = 0;
+    for (const auto& h : hosts_) {
+        if (h.inFlight || !h.retry.empty() || h.next < h.ports.size()) active++;
+    }
+    if (active == 0) return false;
+
+    // Even share of the window, a slow host cannot hold all of it
+    const size_t share = std::max<size_t>(1, (window_ + active - 1) / active);
+    for (size_t n = 0; n < hosts_.size(); ++n) {
+        const size_t h = (rr_ + n) % hosts_.size();
+        Host& hs = hosts_[h];
+        if (hs.inFlight >= share) continue;
+
+        if (!hs.retry.empty()) {
+            index = hs.retry.back().first;
+            attempt = hs.retry.back().second;
+            hs.retry.pop_back();
+        } else if (hs.next < hs.ports.size()) {
+            index = static_cast<uint16_t>(hs.next++);
+            attempt = 0;
+        } else {
+            continue;
+        }
+        host = h;
+        rr_ = h + 1;
+        return true;
+    }
+    return false;
+}
+
+bool NmapScanManager::launch(size_t host, uint16_t index, uint8_t attempt, uint64_t nowUs) {
+    Host& hs = hosts_[host];
+    const int fd = config_.udp ? ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)
+                               : ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) return false;
+        finish(host, index, State::Error);
+        return true;
+    }
+    if (fd >= FD_SETSIZE) {
+        ::close(fd);
+        return false;
+    }
+
+    int nb = 1;
+    ioctl(fd, FIONBIO, &nb);
+    if (!config_.udp) {
+        // Reset on close, no TIME_WAIT left behind for each open port
+        linger lg{};
+        lg.l_onoff = 1;
+        lg.l_linger = 0;
+        (void)setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    }
+
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(hs.ports[index]);
+    sa.sin_addr.s_addr = hs.addr;
+
+    hs.probes++;
+    const int rc = ::connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+    if (config_.udp) {
+        if (rc < 0 || ::send(fd, UDP_PROBE, sizeof(UDP_PROBE) - 1, 0) < 0) {
+            const int e = errno;
+            ::close(fd);
+            if (e == ECONNREFUSED) finish(host, index, State::Closed);
+            else if (e == EHOSTUNREACH || e == ENETUNREACH) finish(host, index, State::OpenFiltered);
+            else finish(host, index, State::Error);
+            return true;
+        }
+    } else if (rc == 0) {
+        ::close(fd);
+        finish(host, index, State::Open);
+        return true;
+    } else if (errno != EINPROGRESS && errno != EALREADY) {
+        const int e = errno;
+        ::close(fd);
+        finish(host, index, tcpState(e));
+        return true;
+    }
+
+    Probe p;
+    p.fd = fd;
+    p.host = static_cast<uint16_t>(host);
+    p.index = index;
+    p.attempt = attempt;
+    p.sentUs = nowUs;
+    probes_.push_back(p);
+    hs.inFlight++;
+    peak_ = std::max(peak_, probes_.size());
+    return true;
+}
+
+bool NmapScanManager::check(Probe& p, bool ready, uint64_t nowUs) {
+    Host& hs = hosts_[p.host];
+
+    if (ready) {
+        State state = State::Pending;
+        if (config_.udp) {
+            uint8_t buf[64];
+            const ssize_t n = ::recv(p.fd, buf, sizeof(buf), 0);
+            const int e = errno;
+            if (n >= 0 || e == EMSGSIZE) state = State::Open;
+            else if (e == ECONNREFUSED) state = State::Closed;        // ICMP port unreachable
+            else if (e == EHOSTUNREACH || e == ENETUNREACH) state = State::OpenFiltered;
+            else if (e != EAGAIN && e != EWOULDBLOCK) state = State::Error;
+        } else {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            state = getsockopt(p.fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 ? State::Error : tcpState(err);
+        }
+
+        if (state != State::Pending) {
+            // Karn: only unambiguous answers time the path
+            if (p.attempt == 0 && (state == State::Open || state == State::Closed)) sample(hs, nowUs - p.sentUs);
+            ::close(p.fd);
+            hs.inFlight--;
+            finish(p.host, p.index, state);
+            return true;
+        }
+    }
+
+    if (nowUs < deadlineUs(p)) return false;
+
+    ::close(p.fd);
+    hs.inFlight--;
+    hs.timeouts++;
+    if (p.attempt < config_.retries) hs.retry.emplace_back(p.index, p.attempt + 1);
+    else finish(p.host, p.index, config_.udp ? State::OpenFiltered : State::Filtered);
+    return true;
+}
+
+void NmapScanManager::finish(size_t host, uint16_t index, State state) {
+    Host& hs = hosts_[host];
+    if (hs.states[index] != State::Pending) return;
+    hs.states[index] = state;
+    hs.done++;
+    done_++;
+}
+
+void NmapScanManager::sample(Host& h, uint64_t rttUs) {
+    const uint32_t r = static_cast<uint32_t>(std::min<uint64_t>(rttUs, 10000000));
+    if (h.samples == 0) {
+        h.srttUs = r;
+        h.rttvarUs = r / 2;
+    } else {
+        const uint32_t diff = h.srttUs > r ? h.srttUs - r : r - h.srttUs;
+        h.rttvarUs = (3 * h.rttvarUs + diff) / 4;
+        h.srttUs = (7 * h.srttUs + r) / 8;
+    }
+    h.samples++;
+}
+
+uint64_t NmapScanManager::timeoutUs(const Host& h, uint8_t attempt) const {
+    const uint64_t minUs = static_cast<uint64_t>(config_.minTimeoutMs) * 1000;
+    const uint64_t maxUs = static_cast<uint64_t>(std::max(config_.maxTimeoutMs, config_.minTimeoutMs)) * 1000;
+    uint64_t t = h.samples ? h.srttUs + 4ull * h.rttvarUs
+                           : static_cast<uint64_t>(config_.initialTimeoutMs) * 1000;
+
+    // Doubled for each retry of the same port
+    t <<= std::min<uint8_t>(attempt, 4);
+    return std::min(std::max(t, minUs), maxUs);
+}
+
+uint64_t NmapScanManager::deadlineUs(const Probe& p) const {
+    // Follows the host timeout, probes sent before the first answers benefit too
+    return p.sentUs + timeoutUs(hosts_[p.host], p.attempt);
+}
+
+NmapScanManager::State NmapScanManager::tcpState(int err) {
+    switch (err) {
+        case 0:
+            return State::Open;
+        case ECONNREFUSED:
+        case ECONNRESET:
+            return State::Closed;                                        // RST
+        case ETIMEDOUT:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case EACCES:
+        case EPERM:
+            return State::Filtered;                                      // dropped or blocked
+        default:
+            return State::Error;
+    }
+}
+
+uint32_t NmapScanManager::elapsedMs() const {
+    if (!startUs_) return 0;
+    return static_cast<uint32_t>(((endUs_ ? endUs_ : nowUs()) - startUs_) / 1000);
+}
+
+float NmapScanManager::portsPerSecond() const {
+    if (!startUs_) return 0.f;
+    const uint64_t us = (endUs_ ? endUs_ : nowUs()) - startUs_;
+    return us ? done_ * 1e6f / us : 0.f;
+}
+
+const char* NmapScanManager::stateName(State state) {
+    switch (state) {
+        case State::Open:         return "open";
+        case State::Closed:       return "closed";
+        case State::Filtered:     return "filtered";
+        case State::OpenFiltered: return "open|filtered";
+        case State::Error:        return "error";
+        case State::Pending:      break;
+    }
+    return "unknown";
+}
+
+bool NmapScanManager::expandHosts(const std::string& spec, std::vector<uint32_t>& out, size_t max) {
+    out.clear();
+    std::unordered_set<uint32_t> seen;
+
+    auto parseIp = [](const std::string& s, uint32_t& ip) {
+        in_addr a{};
+        if (inet_pton(AF_INET, s.c_str(), &a) != 1) return false;
+        ip = ntohl(a.s_addr);
+        return true;
+    };
+    auto parseNumber = [](const std::string& s, long lo, long hi, long& value) {
+        if (s.empty()) return false;
+        char* end = nullptr;
+        value = std::strtol(s.c_str(), &end, 10);
+        return *end == '\0' && value >= lo && value <= hi;
+    };
+    auto addRange = [&](uint32_t first, uint32_t last) {
+        if (last - first >= max - out.size()) return false;
+        for (uint32_t ip = first;; ++ip) {
+            if (seen.insert(ip).second) out.push_back(htonl(ip));
+            if (ip == last) break;
+        }
+        return true;
+    };
+
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string item = spec.substr(start, comma - start);
+        start = comma + 1;
+        if (item.empty()) continue;
+
+        uint32_t ip = 0;
+        long value = 0;
+        const size_t slash = item.find('/');
+        const size_t dash = item.find('-');
+
+        if (slash != std::string::npos) {
+            // Network, without its network and broadcast addresses
+            if (!parseIp(item.substr(0, slash), ip) || !parseNumber(item.substr(slash + 1), 0, 32, value)) return false;
+            const uint32_t mask = value == 0 ? 0 : 0xFFFFFFFFu << (32 - value);
+            uint32_t first = ip & mask;
+            uint32_t last = first | ~mask;
+            if (value < 31) {
+                first++;
+                last--;
+            }
+            if (!addRange(first, last)) return false;
+        } else if (dash != std::string::npos) {
+            // Range of the last byte
+            if (!parseIp(item.substr(0, dash), ip) || !parseNumber(item.substr(dash + 1), 0, 255, value)) return false;
+            if (static_cast<uint32_t>(value) < (ip & 0xFF)) return false;
+            if (!addRange(ip, (ip & 0xFFFFFF00u) | static_cast<uint32_t>(value))) return false;
+        } else {
+            if (!parseIp(item, ip) || !addRange(ip, ip)) return false;
+        }
+    }
+    return !out.empty();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/*
+Concurrent TCP connect / UDP port scanner.
+
+A window of non-blocking sockets is kept in flight and multiplexed with
+select(), so filtered ports wait for their timeout together instead of
+one after the other. Each host has its own timeout, smoothed RTT plus
+four times its variance as TCP does, fed by the ports that answered
+(open or closed) on their first probe. Several hosts are scanned at the
+same time, the window is shared by the hosts that still have ports to
+probe. Plain BSD sockets, runs over lwIP as well as on a desktop.
+No Arduino dependency.
+*/
+class NmapScanManager {
+public:
+    static constexpr size_t MAX_WINDOW = 64;
+    static constexpr size_t MAX_HOSTS  = 256;
+
+    enum class State : uint8_t { Pending, Open, Closed, Filtered, OpenFiltered, Error };
+
+    struct Config {
+        bool     udp              = false;
+        size_t   window           = 8;      // sockets in flight
+        uint32_t initialTimeoutMs = 600;    // until the first RTT sample
+        uint32_t minTimeoutMs     = 100;
+        uint32_t maxTimeoutMs     = 1500;
+        uint8_t  retries          = 0;      // new probes of a port that timed out
+    };
+
+    struct Target {
+        uint32_t              addr = 0;     // network byte order
+        std::vector<uint16_t> ports;
+        uint32_t              rttHintUs = 0; // ping round trip, first RTT sample if known
+    };
+
+    struct Host {
+        uint32_t              addr = 0;
+        std::vector<uint16_t> ports;
+        std::vector<State>    states;
+        uint32_t srttUs    = 0;
+        uint32_t rttvarUs  = 0;
+        uint32_t samples   = 0;
+        uint32_t probes    = 0;
+        uint32_t timeouts  = 0;
+        size_t   done      = 0;
+
+        // Scheduling
+        size_t   next      = 0;
+        size_t   inFlight  = 0;
+        std::vector<std::pair<uint16_t, uint8_t>> retry;  // port index, attempt
+    };
+
+    NmapScanManager() = default;
+    ~NmapScanManager();
+    NmapScanManager(const NmapScanManager&) = delete;
+    NmapScanManager& operator=(const NmapScanManager&) = delete;
+
+    void begin(const Config& config, const std::vector<Target>& targets);
+
+    // One select() round, false once every port has a state
+    bool step(uint32_t maxWaitMs);
+
+    // Until done or keepGoing() returns false, true when done
+    bool run(const std::function<bool()>& keepGoing = nullptr);
+
+    void cancel();
+
+    const std::vector<Host>& hosts() const { return hosts_; }
+    uint32_t timeoutMs(size_t host, uint8_t attempt = 0) const { return timeoutUs(hosts_[host], attempt) / 1000; }
+    size_t   portsTotal()   const { return total_; }
+    size_t   portsDone()    const { return done_; }
+    size_t   window()       const { return window_; }
+    size_t   peakInFlight() const { return peak_; }
+    uint32_t elapsedMs()    const;
+    float    portsPerSecond() const;
+
+    static const char* stateName(State state);
+
+    // Round trip of a first probe answer, smoothed as TCP does (RFC 6298)
+    static void sample(Host& host, uint64_t rttUs);
+
+    // "10.0.0.1", "10.0.0.1-20" (last byte), "10.0.0.0/24", comma separated, network byte order
+    static bool expandHosts(const std::string& spec, std::vector<uint32_t>& out, size_t max = MAX_HOSTS);
+
+private:
+    struct Probe {
+        int      fd      = -1;
+        uint16_t host    = 0;
+        uint16_t index   = 0;
+        uint8_t  attempt = 0;
+        uint64_t sentUs  = 0;
+    };
+
+    Config             config_;
+    std::vector<Host>  hosts_;
+    std::vector<Probe> probes_;
+    size_t   window_  = 0;
+    size_t   rr_      = 0;
+    size_t   total_   = 0;
+    size_t   done_    = 0;
+    size_t   peak_    = 0;
+    uint64_t startUs_ = 0;
+    uint64_t endUs_   = 0;
+
+    void fill(uint64_t nowUs);
+    bool pick(size_t& host, uint16_t& index, uint8_t& attempt);
+    bool launch(size_t host, uint16_t index, uint8_t attempt, uint64_t nowUs);
+    bool check(Probe& probe, bool ready, uint64_t nowUs);
+    void finish(size_t host, uint16_t index, State state);
+    uint64_t timeoutUs(const Host& host, uint8_t attempt) const;
+    uint64_t deadlineUs(const Probe& probe) const;
+
+    static uint64_t nowUs();
+    static State tcpState(int err);
+};
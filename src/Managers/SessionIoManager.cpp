@@ -0,0 +1,82 @@
+#include "SessionIoManager.h"
+#include <algorithm>
+
+void SessionIoManager::begin(Sender sender, Receiver receiver, uint32_t idleMs, size_t flushSize) {
+    sender_ = std::move(sender);
+    receiver_ = std::move(receiver);
+    idleMs_ = idleMs;
+    flushSize_ = std::min(std::max<size_t>(flushSize, 1), TX_CAPACITY);
+    reset();
+    tx_.reserve(TX_CAPACITY);
+}
+
+void SessionIoManager::reset() {
+    tx_.clear();
+    lastMs_ = 0;
+    failed_ = closed_ = false;
+    sends_ = reads_ = 0;
+    bytesOut_ = bytesIn_ = 0;
+}
+
+bool SessionIoManager::write(const char* data, size_t len, uint32_t nowMs) {
+    if (failed_) return false;
+
+    bool newline = false;
+    for (size_t i = 0; i < len; ++i) {
+        if (tx_.size() >= TX_CAPACITY && !flush()) return false;
+        tx_.push_back(data[i]);
+        if (data[i] == '\n') newline = true;
+    }
+    lastMs_ = nowMs;
+
+    if (newline || tx_.size() >= flushSize_) return flush();
+    return true;
+}
+
+bool SessionIoManager::poll(uint32_t nowMs) {
+    if (failed_) return false;
+    if (tx_.empty() || idleMs_ == 0 || nowMs - lastMs_ < idleMs_) return true;
+    return flush();
+}
+
+bool SessionIoManager::flush() {
+    if (failed_) return false;
+
+    size_t off = 0;
+    while (off < tx_.size()) {
+        const int n = sender_ ? sender_(tx_.data() + off, tx_.size() - off) : -1;
+        if (n <= 0) {
+            // The session is gone, what is queued cannot be delivered
+            failed_ = true;
+            tx_.clear();
+            return false;
+        }
+        off += static_cast<size_t>(n);
+        bytesOut_ += static_cast<size_t>(n);
+        sends_++;
+    }
+    tx_.clear();
+    return true;
+}
+
+size_t SessionIoManager::drain(std::string& out) {
+    if (!receiver_ || closed_) return 0;
+
+    size_t total = 0;
+    while (total < RX_MAX_POLL) {
+        const size_t base = out.size();
+        out.resize(base + RX_CHUNK);
+        const int n = receiver_(&out[base], RX_CHUNK);
+        out.resize(base + (n > 0 ? static_cast<size_t>(n) : 0));
+
+        if (n < 0) closed_ = true;
+        if (n <= 0) break;
+        total += static_cast<size_t>(n);
+        reads_++;
+
+        // Short read, nothing more waiting
+        if (static_cast<size_t>(n) < RX_CHUNK) break;
+    }
+    bytesIn_ += total;
+    return total;
+}
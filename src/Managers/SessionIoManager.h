@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/*
+Buffered I/O for the interactive network sessions (netcat, telnet, SSH).
+
+Keystrokes are queued and sent together: at once on a newline, when the
+queue reaches flushSize, or once no key came for idleMs (0 keeps bytes
+until a newline or the size limit, netcat line mode). A pasted script
+goes out in a few segments instead of one per byte.
+
+Reads drain what the transport has in chunks appended to a string the
+caller keeps between polls, so its capacity is reused and the terminal
+gets one print per poll. The transport is two callbacks, no Arduino
+dependency.
+*/
+class SessionIoManager {
+public:
+    // Bytes taken (all of them for a blocking transport), <= 0 on error
+    using Sender   = std::function<int(const char* data, size_t len)>;
+    // Bytes read, 0 when nothing is waiting, < 0 when closed or on error
+    using Receiver = std::function<int(char* buf, size_t cap)>;
+
+    static constexpr size_t   TX_CAPACITY   = 1024;
+    static constexpr size_t   TX_FLUSH_SIZE = 512;
+    static constexpr uint32_t TX_IDLE_MS    = 15;
+    static constexpr size_t   RX_CHUNK      = 512;
+    static constexpr size_t   RX_MAX_POLL   = 4096;   // per drain, the terminal keeps up
+
+    void begin(Sender sender, Receiver receiver, uint32_t idleMs = TX_IDLE_MS, size_t flushSize = TX_FLUSH_SIZE);
+    void reset();
+
+    // Queue bytes, sent when a flush condition is met; false once the transport failed
+    bool write(char c, uint32_t nowMs) { return write(&c, 1, nowMs); }
+    bool write(const char* data, size_t len, uint32_t nowMs);
+
+    // Idle timer, call from the session loop
+    bool poll(uint32_t nowMs);
+    bool flush();
+
+    // Append what the transport has (up to RX_MAX_POLL) to out, returns the byte count
+    size_t drain(std::string& out);
+
+    bool     failed()   const { return failed_; }
+    bool     closed()   const { return closed_; }
+    size_t   pending()  const { return tx_.size(); }
+    uint32_t sends()    const { return sends_; }
+    uint64_t bytesOut() const { return bytesOut_; }
+    uint32_t reads()    const { return reads_; }
+    uint64_t bytesIn()  const { return bytesIn_; }
+
+private:
+    Sender      sender_;
+    Receiver    receiver_;
+    std::string tx_;
+    uint32_t idleMs_    = TX_IDLE_MS;
+    size_t   flushSize_ = TX_FLUSH_SIZE;
+    uint32_t lastMs_    = 0;
+    bool     failed_    = false;
+    bool     closed_    = false;
+    uint32_t sends_     = 0;
+    uint64_t bytesOut_  = 0;
+    uint32_t reads_     = 0;
+    uint64_t bytesIn_   = 0;
+};
@@ -0,0 +1,395 @@
+#include "SignalLibraryManager.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+
+/*
+Catalog file
+*/
+bool SignalLibraryManager::load(const std::string& text) {
+    entries_.clear();
+    dirty_ = false;
+
+    size_t pos = 0;
+    bool header = false;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        if (!header) {
+            if (line != HEADER) { dirty_ = true; return false; }
+            header = true;
+            continue;
+        }
+        if (line.empty()) continue;
+
+        // kind size mtime hash freq bits duration signals protocol file
+        std::vector<std::string> f;
+        size_t start = 0;
+        while (true) {
+            size_t tab = line.find('\t', start);
+            f.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+            if (tab == std::string::npos) break;
+            start = tab + 1;
+        }
+        if (f.size() != 10 || f[0].size() != 1 || f[9].empty()) continue;
+
+        Entry e;
+        e.kind        = f[0][0] == 'I' ? Kind::Infrared : Kind::SubGhz;
+        e.size        = strtoul(f[1].c_str(), nullptr, 10);
+        e.mtime       = strtoul(f[2].c_str(), nullptr, 10);
+        e.hash        = strtoul(f[3].c_str(), nullptr, 16);
+        e.frequencyHz = strtoul(f[4].c_str(), nullptr, 10);
+        e.bits        = static_cast<uint16_t>(strtoul(f[5].c_str(), nullptr, 10));
+        e.durationUs  = strtoul(f[6].c_str(), nullptr, 10);
+        e.signals     = static_cast<uint16_t>(strtoul(f[7].c_str(), nullptr, 10));
+        e.protocol    = f[8];
+        e.file        = f[9];
+        entries_.push_back(std::move(e));
+    }
+
+    if (!header) dirty_ = true;
+    return header;
+}
+
+std::string SignalLibraryManager::serialize() const {
+    std::string out;
+    out.reserve(32 + entries_.size() * 64);
+    out += HEADER;
+    out += '\n';
+
+    char buf[96];
+    for (const auto& e : entries_) {
+        snprintf(buf, sizeof(buf), "%c\t%lu\t%lu\t%08lx\t%lu\t%u\t%lu\t%u\t",
+                 e.kind == Kind::Infrared ? 'I' : 'S',
+                 (unsigned long)e.size, (unsigned long)e.mtime, (unsigned long)e.hash,
+                 (unsigned long)e.frequencyHz, (unsigned)e.bits,
+                 (unsigned long)e.durationUs, (unsigned)e.signals);
+        out += buf;
+        out += e.protocol;
+        out += '\t';
+        out += e.file;
+        out += '\n';
+    }
+    return out;
+}
+
+/*
+Refresh
+*/
+size_t SignalLibraryManager::refresh(const std::vector<FileStat>& files, const Reader& read) {
+    std::unordered_map<std::string, size_t> known;
+    known.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) known[entries_[i].file] = i;
+
+    std::vector<Entry> next;
+    next.reserve(files.size());
+    size_t changed = 0;
+    size_t seen = 0;    // catalog entries still backed by a file
+
+    for (const auto& f : files) {
+        Kind kind;
+        if (!kindOf(f.name, kind)) continue;
+
+        // Unchanged file, the catalog entry is reused as is
+        auto it = known.find(f.name);
+        if (it != known.end()) {
+            seen++;
+            const Entry& old = entries_[it->second];
+            if (old.kind == kind && old.size == f.size && old.mtime == f.mtime) {
+                next.push_back(old);
+                continue;
+            }
+        }
+
+        // New or modified file
+        beginFile(kind);
+        bool ok = read && read(f.name, [this](const uint8_t* data, size_t len) {
+            feed(data, len);
+            return true;
+        });
+        if (!ok) continue;
+
+        Entry e;
+        endFile(e);
+        e.file  = f.name;
+        e.size  = f.size;
+        e.mtime = f.mtime;
+        next.push_back(std::move(e));
+        changed++;
+    }
+
+    // Removed files
+    changed += entries_.size() - seen;
+
+    std::sort(next.begin(), next.end(), [](const Entry& a, const Entry& b) { return a.file < b.file; });
+    entries_.swap(next);
+    if (changed) dirty_ = true;
+    return changed;
+}
+
+size_t SignalLibraryManager::sync(const Storage& storage) {
+    std::string catalog;
+    if (storage.readAll && storage.readAll(INDEX_PATH, catalog)) {
+        load(catalog);
+    } else {
+        entries_.clear();
+        dirty_ = false;
+    }
+
+    const size_t changed = refresh(storage.list ? storage.list() : std::vector<FileStat>{}, storage.read);
+
+    if (dirty_ && storage.write && storage.write(INDEX_PATH, serialize())) {
+        dirty_ = false;
+    }
+    return changed;
+}
+
+/*
+Listing
+*/
+std::vector<size_t> SignalLibraryManager::filter(Kind kind, const std::string& query, bool hideDuplicates) const {
+    std::vector<size_t> out;
+    const std::string q = lower(query);
+
+    // A number is also matched against the frequency in MHz
+    const bool numeric = !q.empty() && std::all_of(q.begin(), q.end(), [](char c) { return c >= '0' && c <= '9'; });
+    const uint32_t mhz = numeric ? strtoul(q.c_str(), nullptr, 10) : 0;
+
+    std::unordered_set<uint64_t> seen;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& e = entries_[i];
+        if (e.kind != kind) continue;
+
+        if (!q.empty()) {
+            bool match = lower(e.file).find(q) != std::string::npos ||
+                         lower(e.protocol).find(q) != std::string::npos;
+            if (!match && numeric && kind == Kind::SubGhz) match = e.frequencyHz / 1000000 == mhz;
+            if (!match) continue;
+        }
+
+        // Only matches are deduplicated, a copy outside the query must not hide one inside it
+        if (hideDuplicates && !seen.insert(contentKey(e)).second) continue;
+        out.push_back(i);
+    }
+    return out;
+}
+
+size_t SignalLibraryManager::duplicateCount(Kind kind) const {
+    std::unordered_set<uint64_t> seen;
+    size_t dups = 0;
+    for (const auto& e : entries_) {
+        if (e.kind != kind) continue;
+        if (!seen.insert(contentKey(e)).second) dups++;
+    }
+    return dups;
+}
+
+std::string SignalLibraryManager::summary(const Entry& e) {
+    std::string s = e.file + "  [" + (e.protocol.empty() ? "Unknown" : e.protocol) + "]";
+    char buf[32];
+
+    if (e.frequencyHz) {
+        if (e.kind == Kind::SubGhz) snprintf(buf, sizeof(buf), " %.2fMHz", e.frequencyHz / 1e6);
+        else                        snprintf(buf, sizeof(buf), " %lukHz", (unsigned long)(e.frequencyHz / 1000));
+        s += buf;
+    }
+    if (e.bits) s += " bits=" + std::to_string(e.bits);
+    if (e.durationUs) {
+        snprintf(buf, sizeof(buf), " %.2fs", e.durationUs / 1e6);
+        s += buf;
+    }
+    if (e.kind == Kind::Infrared) s += " cmds=" + std::to_string(e.signals);
+    return s;
+}
+
+bool SignalLibraryManager::kindOf(const std::string& fileName, Kind& kind) {
+    auto endsWith = [&](const char* ext, size_t n) {
+        if (fileName.size() <= n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::tolower((unsigned char)fileName[fileName.size() - n + i]) != ext[i]) return false;
+        }
+        return true;
+    };
+    if (endsWith(".sub", 4)) { kind = Kind::SubGhz;   return true; }
+    if (endsWith(".ir", 3))  { kind = Kind::Infrared; return true; }
+    return false;
+}
+
+/*
+Indexing, one pass over the file with a few bytes of state
+*/
+void SignalLibraryManager::beginFile(Kind kind) {
+    st_ = IndexState{};
+    st_.kind = kind;
+    st_.entry.kind = kind;
+    st_.key.reserve(MAX_KEY);
+    st_.value.reserve(MAX_VALUE);
+}
+
+void SignalLibraryManager::feed(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        const char c = static_cast<char>(data[i]);
+        hashChar(c);
+
+        switch (st_.state) {
+            case State::Key:
+                keyChar(c);
+                break;
+
+            case State::Value:
+                if (c == '\n') { endValue(); st_.state = State::Key; }
+                else if (st_.value.size() < MAX_VALUE) st_.value.push_back(c);
+                break;
+
+            case State::Numbers:
+                numberChar(c);
+                break;
+
+            case State::Skip:
+                if (c == '\n') st_.state = State::Key;
+                break;
+        }
+    }
+}
+
+void SignalLibraryManager::endFile(Entry& out) {
+    if (st_.state == State::Value) endValue();
+    if (st_.state == State::Numbers) endNumber();
+    if (st_.lineContent && !st_.lineComment) {
+        st_.hash = (st_.hash ^ '\n') * FNV_PRIME;
+    }
+
+    Entry& e = st_.entry;
+    if (st_.kind == Kind::SubGhz) e.signals = 1;
+    e.durationUs = st_.durationUs > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(st_.durationUs);
+    e.hash = st_.hash;
+    out = e;
+}
+
+void SignalLibraryManager::hashChar(char c) {
+    // '\r', comment lines, blank lines and leading blanks do not change the hash
+    if (c == '\r') return;
+    if (c == '\n') {
+        if (st_.lineContent && !st_.lineComment) st_.hash = (st_.hash ^ '\n') * FNV_PRIME;
+        st_.lineStart = true;
+        st_.lineComment = false;
+        st_.lineContent = false;
+        return;
+    }
+    if (st_.lineStart) {
+        if (c == ' ' || c == '\t') return;
+        st_.lineStart = false;
+        st_.lineComment = (c == '#');
+    }
+    if (st_.lineComment) return;
+
+    st_.lineContent = true;
+    st_.hash = (st_.hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+}
+
+void SignalLibraryManager::keyChar(char c) {
+    if (c == '\n') { st_.key.clear(); return; }
+    if (c != ':') {
+        if (st_.key.size() >= MAX_KEY) { st_.key.clear(); st_.state = State::Skip; return; }
+        st_.key.push_back(c);
+        return;
+    }
+
+    trim(st_.key);
+    const bool numbers = st_.kind == Kind::SubGhz ? iequals(st_.key, "RAW_Data") : iequals(st_.key, "data");
+    if (numbers) {
+        st_.inNumber = false;
+        st_.state = State::Numbers;
+        st_.key.clear();
+        return;
+    }
+
+    st_.value.clear();
+    st_.state = State::Value;
+}
+
+void SignalLibraryManager::endValue() {
+    std::string& key = st_.key;
+    std::string& val = st_.value;
+    trim(val);
+    Entry& e = st_.entry;
+
+    if (st_.kind == Kind::SubGhz) {
+        if (iequals(key, "Frequency")) {
+            if (!e.frequencyHz) e.frequencyHz = strtoul(val.c_str(), nullptr, 10);
+        } else if (iequals(key, "Protocol")) {
+            setProtocol(val);
+        } else if (iequals(key, "Bit")) {
+            if (!e.bits) e.bits = static_cast<uint16_t>(strtoul(val.c_str(), nullptr, 10));
+        }
+    } else {
+        if (iequals(key, "name")) {
+            if (e.signals < UINT16_MAX) e.signals++;
+        } else if (iequals(key, "type")) {
+            if (iequals(val, "raw")) setProtocol("RAW");
+        } else if (iequals(key, "protocol")) {
+            setProtocol(val);
+        } else if (iequals(key, "frequency")) {
+            if (!e.frequencyHz) e.frequencyHz = strtoul(val.c_str(), nullptr, 10);
+        }
+    }
+
+    key.clear();
+    val.clear();
+}
+
+void SignalLibraryManager::numberChar(char c) {
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        endNumber();
+        if (c == '\n') st_.state = State::Key;
+        return;
+    }
+    if (c == '-' || c == '+') return; // only the magnitude is summed
+    if (c < '0' || c > '9') return;
+
+    if (!st_.inNumber) { st_.inNumber = true; st_.number = 0; }
+    if (st_.number < UINT32_MAX) st_.number = st_.number * 10 + (c - '0');
+}
+
+void SignalLibraryManager::endNumber() {
+    if (!st_.inNumber) return;
+    st_.inNumber = false;
+    st_.durationUs += st_.number;
+}
+
+void SignalLibraryManager::setProtocol(const std::string& p) {
+    std::string& cur = st_.entry.protocol;
+    if (p.empty()) return;
+    if (cur.empty()) cur = p;
+    else if (!iequals(cur, p.c_str())) cur = "Mixed";
+}
+
+/*
+Helpers
+*/
+bool SignalLibraryManager::iequals(const std::string& a, const char* b) {
+    size_t i = 0;
+    for (; i < a.size() && b[i]; ++i) {
+        if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+    }
+    return i == a.size() && b[i] == '\0';
+}
+
+std::string SignalLibraryManager::lower(const std::string& s) {
+    std::string out(s);
+    for (auto& c : out) c = static_cast<char>(std::tolower((unsigned char)c));
+    return out;
+}
+
+void SignalLibraryManager::trim(std::string& s) {
+    size_t i = 0; while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) ++i;
+    size_t j = s.size(); while (j > i && (s[j-1] == ' ' || s[j-1] == '\t' || s[j-1] == '\r')) --j;
+    s.assign(s.begin() + i, s.begin() + j);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/*
+Catalog of the .sub and .ir captures stored on flash.
+
+One entry per file with what is needed to browse the library without
+parsing it again: protocol, frequency, bit count, total duration, signal
+count and a content hash. Files are indexed chunk by chunk, and only when
+their size or modification time changed since the last refresh.
+
+The catalog is a small text file, one tab separated line per entry. Storage
+is up to the caller (Storage callbacks, or reader callback and serialize()),
+the class has no Arduino dependency.
+*/
+class SignalLibraryManager {
+public:
+    enum class Kind : uint8_t { SubGhz, Infrared };
+
+    struct FileStat {
+        std::string name;       // file name in the library directory
+        uint32_t    size  = 0;
+        uint32_t    mtime = 0;
+    };
+
+    struct Entry {
+        std::string file;
+        Kind        kind = Kind::SubGhz;
+        std::string protocol;           // "Mixed" if the file holds several protocols
+        uint32_t    frequencyHz = 0;    // SubGHz frequency or IR carrier, first seen
+        uint16_t    bits        = 0;
+        uint32_t    durationUs  = 0;    // sum of the raw timings, 0 for decoded signals
+        uint16_t    signals     = 0;    // IR buttons, 1 for a .sub file
+        uint32_t    size        = 0;
+        uint32_t    mtime       = 0;
+        uint32_t    hash        = 0;    // FNV-1a of the content, comments and blank lines ignored
+    };
+
+    using ChunkSink = std::function<bool(const uint8_t* data, size_t len)>;
+    using Reader    = std::function<bool(const std::string& file, const ChunkSink& sink)>;
+
+    // Where the catalog and the captures live
+    struct Storage {
+        std::function<bool(const std::string& path, std::string& out)>        readAll;   // false if missing
+        std::function<bool(const std::string& path, const std::string& text)> write;
+        std::function<std::vector<FileStat>()>                                list;      // library files
+        Reader                                                                read;
+    };
+
+    static constexpr const char* INDEX_PATH = "/signals.idx";
+
+    // Catalog file, load() returns false (and starts empty) on an unknown format
+    bool load(const std::string& text);
+    std::string serialize() const;
+
+    // Sync with the files present, returns the number of entries added, updated or removed
+    size_t refresh(const std::vector<FileStat>& files, const Reader& read);
+
+    // Load the catalog, refresh it and save it back when it changed, same count as refresh()
+    size_t sync(const Storage& storage);
+    bool   dirty() const { return dirty_; }
+    void   clearDirty() { dirty_ = false; }
+
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    // Entries of a kind matching the query (file or protocol substring, or frequency in MHz)
+    std::vector<size_t> filter(Kind kind, const std::string& query, bool hideDuplicates) const;
+
+    // Entries having the same content as an earlier entry of the same kind
+    size_t duplicateCount(Kind kind) const;
+
+    // One line for a selection list
+    static std::string summary(const Entry& e);
+
+    static bool kindOf(const std::string& fileName, Kind& kind);
+
+    // Index a single file fed chunk by chunk
+    void beginFile(Kind kind);
+    void feed(const uint8_t* data, size_t len);
+    void endFile(Entry& out);
+
+private:
+    static constexpr const char* HEADER     = "# signal library v1";
+    static constexpr size_t      MAX_KEY    = 24;
+    static constexpr size_t      MAX_VALUE  = 48;
+    static constexpr uint32_t    FNV_OFFSET = 2166136261u;
+    static constexpr uint32_t    FNV_PRIME  = 16777619u;
+
+    enum class State : uint8_t { Key, Value, Numbers, Skip };
+
+    struct IndexState {
+        Kind        kind = Kind::SubGhz;
+        State       state = State::Key;
+        std::string key;
+        std::string value;
+        Entry       entry;
+        uint64_t    durationUs = 0;
+        uint64_t    number = 0;
+        bool        inNumber = false;
+
+        // Hash normalization
+        uint32_t    hash = FNV_OFFSET;
+        bool        lineStart = true;
+        bool        lineComment = false;
+        bool        lineContent = false;
+    };
+
+    std::vector<Entry> entries_;
+    IndexState         st_;
+    bool               dirty_ = false;
+
+    void hashChar(char c);
+    void keyChar(char c);
+    void endValue();
+    void numberChar(char c);
+    void endNumber();
+    void setProtocol(const std::string& p);
+
+    // Duplicate key, the size keeps 32 bit hash collisions apart
+    static uint64_t contentKey(const Entry& e) { return (static_cast<uint64_t>(e.size) << 32) | e.hash; }
+
+    static bool iequals(const std::string& a, const char* b);
+    static std::string lower(const std::string& s);
+    static void trim(std::string& s);
+};
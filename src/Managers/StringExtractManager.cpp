@@ -0,0 +1,212 @@
+#include "StringExtractManager.h"
+
+#include <new>
+
+void StringExtractManager::begin(const Options& options, Sink s) {
+    opts = options;
+    if (opts.minLen == 0) opts.minLen = 1;
+    sink = std::move(s);
+    st = Stats{};
+
+    for (Run* r : { &asciiRun, &wideRuns[0], &wideRuns[1] }) {
+        r->text.clear();
+        r->text.reserve(MAX_STRING_LEN);
+        r->hasPending = false;
+    }
+
+    seen.reset();
+    seenSlots = 0;
+    seenCount = 0;
+    saturated = false;
+    if (opts.dedupe) {
+        seen.reset(new (std::nothrow) uint64_t[DEDUPE_SLOTS]());
+        if (seen) seenSlots = DEDUPE_SLOTS;
+        else saturated = true;
+    }
+    started = false;
+}
+
+void StringExtractManager::feed(uint32_t address, const uint8_t* buf, size_t len) {
+    // Non contiguous block, runs cannot continue
+    if (started && address != nextAddress) {
+        flushAll();
+    }
+    started = true;
+
+    const bool ascii = (static_cast<uint8_t>(opts.encoding) & static_cast<uint8_t>(Encoding::Ascii)) != 0;
+    const bool wide  = (static_cast<uint8_t>(opts.encoding) & static_cast<uint8_t>(Encoding::Utf16Le)) != 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        uint32_t addr = address + i;
+        uint8_t b = buf[i];
+        if (ascii) pushAscii(addr, b);
+        if (wide) {
+            pushWide(wideRuns[0], 0, addr, b);
+            pushWide(wideRuns[1], 1, addr, b);
+        }
+    }
+
+    st.bytesScanned += len;
+    nextAddress = address + len;
+}
+
+void StringExtractManager::finish() {
+    flushAll();
+    started = false;
+}
+
+void StringExtractManager::pushAscii(uint32_t addr, uint8_t b) {
+    if (!isPrintable(b)) {
+        flush(asciiRun, false);
+        return;
+    }
+
+    if (asciiRun.text.empty()) asciiRun.start = addr;
+    asciiRun.text.push_back(static_cast<char>(b));
+
+    // Too long, emit it and continue as a new run
+    if (asciiRun.text.size() >= MAX_STRING_LEN) flush(asciiRun, false);
+}
+
+void StringExtractManager::pushWide(Run& lane, uint32_t laneParity, uint32_t addr, uint8_t b) {
+    // Low byte of a code unit
+    if ((addr & 1u) == laneParity) {
+        lane.pending = b;
+        lane.hasPending = true;
+        return;
+    }
+
+    // High byte, only the Basic Latin printable range is accepted
+    if (!lane.hasPending) return;
+    lane.hasPending = false;
+
+    if (b != 0x00 || !isPrintable(lane.pending)) {
+        flush(lane, true);
+        return;
+    }
+
+    if (lane.text.empty()) lane.start = addr - 1;
+    lane.text.push_back(static_cast<char>(lane.pending));
+
+    if (lane.text.size() >= MAX_STRING_LEN) flush(lane, true);
+}
+
+void StringExtractManager::flushAll() {
+    flush(asciiRun, false);
+    flush(wideRuns[0], true);
+    flush(wideRuns[1], true);
+    wideRuns[0].hasPending = false;
+    wideRuns[1].hasPending = false;
+}
+
+void StringExtractManager::flush(Run& run, bool wide) {
+    if (run.text.size() < opts.minLen) {
+        run.text.clear();
+        return;
+    }
+
+    if (!opts.filter.empty() && !matchFilter(opts.filter.c_str(), run.text.c_str())) {
+        st.filtered++;
+        run.text.clear();
+        return;
+    }
+
+    if (opts.dedupe && !insertSeen(hashString(run.text))) {
+        st.duplicates++;
+        run.text.clear();
+        return;
+    }
+
+    st.emitted++;
+    if (sink) sink(run.start, run.text, wide);
+    run.text.clear();
+}
+
+bool StringExtractManager::insertSeen(uint64_t key) {
+    if (key == 0) key = 1; // 0 marks an empty slot
+
+    if (seenSlots) {
+        const size_t mask = seenSlots - 1;
+        size_t idx = static_cast<size_t>(key) & mask;
+        while (seen[idx] != 0) {
+            if (seen[idx] == key) return false;
+            idx = (idx + 1) & mask;
+        }
+
+        if (seenCount < (seenSlots * 3) / 4 || growSeen()) {
+            // Slot moved if the table grew
+            idx = static_cast<size_t>(key) & (seenSlots - 1);
+            while (seen[idx] != 0) idx = (idx + 1) & (seenSlots - 1);
+            seen[idx] = key;
+            seenCount++;
+            return true;
+        }
+    }
+
+    // Saturated, keep emitting without remembering
+    st.unremembered++;
+    return true;
+}
+
+bool StringExtractManager::growSeen() {
+    const size_t slots = seenSlots * 2;
+    if (saturated || slots > opts.dedupeMaxSlots) {
+        saturated = true;
+        return false;
+    }
+
+    std::unique_ptr<uint64_t[]> bigger(new (std::nothrow) uint64_t[slots]());
+    if (!bigger) {
+        saturated = true;
+        return false;
+    }
+
+    const size_t mask = slots - 1;
+    for (size_t i = 0; i < seenSlots; ++i) {
+        const uint64_t key = seen[i];
+        if (key == 0) continue;
+        size_t idx = static_cast<size_t>(key) & mask;
+        while (bigger[idx] != 0) idx = (idx + 1) & mask;
+        bigger[idx] = key;
+    }
+
+    seen = std::move(bigger);
+    seenSlots = slots;
+    return true;
+}
+
+uint64_t StringExtractManager::hashString(const std::string& s) {
+    // FNV-1a 64, false drops stay below 1e-11 at the largest table
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/*
+Regex-lite (Kernighan & Pike)
+*/
+bool StringExtractManager::matchFilter(const char* pattern, const char* text) {
+    if (pattern[0] == '^') return matchHere(pattern + 1, text);
+    do {
+        if (matchHere(pattern, text)) return true;
+    } while (*text++ != '\0');
+    return false;
+}
+
+bool StringExtractManager::matchHere(const char* re, const char* text) {
+    if (re[0] == '\0') return true;
+    if (re[1] == '*') return matchStar(re[0], re + 2, text);
+    if (re[0] == '$' && re[1] == '\0') return *text == '\0';
+    if (*text != '\0' && (re[0] == '.' || re[0] == *text)) return matchHere(re + 1, text + 1);
+    return false;
+}
+
+bool StringExtractManager::matchStar(char c, const char* re, const char* text) {
+    do {
+        if (matchHere(re, text)) return true;
+    } while (*text != '\0' && (*text++ == c || c == '.'));
+    return false;
+}
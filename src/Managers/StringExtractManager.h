@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/*
+Streaming printable string extractor.
+Blocks are fed with their absolute address, runs crossing a block
+boundary are carried over to the next feed() call.
+Memory stays constant whatever the size of the scanned image, apart
+from the dedupe table: 64-bit hashes, doubled at 3/4 load up to
+dedupeMaxSlots. Past that (or when the allocation fails) it is
+saturated, remembered strings are still dropped but new ones are all
+emitted and counted in unremembered.
+*/
+class StringExtractManager {
+public:
+    enum class Encoding : uint8_t { Ascii = 1, Utf16Le = 2, Both = 3 };
+
+    struct Options {
+        size_t      minLen   = 8;
+        Encoding    encoding = Encoding::Ascii;
+        std::string filter;           // regex-lite: ^ $ . * (empty = everything)
+        bool        dedupe   = true;
+        size_t      dedupeMaxSlots = DEDUPE_MAX_SLOTS;    // power of two
+    };
+
+    struct Stats {
+        uint32_t bytesScanned = 0;
+        uint32_t emitted      = 0;
+        uint32_t duplicates   = 0;
+        uint32_t filtered     = 0;
+        uint32_t unremembered = 0;    // emitted while the dedupe table was saturated
+    };
+
+    // address of the first char, decoded string, true if UTF-16LE
+    using Sink = std::function<void(uint32_t address, const std::string& str, bool wide)>;
+
+    static constexpr size_t MAX_STRING_LEN   = 256;     // longer runs are split
+    static constexpr size_t DEDUPE_SLOTS     = 2048;    // initial, power of two, 16KB
+    static constexpr size_t DEDUPE_MAX_SLOTS = 16384;   // 128KB, 12288 strings
+
+    // Reset the state and start a new extraction
+    void begin(const Options& options, Sink sink);
+
+    // Feed the next block, address is the absolute address of buf[0]
+    void feed(uint32_t address, const uint8_t* buf, size_t len);
+
+    // Flush pending runs
+    void finish();
+
+    const Stats& stats() const { return st; }
+    bool   dedupeSaturated() const { return saturated; }
+    size_t dedupeSlots()     const { return seenSlots; }
+
+    // Unanchored match, supports c . ^ $ *
+    static bool matchFilter(const char* pattern, const char* text);
+
+private:
+    struct Run {
+        std::string text;
+        uint32_t    start      = 0;
+        uint8_t     pending    = 0;     // UTF-16 low byte waiting for its high byte
+        bool        hasPending = false;
+    };
+
+    Options  opts;
+    Sink     sink;
+    Stats    st;
+    Run      asciiRun;
+    Run      wideRuns[2];               // one lane per address parity
+    uint32_t nextAddress = 0;
+    bool     started     = false;
+
+    std::unique_ptr<uint64_t[]> seen;   // open addressing hash set, 0 = empty slot
+    size_t   seenSlots = 0;
+    size_t   seenCount = 0;
+    bool     saturated = false;         // full at dedupeMaxSlots or out of memory
+
+    void pushAscii(uint32_t addr, uint8_t b);
+    void pushWide(Run& lane, uint32_t laneParity, uint32_t addr, uint8_t b);
+    void flush(Run& run, bool wide);
+    void flushAll();
+    bool insertSeen(uint64_t key);
+    bool growSeen();
+
+    static uint64_t hashString(const std::string& s);
+    static bool isPrintable(uint8_t b) { return b >= 32 && b <= 126; }
+    static bool matchHere(const char* re, const char* text);
+    static bool matchStar(char c, const char* re, const char* text);
+};
@@ -7,10 +7,11 @@ std::string SubGhzAnalyzeManager::analyzeFrame(const std::vector<rmt_item32_t>&
     SubGhzDetectResult r;
     if (items.empty()) { r.notes = "空帧"; return formatFrame(r); }
 
-    std::vector<uint32_t> highs, lows;
-    collectDurations(items, tickPerUs, highs, lows);
+    // 只转换一次，解码器组对时长聚类并给出基准周期
+    collectDurations(items, tickPerUs);
+    const auto& decoded = decoder.decode(durations.data(), durations.size());
 
-    float T = estimateBaseT(highs, lows);
+    float T = static_cast<float>(decoder.frame().teUs);
     r.baseT_us = T;
 
     float ratio = 0.f;
@@ -30,6 +31,29 @@ std::string SubGhzAnalyzeManager::analyzeFrame(const std::vector<rmt_item32_t>&
         r.bitrate_kbps = 1000.f / T;
     }
 
+    // 协议解码器组：取置信度最高的结果
+    if (!decoded.empty() && decoded.front().confidence >= 0.5f) {
+        const auto& best = decoded.front();
+        const std::string name = best.protocol;
+        r.protocolGuess = name;
+        r.payloadHex    = SubGhzDecodeManager::bitsToHex(best.bits);
+        r.bitCount      = static_cast<int>(best.bits.size());
+        r.confidence    = best.confidence;
+        if (name == "Manchester") r.encoding = RfEncoding::Manchester;
+        else if (name == "Princeton" || name == "EV1527") r.encoding = RfEncoding::PulseLength;
+        else r.encoding = RfEncoding::PWM;
+
+        std::ostringstream notes;
+        if (best.repeats > 1) notes << "重复 x" << static_cast<int>(best.repeats);
+        for (size_t i = 1; i < decoded.size() && i < 4; ++i) {
+            if (decoded[i].confidence < 0.3f) break;
+            notes << (notes.tellp() > 0 ? "  " : "") << "候选: " << decoded[i].protocol
+                  << ' ' << static_cast<int>(decoded[i].confidence * 100.f) << '%';
+        }
+        r.notes = notes.str();
+        return formatFrame(r);
+    }
+
     // 尝试解码数据
     if (r.encoding == RfEncoding::PulseLength) {
         std::string hex;
@@ -191,9 +215,9 @@ std::string SubGhzAnalyzeManager::formatFrame(const SubGhzDetectResult& r) const
     return oss.str();
 }
 
-void SubGhzAnalyzeManager::collectDurations(const std::vector<rmt_item32_t>& items, float tickPerUs,
-                                            std::vector<uint32_t>& highs, std::vector<uint32_t>& lows) {
-    highs.clear(); lows.clear();
+void SubGhzAnalyzeManager::collectDurations(const std::vector<rmt_item32_t>& items, float tickPerUs) {
+    durations.clear(); highs.clear(); lows.clear();
+    durations.reserve(items.size() * 2);
     highs.reserve(items.size());
     lows.reserve(items.size());
 
@@ -203,28 +227,25 @@ void SubGhzAnalyzeManager::collectDurations(const std::vector<rmt_item32_t>& ite
         uint32_t d1 = (uint32_t)std::max(1.f, std::round(it.duration1 / tickPerUs));
         highs.push_back(d0);
         lows.push_back(d1);
+
+        // 带符号时长（高电平为正），时长为0表示帧结束
+        if (it.duration0 == 0) break;
+        durations.push_back(it.level0 ? (int32_t)d0 : -(int32_t)d0);
+        if (it.duration1 == 0) break;
+        durations.push_back(it.level1 ? (int32_t)d1 : -(int32_t)d1);
     }
 }
 
-float SubGhzAnalyzeManager::median(std::vector<uint32_t> v) {
+float SubGhzAnalyzeManager::median(const std::vector<uint32_t>& v) {
     if (v.empty()) return 0.f;
-    std::sort(v.begin(), v.end());
-    size_t n = v.size();
-    return (n & 1) ? (float)v[n/2] : 0.5f * (v[n/2 - 1] + v[n/2]);
-}
-
-float SubGhzAnalyzeManager::estimateBaseT(const std::vector<uint32_t>& highs, const std::vector<uint32_t>& lows) {
-    // 取短时长作为基准周期近似值
-    std::vector<uint32_t> pool;
-    pool.reserve(highs.size() + lows.size());
-    for (auto d : highs) if (d >= 2) pool.push_back(d);
-    for (auto d : lows)  if (d >= 2) pool.push_back(d);
-    if (pool.size() < 8) return 0.f;
-
-    std::sort(pool.begin(), pool.end());
-    size_t m = std::max<size_t>(4, pool.size()/4);
-    std::vector<uint32_t> q(pool.begin(), pool.begin() + m);
-    return median(q);
+    // 复用缓冲区，nth_element为O(n)，无需完整排序
+    scratch.assign(v.begin(), v.end());
+    size_t n = scratch.size();
+    auto mid = scratch.begin() + n/2;
+    std::nth_element(scratch.begin(), mid, scratch.end());
+    if (n & 1) return (float)*mid;
+    uint32_t lower = *std::max_element(scratch.begin(), mid);
+    return 0.5f * (lower + *mid);
 }
 
 bool SubGhzAnalyzeManager::looksManchester(float T, const std::vector<uint32_t>& highs, const std::vector<uint32_t>& lows) {
@@ -251,8 +272,8 @@ bool SubGhzAnalyzeManager::looksPulseLength(float T, const std::vector<uint32_t>
         r2.push_back(l / h);
     }
     if (r1.empty() || r2.empty()) { ratioOut = 0.f; return false; }
-    std::sort(r1.begin(), r1.end());
-    std::sort(r2.begin(), r2.end());
+    std::nth_element(r1.begin(), r1.begin() + r1.size()/2, r1.end());
+    std::nth_element(r2.begin(), r2.begin() + r2.size()/2, r2.end());
     float m1 = r1[r1.size()/2];
     float m2 = r2[r2.size()/2];
     ratioOut = (m1 > m2) ? m1 : m2;
@@ -8,6 +8,7 @@
 
 #include "Interfaces/ITerminalView.h"
 #include "Interfaces/IInput.h"
+#include "Managers/SubGhzDecodeManager.h"
 #include "driver/rmt.h"
 
 enum class RfEncoding { Unknown, PulseLength, Manchester, PWM };
@@ -73,10 +74,8 @@ private:
                                 float confidence,
                                 std::string mod);
 
-    void   collectDurations(const std::vector<rmt_item32_t>& items, float tickPerUs,
-                                   std::vector<uint32_t>& highs, std::vector<uint32_t>& lows);
-    float  median(std::vector<uint32_t> v);
-    float  estimateBaseT(const std::vector<uint32_t>& highs, const std::vector<uint32_t>& lows);
+    void   collectDurations(const std::vector<rmt_item32_t>& items, float tickPerUs);
+    float  median(const std::vector<uint32_t>& v);
 
     // Protocols prediction
     bool   looksManchester(float T, const std::vector<uint32_t>& highs, const std::vector<uint32_t>& lows);
@@ -92,4 +91,11 @@ private:
     std::string bitsToHex(const std::string& bits);
     float       clamp01(float v);
     bool        nearf(float a, float b, float tol);
+
+    // Decoder bank and buffers reused from frame to frame
+    SubGhzDecodeManager   decoder;
+    std::vector<int32_t>  durations;      // signed us, shared with the decoder bank
+    std::vector<uint32_t> highs;
+    std::vector<uint32_t> lows;
+    std::vector<uint32_t> scratch;        // median selection
 };
@@ -0,0 +1,372 @@
+#include "SubGhzDecodeManager.h"
+#include <cstring>
+#include <cstdint>
+
+/*
+Pulse width protocols sharing the same two-width coding.
+Timings from the chip datasheets / Flipper decoders, te in us.
+*/
+const SubGhzDecodeManager::PairSpec SubGhzDecodeManager::PAIR_SPECS[] = {
+    // name       layout                 teMin teMax long gap  bits
+    { "Princeton", Layout::HighLow,      200,  600,  3,   31, { 24, 0,  0  } },
+    { "EV1527",    Layout::HighLow,      200,  600,  3,   31, { 24, 0,  0  } },
+    { "CAME",      Layout::StartLowHigh, 250,  450,  2,   47, { 12, 24, 25 } },
+    { "Nice FLO",  Layout::StartLowHigh, 550,  900,  2,   36, { 12, 24, 0  } },
+    { "Holtek",    Layout::StartLowHigh, 250,  450,  2,   36, { 12, 0,  0  } },
+};
+const size_t SubGhzDecodeManager::PAIR_SPECS_COUNT = sizeof(PAIR_SPECS) / sizeof(PAIR_SPECS[0]);
+
+const std::vector<SubGhzDecodeManager::DecodeResult>&
+SubGhzDecodeManager::decode(const int32_t* durations, size_t count) {
+    results_.clear();
+    cluster(durations, count, frame_);
+    if (frame_.teUs == 0) return results_;
+
+    splitPackets();
+    for (size_t i = 0; i < PAIR_SPECS_COUNT; ++i) decodePairs(PAIR_SPECS[i]);
+    decodeManchester();
+
+    // Insertion sort, the bank holds a handful of results
+    for (size_t i = 1; i < results_.size(); ++i) {
+        for (size_t j = i; j > 0 && results_[j].confidence > results_[j - 1].confidence; --j) {
+            std::swap(results_[j], results_[j - 1]);
+        }
+    }
+    return results_;
+}
+
+/*
+Histogram clustering
+*/
+size_t SubGhzDecodeManager::binOf(uint32_t us) {
+    if (us < 8) return 0;
+    // log2 with 3 fractional bits: msb index + the 3 bits below it
+    const int msb = 31 - __builtin_clz(us);
+    const size_t bin = static_cast<size_t>(msb - 3) * 8 + ((us >> (msb - 3)) & 7);
+    return bin < HIST_BINS ? bin : HIST_BINS - 1;
+}
+
+void SubGhzDecodeManager::cluster(const int32_t* durations, size_t count, ClusteredFrame& out) {
+    out.durations.clear();
+    out.units.clear();
+    out.clusters.clear();
+    out.teUs = 0;
+
+    // Merge consecutive durations of the same level
+    for (size_t i = 0; i < count; ++i) {
+        const int32_t d = durations[i];
+        if (d == 0) continue;
+        if (!out.durations.empty() && ((out.durations.back() > 0) == (d > 0))) {
+            out.durations.back() += d;
+        } else {
+            out.durations.push_back(d);
+        }
+    }
+    if (out.durations.size() < MIN_PULSES) return;
+
+    // Pass 1, histogram
+    memset(binCount_, 0, sizeof(binCount_));
+    memset(binSum_, 0, sizeof(binSum_));
+    for (int32_t d : out.durations) {
+        const uint32_t us = static_cast<uint32_t>(d > 0 ? d : -d);
+        const size_t b = binOf(us);
+        binCount_[b]++;
+        binSum_[b] += us;
+    }
+
+    // Runs of non empty bins, split at deep valleys (peaks of T and 2T can touch)
+    memset(binCluster_, 0xFF, sizeof(binCluster_));
+    size_t b = 0;
+    while (b < HIST_BINS) {
+        if (binCount_[b] == 0) { ++b; continue; }
+        size_t runEnd = b;
+        while (runEnd < HIST_BINS && binCount_[runEnd] != 0) ++runEnd;
+
+        size_t start = b;
+        while (start < runEnd) {
+            size_t split = runEnd;
+            uint32_t leftMax = 0;
+            for (size_t v = start; v < runEnd; ++v) {
+                if (binCount_[v] > leftMax) leftMax = binCount_[v];
+                if (v == start || v + 1 >= runEnd) continue;
+                if (binCount_[v] > binCount_[v - 1] || binCount_[v] > binCount_[v + 1]) continue;
+
+                uint32_t rightMax = 0;
+                for (size_t r = v + 1; r < runEnd; ++r) if (binCount_[r] > rightMax) rightMax = binCount_[r];
+                const uint32_t lower = leftMax < rightMax ? leftMax : rightMax;
+                if (binCount_[v] * 3 < lower) { split = v + 1; break; }
+            }
+
+            Cluster c;
+            uint64_t sum = 0;
+            const uint8_t idx = static_cast<uint8_t>(out.clusters.size() < 0xFE ? out.clusters.size() : 0xFE);
+            for (size_t v = start; v < split; ++v) {
+                c.count += binCount_[v];
+                sum += binSum_[v];
+                binCluster_[v] = idx;
+            }
+            c.meanUs = static_cast<uint32_t>(sum / c.count);
+            if (out.clusters.size() < 0xFE) out.clusters.push_back(c);
+            start = split;
+        }
+        b = runEnd;
+    }
+
+    // Base period: narrowest cluster that is not isolated noise
+    const size_t total = out.durations.size();
+    const uint32_t minCount = total / 32 > 2 ? static_cast<uint32_t>(total / 32) : 2;
+    for (const auto& c : out.clusters) {
+        if (c.count >= minCount) { out.teUs = c.meanUs; break; }
+    }
+    if (out.teUs == 0) return;
+
+    for (auto& c : out.clusters) {
+        const uint64_t u = (static_cast<uint64_t>(c.meanUs) * 2 + out.teUs) / (static_cast<uint64_t>(out.teUs) * 2);
+        c.units = static_cast<uint8_t>(u > 255 ? 255 : (u == 0 ? 1 : u));
+    }
+
+    // Pass 2, snap every duration to its cluster width
+    out.units.resize(total);
+    for (size_t i = 0; i < total; ++i) {
+        const int32_t d = out.durations[i];
+        const uint8_t ci = binCluster_[binOf(static_cast<uint32_t>(d > 0 ? d : -d))];
+        out.units[i] = out.clusters[ci].units;
+    }
+}
+
+void SubGhzDecodeManager::splitPackets() {
+    packets_.clear();
+    Packet p;
+    const size_t n = frame_.units.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (frame_.units[i] < GAP_UNITS) continue;
+        p.end = i;
+        if (p.end > p.begin) packets_.push_back(p);
+        p.begin = i + 1;
+        p.gapUnits = frame_.units[i];
+    }
+    p.end = n;
+    if (p.end > p.begin) packets_.push_back(p);
+}
+
+/*
+Pulse width decoders (Princeton, EV1527, CAME, Nice FLO, Holtek)
+*/
+bool SubGhzDecodeManager::pairPacket(const PairSpec& spec, const Packet& p, std::string& bits, float& quality) const {
+    const auto& u = frame_.units;
+    const auto& d = frame_.durations;
+    bits.clear();
+
+    size_t i = p.begin;
+    if (d[i] < 0) ++i;                               // packets start on a high
+    if (spec.layout == Layout::StartLowHigh) {
+        if (i >= p.end || u[i] != 1) return false;   // start bit
+        ++i;
+    }
+
+    // Exact widths count 1, one te off counts 0.5
+    auto width = [&](uint8_t w, bool& isLong, float& score) -> bool {
+        if (w == 1) { isLong = false; score += 1.f; return true; }
+        if (w == spec.longUnits) { isLong = true; score += 1.f; return true; }
+        if (w > 1 && (w + 1 == spec.longUnits || w == spec.longUnits + 1)) {
+            isLong = true; score += 0.5f; return true;
+        }
+        return false;
+    };
+
+    float score = 0.f;
+    size_t widths = 0;
+    while (i < p.end) {
+        bool first = false, second = false;
+        if (!width(u[i], first, score)) return false;
+        widths++;
+
+        // The last width of the packet is eaten by the gap, decide on the first one
+        if (i + 1 >= p.end) {
+            bits.push_back(first ? '1' : '0');
+            break;
+        }
+        if (!width(u[i + 1], second, score)) return false;
+        widths++;
+        if (first == second) return false;           // both short or both long
+
+        bits.push_back(first ? '1' : '0');
+        i += 2;
+    }
+
+    if (bits.size() < MIN_BITS) return false;
+    quality = score / static_cast<float>(widths);
+    return true;
+}
+
+void SubGhzDecodeManager::decodePairs(const PairSpec& spec) {
+    std::string best;
+    float bestQuality = 0.f;
+    uint8_t bestGap = 0;
+    uint8_t repeats = 0;
+
+    for (const auto& p : packets_) {
+        float quality = 0.f;
+        if (!pairPacket(spec, p, scratch_, quality)) continue;
+
+        if (scratch_ == best) {
+            if (repeats < 255) repeats++;
+            if (quality > bestQuality) bestQuality = quality;
+            if (p.gapUnits) bestGap = p.gapUnits;
+            continue;
+        }
+        if (scratch_.size() > best.size() || (scratch_.size() == best.size() && quality > bestQuality)) {
+            best = scratch_;
+            bestQuality = quality;
+            bestGap = p.gapUnits;
+            repeats = 1;
+        }
+    }
+    if (best.empty()) return;
+
+    float bitScore = 0.f;
+    for (uint8_t expected : spec.bitCounts) {
+        if (expected == 0) continue;
+        if (best.size() == expected) { bitScore = 1.f; break; }
+        if (best.size() + 1 == expected || best.size() == expected + 1u) bitScore = 0.5f;
+    }
+
+    // Header silence is only visible when the capture spans several packets
+    float gapScore = 0.75f;
+    if (bestGap) {
+        const int diff = static_cast<int>(bestGap) - spec.gapUnits;
+        gapScore = (diff * 4 <= spec.gapUnits && -diff * 4 <= spec.gapUnits) ? 1.f : 0.4f;
+    }
+
+    float conf = bestQuality * (0.4f * bitScore + 0.3f * teScore(frame_.teUs, spec.teMin, spec.teMax) + 0.2f * gapScore + 0.1f);
+
+    // PT2262 sends tri-state symbols (00, 11, 01), EV1527 sends plain bits
+    bool hasFloat = false;
+    const bool tristate = looksTristate(best, hasFloat);
+    if (spec.layout == Layout::HighLow) {
+        const bool princeton = spec.name[0] == 'P';
+        if (princeton && !tristate) conf *= 0.8f;
+        if (!princeton && tristate && hasFloat) conf *= 0.85f;
+    }
+
+    if (repeats > 1) conf += repeats > 2 ? 0.1f : 0.05f;
+    pushResult(spec.name, best, conf, repeats);
+}
+
+/*
+Manchester (IEEE 802.3: high->low = 0, low->high = 1)
+*/
+bool SubGhzDecodeManager::manchesterPacket(const Packet& p, std::string& bits, float& quality) {
+    const auto& u = frame_.units;
+    const auto& d = frame_.durations;
+    bits.clear();
+
+    // Only te and 2te widths
+    halves_.clear();
+    size_t valid = 0;
+    for (size_t i = p.begin; i < p.end; ++i) {
+        if (u[i] == 1 || u[i] == 2) valid++;
+        const uint8_t level = d[i] > 0 ? 1 : 0;
+        for (uint8_t k = 0; k < u[i] && k < 2; ++k) halves_.push_back(level);
+    }
+    const size_t widths = p.end - p.begin;
+    if (widths < MIN_PULSES || valid * 10 < widths * 9) return false;
+
+    // A leading half of the opposite level is lost before the first edge,
+    // try both alignments and keep the one with fewer invalid pairs
+    size_t bestErrors = SIZE_MAX;
+    for (int offset = 0; offset < 2; ++offset) {
+        scratch_.clear();
+        size_t errors = 0;
+        for (long k = -offset; k + 1 < static_cast<long>(halves_.size()); k += 2) {
+            const uint8_t first  = k < 0 ? (halves_[0] ^ 1) : halves_[k];
+            const uint8_t second = halves_[k + 1];
+            if (first == second) errors++;
+            else scratch_.push_back(first ? '0' : '1');
+        }
+        if (errors < bestErrors) {
+            bestErrors = errors;
+            bits = scratch_;
+        }
+    }
+
+    if (bits.size() < MIN_BITS) return false;
+    const float symbols = static_cast<float>(bits.size() + bestErrors);
+    quality = (static_cast<float>(bits.size()) / symbols) * (static_cast<float>(valid) / static_cast<float>(widths));
+    return true;
+}
+
+void SubGhzDecodeManager::decodeManchester() {
+    std::string best;
+    float bestQuality = 0.f;
+    uint8_t repeats = 0;
+    std::string bits;
+
+    for (const auto& p : packets_) {
+        float quality = 0.f;
+        if (!manchesterPacket(p, bits, quality)) continue;
+        if (bits == best) {
+            if (repeats < 255) repeats++;
+            continue;
+        }
+        if (bits.size() > best.size()) {
+            best = bits;
+            bestQuality = quality;
+            repeats = 1;
+        }
+    }
+    if (best.empty()) return;
+
+    // Generic decoder, capped below a protocol with known timings
+    float conf = bestQuality * bestQuality * 0.85f;
+    if (repeats > 1) conf += 0.05f;
+    pushResult("Manchester", best, conf, repeats);
+}
+
+/*
+Utils
+*/
+void SubGhzDecodeManager::pushResult(const char* name, const std::string& bits, float confidence, uint8_t repeats) {
+    DecodeResult r;
+    r.protocol   = name;
+    r.bits       = bits;
+    r.teUs       = frame_.teUs;
+    r.repeats    = repeats;
+    r.confidence = confidence < 0.f ? 0.f : (confidence > 1.f ? 1.f : confidence);
+    results_.push_back(std::move(r));
+}
+
+float SubGhzDecodeManager::teScore(uint32_t te, uint16_t teMin, uint16_t teMax) {
+    if (te >= teMin && te <= teMax) return 1.f;
+    // Drifting remotes stay within 25% of the nominal range
+    if (te * 4 >= teMin * 3u && te * 4 <= teMax * 5u) return 0.5f;
+    return 0.f;
+}
+
+bool SubGhzDecodeManager::looksTristate(const std::string& bits, bool& hasFloat) {
+    hasFloat = false;
+    if (bits.size() & 1) return false;
+    for (size_t i = 0; i + 1 < bits.size(); i += 2) {
+        if (bits[i] == '1' && bits[i + 1] == '0') return false;
+        if (bits[i] == '0' && bits[i + 1] == '1') hasFloat = true;
+    }
+    return true;
+}
+
+std::string SubGhzDecodeManager::bitsToHex(const std::string& bits) {
+    static const char* kHexDigits = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(bits.size() / 4 + 1);
+
+    const size_t pad = (4 - bits.size() % 4) % 4;
+    int v = 0;
+    size_t n = pad;
+    for (char b : bits) {
+        v = (v << 1) | (b == '1');
+        if (++n % 4 == 0) {
+            out.push_back(kHexDigits[v & 0xF]);
+            v = 0;
+        }
+    }
+    return out;
+}
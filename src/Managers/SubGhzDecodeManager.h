@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Multi-protocol OOK decoder bank.
+
+Durations are signed microseconds (> 0 high, < 0 low), the same layout as
+Flipper RAW_Data. They are clustered once with a log2 histogram, every
+duration is then snapped to a multiple of the base period (te) and all
+decoders of the bank run on this shared clustered frame. Everything is O(n),
+no sort, and the class has no Arduino dependency so it builds on a host.
+*/
+class SubGhzDecodeManager {
+public:
+    struct Cluster {
+        uint32_t meanUs = 0;
+        uint32_t count  = 0;
+        uint8_t  units  = 0;     // meanUs / te, rounded
+    };
+
+    struct ClusteredFrame {
+        std::vector<int32_t> durations;   // merged signed durations (us)
+        std::vector<uint8_t> units;       // per duration, multiple of te (capped at 255)
+        std::vector<Cluster> clusters;    // ascending width
+        uint32_t teUs = 0;                // base period, 0 if not enough pulses
+    };
+
+    struct DecodeResult {
+        const char* protocol = "";
+        std::string bits;                 // '0' / '1', MSB first
+        uint32_t    teUs       = 0;
+        uint8_t     repeats    = 0;       // packets of the frame with the same bits
+        float       confidence = 0.f;     // 0..1
+    };
+
+    static constexpr size_t  HIST_BINS   = 128;  // 8 bins per octave, 8us .. 262ms
+    static constexpr uint8_t GAP_UNITS   = 8;    // a duration >= 8 te splits packets
+    static constexpr size_t  MIN_PULSES  = 8;
+    static constexpr size_t  MIN_BITS    = 8;
+
+    // Cluster and run every decoder, results are sorted by confidence (best first)
+    const std::vector<DecodeResult>& decode(const int32_t* durations, size_t count);
+
+    // Clustered frame of the last decode() call
+    const ClusteredFrame& frame() const { return frame_; }
+
+    // Histogram clustering only
+    void cluster(const int32_t* durations, size_t count, ClusteredFrame& out);
+
+    // Hex string of a bit string, left padded to a multiple of 4 bits
+    static std::string bitsToHex(const std::string& bits);
+
+private:
+    enum class Layout : uint8_t {
+        HighLow,        // [H L] per bit, data in the high width (Princeton, EV1527)
+        StartLowHigh    // start H, then [L H] per bit, data in the low width (CAME, Nice, Holtek)
+    };
+
+    struct PairSpec {
+        const char* name;
+        Layout      layout;
+        uint16_t    teMin;
+        uint16_t    teMax;
+        uint8_t     longUnits;       // long width in te (short is 1)
+        uint8_t     gapUnits;        // header silence in te
+        uint8_t     bitCounts[3];    // accepted lengths, 0 = unused
+    };
+
+    struct Packet {
+        size_t  begin = 0;
+        size_t  end   = 0;           // exclusive
+        uint8_t gapUnits = 0;        // silence before the packet, 0 if frame start
+    };
+
+    static const PairSpec PAIR_SPECS[];
+    static const size_t   PAIR_SPECS_COUNT;
+
+    ClusteredFrame            frame_;
+    std::vector<Packet>       packets_;
+    std::vector<DecodeResult> results_;
+    std::string               scratch_;
+    std::vector<uint8_t>      halves_;
+    uint32_t                  binCount_[HIST_BINS];
+    uint64_t                  binSum_[HIST_BINS];
+    uint8_t                   binCluster_[HIST_BINS];
+
+    void splitPackets();
+    void decodePairs(const PairSpec& spec);
+    void decodeManchester();
+
+    bool  pairPacket(const PairSpec& spec, const Packet& p, std::string& bits, float& quality) const;
+    bool  manchesterPacket(const Packet& p, std::string& bits, float& quality);
+    void  pushResult(const char* name, const std::string& bits, float confidence, uint8_t repeats);
+
+    static size_t binOf(uint32_t us);
+    static bool   looksTristate(const std::string& bits, bool& hasFloat);
+    static float  teScore(uint32_t te, uint16_t teMin, uint16_t teMax);
+};
@@ -0,0 +1,190 @@
+#include "SubGhzRecordManager.h"
+#include <cstring>
+#include <cstdio>
+
+bool SubGhzRecordManager::begin(Format format, uint32_t frequencyHz, uint32_t tickPerUs, Writer writer) {
+    format_ = format;
+    writer_ = std::move(writer);
+    tickPerUs_ = tickPerUs ? tickPerUs : 1;
+    buf_.clear();
+    buf_.reserve(WRITE_BUFFER_SIZE + 64);
+
+    frames_ = 0;
+    pulses_ = 0;
+    bytesWritten_ = 0;
+    failed_ = false;
+    lastFrameEndUs_ = 0;
+    pendingUs_ = 0;
+    lineValues_ = 0;
+
+    if (format_ == Format::Binary) {
+        uint8_t header[BINARY_HEADER_SIZE];
+        uint32_t magic = BINARY_MAGIC;
+        uint16_t version = BINARY_VERSION;
+        uint16_t tick = static_cast<uint16_t>(tickPerUs_);
+        memcpy(header + 0, &magic, 4);
+        memcpy(header + 4, &version, 2);
+        memcpy(header + 6, &tick, 2);
+        memcpy(header + 8, &frequencyHz, 4);
+        append(header, sizeof(header));
+    } else {
+        char header[192];
+        int n = snprintf(header, sizeof(header),
+                         "Filetype: Flipper SubGhz RAW File\n"
+                         "Version: 1\n"
+                         "Frequency: %lu\n"
+                         "Preset: FuriHalSubGhzPresetOok650Async\n"
+                         "Protocol: RAW\n",
+                         static_cast<unsigned long>(frequencyHz));
+        append(header, n);
+    }
+
+    return flush();
+}
+
+bool SubGhzRecordManager::record(uint32_t timestampUs, const rmt_item32_t* items, size_t count) {
+    if (failed_ || !items || count == 0) return false;
+
+    if (format_ == Format::Binary) {
+        // A frame never exceeds the RMT ring size, count fits in 16 bits
+        uint16_t n = static_cast<uint16_t>(count > 0xFFFF ? 0xFFFF : count);
+        append(&timestampUs, 4);
+        append(&n, 2);
+        append(items, n * sizeof(rmt_item32_t));
+    } else {
+        // Silence between the previous frame and this one
+        if (frames_ > 0 && timestampUs > lastFrameEndUs_) {
+            pushFlipperDuration(false, timestampUs - lastFrameEndUs_);
+        }
+
+        uint32_t frameUs = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t us0 = items[i].duration0 / tickPerUs_;
+            uint32_t us1 = items[i].duration1 / tickPerUs_;
+            if (us0) pushFlipperDuration(items[i].level0, us0);
+            if (us1) pushFlipperDuration(items[i].level1, us1);
+            frameUs += us0 + us1;
+
+            // duration 0 marks the end of the RMT frame
+            if (items[i].duration0 == 0 || items[i].duration1 == 0) break;
+        }
+        lastFrameEndUs_ = timestampUs + frameUs;
+    }
+
+    frames_++;
+    pulses_ += count;
+
+    if (buf_.size() >= WRITE_BUFFER_SIZE) return flush();
+    return !failed_;
+}
+
+bool SubGhzRecordManager::end() {
+    if (format_ == Format::Flipper) {
+        flushFlipperPending();
+        if (lineValues_ > 0) {
+            append("\n", 1);
+            lineValues_ = 0;
+        }
+    }
+    return flush();
+}
+
+bool SubGhzRecordManager::append(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    buf_.insert(buf_.end(), p, p + len);
+    return true;
+}
+
+bool SubGhzRecordManager::flush() {
+    if (buf_.empty() || failed_) return !failed_;
+    if (!writer_ || !writer_(buf_.data(), buf_.size())) {
+        failed_ = true;
+        return false;
+    }
+    bytesWritten_ += buf_.size();
+    buf_.clear();
+    return true;
+}
+
+void SubGhzRecordManager::pushFlipperDuration(bool high, uint32_t us) {
+    int32_t v = high ? static_cast<int32_t>(us) : -static_cast<int32_t>(us);
+
+    // Merge consecutive durations of the same level
+    if (pendingUs_ != 0 && ((pendingUs_ > 0) == high)) {
+        pendingUs_ += v;
+        return;
+    }
+    flushFlipperPending();
+    pendingUs_ = v;
+}
+
+void SubGhzRecordManager::flushFlipperPending() {
+    if (pendingUs_ == 0) return;
+    appendFlipperValue(pendingUs_);
+    pendingUs_ = 0;
+}
+
+void SubGhzRecordManager::appendFlipperValue(int32_t us) {
+    if (lineValues_ == 0) {
+        append("RAW_Data:", 9);
+    }
+
+    char tmp[16];
+    int n = snprintf(tmp, sizeof(tmp), " %ld", static_cast<long>(us));
+    append(tmp, n);
+
+    if (++lineValues_ >= FLIPPER_LINE_VALUES) {
+        append("\n", 1);
+        lineValues_ = 0;
+    }
+}
+
+void SubGhzRecordManager::beginParse() {
+    pending_.clear();
+    headerParsed_ = false;
+    parsedFreqHz_ = 0;
+    parsedTickPerUs_ = 1;
+}
+
+bool SubGhzRecordManager::parseChunk(const uint8_t* data, size_t len, const FrameVisitor& visit) {
+    pending_.insert(pending_.end(), data, data + len);
+    size_t off = 0;
+
+    if (!headerParsed_) {
+        if (pending_.size() < BINARY_HEADER_SIZE) return true;
+
+        uint32_t magic = 0;
+        uint16_t tick = 1;
+        memcpy(&magic, pending_.data(), 4);
+        memcpy(&tick, pending_.data() + 6, 2);
+        memcpy(&parsedFreqHz_, pending_.data() + 8, 4);
+        if (magic != BINARY_MAGIC) return false;
+
+        parsedTickPerUs_ = tick ? tick : 1;
+        headerParsed_ = true;
+        off = BINARY_HEADER_SIZE;
+    }
+
+    // Consume every complete frame, keep the tail for the next chunk
+    while (pending_.size() - off >= 6) {
+        uint32_t ts = 0;
+        uint16_t n = 0;
+        memcpy(&ts, pending_.data() + off, 4);
+        memcpy(&n, pending_.data() + off + 4, 2);
+
+        size_t frameBytes = 6 + static_cast<size_t>(n) * sizeof(rmt_item32_t);
+        if (pending_.size() - off < frameBytes) break;
+
+        // Copy to an aligned buffer, frame records are packed
+        frame_.resize(n);
+        if (n) memcpy(frame_.data(), pending_.data() + off + 6, n * sizeof(rmt_item32_t));
+        off += frameBytes;
+        if (!visit(ts, frame_.data(), n)) {
+            pending_.clear();
+            return false;
+        }
+    }
+
+    pending_.erase(pending_.begin(), pending_.begin() + off);
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+#include "driver/rmt.h"
+
+/*
+Records raw RMT frames to a file without formatting them.
+
+Binary  : 12 bytes header, then per frame [u32 timestamp us][u16 count][count x rmt_item32_t]
+Flipper : "Filetype: Flipper SubGhz RAW File" + RAW_Data lines of signed durations (us)
+
+Bytes are handed to a writer callback, the storage (LittleFS, SD) is up to the caller.
+*/
+class SubGhzRecordManager {
+public:
+    enum class Format { Binary, Flipper };
+
+    using Writer       = std::function<bool(const uint8_t* data, size_t len)>;
+    using FrameVisitor = std::function<bool(uint32_t timestampUs, const rmt_item32_t* items, size_t count)>;
+
+    static constexpr uint32_t BINARY_MAGIC        = 0x46525042; // "BPRF"
+    static constexpr uint16_t BINARY_VERSION      = 1;
+    static constexpr size_t   BINARY_HEADER_SIZE  = 12;
+    static constexpr size_t   WRITE_BUFFER_SIZE   = 4096;
+    static constexpr size_t   FLIPPER_LINE_VALUES = 512;
+
+    // Start a new recording, the header is written immediately
+    bool begin(Format format, uint32_t frequencyHz, uint32_t tickPerUs, Writer writer);
+
+    // Append one frame as received from the RMT ring buffer
+    bool record(uint32_t timestampUs, const rmt_item32_t* items, size_t count);
+
+    // Flush pending bytes
+    bool end();
+
+    uint32_t framesRecorded() const { return frames_; }
+    uint32_t pulsesRecorded() const { return pulses_; }
+    uint32_t bytesWritten()   const { return bytesWritten_; }
+    bool     failed()         const { return failed_; }
+
+    // Binary file reader, fed chunk by chunk (LittleFsService::readChunks)
+    void beginParse();
+    bool parseChunk(const uint8_t* data, size_t len, const FrameVisitor& visit);
+    uint32_t parsedFrequencyHz() const { return parsedFreqHz_; }
+    uint32_t parsedTickPerUs()   const { return parsedTickPerUs_; }
+
+private:
+    Format   format_ = Format::Binary;
+    Writer   writer_;
+    uint32_t tickPerUs_ = 1;
+    std::vector<uint8_t> buf_;
+
+    uint32_t frames_ = 0;
+    uint32_t pulses_ = 0;
+    uint32_t bytesWritten_ = 0;
+    bool     failed_ = false;
+
+    // Flipper state
+    uint32_t lastFrameEndUs_ = 0;
+    int32_t  pendingUs_      = 0;   // signed duration not yet written (same level merged)
+    size_t   lineValues_     = 0;
+
+    // Parser state
+    std::vector<uint8_t> pending_;
+    std::vector<rmt_item32_t> frame_;
+    bool     headerParsed_    = false;
+    uint32_t parsedFreqHz_    = 0;
+    uint32_t parsedTickPerUs_ = 1;
+
+    bool append(const void* data, size_t len);
+    bool flush();
+    void appendFlipperValue(int32_t us);
+    void pushFlipperDuration(bool high, uint32_t us);
+    void flushFlipperPending();
+};
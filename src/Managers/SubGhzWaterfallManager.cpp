@@ -0,0 +1,127 @@
+#include "SubGhzWaterfallManager.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+// Zeroed, PSRAM first on the device, nullptr when neither heap has room
+static uint8_t* allocRing(size_t bytes) {
+#if defined(ESP_PLATFORM)
+    void* p = heap_caps_calloc(bytes, 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_calloc(bytes, 1, MALLOC_CAP_8BIT);
+    return static_cast<uint8_t*>(p);
+#else
+    return static_cast<uint8_t*>(calloc(bytes, 1));
+#endif
+}
+
+bool SubGhzWaterfallManager::begin(size_t channels, size_t depth) {
+    end();
+    if (channels == 0 || depth == 0 || depth == SIZE_MAX || channels > SIZE_MAX / (depth + 1)) return false;
+
+    // One slot more than the history, the row being measured never hides the oldest one
+    ring_ = allocRing(channels * (depth + 1));
+    if (!ring_) return false;
+
+    channels_ = channels;
+    depth_ = depth;
+    slots_ = depth + 1;
+    return true;
+}
+
+void SubGhzWaterfallManager::end() {
+    free(ring_);   // heap_caps_calloc memory is released with free() too
+    ring_ = nullptr;
+    channels_ = depth_ = slots_ = 0;
+    head_ = filled_ = 0;
+    sweeps_ = firstMs_ = lastMs_ = 0;
+}
+
+uint8_t SubGhzWaterfallManager::encode(int dbm) {
+    int v = (dbm + 128) * 2;
+    if (v < 0) v = 0;
+    if (v > 255) v = 255;
+    return static_cast<uint8_t>(v);
+}
+
+void SubGhzWaterfallManager::setCell(size_t channel, int dbm) {
+    if (channel >= channels_) return;
+    ring_[head_ * channels_ + channel] = encode(dbm);
+}
+
+void SubGhzWaterfallManager::commitRow(uint32_t nowMs) {
+    if (depth_ == 0) return;
+
+    if (sweeps_ == 0) firstMs_ = nowMs;
+    lastMs_ = nowMs;
+    sweeps_++;
+
+    head_ = (head_ + 1) % slots_;
+    if (filled_ < depth_) filled_++;
+
+    // The oldest row is reused for the next sweep
+    memset(&ring_[head_ * channels_], 0, channels_);
+}
+
+const uint8_t* SubGhzWaterfallManager::row(size_t age) const {
+    if (age >= filled_) return nullptr;
+    const size_t slot = (head_ + slots_ - 1 - age) % slots_;
+    return &ring_[slot * channels_];
+}
+
+float SubGhzWaterfallManager::sweepsPerSecond() const {
+    if (sweeps_ < 2 || lastMs_ == firstMs_) return 0.f;
+    return (sweeps_ - 1) * 1000.f / static_cast<float>(lastMs_ - firstMs_);
+}
+
+int SubGhzWaterfallManager::peakDbm(size_t channel, size_t rowsBack) const {
+    uint8_t best = 0;
+    if (channel >= channels_) return decode(best);
+    for (size_t age = 0; age < rowsBack && age < filled_; ++age) {
+        const uint8_t v = row(age)[channel];
+        if (v > best) best = v;
+    }
+    return decode(best);
+}
+
+std::string SubGhzWaterfallManager::heatmap(size_t rowsBack, size_t cols, int floorDbm, int spanDb) const {
+    std::string out;
+    if (channels_ == 0 || cols == 0 || spanDb <= 0) return out;
+    if (cols > channels_) cols = channels_;
+    out.reserve(cols);
+
+    const size_t levels = strlen(HEAT_CHARS);
+    for (size_t c = 0; c < cols; ++c) {
+        // Channels folded into this column
+        const size_t from = c * channels_ / cols;
+        const size_t to   = (c + 1) * channels_ / cols;
+
+        uint8_t best = 0;
+        for (size_t age = 0; age < rowsBack && age < filled_; ++age) {
+            const uint8_t* r = row(age);
+            for (size_t ch = from; ch < to; ++ch) if (r[ch] > best) best = r[ch];
+        }
+
+        int level = (decode(best) - floorDbm) * static_cast<int>(levels) / spanDb;
+        if (level < 0) level = 0;
+        if (level >= static_cast<int>(levels)) level = static_cast<int>(levels) - 1;
+        out.push_back(HEAT_CHARS[level]);
+    }
+    return out;
+}
+
+void SubGhzWaterfallManager::normalizeRow(const uint8_t* src, std::vector<uint8_t>& out, int floorDbm, int spanDb) const {
+    out.resize(channels_);
+    if (!src || spanDb <= 0) {
+        std::fill(out.begin(), out.end(), 0);
+        return;
+    }
+    for (size_t ch = 0; ch < channels_; ++ch) {
+        int v = (decode(src[ch]) - floorDbm) * 255 / spanDb;
+        if (v < 0) v = 0;
+        if (v > 255) v = 255;
+        out[ch] = static_cast<uint8_t>(v);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Rolling RSSI history, one row per sweep, one byte per channel.
+A byte holds (dBm + 128) * 2 so the CC1101 0.5 dB steps fit in 8 bits.
+The row being measured is written in place in the ring, commitRow()
+makes it the newest row.
+The ring is allocated without exceptions, in PSRAM when the board has it.
+*/
+class SubGhzWaterfallManager {
+public:
+    static constexpr const char* HEAT_CHARS = " .:-=+*#%@";
+
+    SubGhzWaterfallManager() = default;
+    ~SubGhzWaterfallManager() { end(); }
+    SubGhzWaterfallManager(const SubGhzWaterfallManager&) = delete;
+    SubGhzWaterfallManager& operator=(const SubGhzWaterfallManager&) = delete;
+
+    // Allocate channels x (depth + 1) bytes, false if the memory is not available
+    bool begin(size_t channels, size_t depth);
+    void end();
+
+    // Write the RSSI of a channel in the row being measured
+    void setCell(size_t channel, int dbm);
+
+    // The measured row becomes the newest, nowMs is used for the sweep rate
+    void commitRow(uint32_t nowMs);
+
+    // Row by age, 0 = newest, nullptr if not recorded yet
+    const uint8_t* row(size_t age) const;
+
+    // Strongest dBm of a channel over the last rows
+    int peakDbm(size_t channel, size_t rowsBack) const;
+
+    // Max hold over the last rows, condensed to cols characters
+    std::string heatmap(size_t rowsBack, size_t cols, int floorDbm, int spanDb) const;
+
+    // Scale a row to 0..255 between floorDbm and floorDbm + spanDb, for the device view
+    void normalizeRow(const uint8_t* src, std::vector<uint8_t>& out, int floorDbm, int spanDb) const;
+
+    size_t   channels()    const { return channels_; }
+    size_t   depth()       const { return depth_; }
+    size_t   rows()        const { return filled_; }
+    uint32_t sweeps()      const { return sweeps_; }
+    size_t   memoryBytes() const { return channels_ * slots_; }
+    float    sweepsPerSecond() const;
+
+    static uint8_t encode(int dbm);
+    static int     decode(uint8_t v) { return static_cast<int>(v) / 2 - 128; }
+
+private:
+    uint8_t* ring_     = nullptr;
+    size_t   channels_ = 0;
+    size_t   depth_    = 0;
+    size_t   slots_    = 0;     // depth rows and the one being measured
+    size_t   head_     = 0;     // slot of the row being measured
+    size_t   filled_   = 0;
+    uint32_t sweeps_   = 0;
+    uint32_t firstMs_  = 0;
+    uint32_t lastMs_   = 0;
+};
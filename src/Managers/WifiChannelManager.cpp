@@ -0,0 +1,136 @@
+#include "WifiChannelManager.h"
+#include <cstdlib>
+
+bool WifiChannelManager::begin(const std::vector<uint8_t>& channels, Mode mode, uint32_t nowMs) {
+    stats_.clear();
+    for (uint8_t ch : channels) {
+        if (ch == 0 || ch > MAX_CHANNEL) return false;
+        ChannelStats s;
+        s.channel = ch;
+        stats_.push_back(s);
+    }
+    if (stats_.empty()) return false;
+    if (mode == Mode::Pinned) stats_.resize(1);
+
+    for (uint8_t ch = 0; ch <= MAX_CHANNEL; ++ch) {
+        seen_[ch] = counters_[ch].load(std::memory_order_relaxed);
+    }
+
+    mode_ = mode;
+    index_ = 0;
+    startMs_ = enteredMs_ = nowMs;
+    dwellMs_ = dwellFor(0);
+    return true;
+}
+
+void WifiChannelManager::countFrame(uint8_t channel) {
+    if (channel <= MAX_CHANNEL) counters_[channel].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t WifiChannelManager::advance(uint32_t nowMs) {
+    if (stats_.empty()) return dwellMs_;
+
+    // Channel just left
+    ChannelStats& s = stats_[index_];
+    const uint32_t count = counters_[s.channel].load(std::memory_order_relaxed);
+    const uint32_t frames = count - seen_[s.channel];
+    seen_[s.channel] = count;
+
+    const uint32_t spent = nowMs - enteredMs_;
+    s.frames += frames;
+    s.dwellMs += spent;
+    if (spent > 0) {
+        const float rate = frames * 1000.f / spent;
+        s.rate = s.visits == 0 ? rate : s.rate + RATE_SMOOTHING * (rate - s.rate);
+    }
+    s.visits++;
+
+    index_ = (index_ + 1) % stats_.size();
+    enteredMs_ = nowMs;
+    dwellMs_ = dwellFor(index_);
+    return dwellMs_;
+}
+
+uint32_t WifiChannelManager::skip(uint32_t nowMs) {
+    if (stats_.empty()) return dwellMs_;
+
+    // Nothing was captured on it, the counter restarts from here
+    ChannelStats& s = stats_[index_];
+    seen_[s.channel] = counters_[s.channel].load(std::memory_order_relaxed);
+    s.failed++;
+
+    index_ = (index_ + 1) % stats_.size();
+    enteredMs_ = nowMs;
+    dwellMs_ = dwellFor(index_);
+    return dwellMs_;
+}
+
+uint32_t WifiChannelManager::dwellFor(size_t index) const {
+    if (mode_ == Mode::Pinned) return PINNED_DWELL_MS;
+    if (mode_ == Mode::Fixed) return FIXED_DWELL_MS;
+
+    // Same cycle length as the fixed schedule, shared by frame rate
+    float total = 0.f;
+    for (const auto& s : stats_) total += s.rate;
+    if (total <= 0.f) return FIXED_DWELL_MS;
+
+    const uint32_t cycle = FIXED_DWELL_MS * static_cast<uint32_t>(stats_.size());
+    const uint32_t floor = MIN_DWELL_MS * static_cast<uint32_t>(stats_.size());
+    const uint32_t spare = cycle > floor ? cycle - floor : 0;
+    uint32_t dwell = MIN_DWELL_MS + static_cast<uint32_t>(spare * (stats_[index].rate / total));
+    return dwell > MAX_DWELL_MS ? MAX_DWELL_MS : dwell;
+}
+
+uint32_t WifiChannelManager::totalFrames() const {
+    uint32_t total = 0;
+    for (const auto& s : stats_) total += s.frames;
+    return total;
+}
+
+bool WifiChannelManager::parseChannels(const std::string& spec, std::vector<uint8_t>& out) {
+    out.clear();
+    uint8_t last = 0;
+    if (spec == "us") last = 11;
+    else if (spec == "eu") last = 13;
+    else if (spec == "jp") last = 14;
+    if (last) {
+        for (uint8_t ch = 1; ch <= last; ++ch) out.push_back(ch);
+        return true;
+    }
+
+    bool used[MAX_CHANNEL + 1] = {};
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string item = spec.substr(start, comma - start);
+        start = comma + 1;
+        if (item.empty()) continue;
+
+        // Single channel or range
+        char* end = nullptr;
+        long from = std::strtol(item.c_str(), &end, 10);
+        long to = from;
+        if (*end == '-') to = std::strtol(end + 1, &end, 10);
+        if (*end != '\0' || from < 1 || to > MAX_CHANNEL || from > to) {
+            out.clear();
+            return false;
+        }
+
+        for (long ch = from; ch <= to; ++ch) {
+            if (used[ch]) continue;
+            used[ch] = true;
+            out.push_back(static_cast<uint8_t>(ch));
+        }
+    }
+    return !out.empty();
+}
+
+const char* WifiChannelManager::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::Fixed:    return "fixed";
+        case Mode::Adaptive: return "adaptive";
+        case Mode::Pinned:   return "pinned";
+    }
+    return "?";
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Channel hopping schedule of the Wi-Fi sniffer.
+
+Frames are counted per channel by the capture callback (countFrame, lock
+free). At the end of each dwell the hopper calls advance(), which updates
+the frame rate of the channel just left and returns the dwell of the next
+one. Every channel of the set is visited once per cycle:
+  Fixed     same dwell everywhere, the old behaviour, for comparison
+  Adaptive  the cycle time is shared by frame rate, a quiet channel still
+            gets MIN_DWELL_MS so a new network shows up on the next cycle
+  Pinned    a single channel, advance() only refreshes the statistics
+A channel the radio refuses to tune is passed with skip(), it gets no
+frames, dwell or visit for that turn. No Arduino dependency.
+*/
+class WifiChannelManager {
+public:
+    enum class Mode : uint8_t { Fixed, Adaptive, Pinned };
+
+    struct ChannelStats {
+        uint8_t  channel = 0;
+        uint32_t frames  = 0;
+        uint32_t dwellMs = 0;       // total time spent on the channel
+        uint32_t visits  = 0;
+        uint32_t failed  = 0;       // switches to the channel the radio refused
+        float    rate    = 0.f;     // frames per second, smoothed over the visits
+    };
+
+    static constexpr uint8_t  MAX_CHANNEL      = 14;
+    static constexpr uint32_t FIXED_DWELL_MS   = 100;
+    static constexpr uint32_t MIN_DWELL_MS     = 40;
+    static constexpr uint32_t MAX_DWELL_MS     = 600;
+    static constexpr uint32_t PINNED_DWELL_MS  = 250;
+    static constexpr float    RATE_SMOOTHING   = 0.5f;   // weight of the last visit
+
+    bool begin(const std::vector<uint8_t>& channels, Mode mode, uint32_t nowMs);
+
+    // Capture callback side
+    void countFrame(uint8_t channel);
+
+    // End of the dwell on current(), returns the dwell of the new current()
+    uint32_t advance(uint32_t nowMs);
+
+    // current() could not be tuned, moves on without crediting it, returns the dwell of the new current()
+    uint32_t skip(uint32_t nowMs);
+
+    uint8_t  current() const { return stats_.empty() ? 0 : stats_[index_].channel; }
+    uint32_t dwellMs() const { return dwellMs_; }
+    Mode     mode()    const { return mode_; }
+
+    const std::vector<ChannelStats>& stats() const { return stats_; }
+    uint32_t totalFrames() const;
+    uint32_t elapsedMs(uint32_t nowMs) const { return nowMs - startMs_; }
+
+    // "us" (1-11), "eu" (1-13), "jp" (1-14) or a list such as "1,6,11" / "1-6,11"
+    static bool parseChannels(const std::string& spec, std::vector<uint8_t>& out);
+    static const char* modeName(Mode mode);
+
+private:
+    std::vector<ChannelStats> stats_;
+    std::atomic<uint32_t>     counters_[MAX_CHANNEL + 1] = {};
+    uint32_t                  seen_[MAX_CHANNEL + 1] = {};     // counter at the last advance
+    Mode                      mode_      = Mode::Fixed;
+    size_t                    index_     = 0;
+    uint32_t                  dwellMs_   = FIXED_DWELL_MS;
+    uint32_t                  startMs_   = 0;
+    uint32_t                  enteredMs_ = 0;
+
+    uint32_t dwellFor(size_t index) const;
+};
@@ -0,0 +1,189 @@
+#include "WifiSniffManager.h"
+#include <cstring>
+
+namespace {
+
+void putLe16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putLe32(std::vector<uint8_t>& out, uint32_t v) {
+    putLe16(out, static_cast<uint16_t>(v));
+    putLe16(out, static_cast<uint16_t>(v >> 16));
+}
+
+}
+
+bool WifiSniffManager::begin(size_t slots, size_t snapLen) {
+    end();
+    if (slots < 2) return false;
+
+    // Slots are kept 4 byte aligned for the descriptor
+    slotBytes_ = (SLOT_HEADER + snapLen + 3) & ~static_cast<size_t>(3);
+    storage_.assign(slots * slotBytes_, 0);
+    slots_ = slots;
+    snapLen_ = snapLen;
+    return true;
+}
+
+void WifiSniffManager::end() {
+    pcapEnd();
+    std::vector<uint8_t>().swap(storage_);
+    slots_ = slotBytes_ = snapLen_ = 0;
+    head_.store(0);
+    tail_.store(0);
+    received_.store(0);
+    dropped_.store(0);
+}
+
+bool WifiSniffManager::push(const Frame& frame, const uint8_t* payload) {
+    if (slots_ == 0) return false;
+    received_.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t next = static_cast<uint32_t>((head + 1) % slots_);
+    if (next == tail_.load(std::memory_order_acquire)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* slot = &storage_[head * slotBytes_];
+    Frame f = frame;
+    if (f.captured > snapLen_) f.captured = static_cast<uint16_t>(snapLen_);
+    if (!payload) f.captured = 0;
+    memcpy(slot, &f, SLOT_HEADER);
+    if (f.captured) memcpy(slot + SLOT_HEADER, payload, f.captured);
+
+    head_.store(next, std::memory_order_release);
+    return true;
+}
+
+const uint8_t* WifiSniffManager::peek(Frame& out) const {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (slots_ == 0 || tail == head_.load(std::memory_order_acquire)) return nullptr;
+
+    const uint8_t* slot = &storage_[tail * slotBytes_];
+    memcpy(&out, slot, SLOT_HEADER);
+    return slot + SLOT_HEADER;
+}
+
+void WifiSniffManager::release() {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (slots_ == 0 || tail == head_.load(std::memory_order_acquire)) return;
+    tail_.store(static_cast<uint32_t>((tail + 1) % slots_), std::memory_order_release);
+}
+
+size_t WifiSniffManager::pending() const {
+    if (slots_ == 0) return 0;
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    return (head + slots_ - tail) % slots_;
+}
+
+bool WifiSniffManager::pcapBegin(size_t bufferBytes) {
+    pcapEnd();
+
+    // At least one full frame must fit
+    const size_t minimum = PCAP_FILE_HEADER + PCAP_RECORD_HEADER + RADIOTAP_LEN + snapLen_;
+    if (bufferBytes < minimum) bufferBytes = minimum;
+
+    for (auto& b : pcapBuffers_) {
+        b.clear();
+        b.reserve(bufferBytes);
+    }
+    pcapCapacity_ = bufferBytes;
+    pcapActive_ = 0;
+    pcapQueued_.store(-1);
+    pcapFrames_ = pcapDropped_ = 0;
+    pcapBytes_ = 0;
+    pcapEpochUs_ = 0;
+    pcapLastUs_ = 0;
+
+    writePcapHeader(pcapBuffers_[0]);
+    return true;
+}
+
+void WifiSniffManager::pcapEnd() {
+    for (auto& b : pcapBuffers_) std::vector<uint8_t>().swap(b);
+    pcapCapacity_ = 0;
+    pcapQueued_.store(-1);
+}
+
+bool WifiSniffManager::pcapAppend(const Frame& frame, const uint8_t* payload) {
+    if (!pcapActive()) return false;
+
+    const size_t need = PCAP_RECORD_HEADER + RADIOTAP_LEN + frame.captured;
+    if (pcapBuffers_[pcapActive_].size() + need > pcapCapacity_ && !pcapFlush()) {
+        pcapDropped_++;
+        return false;
+    }
+
+    // The radio clock wraps every ~71 minutes
+    if (frame.timestampUs < pcapLastUs_) pcapEpochUs_ += 1ull << 32;
+    pcapLastUs_ = frame.timestampUs;
+
+    std::vector<uint8_t>& buf = pcapBuffers_[pcapActive_];
+    const size_t before = buf.size();
+    writePcapRecord(buf, frame, payload, pcapEpochUs_ + frame.timestampUs);
+    pcapBytes_ += buf.size() - before;
+    pcapFrames_++;
+    return true;
+}
+
+bool WifiSniffManager::pcapFlush() {
+    if (!pcapActive()) return false;
+    if (pcapBuffers_[pcapActive_].empty()) return true;
+    if (pcapQueued_.load(std::memory_order_acquire) >= 0) return false;
+
+    // The other buffer was written, it becomes the one being filled
+    pcapQueued_.store(static_cast<int8_t>(pcapActive_), std::memory_order_release);
+    pcapActive_ ^= 1;
+    pcapBuffers_[pcapActive_].clear();
+    return true;
+}
+
+const std::vector<uint8_t>* WifiSniffManager::pcapQueued() const {
+    const int8_t q = pcapQueued_.load(std::memory_order_acquire);
+    return q < 0 ? nullptr : &pcapBuffers_[q];
+}
+
+void WifiSniffManager::pcapWritten() {
+    pcapQueued_.store(-1, std::memory_order_release);
+}
+
+void WifiSniffManager::writePcapHeader(std::vector<uint8_t>& out) {
+    putLe32(out, 0xA1B2C3D4);   // microsecond timestamps
+    putLe16(out, 2);
+    putLe16(out, 4);
+    putLe32(out, 0);            // thiszone
+    putLe32(out, 0);            // sigfigs
+    putLe32(out, PCAP_SNAPLEN);
+    putLe32(out, LINKTYPE_RADIOTAP);
+}
+
+void WifiSniffManager::writePcapRecord(std::vector<uint8_t>& out, const Frame& frame, const uint8_t* payload, uint64_t timestampUs) {
+    const uint16_t captured = payload ? frame.captured : 0;
+
+    putLe32(out, static_cast<uint32_t>(timestampUs / 1000000));
+    putLe32(out, static_cast<uint32_t>(timestampUs % 1000000));
+    putLe32(out, static_cast<uint32_t>(RADIOTAP_LEN + captured));
+    putLe32(out, static_cast<uint32_t>(RADIOTAP_LEN + frame.length));
+
+    // Radiotap, present: channel (bit 3), dBm antenna signal (bit 5)
+    out.push_back(0);
+    out.push_back(0);
+    putLe16(out, static_cast<uint16_t>(RADIOTAP_LEN));
+    putLe32(out, (1u << 3) | (1u << 5));
+    putLe16(out, channelMhz(frame.channel));
+    putLe16(out, 0x0080);       // 2 GHz spectrum
+    out.push_back(static_cast<uint8_t>(frame.rssi));
+
+    out.insert(out.end(), payload, payload + captured);
+}
+
+uint16_t WifiSniffManager::channelMhz(uint8_t channel) {
+    if (channel == 14) return 2484;
+    if (channel >= 1 && channel <= 13) return static_cast<uint16_t>(2407 + 5 * channel);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Capture path of the Wi-Fi sniffer.
+
+The promiscuous callback only copies a fixed size descriptor and the first
+snapLen bytes of the frame into a single producer / single consumer ring,
+no allocation and no lock. A full ring drops the frame and counts it. The
+reader drains the ring, formats what it displays, and can feed a PCAP
+stream: frames are encoded (radiotap header with channel and RSSI) into
+one of two buffers while the other one is written to the card. When both
+are busy the frame is counted as a PCAP drop. No Arduino dependency.
+*/
+class WifiSniffManager {
+public:
+    struct Frame {
+        uint32_t timestampUs = 0;
+        uint16_t length      = 0;   // on air, without FCS
+        uint16_t captured    = 0;   // bytes stored, <= snapLen
+        int8_t   rssi        = 0;
+        uint8_t  channel     = 0;
+        uint8_t  type        = 0;   // 0 mgmt, 1 ctrl, 2 data
+        uint8_t  subtype     = 0;
+    };
+
+    static constexpr uint32_t PCAP_SNAPLEN       = 2346;  // largest 802.11 MPDU
+    static constexpr uint32_t LINKTYPE_RADIOTAP  = 127;
+    static constexpr size_t   RADIOTAP_LEN       = 13;    // header, channel, dBm signal
+    static constexpr size_t   PCAP_RECORD_HEADER = 16;
+    static constexpr size_t   PCAP_FILE_HEADER   = 24;
+
+    // Ring of slots frames, each with up to snapLen payload bytes
+    bool begin(size_t slots, size_t snapLen);
+    void end();
+
+    // Producer side, called from the Wi-Fi callback
+    bool push(const Frame& frame, const uint8_t* payload);
+
+    // Consumer side, the oldest frame stays valid until release()
+    const uint8_t* peek(Frame& out) const;
+    void release();
+    size_t pending() const;
+
+    uint32_t received() const { return received_.load(std::memory_order_relaxed); }
+    uint32_t dropped()  const { return dropped_.load(std::memory_order_relaxed); }
+    size_t   snapLen()  const { return snapLen_; }
+    size_t   memoryBytes() const { return storage_.capacity() + pcapBuffers_[0].capacity() + pcapBuffers_[1].capacity(); }
+
+    // PCAP stream, the file header is in the first buffer
+    bool pcapBegin(size_t bufferBytes);
+    void pcapEnd();
+    bool pcapActive() const { return pcapCapacity_ != 0; }
+
+    // Encode a frame, a full buffer is queued for writing
+    bool pcapAppend(const Frame& frame, const uint8_t* payload);
+
+    // Queue the buffer being filled, false if a write is still queued
+    bool pcapFlush();
+
+    // Writer side, the queued buffer or nullptr, then pcapWritten()
+    const std::vector<uint8_t>* pcapQueued() const;
+    void pcapWritten();
+
+    uint32_t pcapFrames()  const { return pcapFrames_; }
+    uint32_t pcapDropped() const { return pcapDropped_; }
+    uint64_t pcapBytes()   const { return pcapBytes_; }
+
+    static void writePcapHeader(std::vector<uint8_t>& out);
+    static void writePcapRecord(std::vector<uint8_t>& out, const Frame& frame, const uint8_t* payload, uint64_t timestampUs);
+    static uint16_t channelMhz(uint8_t channel);
+
+private:
+    static constexpr size_t SLOT_HEADER = sizeof(Frame);
+
+    std::vector<uint8_t>  storage_;
+    size_t                slots_      = 0;
+    size_t                slotBytes_  = 0;
+    size_t                snapLen_    = 0;
+    std::atomic<uint32_t> head_{0};     // next slot written by the producer
+    std::atomic<uint32_t> tail_{0};     // next slot read by the consumer
+    std::atomic<uint32_t> received_{0};
+    std::atomic<uint32_t> dropped_{0};
+
+    std::vector<uint8_t>  pcapBuffers_[2];
+    size_t                pcapCapacity_ = 0;
+    uint8_t               pcapActive_   = 0;
+    std::atomic<int8_t>   pcapQueued_{-1};
+    uint32_t              pcapFrames_   = 0;
+    uint32_t              pcapDropped_  = 0;
+    uint64_t              pcapBytes_    = 0;
+    uint64_t              pcapEpochUs_  = 0;
+    uint32_t              pcapLastUs_   = 0;
+};
@@ -0,0 +1,204 @@
+#include "WifiStationManager.h"
+#include <cstring>
+#include <algorithm>
+
+bool WifiStationManager::begin(size_t slots) {
+    size_t n = 8;
+    while (n < slots && n < MAX_SLOTS) n <<= 1;
+
+    slots_.assign(n, Slot());
+    mask_ = n - 1;
+    limit_ = n - n / 4;
+    clear();
+    return true;
+}
+
+void WifiStationManager::end() {
+    std::vector<Slot>().swap(slots_);
+    mask_ = limit_ = 0;
+    count_ = 0;
+    newest_ = oldest_ = NONE;
+    evicted_ = 0;
+}
+
+void WifiStationManager::clear() {
+    for (auto& s : slots_) s = Slot();
+    count_ = 0;
+    newest_ = oldest_ = NONE;
+    evicted_ = 0;
+}
+
+uint32_t WifiStationManager::hash(const uint8_t mac[6]) {
+    // FNV-1a, the OUI bytes alone spread badly
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 6; ++i) h = (h ^ mac[i]) * 16777619u;
+    return h ^ (h >> 15);
+}
+
+size_t WifiStationManager::probe(const uint8_t mac[6], bool& found) const {
+    size_t i = hash(mac) & mask_;
+    while (slots_[i].used) {
+        if (memcmp(slots_[i].station.mac, mac, 6) == 0) {
+            found = true;
+            return i;
+        }
+        i = (i + 1) & mask_;
+    }
+    found = false;
+    return i;
+}
+
+const WifiStationManager::Station* WifiStationManager::find(const uint8_t mac[6]) const {
+    if (slots_.empty()) return nullptr;
+    bool found = false;
+    size_t i = probe(mac, found);
+    return found ? &slots_[i].station : nullptr;
+}
+
+WifiStationManager::Station* WifiStationManager::touch(const uint8_t mac[6], uint32_t nowMs) {
+    if (slots_.empty()) return nullptr;
+
+    bool found = false;
+    size_t i = probe(mac, found);
+    if (found) {
+        unlink(static_cast<uint16_t>(i));
+        pushFront(static_cast<uint16_t>(i));
+        slots_[i].station.lastMs = nowMs;
+        return &slots_[i].station;
+    }
+
+    // Full, the least recently seen entry makes room
+    if (count_ >= limit_) {
+        erase(oldest_);
+        evicted_++;
+        i = probe(mac, found);
+    }
+
+    Slot& slot = slots_[i];
+    slot = Slot();
+    slot.used = true;
+    memcpy(slot.station.mac, mac, 6);
+    slot.station.firstMs = slot.station.lastMs = nowMs;
+    pushFront(static_cast<uint16_t>(i));
+    count_++;
+    return &slot.station;
+}
+
+void WifiStationManager::unlink(uint16_t index) {
+    Slot& s = slots_[index];
+    if (s.prev != NONE) slots_[s.prev].next = s.next; else newest_ = s.next;
+    if (s.next != NONE) slots_[s.next].prev = s.prev; else oldest_ = s.prev;
+    s.prev = s.next = NONE;
+}
+
+void WifiStationManager::pushFront(uint16_t index) {
+    Slot& s = slots_[index];
+    s.prev = NONE;
+    s.next = newest_;
+    if (newest_ != NONE) slots_[newest_].prev = index;
+    newest_ = index;
+    if (oldest_ == NONE) oldest_ = index;
+}
+
+void WifiStationManager::move(size_t from, size_t to) {
+    // The entry keeps its place in the recency list
+    slots_[to] = slots_[from];
+    Slot& s = slots_[to];
+    const uint16_t t = static_cast<uint16_t>(to);
+    if (s.prev != NONE) slots_[s.prev].next = t; else newest_ = t;
+    if (s.next != NONE) slots_[s.next].prev = t; else oldest_ = t;
+    slots_[from] = Slot();
+}
+
+void WifiStationManager::erase(size_t index) {
+    unlink(static_cast<uint16_t>(index));
+    slots_[index] = Slot();
+    count_--;
+
+    // Backward shift, the entries after the hole stay reachable without tombstones
+    size_t hole = index;
+    size_t j = (index + 1) & mask_;
+    while (slots_[j].used) {
+        const size_t home = hash(slots_[j].station.mac) & mask_;
+        const size_t distHole = (hole - home) & mask_;
+        const size_t distJ = (j - home) & mask_;
+        if (distHole < distJ) {
+            move(j, hole);
+            hole = j;
+        }
+        j = (j + 1) & mask_;
+    }
+}
+
+bool WifiStationManager::ingest(const uint8_t* frame, size_t length, int8_t rssi, uint8_t channel, uint32_t nowMs) {
+    // Frame control, duration, addr1, addr2; ACK and CTS have no transmitter
+    if (!frame || length < 16) return false;
+
+    const uint8_t type = (frame[0] >> 2) & 0x03;
+    const uint8_t subtype = (frame[0] >> 4) & 0x0F;
+    const uint8_t flags = frame[1];
+    if (type > 2) return false;
+
+    Station* s = touch(frame + 10, nowMs);
+    if (!s) return false;
+
+    const uint32_t before = s->total();
+    s->frames[type]++;
+    s->rssiSum += rssi;
+    if (before == 0 || rssi < s->rssiMin) s->rssiMin = rssi;
+    if (before == 0 || rssi > s->rssiMax) s->rssiMax = rssi;
+    s->channel = channel;
+
+    if (type == 0) {
+        if (subtype == 8 || subtype == 5) {            // beacon, probe response
+            s->ap = true;
+            readSsid(frame, length, 36, *s);
+        } else if (subtype == 4) {                     // probe request
+            readSsid(frame, length, 24, *s);
+        }
+    } else if (type == 2) {
+        const bool toDs = flags & 0x01;
+        const bool fromDs = flags & 0x02;
+        if (fromDs && !toDs) s->ap = true;             // sent by the access point
+    }
+    return true;
+}
+
+void WifiStationManager::readSsid(const uint8_t* frame, size_t length, size_t offset, Station& s) {
+    while (offset + 2 <= length) {
+        const uint8_t id = frame[offset];
+        const uint8_t len = frame[offset + 1];
+        if (offset + 2 + len > length) return;
+
+        if (id == 0) {
+            // Hidden networks send an empty or zeroed SSID, the known one is kept
+            if (len == 0 || len > SSID_MAX || frame[offset + 2] == 0) return;
+            memcpy(s.ssid, frame + offset + 2, len);
+            s.ssid[len] = '\0';
+            s.ssidLen = len;
+            return;
+        }
+        offset += 2 + len;
+    }
+}
+
+std::vector<const WifiStationManager::Station*> WifiStationManager::sorted(size_t max) const {
+    std::vector<const Station*> out;
+    out.reserve(count_);
+    for (const auto& slot : slots_) {
+        if (slot.used) out.push_back(&slot.station);
+    }
+
+    auto better = [](const Station* a, const Station* b) {
+        if (a->ap != b->ap) return a->ap;
+        if (a->total() != b->total()) return a->total() > b->total();
+        return memcmp(a->mac, b->mac, 6) < 0;
+    };
+    if (out.size() > max) {
+        std::partial_sort(out.begin(), out.begin() + max, out.end(), better);
+        out.resize(max);
+    } else {
+        std::sort(out.begin(), out.end(), better);
+    }
+    return out;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Table of the access points and stations heard by the Wi-Fi sniffer.
+
+One entry per transmitter MAC with first/last seen, frame counts by type,
+RSSI min/avg/max, channel and SSID (network name for an access point, last
+probed network for a station). Open addressing with linear probing over a
+power of two number of slots, at most 3/4 used. When full the least
+recently seen entry is evicted, the recency order is a linked list through
+the slots so a frame costs one probe sequence and no allocation.
+No Arduino dependency.
+*/
+class WifiStationManager {
+public:
+    static constexpr size_t SSID_MAX = 32;
+
+    struct Station {
+        uint8_t  mac[6]    = {};
+        bool     ap        = false;
+        uint8_t  channel   = 0;
+        int8_t   rssiMin   = 0;
+        int8_t   rssiMax   = 0;
+        uint8_t  ssidLen   = 0;
+        char     ssid[SSID_MAX + 1] = {};
+        uint32_t firstMs   = 0;
+        uint32_t lastMs    = 0;
+        uint32_t frames[3] = {};    // management, control, data
+        int32_t  rssiSum   = 0;
+
+        uint32_t total() const { return frames[0] + frames[1] + frames[2]; }
+        int      rssiAvg() const { return total() ? static_cast<int>(rssiSum / static_cast<int32_t>(total())) : 0; }
+    };
+
+    static constexpr size_t MAX_SLOTS = 32768;   // slot indices stay below the 16 bit NONE link
+
+    // Slots rounded up to a power of two, at least 8 and at most MAX_SLOTS
+    bool begin(size_t slots);
+    void end();
+    void clear();
+
+    // Parse an 802.11 header (and SSID element) and update its transmitter, false if not usable
+    bool ingest(const uint8_t* frame, size_t length, int8_t rssi, uint8_t channel, uint32_t nowMs);
+
+    // Entry of a transmitter, created (and an old one evicted) if needed
+    Station* touch(const uint8_t mac[6], uint32_t nowMs);
+    const Station* find(const uint8_t mac[6]) const;
+
+    // Access points first, then by frame count
+    std::vector<const Station*> sorted(size_t max) const;
+
+    size_t   size()      const { return count_; }
+    size_t   capacity()  const { return limit_; }
+    uint32_t evicted()   const { return evicted_; }
+    size_t   memoryBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+    static uint32_t hash(const uint8_t mac[6]);
+
+private:
+    static constexpr uint16_t NONE = 0xFFFF;
+
+    struct Slot {
+        Station  station;
+        bool     used = false;
+        uint16_t prev = NONE;       // more recent
+        uint16_t next = NONE;       // less recent
+    };
+
+    std::vector<Slot> slots_;
+    size_t   mask_    = 0;
+    size_t   limit_   = 0;
+    size_t   count_   = 0;
+    uint16_t newest_  = NONE;
+    uint16_t oldest_  = NONE;
+    uint32_t evicted_ = 0;
+
+    size_t probe(const uint8_t mac[6], bool& found) const;
+    void unlink(uint16_t index);
+    void pushFront(uint16_t index);
+    void erase(size_t index);
+    void move(size_t from, size_t to);
+
+    static void readSsid(const uint8_t* frame, size_t length, size_t offset, Station& s);
+};
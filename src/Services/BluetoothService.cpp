@@ -1,10 +1,9 @@
 #include "BluetoothService.h"
 
 // 嗅探器静态变量
-std::vector<std::string> BluetoothService::bluetoothSniffLog;
-portMUX_TYPE BluetoothService::bluetoothSniffMux = portMUX_INITIALIZER_UNLOCKED;
+BluetoothDeviceManager BluetoothService::deviceTable;
+std::mutex BluetoothService::deviceMutex;
 BLEScan* BluetoothService::bleScan = nullptr;
-std::string BluetoothService::lastAdParsed = "";
 
 // 连接/断开回调类
 class BluetoothServerCallbacks : public BLEServerCallbacks {
@@ -187,30 +186,22 @@ void BluetoothService::switchToMode(BluetoothMode newMode) {
     mode = newMode;
 }
 
-std::vector<std::string> BluetoothService::scanDevices(int seconds) {
+bool BluetoothService::startScan(bool active, uint16_t intervalMs, uint16_t windowMs) {
+    if (intervalMs < 3 || intervalMs > 10240 || windowMs < 3 || windowMs > intervalMs) return false; // BLE允许2.5ms至10.24s
+
     switchToMode(BluetoothMode::CLIENT);
     stopPassiveBluetoothSniffing();
+    startTableScan(active, intervalMs, windowMs);
+    return true;
+}
 
-    auto scan = BLEDevice::getScan();
-    scan->setActiveScan(true);
-    auto results = scan->start(seconds);
-
-    std::vector<std::string> formattedDevices;
-
-    for (int i = 0; i < results.getCount(); ++i) {
-        BLEAdvertisedDevice device = results.getDevice(i);
-
-        std::string name = device.getName().empty() ? "(未知设备)" : device.getName();
-        std::string addr = device.getAddress().toString();
-        int rssi = device.getRSSI();
-        std::string type = isLikelyConnectable(device) ? "可连接" : "不可连接";
-        std::string entry = addr + " | " + name + " | RSSI: " + std::to_string(rssi) + " | 类型: " + type;
-
-        formattedDevices.push_back(entry);
-    }
+void BluetoothService::stopScan() {
+    stopPassiveBluetoothSniffing();
+}
 
-    scan->clearResults();
-    return formattedDevices;
+std::vector<BluetoothDeviceManager::View> BluetoothService::takeNewDevices() {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    return deviceTable.takeNew();
 }
 
 std::vector<std::string> BluetoothService::connectTo(const std::string& addr) {
@@ -300,50 +291,40 @@ void BluetoothService::clearBondedDevices() {
 }
 
 void BluetoothService::PassiveAdvertisedDeviceCallbacks::onResult(BLEAdvertisedDevice advertisedDevice) {
-    // 基础信息
-    std::string name = advertisedDevice.getName().empty() ? "(未知设备)" : advertisedDevice.getName();
-    std::string addr = advertisedDevice.getAddress().toString();
-    int rssi = advertisedDevice.getRSSI();
-
-    // 设备类型判断
-    std::string type;
-    if (isLikelyConnectable(advertisedDevice)) {
-        type = "可连接      ";
-    } else {
-        type = "不可连接    ";
-    }
-
-    // 构建日志条目
-    std::string logEntry = "[蓝牙] " + addr + " | " + name + " | RSSI: " + std::to_string(rssi) + " | 类型: " + type;
-
-    // 解析AD数据
-    std::string adParsed = parseAdTypes(advertisedDevice.getPayload(), advertisedDevice.getPayloadLength());
-
-    // 过滤重复的AD数据
-    if (adParsed == lastAdParsed) return;
-    lastAdParsed = adParsed;
-
-    // 添加AD解析信息到日志
-    if (!adParsed.empty()) {
-        logEntry += " | " + adParsed;
-    }
-
-    // 将日志添加到共享向量，超过最大长度时删除第一条
-    portENTER_CRITICAL(&BluetoothService::bluetoothSniffMux);
-    if (bluetoothSniffLog.size() > 200) bluetoothSniffLog.erase(bluetoothSniffLog.begin());
-    BluetoothService::bluetoothSniffLog.push_back(logEntry);
-    portEXIT_CRITICAL(&BluetoothService::bluetoothSniffMux);
+    // 只更新设备表，AD解析和格式化在显示时进行
+    BLEAddress address = advertisedDevice.getAddress();
+    uint8_t addr[6];
+    memcpy(addr, *address.getNative(), sizeof(addr));
+
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    deviceTable.update(addr, static_cast<int8_t>(advertisedDevice.getRSSI()),
+                       advertisedDevice.getPayload(), advertisedDevice.getPayloadLength(), millis());
 }
 
 void BluetoothService::startPassiveBluetoothSniffing() {
     if (!BLEDevice::getInitialized()) {
         BLEDevice::init("嗅探器");
     }
+    startTableScan(false, 0, 0);
+}
 
+void BluetoothService::startTableScan(bool active, uint16_t intervalMs, uint16_t windowMs) {
+    {
+        // 同一负载的AD解析结果按哈希缓存
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        deviceTable.begin(SNIFF_MAX_DEVICES, &BluetoothService::parseAdTypes);
+    }
+
+    // 接收重复广播，库内部不保存扫描结果，内存不随时间增长
+    static PassiveAdvertisedDeviceCallbacks callbacks;
     bleScan = BLEDevice::getScan();
-    bleScan->setAdvertisedDeviceCallbacks(new PassiveAdvertisedDeviceCallbacks(), true);
-    bleScan->setActiveScan(false);
-    bleScan->start(0, nullptr);
+    bleScan->setAdvertisedDeviceCallbacks(&callbacks, true);
+    bleScan->setActiveScan(active);
+    if (intervalMs && windowMs) {
+        bleScan->setInterval(intervalMs);
+        bleScan->setWindow(windowMs);
+    }
+    bleScan->start(0, nullptr, false); // 非阻塞，持续扫描直到stop()
 }
 
 void BluetoothService::stopPassiveBluetoothSniffing() {
@@ -353,15 +334,15 @@ void BluetoothService::stopPassiveBluetoothSniffing() {
         bleScan->clearResults();
         bleScan = nullptr;
     }
-    bluetoothSniffLog.clear();
+    // 设备表保留到下次嗅探，用于显示最终结果
 }
 
-std::vector<std::string> BluetoothService::getBluetoothSniffLog() {
-    std::vector<std::string> copy;
-    portENTER_CRITICAL(&bluetoothSniffMux);
-    copy.swap(bluetoothSniffLog);
-    portEXIT_CRITICAL(&bluetoothSniffMux);
-    return copy;
+std::vector<BluetoothDeviceManager::View> BluetoothService::getDeviceView(size_t max, size_t& total, uint32_t& adverts) {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    deviceTable.age(millis());
+    total = deviceTable.size();
+    adverts = deviceTable.adverts();
+    return deviceTable.view(max);
 }
 
 bool BluetoothService::isLikelyConnectable(BLEAdvertisedDevice& device) {
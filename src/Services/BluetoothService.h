@@ -7,6 +7,8 @@
 #include "BLEHIDDevice.h"
 #include "HIDTypes.h"
 #include "Data/AsciiHid.h"
+#include "Managers/BluetoothDeviceManager.h"
+#include <mutex>
 
 enum class BluetoothMode {
     NONE,
@@ -31,7 +33,6 @@ private:
     static const uint8_t HID_REPORT_MAP[];
     BluetoothMode mode = BluetoothMode::NONE;
     static BLEScan* bleScan;
-    static std::string lastAdParsed;
 
 public:
     class PassiveAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
@@ -72,18 +73,28 @@ public:
     void clearBondedDevices();
     void switchToMode(BluetoothMode newMode);
     
-    // Scan
-    std::vector<std::string> scanDevices(int seconds = 10);
+    // Scan, continuous until stopScan(), devices go to the sniffer table
+    static constexpr uint16_t SCAN_INTERVAL_MS = 100;
+    static constexpr uint16_t SCAN_WINDOW_MS   = 99;
+    bool startScan(bool active = true, uint16_t intervalMs = SCAN_INTERVAL_MS, uint16_t windowMs = SCAN_WINDOW_MS);
+    void stopScan();
+    static std::vector<BluetoothDeviceManager::View> takeNewDevices();
     std::vector<std::string> connectTo(const std::string& addr);
     
     // Bluetooth sniffing
+    static constexpr size_t SNIFF_MAX_DEVICES = 128;
     class PassiveBLEAdvertisedDeviceCallbacks;
     static void startPassiveBluetoothSniffing();
     static void stopPassiveBluetoothSniffing();
-    static std::vector<std::string> getBluetoothSniffLog();
     static bool isLikelyConnectable(BLEAdvertisedDevice& device);
     static std::string parseAdTypes(const uint8_t* payload, size_t len);
-    static std::vector<std::string> bluetoothSniffLog;
-    static portMUX_TYPE bluetoothSniffMux;
+
+    // Device table, stale devices aged out, strongest first
+    static std::vector<BluetoothDeviceManager::View> getDeviceView(size_t max, size_t& total, uint32_t& adverts);
+    static BluetoothDeviceManager deviceTable;
+    static std::mutex deviceMutex;
+
+private:
+    static void startTableScan(bool active, uint16_t intervalMs, uint16_t windowMs);
 };
 
@@ -231,4 +231,186 @@ std::string HttpService::lastResponse()
 bool HttpService::isResponseReady() const noexcept 
 {
     return ready.load(std::memory_order_acquire);
-}
\ No newline at end of file
+}
+
+void HttpService::startStreamTask(const std::string& url, int timeout_ms, bool insecure, const std::string& filter,
+                                  int stack_bytes, int core)
+{
+    {
+        std::lock_guard<std::mutex> lock(streamMutex_);
+        streamLines_.clear();
+        streamStatus_ = StreamStatus();
+    }
+    streamStop_.store(false);
+    auto* p = new HttpStreamParams{url, timeout_ms, insecure, filter, nullptr, 0, this};
+    xTaskCreatePinnedToCore(&HttpService::streamTask, "HttpStream", stack_bytes,
+                            p, 1, nullptr, core);
+}
+
+void HttpService::startDownloadTask(const std::string& url, int timeout_ms, bool insecure,
+                                    HttpStreamManager::DataSink sink, uint64_t maxBytes,
+                                    int stack_bytes, int core)
+{
+    {
+        std::lock_guard<std::mutex> lock(streamMutex_);
+        streamLines_.clear();
+        streamStatus_ = StreamStatus();
+    }
+    streamStop_.store(false);
+    auto* p = new HttpStreamParams{url, timeout_ms, insecure, "", std::move(sink), maxBytes, this};
+    xTaskCreatePinnedToCore(&HttpService::streamTask, "HttpStream", stack_bytes,
+                            p, 1, nullptr, core);
+}
+
+bool HttpService::queueStreamLine(const std::string& line)
+{
+    // 队列已满时等待终端取走，内存占用保持固定
+    while (!streamStop_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(streamMutex_);
+            if (streamLines_.size() < STREAM_MAX_LINES) {
+                streamLines_.push_back(line);
+                streamStatus_.lines++;
+                return true;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return false;
+}
+
+void HttpService::streamTask(void* pv)
+{
+    auto* p = static_cast<HttpStreamParams*>(pv);
+    auto* self = p->self;
+    const bool download = static_cast<bool>(p->sink);
+    std::string error;
+
+    // 复用HTTP客户端
+    const bool isHttps = (p->url.rfind("https://", 0) == 0);
+    self->ensureClient(isHttps, p->insecure, p->timeout_ms / 1000);
+
+    HttpStreamManager body;
+    bool writeFailed = false;
+    bool tooLarge = false;
+
+    if (!self->beginHttp(p->url, p->timeout_ms)) {
+        error = "初始化失败"; // 汉化
+    } else {
+        const char* keys[] = {"Content-Type", "Content-Length", "Transfer-Encoding"};
+        self->http_.collectHeaders(keys, 3);
+        self->http_.addHeader("Accept-Encoding", "identity");
+        self->http_.addHeader("Connection", "close");
+
+        const int code = self->http_.GET();
+        if (code <= 0) {
+            error = self->http_.errorToString(code).c_str();
+        } else if (download && (code < 200 || code >= 300)) {
+            error = "服务器返回 " + std::to_string(code); // 汉化
+        } else {
+            const String ct = self->http_.header("Content-Type");
+            String te = self->http_.header("Transfer-Encoding");
+            te.toLowerCase();
+            const bool chunked = te.indexOf("chunked") >= 0;
+            const int64_t length = chunked ? -1 : self->http_.getSize();
+            {
+                std::lock_guard<std::mutex> lock(self->streamMutex_);
+                self->streamStatus_.code = code;
+                self->streamStatus_.contentLength = length;
+            }
+
+            if (download) {
+                // 写入回调，超出空间限制或写入失败时终止
+                const uint64_t maxBytes = p->maxBytes;
+                auto& sink = p->sink;
+                body.begin(HttpStreamManager::Mode::Raw, chunked, length, nullptr,
+                    [&](const uint8_t* data, size_t len) {
+                        if (maxBytes && body.bodyBytes() > maxBytes) { tooLarge = true; return false; }
+                        if (!sink(data, len)) { writeFailed = true; return false; }
+                        return true;
+                    });
+                if (maxBytes && length > 0 && static_cast<uint64_t>(length) > maxBytes) tooLarge = true;
+            } else {
+                // 响应头信息
+                self->queueStreamLine("HTTP/1.1 " + std::to_string(code));
+                if (ct.length()) self->queueStreamLine(std::string("Content-Type: ") + ct.c_str());
+                if (length >= 0) self->queueStreamLine("Content-Length: " + std::to_string(length));
+                else if (chunked) self->queueStreamLine("Transfer-Encoding: chunked");
+                self->queueStreamLine("");
+
+                // 内容类型为JSON或指定了路径过滤时按JSON解析，否则按文本逐行输出
+                const bool json = !p->filter.empty() || ct.indexOf("json") >= 0;
+                body.begin(json ? HttpStreamManager::Mode::Json : HttpStreamManager::Mode::Text,
+                           chunked, length,
+                           [self](const std::string& line) { return self->queueStreamLine(line); },
+                           nullptr, p->filter);
+            }
+
+            WiFiClient* stream = self->http_.getStreamPtr();
+            uint8_t buf[STREAM_CHUNK];
+            unsigned long lastDataMs = millis();
+
+            // 边接收边处理，不缓存完整响应体
+            while (!tooLarge && stream && !self->streamStop_.load()) {
+                const int avail = stream->available();
+                if (avail <= 0) {
+                    if (!stream->connected()) break;
+                    if (millis() - lastDataMs > static_cast<unsigned long>(p->timeout_ms)) {
+                        error = "读取超时"; // 汉化
+                        break;
+                    }
+                    vTaskDelay(pdMS_TO_TICKS(2));
+                    continue;
+                }
+
+                const int n = stream->read(buf, std::min<size_t>(static_cast<size_t>(avail), sizeof(buf)));
+                if (n <= 0) { vTaskDelay(pdMS_TO_TICKS(1)); continue; }
+                lastDataMs = millis();
+
+                const bool more = body.feed(buf, static_cast<size_t>(n));
+                {
+                    std::lock_guard<std::mutex> lock(self->streamMutex_);
+                    self->streamStatus_.bodyBytes = body.bodyBytes();
+                    self->streamStatus_.values = body.values();
+                }
+                if (!more) break;
+            }
+
+            if (error.empty() && !self->streamStop_.load()) body.finish();
+            if (tooLarge)          error = "存储空间不足"; // 汉化
+            else if (writeFailed)  error = "写入失败"; // 汉化
+            else if (error.empty() && body.failed()) error = body.error();
+        }
+    }
+
+    // 清理HTTP资源
+    self->http_.getStream().stop();
+    self->http_.end();
+
+    {
+        std::lock_guard<std::mutex> lock(self->streamMutex_);
+        self->streamStatus_.bodyBytes = body.bodyBytes();
+        self->streamStatus_.values = body.values();
+        self->streamStatus_.cancelled = self->streamStop_.load();
+        self->streamStatus_.error = error;
+        self->streamStatus_.done = true;
+    }
+
+    delete p;
+    vTaskDelete(nullptr);
+}
+
+std::vector<std::string> HttpService::fetchStreamLines()
+{
+    std::vector<std::string> out;
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    out.swap(streamLines_);
+    streamLines_.reserve(STREAM_MAX_LINES);
+    return out;
+}
+
+HttpService::StreamStatus HttpService::streamStatus()
+{
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    return streamStatus_;
+}
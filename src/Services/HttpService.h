@@ -8,6 +8,7 @@
 #include <string>
 #include <atomic>
 #include <mutex>
+#include "Managers/HttpStreamManager.h"
 
 class HttpService {
 public:
@@ -27,8 +28,38 @@ public:
     // Resets the internal state
     void reset() { response.clear(); ready = false; }
 
+    // Streamed GET, JSON as "path = value" lines (filtered) or text lines, queued for fetchStreamLines()
+    void startStreamTask(const std::string& url, int timeout_ms, bool insecure, const std::string& filter,
+                         int stack_bytes = 20000, int core = 1);
+
+    // Streamed GET written to sink as it arrives, maxBytes 0 for no limit
+    void startDownloadTask(const std::string& url, int timeout_ms, bool insecure,
+                           HttpStreamManager::DataSink sink, uint64_t maxBytes,
+                           int stack_bytes = 20000, int core = 1);
+
+    struct StreamStatus {
+      int         code = 0;
+      int64_t     contentLength = -1;   // -1 when unknown
+      uint64_t    bodyBytes = 0;
+      uint32_t    values = 0;           // JSON values parsed
+      uint32_t    lines = 0;            // lines queued
+      bool        done = false;
+      bool        cancelled = false;
+      std::string error;
+    };
+
+    // Queued lines, the task waits while the queue is full
+    std::vector<std::string> fetchStreamLines();
+    StreamStatus streamStatus();
+    void stopStream() { streamStop_.store(true); }
+
+    static constexpr size_t STREAM_MAX_LINES = 32;
+    static constexpr size_t STREAM_CHUNK     = 1460;  // one TCP segment
+
 private:
     static void getTask(void* pv);
+    static void streamTask(void* pv);
+    bool queueStreamLine(const std::string& line);
     static std::string getJsonBody(HTTPClient& http, int bodyMaxBytes);
     static std::string getTextBody(HTTPClient& http, size_t maxBytes);
     void ensureClient(bool https, bool insecure, int timeout_s);
@@ -47,6 +78,22 @@ private:
       HttpService* self;
     };
 
+    struct HttpStreamParams {
+      std::string url;
+      int timeout_ms;
+      bool insecure;
+      std::string filter;
+      HttpStreamManager::DataSink sink;   // download when set
+      uint64_t maxBytes;
+      HttpService* self;
+    };
+
+    // Streamed response
+    std::mutex streamMutex_;
+    std::vector<std::string> streamLines_;
+    StreamStatus streamStatus_;
+    std::atomic<bool> streamStop_{false};
+
     // HTTP client
     std::unique_ptr<WiFiClient> client_;
     bool client_https_ = false;
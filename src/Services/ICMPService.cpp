@@ -4,10 +4,13 @@
 #include <freertos/task.h>
 #include <vector>
 #include <algorithm>
-#include <ESP32Ping.h>
 
 #include "lwip/inet.h"
 #include "lwip/netdb.h"
+#include "lwip/sockets.h"
+#include <sys/ioctl.h>
+#include "esp_timer.h"
+#include "Managers/ICMPSweepManager.h"
 #include "ping/ping_sock.h"
 extern "C"
 {
@@ -93,12 +96,19 @@ static int median_ms(std::vector<uint32_t> &v)
     return (int)((v[n / 2 - 1] + v[n / 2] + 1) / 2);
 }
 
+static std::string formatUs(uint32_t us)
+{
+    // 毫秒，保留一位小数
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.1f", us / 1000.0f);
+    return buf;
+}
+
 void ICMPService::discoveryTask(void* params){
     auto* taskParams = static_cast<DiscoveryTaskParams*>(params);
     std::string deviceIP = taskParams->deviceIP;
     ICMPService* service = taskParams->service;
     ip4_addr_t targetIP;
-    uint32_t targetsResponded = 0;
 
     pushICMPLog("发现：正在扫描网络设备... 按[回车]停止。\r\n");
 
@@ -116,66 +126,89 @@ void ICMPService::discoveryTask(void* params){
     uint8_t o3 = ip4_addr3(&targetIP);
     uint8_t deviceIndex = ip4_addr4(&targetIP);
 
-    // 扫描同网段1-254的所有IP
-    for (uint8_t targetIndex = 1; targetIndex < 255; targetIndex++)
+    // 同网段1-254的所有IP，跳过自身
+    std::vector<uint32_t> targets;
+    for (uint16_t targetIndex = 1; targetIndex < 255; targetIndex++)
     {
-        // 检查用户是否停止扫描
-        if (ICMPService::getICMPServiceStatus() == true)
-        {
-            pushICMPLog("发现：用户已停止扫描\r\n");
-            delete taskParams;
-            vTaskDelete(nullptr);
-            return;
-        }
-
-        // 跳过自身IP
         if (targetIndex == deviceIndex)
             continue;
-
-        // 重新构建目标IP地址
         IP4_ADDR(&targetIP, o1, o2, o3, targetIndex);
+        targets.push_back(targetIP.addr);
+    }
 
-        // 转换为点分十进制字符串
-        char targetIPCStr[16];
-        ip4addr_ntoa_r(&targetIP, targetIPCStr, sizeof(targetIPCStr));
-        std::string targetIPStr(targetIPCStr);
-
-        service->cleanupICMPService();
-        auto *params = new ICMPTaskParams{targetIPStr, 2, 150, 100, service};
-
-        #ifndef DEVICE_M5STICK
-        // 创建ping任务
-        xTaskCreatePinnedToCore(pingAPI, "ICMPPing", 4096, params, 1, nullptr, 1);
+    ICMPSweepManager sweep;
+    ICMPSweepManager::Config config;
+    config.identifier = static_cast<uint16_t>(esp_random());
+    config.rounds = DISCOVERY_ROUNDS;
+    config.rate = DISCOVERY_RATE;
+    config.timeoutMs = DISCOVERY_TIMEOUT_MS;
+    const uint64_t startUs = esp_timer_get_time();
+
+    bool stopped = false;
+    const bool swept = service->runSweep(sweep, config, targets,
+        [&stopped]() {
+            // 检查用户是否停止扫描
+            if (ICMPService::getICMPServiceStatus() == true)
+            {
+                pushICMPLog("发现：用户已停止扫描\r\n");
+                stopped = true;
+            }
+            return stopped;
+        },
+        [&sweep](size_t host) {
+            char ipStr[16];
+            in_addr ip{};
+            ip.s_addr = sweep.hosts()[host].addr;
+            inet_ntoa_r(ip, ipStr, sizeof(ipStr));
+            pushICMPLog("发现设备：" + std::string(ipStr) + "  " + formatUs(sweep.hosts()[host].minUs) + " 毫秒");
+        });
+    if (!swept)
+    {
+        pushICMPLog("发现：创建ICMP套接字失败\r\n");
+        service->discoveryReady = true;
+        delete taskParams;
+        vTaskDelete(nullptr);
+        return;
+    }
 
-        // 等待ping完成
-        while (!service->pingReady)
+    // 每台在线设备的延迟统计
+    if (sweep.responders() > 0)
+    {
+        pushICMPLog("\r\n地址              接收   最小    p50     p90     最大    抖动 (毫秒)");
+        for (size_t i = 0; i < sweep.hosts().size(); ++i)
         {
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
-        // ping成功则记录设备
-        if (service->pingRC == ping_rc_t::ping_ok){
-            pushICMPLog("发现设备：" + targetIPStr);
-            targetsResponded++;
-        }
-        #else
-        // M5Stick使用ESP32Ping库（避免IRAM溢出）
-        // 该库无法设置ping超时，每个ping耗时约5秒
-        // TODO: 优化超时逻辑
-        const unsigned long t0 = millis();
-        const bool ok = Ping.ping(targetIPStr.c_str(), 1);
-        const unsigned long t1 = millis();
-        if (ok) {
-            pushICMPLog("发现设备：" + targetIPStr);
-            targetsResponded++;
-        } else {
-            pushICMPLog("未发现设备：" + targetIPStr);
+            const auto& h = sweep.hosts()[i];
+            if (h.received == 0)
+                continue;
+
+            char ipStr[16];
+            in_addr ip{};
+            ip.s_addr = h.addr;
+            inet_ntoa_r(ip, ipStr, sizeof(ipStr));
+            char line[96];
+            snprintf(line, sizeof(line), "%-17s %u/%-4u %-7s %-7s %-7s %-7s %s",
+                     ipStr, h.received, h.sent,
+                     formatUs(h.minUs).c_str(),
+                     formatUs(sweep.percentileUs(i, 50)).c_str(),
+                     formatUs(sweep.percentileUs(i, 90)).c_str(),
+                     formatUs(h.maxUs).c_str(),
+                     formatUs(h.jitterUs).c_str());
+            pushICMPLog(line);
         }
-        #endif
     }
 
     // 输出扫描结果
-    pushICMPLog(std::to_string(targetsResponded) + " 台设备在线，" + 
-        std::to_string(254 - targetsResponded) + " 台设备离线");
+    const uint32_t elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+    const size_t offline = targets.size() - sweep.responders();
+    pushICMPLog(std::to_string(sweep.responders()) + " 台设备在线，" +
+        std::to_string(offline) + " 台设备离线" + (stopped ? "（未完成）" : "") +
+        "，耗时 " + std::to_string(elapsedMs / 1000) + "." + std::to_string(elapsedMs % 1000 / 100) + " 秒");
+    if (sweep.overall().count() > 0)
+    {
+        pushICMPLog("延迟：p50 " + formatUs(sweep.overall().percentile(50)) +
+                    " / p90 " + formatUs(sweep.overall().percentile(90)) +
+                    " / p99 " + formatUs(sweep.overall().percentile(99)) + " 毫秒");
+    }
 
     service->discoveryReady = true;
 
@@ -183,6 +216,65 @@ void ICMPService::discoveryTask(void* params){
     vTaskDelete(nullptr);
 }
 
+bool ICMPService::runSweep(ICMPSweepManager& sweep, const ICMPSweepManager::Config& config, const std::vector<uint32_t>& targets,
+                           const std::function<bool()>& stop, const std::function<void(size_t host)>& onHostUp)
+{
+    if (!sweep.begin(config, targets, esp_timer_get_time()))
+        return false;
+
+    // 单个原始套接字发送所有回显请求，按标识符/序号匹配应答
+    int sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (sock < 0)
+        return false;
+    int nonBlocking = 1;
+    ioctl(sock, FIONBIO, &nonBlocking);
+
+    uint8_t txBuf[64];
+    uint8_t rxBuf[128];
+    while (!sweep.done(esp_timer_get_time()))
+    {
+        if (stop && stop())
+            break;
+
+        // 按速率发送到期的请求
+        size_t len = 0;
+        uint32_t addr = 0;
+        while (sweep.nextRequest(esp_timer_get_time(), txBuf, sizeof(txBuf), len, addr))
+        {
+            sockaddr_in to{};
+            to.sin_family = AF_INET;
+            to.sin_addr.s_addr = addr;
+            sendto(sock, txBuf, len, 0, reinterpret_cast<sockaddr*>(&to), sizeof(to));
+        }
+
+        // 等待应答或下一个发送时刻，最多20ms以便响应停止
+        const uint64_t now = esp_timer_get_time();
+        const uint64_t next = sweep.nextEventUs();
+        const uint32_t waitUs = next > now ? static_cast<uint32_t>(std::min<uint64_t>(next - now, 20000)) : 0;
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(sock, &readSet);
+        timeval tv{0, static_cast<long>(waitUs)};
+        select(sock + 1, &readSet, nullptr, nullptr, &tv);
+
+        // 读取所有已到达的应答
+        for (;;)
+        {
+            sockaddr_in from{};
+            socklen_t fromLen = sizeof(from);
+            int n = recvfrom(sock, rxBuf, sizeof(rxBuf), 0, reinterpret_cast<sockaddr*>(&from), &fromLen);
+            if (n <= 0)
+                break;
+
+            int host = sweep.onReply(rxBuf, n, from.sin_addr.s_addr, esp_timer_get_time());
+            if (host >= 0 && sweep.hosts()[host].received == 1 && onHostUp)
+                onHostUp(static_cast<size_t>(host));
+        }
+    }
+    close(sock);
+    return true;
+}
+
 void ICMPService::startDiscoveryTask(const std::string deviceIP)
 {
     report.clear();
@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <functional>
 #include <freertos/FreeRTOS.h>
+#include "Managers/ICMPSweepManager.h"
 
 enum phy_interface_t {
     phy_none,
@@ -27,6 +29,12 @@ public:
     // Discovery of devices
     void startDiscoveryTask(const std::string deviceIP);
     static void discoveryTask(void* params);
+    // Echo sweep of many hosts from one raw socket, run to the end in the calling task.
+    // stop is polled at least every 20 ms, onHostUp gets the index of each host on its first reply.
+    // False when the socket cannot be created
+    bool runSweep(ICMPSweepManager& sweep, const ICMPSweepManager::Config& config, const std::vector<uint32_t>& targets,
+                  const std::function<bool()>& stop = nullptr,
+                  const std::function<void(size_t host)>& onHostUp = nullptr);
 
     // Results
     bool isPingReady() const { return pingReady; }
@@ -60,6 +68,11 @@ private:
     static portMUX_TYPE icmpMux;
     static std::vector<std::string> icmpLog;
     static constexpr size_t ICMP_LOG_MAX = 200;
+
+    // Discovery sweep: echo requests per host, requests per second, reply timeout
+    static constexpr uint8_t  DISCOVERY_ROUNDS = 3;
+    static constexpr uint32_t DISCOVERY_RATE = 200;
+    static constexpr uint32_t DISCOVERY_TIMEOUT_MS = 1000;
     static bool stopICMPFlag;
 
     static void pushICMPLog(const std::string& line);
@@ -54,17 +54,12 @@ void InfraredService::sendInfraredCommand(InfraredCommand command) {
         // Handle by MakeHex
         default: {
             int frequency = 38; // Default frequency, passed by reference to encodeRemoteCommand
-            std::vector<float> sequence = encodeRemoteCommand(command, protocolString.c_str(), frequency);
-
-            // Convert for sendRaw
-            uint16_t* raw = new uint16_t[sequence.size()];
-            for (size_t i = 0; i < sequence.size(); ++i) {
-                raw[i] = static_cast<uint16_t>(sequence[i]);
+            if (!encodeRemoteCommand(command, protocolString.c_str(), frequency, rawBuffer)) {
+                break;
             }
-            
+
             // Send the raw generated sequence with the correct frequency
-            IrSender.sendRaw(raw, sequence.size(), frequency);
-            delete[] raw;
+            IrSender.sendRaw(rawBuffer.data(), rawBuffer.size(), frequency);
         }
     }
 }
@@ -89,14 +84,54 @@ void InfraredService::sendInfraredFileCommand(InfraredFileRemoteCommand command)
 }
 
 InfraredCommand InfraredService::receiveInfraredCommand() {
-    InfraredCommand command;
+    if (!IrReceiver.decode()) {
+        return InfraredCommand();
+    }
 
+    IrReceiver.resume();
+    return decodedCommand();
+}
+
+bool InfraredService::receiveFrame(InfraredCommand& command, bool& repeat, std::vector<uint16_t>& timings, uint32_t& khz) {
     if (!IrReceiver.decode()) {
-        return command;
+        return false;
+    }
+
+    // Raw buffer is read before resuming
+    struct ResumeGuard {
+        ~ResumeGuard(){ IrReceiver.resume(); }
+    } guard;
+
+    khz = 38; // same default as receiveRaw
+    if (!copyRawTimings(timings)) {
+        return false;
     }
 
+    command = decodedCommand();
+    repeat = (IrReceiver.decodedIRData.flags & IRDATA_FLAGS_IS_REPEAT) != 0;
+    return true;
+}
+
+bool InfraredService::copyRawTimings(std::vector<uint16_t>& timings) {
+    const auto* raw = IrReceiver.decodedIRData.rawDataPtr;
+    if (raw == nullptr || raw->rawlen <= 1) {
+        return false;
+    }
+
+    timings.clear();
+    timings.reserve(raw->rawlen - 1);
+
+    for (uint16_t i = 1; i < raw->rawlen; i++) {
+        // Convert ticks to microseconds
+        uint32_t us = static_cast<uint32_t>(raw->rawbuf[i]) * MICROS_PER_TICK;
+        timings.push_back(static_cast<uint16_t>(us));
+    }
+    return true;
+}
+
+InfraredCommand InfraredService::decodedCommand() {
+    InfraredCommand command;
     const IRData& data = IrReceiver.decodedIRData;
-    IrReceiver.resume();
 
     // Ignore invalid
     if (data.numberOfBits == 0 || data.protocol == UNKNOWN) {
@@ -207,30 +242,14 @@ bool InfraredService::receiveRaw(std::vector<uint16_t>& timings, uint32_t& khz)
         return false;
     }
 
-    const IRData& data = IrReceiver.decodedIRData;
-    const auto* raw = data.rawDataPtr;
-
     // Ensure we resume after processing
     struct ResumeGuard {
         ~ResumeGuard(){ IrReceiver.resume(); }
     } guard;
 
-    if (raw == nullptr || raw->rawlen <= 1) {
-        return false;
-    }
-
     khz = 38; // TODO: default frequency, handle that ?
 
-    timings.clear();
-    timings.reserve(raw->rawlen - 1);
-
-    for (uint16_t i = 1; i < raw->rawlen; i++) {
-        // Convert ticks to microseconds
-        uint32_t us = static_cast<uint32_t>(raw->rawbuf[i]) * MICROS_PER_TICK;
-        timings.push_back(static_cast<uint16_t>(us));
-    }
-
-    return true;
+    return copyRawTimings(timings);
 }
 
 void InfraredService::sendRaw(const std::vector<uint16_t>& timings, uint32_t khz) {
@@ -328,4 +347,144 @@ std::vector<std::string> InfraredService::getCarrierStrings() {
 
 std::vector<std::string> InfraredService::getJamModeStrings() {
     return {"carrier", "sweep", "random"};
-}
\ No newline at end of file
+}
+
+bool InfraredService::encodeFrame(const InfraredCommand& command, Frame& frame) {
+    frame.command = command;
+    frame.khz = 38;
+
+    switch (command.getProtocol()) {
+        // Sent by the IRremote encoders in sendInfraredCommand
+        case InfraredProtocolEnum::_SAMSUNG:
+        case InfraredProtocolEnum::SAMSUNG20:
+        case InfraredProtocolEnum::_PANASONIC:
+        case InfraredProtocolEnum::PANASONIC2:
+        case InfraredProtocolEnum::SONY20:
+        case InfraredProtocolEnum::LEGO:
+            frame.timings.clear();
+            frame.native = true;
+            return true;
+
+        default:
+            break;
+    }
+
+    // Same encoding as sendInfraredCommand, the frame buffer is reused
+    frame.native = false;
+    int frequency = 38;
+    std::string protocolString = InfraredProtocolMapper::toString(command.getProtocol());
+    if (!encodeRemoteCommand(command, protocolString.c_str(), frequency, frame.timings)) {
+        return false;
+    }
+    frame.khz = static_cast<uint16_t>(frequency);
+    return true;
+}
+
+bool InfraredService::startEncoder() {
+    frameKhz_ = 0;
+    if (encoderHandle_.load()) return true;
+
+    // Static semaphores, never deleted while the task may still use them
+    if (!encodeDone_) encodeDone_ = xSemaphoreCreateBinaryStatic(&encodeDoneStruct_);
+    if (!encoderExited_) encoderExited_ = xSemaphoreCreateBinaryStatic(&encoderExitedStruct_);
+
+    // Encoder on the core not sending, the IR bursts are busy waits
+    encoderRunning_ = true;
+    encodePending_ = false;
+    const BaseType_t core = (xPortGetCoreID() == 0) ? 1 : 0;
+    TaskHandle_t handle = nullptr;
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        &InfraredService::encoderTaskThunk,
+        "ir_encoder",
+        6144,
+        this,
+        1,
+        &handle,
+        core
+    );
+    encoderHandle_ = (ok == pdPASS) ? handle : nullptr;
+    if (ok != pdPASS) {
+        encoderRunning_ = false;
+        return false;
+    }
+    return true;
+}
+
+void InfraredService::stopEncoder() {
+    waitEncoded();
+
+    TaskHandle_t encoder = encoderHandle_.load();
+    if (encoder) {
+        // Woken while still running, it cannot have exited before the notify
+        xTaskNotifyGive(encoder);
+        encoderRunning_ = false;
+        xSemaphoreTake(encoderExited_, portMAX_DELAY);
+    }
+    frameKhz_ = 0;
+}
+
+void InfraredService::encodeAsync(const InfraredCommand& command, Frame& frame) {
+    waitEncoded();
+
+    // No encoder task, encode in place
+    TaskHandle_t encoder = encoderHandle_.load();
+    if (!encoder) {
+        encodeOk_ = encodeFrame(command, frame);
+        return;
+    }
+
+    encodeCommand_ = command;
+    encodeFrame_ = &frame;
+    encodePending_ = true;
+    xTaskNotifyGive(encoder);
+}
+
+bool InfraredService::waitEncoded() {
+    if (encodePending_) {
+        xSemaphoreTake(encodeDone_, portMAX_DELAY);
+        encodePending_ = false;
+    }
+    return encodeOk_;
+}
+
+void InfraredService::sendFrame(const Frame& frame) {
+    if (frame.native) {
+        // IRremote encoders set up the carrier themselves
+        sendInfraredCommand(frame.command);
+        frameKhz_ = 0;
+        return;
+    }
+    if (frame.timings.empty()) return;
+
+    // Same output as IrSender.sendRaw, the carrier is only set up when it changes
+    if (frame.khz != frameKhz_) {
+        IrSender.enableIROut(frame.khz);
+        frameKhz_ = frame.khz;
+    }
+    for (size_t i = 0; i < frame.timings.size(); ++i) {
+        if (i & 1) {
+            IrSender.space(frame.timings[i]);
+        } else {
+            IrSender.mark(frame.timings[i]);
+        }
+    }
+}
+
+void InfraredService::encoderTaskThunk(void* arg) {
+    auto* self = static_cast<InfraredService*>(arg);
+    self->encoderTask();
+    self->encoderHandle_ = nullptr;
+    xSemaphoreGive(self->encoderExited_);  // 之后不再访问self
+    vTaskDelete(nullptr);
+}
+
+void InfraredService::encoderTask() {
+    while (encoderRunning_.load()) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10)) == 0) continue;
+        if (!encodeFrame_) continue;
+
+        encodeOk_ = encodeFrame(encodeCommand_, *encodeFrame_);
+        encodeFrame_ = nullptr;
+        xSemaphoreGive(encodeDone_);
+    }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <Models/InfraredCommand.h>
 #include <Models/InfraredFileRemoteCommand.h>
 #include <Vendors/MakeHex.h>
@@ -9,6 +13,15 @@
 class InfraredService {
 public:
     enum class JamMode : uint8_t { CARRIER, SWEEP, RANDOM };
+
+    // Command ready to send, timings are empty for protocols sent by IRremote encoders
+    struct Frame {
+        InfraredCommand command;
+        std::vector<uint16_t> timings;
+        uint16_t khz = 38;
+        bool native = false;
+    };
+
     void configure(uint8_t tx, uint8_t rx);
     void startReceiver();
     void stopReceiver();
@@ -16,6 +29,8 @@ public:
     void sendInfraredFileCommand(InfraredFileRemoteCommand command);
     InfraredCommand receiveInfraredCommand();
     bool receiveRaw(std::vector<uint16_t>& timings, uint32_t& khz);
+    // Raw timings and decoded command of the same frame, protocol RAW if not decoded
+    bool receiveFrame(InfraredCommand& command, bool& repeat, std::vector<uint16_t>& timings, uint32_t& khz);
     void sendRaw(const std::vector<uint16_t>& timings, uint32_t khz);
     void sendJam(uint8_t modeIndex,
         uint16_t khz,
@@ -23,11 +38,38 @@ public:
         uint8_t density);
     std::vector<std::string> getCarrierStrings();
     static std::vector<std::string> getJamModeStrings();
+
+    // Batch sending, the next frame is encoded on the other core while the current one is on air
+    bool encodeFrame(const InfraredCommand& command, Frame& frame);
+    bool startEncoder();
+    void stopEncoder();
+    void encodeAsync(const InfraredCommand& command, Frame& frame);
+    bool waitEncoded();
+    void sendFrame(const Frame& frame);
 private:        
     inline static constexpr uint16_t carrierKhz[] = {
         30, 33, 36, 38, 40, 42, 56
     };
+    std::vector<uint16_t> rawBuffer; // MakeHex output, reused between sends
+
+    // Encoder task, only one request in flight
+    std::atomic<TaskHandle_t> encoderHandle_{nullptr};
+    SemaphoreHandle_t encodeDone_ = nullptr;
+    StaticSemaphore_t encodeDoneStruct_;
+    SemaphoreHandle_t encoderExited_ = nullptr;     // given by the task right before it deletes itself
+    StaticSemaphore_t encoderExitedStruct_;
+    std::atomic<bool> encoderRunning_{false};
+    InfraredCommand encodeCommand_;
+    Frame* encodeFrame_ = nullptr;
+    bool encodeOk_ = false;
+    bool encodePending_ = false;
+    uint16_t frameKhz_ = 0;     // carrier configured by the last sendFrame, 0 if unknown
+
+    static void encoderTaskThunk(void* arg);
+    void encoderTask();
     uint16_t getKaseikyoVendorIdCode(const std::string& input);
+    bool copyRawTimings(std::vector<uint16_t>& timings);
+    InfraredCommand decodedCommand();
 };
 
 
@@ -101,11 +101,12 @@ std::vector<LittleFsService::Entry> LittleFsService::list(const std::string& use
             name = full.substr(1);
         }
 
-        // 添加目录项信息（名称、大小、是否为目录）
+        // 添加目录项信息（名称、大小、是否为目录、修改时间）
         out.push_back(Entry{
             /*name=*/name,
             /*size=*/static_cast<size_t>(f.size()),
-            /*isDir=*/f.isDirectory()
+            /*isDir=*/f.isDirectory(),
+            /*mtime=*/static_cast<uint32_t>(f.getLastWrite())
         });
         f.close();
     }
@@ -174,6 +175,30 @@ bool LittleFsService::readChunks(const std::string& userPath,
     return ok;
 }
 
+bool LittleFsService::readRange(const std::string& userPath, size_t offset, size_t length, std::string& out) const {
+    // 读取文件中指定偏移处的一段内容
+    if (!_mounted) return false;
+    std::string p;
+    if (!normalizeUserPath(userPath, p, /*dir=*/false)) return false;
+
+    fs::File f = LittleFS.open(p.c_str(), "r");
+    if (!f) return false;
+    if (offset > f.size() || !f.seek(offset)) { f.close(); return false; }
+
+    // 超出文件末尾的部分截断
+    if (length > f.size() - offset) length = f.size() - offset;
+    out.resize(length);
+    size_t done = 0;
+    while (done < length) {
+        int n = f.read(reinterpret_cast<uint8_t*>(&out[done]), length - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    f.close();
+    out.resize(done);
+    return done == length;
+}
+
 bool LittleFsService::ensureParentDirs(const std::string& userFilePath) const {
     // 确保文件的父目录存在（不存在则创建）
     auto pos = userFilePath.find_last_of('/');
@@ -215,6 +240,13 @@ bool LittleFsService::write(const std::string& userPath, const uint8_t* data, si
     return ok;
 }
 
+fs::File LittleFsService::openFileWrite(const std::string& userPath) {
+    // 打开文件用于分块写入（覆盖模式，调用方负责关闭）
+    if (!_mounted || _readOnly) return fs::File();
+    if (!ensureParentDirs(userPath)) return fs::File();
+    return LittleFS.open(userPath.c_str(), "w", true);
+}
+
 bool LittleFsService::mkdirRecursive(const std::string& userDir) const {
     // 递归创建目录（支持多级目录）
     if (!_mounted || _readOnly) return false;
@@ -378,4 +410,4 @@ std::vector<std::string> LittleFsService::listFiles(const std::string& userDir,
     dir.close();
 
     return files;
-}
\ No newline at end of file
+}
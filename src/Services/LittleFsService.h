@@ -15,6 +15,7 @@ public:
         std::string name; 
         size_t      size;
         bool        isDir;
+        uint32_t    mtime;  // last write, seconds
     };
 
     ~LittleFsService();
@@ -34,9 +35,11 @@ public:
     bool readAll(const std::string& userPath, std::string& out) const;
     bool readChunks(const std::string& userPath,
                     const std::function<bool(const uint8_t*, size_t)>& writer) const;
+    bool readRange(const std::string& userPath, size_t offset, size_t length, std::string& out) const;
 
     bool write(const std::string& userPath, const std::string& data, bool append=false);
     bool write(const std::string& userPath, const uint8_t* data, size_t len, bool append=false);
+    fs::File openFileWrite(const std::string& userPath);   // streamed writes, parent dirs created
 
     bool mkdirRecursive(const std::string& userDir) const;
     bool removeFile    (const std::string& userPath);
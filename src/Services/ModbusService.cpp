@@ -42,25 +42,32 @@ void ModbusService::begin(uint32_t reqTimeoutMs, uint32_t idleCloseMs, uint32_t
 // FC01 - 读取线圈状态
 Error ModbusService::readCoils(uint8_t unit, uint16_t addr0, uint16_t qty) {
   if (!_mb) return INVALID_SERVER; // 客户端未初始化返回无效服务器错误
-  return _mb->addRequest(millis(), unit, READ_COIL, addr0, qty);
+  return _mb->addRequest(autoToken(), unit, READ_COIL, addr0, qty);
 }
 
 // FC02 - 读取离散输入状态
 Error ModbusService::readDiscreteInputs(uint8_t unit, uint16_t addr0, uint16_t qty) {
   if (!_mb) return INVALID_SERVER;
-  return _mb->addRequest(millis(), unit, READ_DISCR_INPUT, addr0, qty);
+  return _mb->addRequest(autoToken(), unit, READ_DISCR_INPUT, addr0, qty);
 }
 
 // FC03 - 读取保持寄存器
 Error ModbusService::readHolding(uint8_t unit, uint16_t addr0, uint16_t qty) {
   if (!_mb) return INVALID_SERVER;
-  return _mb->addRequest(millis(), unit, READ_HOLD_REGISTER, addr0, qty);
+  return _mb->addRequest(autoToken(), unit, READ_HOLD_REGISTER, addr0, qty);
 }
 
 // FC04 - 读取输入寄存器
 Error ModbusService::readInputRegisters(uint8_t unit, uint16_t addr0, uint16_t qty) {
   if (!_mb) return INVALID_SERVER;
-  return _mb->addRequest(millis(), unit, READ_INPUT_REGISTER, addr0, qty);
+  return _mb->addRequest(autoToken(), unit, READ_INPUT_REGISTER, addr0, qty);
+}
+
+// FC01-FC04 - 使用调用方令牌的读取请求（流水线）
+Error ModbusService::readRequest(uint32_t token, uint8_t unit, uint8_t fc, uint16_t addr0, uint16_t qty) {
+  if (!_mb) return INVALID_SERVER;
+  if (fc < READ_COIL || fc > READ_INPUT_REGISTER) return ILLEGAL_FUNCTION;
+  return _mb->addRequest(token, unit, fc, addr0, qty);
 }
 
 // FC05 - 写入单个线圈
@@ -68,13 +75,13 @@ Error ModbusService::writeSingleCoil(uint8_t unit, uint16_t addr0, bool on) {
   if (!_mb) return INVALID_SERVER;
   // Modbus协议规定：0xFF00表示置1，0x0000表示置0
   const uint16_t val = on ? 0xFF00 : 0x0000;
-  return _mb->addRequest(millis(), unit, WRITE_COIL, addr0, val);
+  return _mb->addRequest(autoToken(), unit, WRITE_COIL, addr0, val);
 }
 
 // FC06 - 写入单个保持寄存器
 Error ModbusService::writeHoldingSingle(uint8_t unit, uint16_t addr0, uint16_t value) {
   if (!_mb) return INVALID_SERVER;
-  return _mb->addRequest(millis(), unit, WRITE_HOLD_REGISTER, addr0, value);
+  return _mb->addRequest(autoToken(), unit, WRITE_HOLD_REGISTER, addr0, value);
 }
 
 // FC10/0x16 - 写入多个保持寄存器
@@ -83,7 +90,7 @@ Error ModbusService::writeHoldingMultiple(uint8_t unit, uint16_t addr0, const st
   std::vector<uint16_t> tmp(values.begin(), values.end());
   const uint16_t qty     = static_cast<uint16_t>(tmp.size());    // 寄存器数量
   const uint8_t  byteCnt = static_cast<uint8_t>(qty * 2);        // 字节总数（每个寄存器2字节）
-  return _mb->addRequest(millis(), unit, WRITE_MULT_REGISTERS, addr0, qty, byteCnt, tmp.data());
+  return _mb->addRequest(autoToken(), unit, WRITE_MULT_REGISTERS, addr0, qty, byteCnt, tmp.data());
 }
 
 // FC0F - 写入多个线圈
@@ -93,7 +100,7 @@ Error ModbusService::writeMultipleCoils(uint8_t unit, uint16_t addr0,
   if (!_mb) return INVALID_SERVER;
   std::vector<uint8_t> tmp(packedBytes.begin(), packedBytes.end());
   const uint8_t byteCnt = static_cast<uint8_t>(tmp.size()); // 打包后的字节数
-  return _mb->addRequest(millis(), unit, WRITE_MULT_COILS, addr0, coilQty, byteCnt, tmp.data());
+  return _mb->addRequest(autoToken(), unit, WRITE_MULT_COILS, addr0, coilQty, byteCnt, tmp.data());
 }
 
 // 静态数据回调转发到实例方法
@@ -114,8 +121,9 @@ void ModbusService::onData(ModbusMessage& resp, uint32_t token) {
   // 功能码最高位为1表示异常响应
   if (r.fc & 0x80) {
     r.ok = false;
-    // 异常响应第二个字节为异常码
-    if (resp.size() >= 2) r.exception = resp[1];
+    // 异常码紧跟功能码（resp[0] 为单元 ID）
+    r.err = resp.getError();
+    r.exception = r.err;
   } else {
     r.ok = true;
 
@@ -145,6 +153,9 @@ void ModbusService::onError(Error error, uint32_t token) {
   // 构造错误响应对象并触发通用回调
   Reply r;
   r.ok = false;
+  r.err = error;
+  // 异常响应（0x01-0x0B）也经由错误回调返回
+  if (error != SUCCESS && error < 0x20) r.exception = error;
   ModbusError me(error);
   r.error = (const char*)me; // 转换错误码为可读字符串
 
@@ -29,6 +29,7 @@ public:
     bool ok = false;
     uint8_t fc = 0;
     uint8_t exception = 0;
+    Error err = SUCCESS;            // eModbus error or exception code
     uint8_t  byteCount = 0;         // FC01/FC02
     std::string error;
     std::vector<uint16_t> regs;     // FC03/FC04
@@ -56,6 +57,12 @@ public:
                             const std::vector<uint8_t>& packedBytes,
                             uint16_t coilQty);
 
+  // Tokens with this bit set belong to readRequest callers, the helpers above never use it
+  static constexpr uint32_t TOKEN_CALLER = 0x80000000u;
+
+  // FC01-FC04 read with the caller's token, several can be in flight (up to maxInflight)
+  Error readRequest(uint32_t token, uint8_t unit, uint8_t fc, uint16_t addr0, uint16_t qty);
+
   // Callbacks
   using ReplyHandler = std::function<void(const Reply&, uint32_t token)>;
   void setOnReply(ReplyHandler h) { _onReply = std::move(h); }
@@ -77,6 +84,7 @@ private:
   void onData(ModbusMessage& resp, uint32_t token);
   void onError(Error error, uint32_t token);
   static bool resolveIPv4(const std::string& host, IPAddress& outIp);
+  static uint32_t autoToken() { return millis() & ~TOKEN_CALLER; }
 
 private:
   std::unique_ptr<ModbusClientTCPasync> _mb;
@@ -2,6 +2,7 @@
 #include <Arduino.h>
 #include <lwip/sockets.h>   // ESP32 lwIP协议栈的socket通信头文件
 #include <cstring>          // 字符串操作头文件
+#include <cerrno>           // errno
 #include <freertos/FreeRTOS.h> // FreeRTOS实时操作系统头文件
 #include <freertos/task.h>     // FreeRTOS任务管理头文件
 
@@ -60,6 +61,17 @@ bool NetcatService::connect(const std::string &host, int verbosity, uint16_t por
     if (!openSocket(host, port)) // 创建并连接socket失败则返回false
         return false;
     setNonBlocking(); // 将socket设置为非阻塞模式（避免读写阻塞任务）
+
+    // 发送合并：行缓冲模式只在换行或缓冲满时发送，否则输入空闲后发送
+    io.begin(
+        [this](const char* data, size_t len) { return sendBlocking(data, len); },
+        [this](char* buf, size_t cap) {
+            int n = ::recv(sock, buf, cap, 0);
+            if (n > 0) return n;
+            if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return 0; // 暂无数据
+            return -1;                                                        // 对端关闭或出错
+        },
+        lineBuffer ? 0 : SessionIoManager::TX_IDLE_MS);
     connected = true; // 标记连接状态为已连接
     return true;
 }
@@ -114,50 +126,77 @@ bool NetcatService::isConnected() const
     return sock >= 0 && connected;
 }
 
+/**
+ * @brief 非阻塞socket上发送全部数据，发送缓冲区满时最多等待1秒
+ * @param data 数据
+ * @param len 长度
+ * @return 已发送字节数，失败返回-1
+ */
+int NetcatService::sendBlocking(const char* data, size_t len)
+{
+    size_t sent = 0;
+    while (sent < len)
+    {
+        int n = ::send(sock, data + sent, len - sent, 0);
+        if (n > 0)
+        {
+            sent += n;
+            continue;
+        }
+        if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
+        {
+            // 等待socket可写
+            fd_set wfds;
+            FD_ZERO(&wfds);
+            FD_SET(sock, &wfds);
+            timeval tv{1, 0};
+            if (::select(sock + 1, nullptr, &wfds, nullptr, &tv) > 0)
+                continue;
+        }
+        return -1;
+    }
+    return static_cast<int>(sent);
+}
+
 /**
  * @brief 发送单个字符（支持行缓冲/即时发送两种模式）
  * @param c 要发送的字符
+ * @note 字符先进入发送缓冲，换行、缓冲满或输入空闲时合并发送
  */
 void NetcatService::writeChar(char c)
 {
     if (!isConnected()) // 未连接则直接返回
         return;
 
-    // 行缓冲模式：字符先存入缓冲区，遇到换行/回车时一次性发送
-    if (buffered)
-    {
-        txBuf.push_back(c); // 将字符加入发送缓冲区
-        // 遇到换行符(\n)或回车符(\r)时触发发送
-        if (c == '\n' || c == '\r')
-        {
-            if (c == '\r') 
-                txBuf.push_back('\n'); // 单独的\r自动补\n，统一换行格式
-            // 发送缓冲区中的所有数据
-            ::send(sock, txBuf.data(), txBuf.size(), 0);
-            txBuf.clear(); // 清空发送缓冲区
-        }
-    }
-    else // 非缓冲模式：收到字符后立即发送
+    // 行缓冲模式：单独的\r自动补\n，统一换行格式
+    if (buffered && c == '\r')
     {
-        ::send(sock, &c, 1, 0);
+        io.write("\r\n", 2, millis());
+        return;
     }
+    io.write(c, millis());
+}
+
+/**
+ * @brief 发送空闲超时的缓冲数据，需在会话循环中调用
+ */
+void NetcatService::poll()
+{
+    if (isConnected())
+        io.poll(millis());
 }
 
 /**
  * @brief 非阻塞读取socket接收的数据
- * @return 读取到的字符串（无数据/连接关闭返回空字符串）
+ * @param out 追加接收数据的字符串（由调用方复用）
+ * @return 本次读取的字节数（无数据/连接关闭返回0）
+ * @note 一次读完socket中已有的数据（上限RX_MAX_POLL）
  */
-std::string NetcatService::readOutputNonBlocking()
+size_t NetcatService::readOutputNonBlocking(std::string& out)
 {
-    if (!isConnected()) // 未连接则返回空字符串
-        return "";
-
-    char buf[256]; // 接收缓冲区，单次最多读取256字节
-    // 非阻塞接收数据：无数据时返回<=0（EWOULDBLOCK错误），有数据返回读取的字节数
-    int n = ::recv(sock, buf, sizeof(buf), 0);
-    if (n <= 0) // 无数据或连接已关闭
-        return "";
-    return std::string(buf, n); // 将接收到的字符转为字符串返回
+    if (!isConnected()) // 未连接则不读取
+        return 0;
+    return io.drain(out);
 }
 
 /**
@@ -167,9 +206,12 @@ void NetcatService::close()
 {
     if (sock >= 0) // socket描述符有效时才执行关闭操作
     {
+        if (connected)
+            io.flush();              // 发送缓冲中剩余的数据
         ::shutdown(sock, SHUT_RDWR); // 关闭socket的读写方向
         ::close(sock);              // 关闭socket文件描述符
         sock = -1;                  // 重置socket描述符
     }
     connected = false; // 标记连接状态为未连接
+    io.reset();
 }
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <string>
+#include "Managers/SessionIoManager.h"
 
 class NetcatService {
 public:
     void startTask(const std::string& host, int verbosity, uint16_t port, bool lineBuffer = false);    
     bool isConnected() const;
     void writeChar(char c);
-    std::string readOutputNonBlocking();
+    // Sends what the idle timer released
+    void poll();
+    // Appends the received bytes to out, returns their count
+    size_t readOutputNonBlocking(std::string& out);
     void close();
 
 private:
@@ -17,9 +21,10 @@ private:
     bool connect(const std::string& host, int verbosity, uint16_t port, bool lineBuffer);
     bool openSocket(const std::string& host, uint16_t port);
     void setNonBlocking();
+    int  sendBlocking(const char* data, size_t len);
 
     int  sock  = -1;        // lwIP socket FD
     bool connected = false;
     bool buffered  = false; // if true, send() when '\n' received
-    std::string txBuf;
+    SessionIoManager io;
 };
@@ -1,4 +1,5 @@
 #include "NmapService.h"
+#include "Managers/NmapScanManager.h"
 #include <Arduino.h>
 #include "lwip/sockets.h"
 #include "lwip/netdb.h"
@@ -8,7 +9,6 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <unordered_set>
-#include <ESP32Ping.h>
 
 extern "C" {
 #include <getopt.h>   // provides getopt_long
@@ -44,12 +44,16 @@ std::string NmapService::getHelpText() {
     "  -sT             TCP connect scan (default)\r\n"
     "  -sU             UDP scan\r\n"
     "  -sn             Ping scan (disable port scan)\r\n"
+    "  -Pn             Skip host discovery, treat all hosts as up\r\n"
+    "  --max-parallelism <n>  Probes in flight (default 8, max 12)\r\n"
     "  -v / -vv        Verbosity\r\n"
     "\r\n"
     "Examples:\r\n"
     "  nmap 192.168.1.10 -p 22,80-90 -sT -vv\r\n"
     "  nmap example.com -sU -p 53,123\r\n"
-    "  nmap 10.0.0.5 -p 8080\r\n";
+    "  nmap 10.0.0.5 -p 8080\r\n"
+    "  nmap 192.168.1.1-30 -p 22,80 -Pn\r\n"
+    "  nmap 192.168.1.0/24 -sn\r\n";
 }
 
 NmapOptions NmapService::parseNmapArgs(const std::vector<std::string>& tokens) {
@@ -74,11 +78,12 @@ NmapOptions NmapService::parseNmapArgs(const std::vector<std::string>& tokens) {
         {"help",  no_argument,       nullptr, 'h'},
         {"ports", required_argument, nullptr, 'p'},
         {"scan",  required_argument, nullptr, 's'}, // e.g. -sT / -sU
+        {"max-parallelism", required_argument, nullptr, 'm'},
         {nullptr, 0,                 nullptr,  0 }
     };
 
     int option;
-    while ((option = getopt_long(argc, argv.data(), "hp:s:v", longopts, nullptr)) != -1) {
+    while ((option = getopt_long(argc, argv.data(), "hp:s:vP:", longopts, nullptr)) != -1) {
         switch (option) {
             case 'h': nmapOptions.help = true; break;
             case 'p':
@@ -98,6 +103,17 @@ NmapOptions NmapService::parseNmapArgs(const std::vector<std::string>& tokens) {
                     else nmapOptions.hasTrash = true; // unknown letter after -s
                 }
                 break;
+            case 'P': // -Pn
+                if (optarg && std::string(optarg) == "n") nmapOptions.skipPing = true;
+                else nmapOptions.hasTrash = true;
+                break;
+            case 'm': {
+                // Sockets in flight, bounded by the lwIP socket count
+                int n = optarg ? atoi(optarg) : 0;
+                if (n >= 1 && n <= MAX_SCAN_WINDOW) nmapOptions.parallelism = n;
+                else nmapOptions.hasTrash = true;
+                break;
+            }
             case 'v':
                 // If using double verbosity, it will add
                 ++nmapOptions.verbosity;
@@ -126,165 +142,6 @@ const std::string NmapService::getReport() {
     return this->report;
 }
 
-static int udp_probe_with_timeout(in_addr addr, uint16_t port, int timeout_ms,
-                                  const void* payload, size_t payload_len, int retries = 2)
-{
-    int s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (s < 0) return nmap_rc_enum::OTHER;
-
-    int rcvbuf = 4096;
-    (void)setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
-
-    sockaddr_in sa{
-        .sin_family = AF_INET,
-        .sin_port   = htons(port),
-        .sin_addr   = addr 
-    };
-
-    if (::connect(s, (sockaddr*)&sa, sizeof(sa)) < 0) {
-        int e = errno;
-        ::close(s);
-        if (e == EHOSTUNREACH || e == ENETUNREACH) 
-            return nmap_rc_enum::UDP_OPEN_FILTERED;
-        return nmap_rc_enum::OTHER;
-    }
-
-    timeval tv{
-        .tv_sec = timeout_ms / 1000,
-        .tv_usec = (timeout_ms % 1000) * 1000
-    };
-    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-
-    // Probe message
-    static const char kProbe[] = "PING\n";
-    const void* buf   = (payload && payload_len) ? payload : kProbe;
-    size_t      blen  = (payload && payload_len) ? payload_len : (sizeof(kProbe)-1);
-
-    uint8_t rbuf[512];
-
-    for (int attempt = 0; attempt <= retries; ++attempt) {
-        if (::send(s, buf, blen, 0) < 0) {
-            int e = errno; ::close(s);
-            if (e == EHOSTUNREACH || e == ENETUNREACH)
-                return nmap_rc_enum::UDP_OPEN_FILTERED;
-            return nmap_rc_enum::OTHER;
-        }
-
-        ssize_t n = ::recvfrom(s, rbuf, sizeof(rbuf), MSG_TRUNC, nullptr, nullptr);
-        if (n >= 0) {
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN;
-        }
-
-        int e = errno;
-        if (e == ECONNREFUSED) {           // ICMP Unreachable
-            ::close(s);
-            return nmap_rc_enum::UDP_CLOSED;
-        }
-        if (e == EMSGSIZE) {               // Datagram larger buffer
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN;
-        }
-        if (e == EAGAIN || e == EWOULDBLOCK) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-            continue;                      // Retry
-        }
-        if (e == EHOSTUNREACH || e == ENETUNREACH) {
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN_FILTERED;
-        }
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    ::close(s);
-    return nmap_rc_enum::UDP_OPEN_FILTERED;
-}
-
-static int tcp_connect_with_timeout(in_addr addr, uint16_t port, int timeout_ms)
-{
-    int s = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (s < 0) 
-        return nmap_rc_enum::OTHER;
-
-    // Make socket non-blocking to avoid blocking the thread
-    int nb = 1;
-    if (ioctl(s, FIONBIO, &nb) < 0) {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    // Setup the sockaddr_in structure
-    sockaddr_in sa{
-        .sin_family = AF_INET,
-        .sin_port   = htons(port),
-        .sin_addr   = addr
-    };
-
-    int rc = ::connect(s, (sockaddr*)&sa, sizeof(sa));
-    if (rc == 0) {
-        ::close(s);
-        return nmap_rc_enum::TCP_OPEN;
-    }
-
-    // Check status of connection
-    if (errno != EINPROGRESS && errno != EALREADY) {
-        int e = errno;
-        ::close(s);
-        if (e == ECONNREFUSED || e == ECONNRESET) return nmap_rc_enum::TCP_CLOSED;     // RST
-        if (e == ETIMEDOUT || e == EHOSTUNREACH || e == ENETUNREACH || e == EACCES || e == EPERM)
-            return nmap_rc_enum::TCP_FILTERED;                                         // Silently dropped / blocked
-        return nmap_rc_enum::OTHER;
-    }
-
-    // Wait to write
-    fd_set wfds, efds;
-    FD_ZERO(&wfds); FD_ZERO(&efds);
-    FD_SET(s, &wfds); FD_SET(s, &efds);
-
-    struct timeval tv{
-        .tv_sec  = timeout_ms / 1000,
-        .tv_usec = (timeout_ms % 1000) * 1000
-    };
-
-    rc = ::select(s + 1, nullptr, &wfds, &efds, &tv);
-    if (rc == 0) {                 // handshake never completed -> should be filtered
-        ::close(s);
-        return nmap_rc_enum::TCP_FILTERED;
-    }
-    if (rc < 0)  {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    int soerr = 0;
-    socklen_t len = sizeof(soerr);
-    if (getsockopt(s, SOL_SOCKET, SO_ERROR, &soerr, &len) < 0) {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    ::close(s);
-    switch (soerr)
-    {
-    case 0:
-        /* code */
-        return nmap_rc_enum::TCP_OPEN;
-    case ECONNREFUSED:
-    case ECONNRESET:
-        return nmap_rc_enum::TCP_CLOSED;
-    case ETIMEDOUT:
-    case EHOSTUNREACH:
-    case ENETUNREACH: 
-    case EACCES:
-    case EPERM:
-        return nmap_rc_enum::TCP_FILTERED;
-    default:
-        return nmap_rc_enum::OTHER;
-    }
-    return nmap_rc_enum::OTHER;
-}
-
 static bool resolveIPv4(const std::string& host, in_addr& out)
 {
     struct addrinfo hints{};
@@ -329,41 +186,81 @@ static inline void columnString(std::string& dest, const std::string& text, size
     if (text.size() < width) dest.append(width - text.size(), ' ');
 }
 
-void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t> &ports)
+void NmapService::scanTargets(const std::vector<std::string> &hosts, const std::vector<uint16_t> &ports)
 {
-    in_addr ip{};
-    if (!resolveIPv4(host, ip)) {
-        this->report.append("Failed to resolve host: ").append(host).append("\r\n");
+    const unsigned long startMs = millis();
+    if (icmpService == nullptr && !this->_options.skipPing) {
+        this->report.append("Error: ICMP service not available.\r\n");
         return;
     }
 
-    char ipStr[INET_ADDRSTRLEN]{};
-    inet_ntop(AF_INET, &ip, ipStr, sizeof(ipStr));
-    this->report.append("Nmap scan report for ").append(host).append(" (").append(ipStr).append(")\r\n");
+    // Resolve every host, then one echo sweep over all of them, the port scan runs on every host that is up at once
+    std::vector<std::string> sections(hosts.size());
+    std::vector<uint32_t> addresses;
+    std::vector<size_t> addressSection;
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        const std::string& host = hosts[i];
+        in_addr ip{};
+        if (!resolveIPv4(host, ip)) {
+            sections[i].append("Failed to resolve host: ").append(host).append("\r\n");
+            continue;
+        }
 
-    if (icmpService != nullptr) {
-        #ifndef DEVICE_M5STICK
-        icmpService->startPingTask(host, 1, 1000, 200);
-        while (!icmpService->isPingReady()) vTaskDelay(pdMS_TO_TICKS(50));
-        if (icmpService->lastRc() == ping_rc_t::ping_ok) {
-            this->report.append("Host is up (").append(std::to_string(icmpService->lastMedianMs())).append("ms latency).\r\n");
-        } else {
-            this->report.append("Host is down.\r\n");
+        char ipStr[INET_ADDRSTRLEN]{};
+        inet_ntop(AF_INET, &ip, ipStr, sizeof(ipStr));
+        sections[i].append("Nmap scan report for ").append(host).append(" (").append(ipStr).append(")\r\n");
+        addresses.push_back(ip.s_addr);
+        addressSection.push_back(i);
+    }
+
+    ICMPSweepManager sweep;
+    if (!this->_options.skipPing && !addresses.empty()) {
+        ICMPSweepManager::Config config;
+        config.identifier = static_cast<uint16_t>(esp_random());
+        config.rounds = PING_ROUNDS;
+        config.rate = PING_RATE;
+        config.timeoutMs = PING_TIMEOUT_MS;
+        if (!icmpService->runSweep(sweep, config, addresses)) {
+            this->report.append("Error: ICMP socket not available.\r\n");
             return;
         }
-        #else
-        const unsigned long t0 = millis();
-        const bool ok = Ping.ping(host.c_str(), 1);
-        const unsigned long t1 = millis();
-        if (ok) this->report.append("Host is up (").append(std::to_string(t1 - t0)).append("ms latency).\r\n");
-        else { this->report.append("Host is down.\r\n"); return; }
-        #endif
-    } else {
-        this->report.append("Error: ICMP service not available.\r\n");
-        return;
     }
 
-    if (this->_options.pingOnly) return;
+    std::vector<NmapScanManager::Target> targets;
+    std::vector<size_t> targetSection;
+    for (size_t a = 0; a < addresses.size(); ++a) {
+        std::string& section = sections[addressSection[a]];
+        uint32_t rttUs = 0;
+        if (this->_options.skipPing) {
+            section.append("Host is up (ping skipped).\r\n");
+        } else if (sweep.hosts()[a].received > 0) {
+            rttUs = sweep.hosts()[a].meanUs();
+            char latency[16];
+            snprintf(latency, sizeof(latency), "%.1f", rttUs / 1000.0);
+            section.append("Host is up (").append(latency).append("ms latency).\r\n");
+        } else {
+            section.append("Host is down.\r\n");
+            continue;
+        }
+
+        NmapScanManager::Target target;
+        target.addr = addresses[a];
+        target.ports = ports;
+        target.rttHintUs = rttUs;
+        targets.push_back(std::move(target));
+        targetSection.push_back(addressSection[a]);
+    }
+
+    NmapScanManager scanner;
+    if (!this->_options.pingOnly && !targets.empty()) {
+        NmapScanManager::Config config;
+        config.udp = this->layer4Protocol == Layer4Protocol::UDP;
+        config.window = this->_options.parallelism > 0 ? this->_options.parallelism : SCAN_WINDOW;
+        config.initialTimeoutMs = CONNECT_TIMEOUT_MS;
+        config.retries = config.udp ? UDP_RETRIES : 0;
+        scanner.begin(config, targets);
+        scanner.run();
+    }
 
     auto columnString = [](std::string& dst, const std::string& txt, size_t width){
         dst += txt;
@@ -376,84 +273,65 @@ void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t
         if (len > portCol) portCol = len;
     }
     portCol += 2;
-
-    size_t stateCol = std::string("open|filtered").size();
-    stateCol += 2;
-    std::string header;
-    columnString(header, "PORT",  portCol);
-    columnString(header, "STATE", stateCol);
-    header += "SERVICE\r\n";
-    report += header;
-
-    int closed_ports = ports.size();
-    for (uint16_t p : ports) {
-        std::string state;
-
-        if (this->layer4Protocol == Layer4Protocol::TCP) {
-            int st = tcp_connect_with_timeout(ip, p, CONNECT_TIMEOUT_MS);
-            switch (st) {
-                case nmap_rc_enum::TCP_OPEN:
-                    state = "open";
-                    closed_ports--;
-                    break;
-                case nmap_rc_enum::TCP_CLOSED:
-                    if (this->verbosity >= 1) 
-                        state = "closed";
-                    break;
-                case nmap_rc_enum::TCP_FILTERED:
-                    state = "filtered";
-                    closed_ports--;
-                    break;
-                default:
-                    if (this->verbosity >= 1)
-                        state = "error";
-                    break;
-            }
-        } else if (this->layer4Protocol == Layer4Protocol::UDP) {
-            int st = udp_probe_with_timeout(ip, p, CONNECT_TIMEOUT_MS, nullptr, 0);
-            switch (st) {
-                case nmap_rc_enum::UDP_OPEN:
-                    state = "open";
-                    closed_ports--;
-                    break;
-                case nmap_rc_enum::UDP_CLOSED:
-                    if (this->verbosity >= 1)
-                        state = "closed";
-                    break;
-                case nmap_rc_enum::UDP_OPEN_FILTERED:
-                    state = "open|filtered";
-                    closed_ports--;
-                    break;
-                default:
-                    if (this->verbosity >= 1) state = "error";
-                    break;
+    size_t stateCol = std::string("open|filtered").size() + 2;
+
+    const bool tcp = this->layer4Protocol == Layer4Protocol::TCP;
+    for (size_t t = 0; t < scanner.hosts().size(); ++t) {
+        const auto& result = scanner.hosts()[t];
+        std::string& section = sections[targetSection[t]];
+
+        std::string header;
+        columnString(header, "PORT",  portCol);
+        columnString(header, "STATE", stateCol);
+        header += "SERVICE\r\n";
+        section += header;
+
+        size_t notShown = 0;
+        for (size_t i = 0; i < result.ports.size(); ++i) {
+            const uint16_t p = result.ports[i];
+            const auto st = result.states[i];
+            const bool quiet = st == NmapScanManager::State::Closed || st == NmapScanManager::State::Error ||
+                               st == NmapScanManager::State::Pending;
+            if (quiet && this->verbosity < 1) {
+                notShown++;
+                continue;
             }
-        } else {
-            return;
-        }
 
-        if (!state.empty()) {
             std::string row;
-            std::string portField = std::to_string(p) + (layer4Protocol == Layer4Protocol::TCP ? "/tcp" : "/udp");
-            columnString(row, portField, portCol);
-            columnString(row, state,     stateCol);
+            columnString(row, std::to_string(p) + (tcp ? "/tcp" : "/udp"), portCol);
+            columnString(row, NmapScanManager::stateName(st), stateCol);
 
             const char* svc = nmap_guess_service(
                 p,
                 layer4Protocol,
-                (layer4Protocol == Layer4Protocol::TCP) ? TOP100_TCP_MAP : TOP100_UDP_MAP,
-                (layer4Protocol == Layer4Protocol::TCP) ? TOP100_TCP_MAP_COUNT : TOP100_UDP_MAP_COUNT
+                tcp ? TOP100_TCP_MAP : TOP100_UDP_MAP,
+                tcp ? TOP100_TCP_MAP_COUNT : TOP100_UDP_MAP_COUNT
             );
             if (svc) row += svc;
-
-            report.append(row).append("\r\n");
+            section.append(row).append("\r\n");
         }
 
-        vTaskDelay(pdMS_TO_TICKS(SMALL_DELAY_MS));
+        if (notShown > 0)
+            section.append("Not shown: ").append(std::to_string(notShown)).append(" ports\r\n");
+        if (this->verbosity >= 1)
+            section.append("Timeout ").append(std::to_string(scanner.timeoutMs(t))).append("ms, ")
+                   .append(std::to_string(result.probes)).append(" probes, ")
+                   .append(std::to_string(result.timeouts)).append(" timeouts\r\n");
+        section.append("\r\n");
     }
 
-    if (closed_ports > 0)
-        this->report.append("Not shown: ").append(std::to_string(closed_ports)).append(" ports\r\n\n");
+    for (const auto& section : sections) this->report.append(section);
+
+    // Summary, as nmap prints it
+    const unsigned long elapsedMs = millis() - startMs;
+    char elapsed[16];
+    snprintf(elapsed, sizeof(elapsed), "%.2f", elapsedMs / 1000.0);
+    this->report.append("Nmap done: ").append(std::to_string(hosts.size())).append(" IP address(es) (")
+        .append(std::to_string(targets.size())).append(" host(s) up) scanned in ").append(elapsed).append(" seconds");
+    if (scanner.portsTotal() > 0) {
+        this->report.append(", ").append(std::to_string(static_cast<int>(scanner.portsPerSecond()))).append(" ports/s");
+    }
+    this->report.append("\r\n");
 }
 
 void NmapService::setICMPService(ICMPService* icmpService){
@@ -474,13 +352,10 @@ void NmapService::scanTask(void *pvParams)
 {
     auto *params = static_cast<NmapTaskParams *>(pvParams);
     auto &service = *params->service;
-    auto &hosts = params->targetHosts;
-    for (auto host : hosts) {
-        service.scanTarget(host, params->targetPorts);
-    }
+    service.verbosity = params->verbosity;
+    service.scanTargets(params->targetHosts, params->targetPorts);
 
     service.ready = true;
-    service.verbosity = params->verbosity;
     delete params;
     vTaskDelete(nullptr);
 }
@@ -496,20 +371,19 @@ bool NmapService::parseHosts(const std::string& hosts_arg)
 {
     this->targetHosts = std::vector<std::string>();
 
-    // If we find ',' or '-' or '/network_mask' there are multiple hosts
-    if (hosts_arg.find(',') == std::string::npos && hosts_arg.find('-') == std::string::npos && hosts_arg.find('/') == std::string::npos) {
-        // Single host
-        if (isIpv4(hosts_arg)) {
-            this->targetHosts.push_back(hosts_arg);
-        }
-        else {
-            return false;
-        }
-    }
-    else {
-        // Not yet implemented
+    // Single address, last byte range, CIDR network, or a comma separated list of them
+    std::vector<uint32_t> addresses;
+    if (!NmapScanManager::expandHosts(hosts_arg, addresses, NmapScanManager::MAX_HOSTS)) {
         return false;
     }
+
+    for (uint32_t address : addresses) {
+        in_addr ip{};
+        ip.s_addr = address;
+        char ipStr[INET_ADDRSTRLEN]{};
+        inet_ntop(AF_INET, &ip, ipStr, sizeof(ipStr));
+        this->targetHosts.push_back(ipStr);
+    }
     return true;
 }
 
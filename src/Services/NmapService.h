@@ -29,7 +29,8 @@ private:
     // Nmap Task, cause overflow if it runs in the main loop, so it must run in a dedicated FreeRTOS task with a larger stack
     static void scanTask(void *pvParams);
     bool isIpv4(const std::string& address);
-    void scanTarget(const std::string &host, const std::vector<uint16_t> &ports);
+    // One ICMP sweep over every host, then the ports of the hosts that are up, all concurrently
+    void scanTargets(const std::vector<std::string> &hosts, const std::vector<uint16_t> &ports);
 
     ICMPService* icmpService;
     std::vector<std::string> targetHosts;
@@ -78,6 +78,11 @@ bool SshService::connect(const std::string& host, const std::string& user, const
     if (!requestPty()) return false;
     if (!startShell()) return false;
 
+    // 按键合并后写入通道，读取时批量读完
+    io.begin(
+        [this](const char* data, size_t len) { return ssh_channel_write(channel, data, len); },
+        [this](char* buf, size_t cap) { return ssh_channel_read_nonblocking(channel, buf, cap, 0); });
+
     connected = true; // 标记SSH已成功连接
     return true;
 }
@@ -146,11 +151,19 @@ bool SshService::isConnected() const {
 /**
  * @brief 向SSH通道写入单个字符
  * @param c 要写入的字符
- * @note 仅当连接有效时执行写入操作
+ * @note 字符先进入发送缓冲，换行、缓冲满或输入空闲时合并写入
  */
 void SshService::writeChar(char c) {
     if (!isConnected()) return;
-    ssh_channel_write(channel, &c, 1);
+    io.write(c, millis());
+}
+
+/**
+ * @brief 写入空闲超时的缓冲数据，需在会话循环中调用
+ */
+void SshService::poll() {
+    if (!isConnected()) return;
+    io.poll(millis());
 }
 
 /**
@@ -168,15 +181,13 @@ std::string SshService::readOutput() {
 
 /**
  * @brief 非阻塞读取SSH通道输出
- * @return 读取到的字符串（无数据返回空字符串）
- * @note 此方法不会阻塞，立即返回当前可用数据
+ * @param out 追加输出的字符串（由调用方复用）
+ * @return 本次读取的字节数（无数据返回0）
+ * @note 此方法不会阻塞，一次读完通道中已有的数据（上限RX_MAX_POLL）
  */
-std::string SshService::readOutputNonBlocking() {
-    if (!isConnected()) return "";
-    char buf[256]; // 读取缓冲区（256字节）
-    // 非阻塞读取通道数据
-    int n = ssh_channel_read_nonblocking(channel, buf, sizeof(buf), 0);
-    return (n > 0) ? std::string(buf, n) : ""; // 有数据则返回字符串，否则返回空
+size_t SshService::readOutputNonBlocking(std::string& out) {
+    if (!isConnected()) return 0;
+    return io.drain(out);
 }
 
 /**
@@ -184,6 +195,10 @@ std::string SshService::readOutputNonBlocking() {
  * @note 先关闭通道→释放通道→断开会话→释放会话→重置连接状态
  */
 void SshService::close() {
+    // 发送缓冲中剩余的数据
+    if (isConnected()) io.flush();
+    io.reset();
+
     // 关闭并释放SSH通道
     if (channel) {
         ssh_channel_close(channel);
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <libssh/libssh.h>
+#include "Managers/SessionIoManager.h"
 
 class SshService {
 public:
@@ -9,8 +10,11 @@ public:
     
     bool isConnected() const;
     void writeChar(char c);
+    // Sends what the idle timer released
+    void poll();
     std::string readOutput();
-    std::string readOutputNonBlocking();
+    // Appends the received bytes to out, returns their count
+    size_t readOutputNonBlocking(std::string& out);
     void close();
 
 private:
@@ -26,4 +30,5 @@ private:
     ssh_session session = nullptr;
     ssh_channel channel = nullptr;
     bool connected = false;
+    SessionIoManager io;
 };
@@ -1,6 +1,9 @@
 #include "SubGhzService.h"
 #include "driver/rmt.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include <sstream>
+#include <cstring>
 
 // -------------------------- 基础配置与初始化 --------------------------
 
@@ -29,6 +32,8 @@ bool SubGhzService::configure(SPIClass& spi, uint8_t sck, uint8_t miso, uint8_t
     mhz_ = mhz;
     paDbm_ = paDbm;
     ccMode_ = true;
+    hopping_ = false;
+    calCache_.clear();             // 新模块需要重新校准
 
     // SPI实例适配（不同硬件平台差异化处理）
     #ifdef DEVICE_TEMBEDS3CC1101
@@ -63,6 +68,7 @@ bool SubGhzService::configure(SPIClass& spi, uint8_t sck, uint8_t miso, uint8_t
 void SubGhzService::tune(float mhz)
 {
     if (!isConfigured_) return;
+    endHopping();                  // 恢复自动校准
     mhz_ = mhz;
     ELECHOUSE_cc1101.SetRx(mhz_);  // 设置接收频率
 
@@ -80,19 +86,135 @@ void SubGhzService::tune(float mhz)
  */
 int SubGhzService::measurePeakRssi(uint32_t holdMs)
 {
-    if (!isConfigured_) return -127;
     if (holdMs < 1) holdMs = 1;    // 最小测量时长1ms
+    return measurePeakRssiUs(holdMs * 1000);
+}
 
-    const unsigned long t0 = millis();
+/**
+ * @brief 以微秒为单位测量峰值RSSI
+ * @param holdUs 测量时长（微秒）
+ * @return 峰值RSSI值（dBm，-127表示无信号）
+ * @note 连续读取RSSI寄存器，不再以1ms为粒度延时，至少采样一次
+ */
+int SubGhzService::measurePeakRssiUs(uint32_t holdUs)
+{
+    if (!isConfigured_) return -127;
+
+    const int64_t t0 = esp_timer_get_time();
     int peak = -127;               // 初始峰值设为最小
-    while (millis() - t0 < holdMs) {
+    do {
         int r = ELECHOUSE_cc1101.getRssi(); // 读取当前RSSI
         if (r > peak) peak = r;             // 更新峰值
-        delay(1);
-    }
+    } while ((uint32_t)(esp_timer_get_time() - t0) < holdUs);
     return peak;
 }
 
+// -------------------------- 快速跳频（校准缓存） --------------------------
+
+/**
+ * @brief 预先校准一组频率并缓存FSCAL值
+ * @param freqs 频率列表（MHz）
+ * @return 新校准的频率数量（已缓存的跳过）
+ */
+size_t SubGhzService::calibrateChannels(const std::vector<float>& freqs)
+{
+    if (!isConfigured_) return 0;
+
+    size_t added = 0;
+    for (float f : freqs) {
+        const uint32_t key = (uint32_t)(f * 1000.0f + 0.5f);
+        if (calCache_.count(key)) continue;
+
+        ChannelCalibration cal;
+        if (!calibrateChannel(f, cal)) continue;
+        calCache_[key] = cal;
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief 校准单个频率并读取校准结果
+ * @param mhz 频率（MHz）
+ * @param out 输出的寄存器值
+ * @return 校准成功返回true
+ * @note setMHZ写入频率及FSCTRL0/TEST0，SCAL触发校准，完成后芯片回到IDLE
+ */
+bool SubGhzService::calibrateChannel(float mhz, ChannelCalibration& out)
+{
+    ELECHOUSE_cc1101.setSidle();
+    ELECHOUSE_cc1101.setMHZ(mhz);
+    if (!ELECHOUSE_cc1101.SpiStrobe(CC1101_SCAL)) return false;
+
+    // 校准约需720us，等待回到IDLE状态
+    const int64_t t0 = esp_timer_get_time();
+    while ((ELECHOUSE_cc1101.SpiReadStatus(CC1101_MARCSTATE) & 0x1F) != 0x01) {
+        if (esp_timer_get_time() - t0 > 2000) return false;
+    }
+
+    // FSCTRL0、FREQ2..0以及FSCAL3..1地址连续，各一次突发读取
+    if (!ELECHOUSE_cc1101.SpiReadBurstReg(CC1101_FSCTRL0, out.freq, sizeof(out.freq))) return false;
+    if (!ELECHOUSE_cc1101.SpiReadBurstReg(CC1101_FSCAL3, out.fscal, sizeof(out.fscal))) return false;
+    out.test0 = ELECHOUSE_cc1101.SpiReadReg(CC1101_TEST0);
+    return true;
+}
+
+/**
+ * @brief 使用缓存的校准值快速切换接收频率
+ * @param mhz 目标频率（MHz），未缓存时先校准
+ * @return 切换成功返回true
+ * @note 首次调用关闭MCSM0的自动校准，结束后必须调用endHopping()恢复
+ */
+bool SubGhzService::hopTo(float mhz)
+{
+    if (!isConfigured_) return false;
+
+    const uint32_t key = (uint32_t)(mhz * 1000.0f + 0.5f);
+    auto it = calCache_.find(key);
+    if (it == calCache_.end()) {
+        ChannelCalibration cal;
+        if (!calibrateChannel(mhz, cal)) return false;
+        it = calCache_.emplace(key, cal).first;
+    }
+
+    // 关闭IDLE->RX时的自动校准
+    if (!hopping_) {
+        savedMcsm0_ = ELECHOUSE_cc1101.SpiReadReg(CC1101_MCSM0);
+        ELECHOUSE_cc1101.SpiWriteReg(CC1101_MCSM0, savedMcsm0_ & ~0x30);
+        hopping_ = true;
+    }
+
+    ChannelCalibration& cal = it->second;
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SIDLE);
+    ELECHOUSE_cc1101.SpiWriteBurstReg(CC1101_FSCTRL0, cal.freq, sizeof(cal.freq));
+    ELECHOUSE_cc1101.SpiWriteBurstReg(CC1101_FSCAL3, cal.fscal, sizeof(cal.fscal));
+    ELECHOUSE_cc1101.SpiWriteReg(CC1101_TEST0, cal.test0);
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SRX);
+    mhz_ = mhz;
+
+    #ifdef DEVICE_TEMBEDS3CC1101
+    selectRfPathFor(mhz_);         // Tembed硬件：根据频率选择射频路径
+    #endif
+
+    // 等待进入RX状态（无校准时约90us）
+    const int64_t t0 = esp_timer_get_time();
+    while ((ELECHOUSE_cc1101.SpiReadStatus(CC1101_MARCSTATE) & 0x1F) != 0x0D) {
+        if (esp_timer_get_time() - t0 > 1000) break;
+    }
+    return true;
+}
+
+/**
+ * @brief 结束快速跳频，恢复MCSM0自动校准设置
+ */
+void SubGhzService::endHopping()
+{
+    if (!hopping_) return;
+    ELECHOUSE_cc1101.setSidle();
+    ELECHOUSE_cc1101.SpiWriteReg(CC1101_MCSM0, savedMcsm0_);
+    hopping_ = false;
+}
+
 /**
  * @brief 获取支持的频段列表
  * @return 频段名称向量（用户可见文本已汉化）
@@ -163,6 +285,7 @@ void SubGhzService::setScanBand(const std::string& s) {
  * @param pin 嗅探引脚（连接CC1101的GDO0或直接接收射频信号）
  * @return 启动成功返回true，失败返回false
  * @note RMT配置：RX模式、滤波开启、空闲阈值3ms、滤波阈值200us
+ *       RMT环形缓冲区由独立的高优先级任务排空到积压缓冲区（优先PSRAM）
  */
 bool SubGhzService::startRawSniffer(int pin) {
     // 配置RMT接收参数
@@ -181,34 +304,145 @@ bool SubGhzService::startRawSniffer(int pin) {
     if (rmt_config(&rxconfig) != ESP_OK) return false;
     if (rmt_driver_install(rxconfig.channel, RMT_BUFFER_SIZE, 0) != ESP_OK) return false;
 
-    // 获取环形缓冲区句柄并启动接收
-    if (rmt_get_ringbuf_handle(rxconfig.channel, &rb_) != ESP_OK) return false;
+    // 获取环形缓冲区句柄
+    if (rmt_get_ringbuf_handle(rxconfig.channel, &rb_) != ESP_OK) {
+        rmt_driver_uninstall(rxconfig.channel);
+        rb_ = nullptr;
+        return false;
+    }
+
+    // 启动消费任务，失败则释放RMT
+    if (!startConsumer()) {
+        rmt_driver_uninstall(rxconfig.channel);
+        rb_ = nullptr;
+        return false;
+    }
+
     rmt_rx_start(rxconfig.channel, true);
+    return true;
+}
+
+/**
+ * @brief 分配积压缓冲区并启动RMT消费任务
+ * @return 启动成功返回true，失败返回false
+ * @note 任务固定在UI循环之外的另一个核心上运行
+ */
+bool SubGhzService::startConsumer() {
+    overflowCount_ = 0;
+
+    // 积压缓冲区：优先PSRAM，否则使用较小的内部RAM
+    backlogSize_ = 0;
+    if (psramFound()) {
+        backlogStorage_ = (uint8_t*) heap_caps_malloc(SUBGHZ_BACKLOG_PSRAM_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (backlogStorage_) backlogSize_ = SUBGHZ_BACKLOG_PSRAM_SIZE;
+    }
+    if (!backlogStorage_) {
+        backlogStorage_ = (uint8_t*) heap_caps_malloc(SUBGHZ_BACKLOG_INTERNAL_SIZE, MALLOC_CAP_8BIT);
+        if (!backlogStorage_) return false;
+        backlogSize_ = SUBGHZ_BACKLOG_INTERNAL_SIZE;
+    }
+
+    backlog_ = xRingbufferCreateStatic(backlogSize_, RINGBUF_TYPE_NOSPLIT, backlogStorage_, &backlogStruct_);
+    if (!backlog_) {
+        heap_caps_free(backlogStorage_);
+        backlogStorage_ = nullptr;
+        backlogSize_ = 0;
+        return false;
+    }
 
+    // 退出信号量，静态分配
+    if (!consumerExited_) consumerExited_ = xSemaphoreCreateBinaryStatic(&consumerExitedStruct_);
+
+    // 高优先级任务，运行在UI循环的另一个核心
+    consumerRunning_ = true;
+    const BaseType_t core = (xPortGetCoreID() == 0) ? 1 : 0;
+    TaskHandle_t handle = nullptr;
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        &SubGhzService::consumerTaskThunk,
+        "subghz_rmt_rx",
+        3072,
+        this,
+        configMAX_PRIORITIES - 2,
+        &handle,
+        core
+    );
+    consumerHandle_ = (ok == pdPASS) ? handle : nullptr;
+    if (ok != pdPASS) {
+        consumerRunning_ = false;
+        vRingbufferDelete(backlog_);
+        backlog_ = nullptr;
+        heap_caps_free(backlogStorage_);
+        backlogStorage_ = nullptr;
+        backlogSize_ = 0;
+        return false;
+    }
     return true;
 }
 
 /**
- * @brief 检查嗅探器缓冲区是否溢出
- * @return 溢出返回true，正常返回false
- * @note 剩余空间小于128字节判定为溢出
+ * @brief 停止RMT消费任务并释放积压缓冲区
+ */
+void SubGhzService::stopConsumer() {
+    if (consumerHandle_.load()) {
+        consumerRunning_ = false;
+        // 任务每次最多阻塞10ms，等它退出前的信号，之后才能释放缓冲区
+        xSemaphoreTake(consumerExited_, portMAX_DELAY);
+    }
+
+    if (backlog_) {
+        vRingbufferDelete(backlog_);
+        backlog_ = nullptr;
+    }
+    if (backlogStorage_) {
+        heap_caps_free(backlogStorage_);
+        backlogStorage_ = nullptr;
+    }
+    backlogSize_ = 0;
+}
+
+void SubGhzService::consumerTaskThunk(void* arg) {
+    auto* self = static_cast<SubGhzService*>(arg);
+    self->consumerTask();
+    self->consumerHandle_ = nullptr;
+    xSemaphoreGive(self->consumerExited_);  // 之后不再访问self
+    vTaskDelete(nullptr);
+}
+
+/**
+ * @brief RMT消费任务：将帧从RMT环形缓冲区移动到带时间戳的积压缓冲区
+ * @note 积压缓冲区满时丢弃该帧并累加溢出计数
  */
-bool SubGhzService::isSnifferOverflowing() const {
-    if (!rb_) return false;
-    size_t freeBytes = xRingbufferGetCurFreeSize(rb_);
-    return freeBytes < 128;
+void SubGhzService::consumerTask() {
+    while (consumerRunning_.load()) {
+        size_t rxSize = 0;
+        rmt_item32_t* item = (rmt_item32_t*) xRingbufferReceive(rb_, &rxSize, pdMS_TO_TICKS(10));
+        if (!item) continue;
+
+        const uint32_t ts = (uint32_t) esp_timer_get_time();
+        void* slot = nullptr;
+        if (xRingbufferSendAcquire(backlog_, &slot, sizeof(BacklogHeader) + rxSize, 0) == pdTRUE && slot) {
+            BacklogHeader header{ ts };
+            memcpy(slot, &header, sizeof(header));
+            memcpy((uint8_t*)slot + sizeof(header), item, rxSize);
+            xRingbufferSendComplete(backlog_, slot);
+        } else {
+            overflowCount_++;
+        }
+
+        vRingbufferReturnItem(rb_, (void*)item);
+    }
 }
 
 /**
- * @brief 清空嗅探器缓冲区（释放所有未处理的脉冲数据）
+ * @brief 清空积压缓冲区（释放所有未处理的脉冲数据）
  */
 void SubGhzService::drainSniffer() {
-    if (!rb_) return;
+    if (!backlog_) return;
     while (true) {
         size_t rx_size = 0;
-        rmt_item32_t* item = (rmt_item32_t*) xRingbufferReceive(rb_, &rx_size, 0);
-        if (!item) break;          // 无数据则退出
-        vRingbufferReturnItem(rb_, (void*)item); // 释放缓冲区
+        void* record = xRingbufferReceive(backlog_, &rx_size, 0);
+        if (!record) break;          // 无数据则退出
+        vRingbufferReturnItem(backlog_, record); // 释放缓冲区
     }
 }
 
@@ -217,7 +451,7 @@ void SubGhzService::drainSniffer() {
  */
 void SubGhzService::stopRawSniffer() {
     rmt_rx_stop(RMT_RX_CHANNEL);   // 停止RMT接收
-    drainSniffer();                // 清空缓冲区
+    stopConsumer();                // 停止消费任务并释放积压缓冲区
     rmt_driver_uninstall(RMT_RX_CHANNEL); // 卸载RMT驱动
     rb_ = nullptr;                 // 重置缓冲区句柄
     ELECHOUSE_cc1101.setSidle();   // CC1101进入空闲状态
@@ -229,37 +463,80 @@ void SubGhzService::stopRawSniffer() {
  * @note 输出文本已完全汉化，包含脉冲数量、频率、总时长、高低电平及时长
  */
 std::pair<std::string, size_t> SubGhzService::readRawPulses() {
-    if (!rb_) return {"", 0};
+    size_t n = 0;
+    const rmt_item32_t* items = receiveRawItems(n);
+    if (!items) return {"", 0};
 
-    size_t rx_size = 0;
-    rmt_item32_t* item = (rmt_item32_t*) xRingbufferReceive(rb_, &rx_size, 0);
-    if (!item) return {"", 0};
+    std::string text = formatRawPulses(items, n);
 
-    size_t n = rx_size / sizeof(rmt_item32_t);
+    returnRawItems(items); // 释放内存
+    return {text, n};
+}
+
+/**
+ * @brief 将RMT脉冲格式化为用户可读字符串
+ * @param items RMT脉冲结构体数组
+ * @param count 脉冲数量
+ * @return 包含脉冲数量、频率、总时长、高低电平及时长的描述文本
+ * @note 仅在需要显示时调用，录制路径不做任何格式化
+ */
+std::string SubGhzService::formatRawPulses(const rmt_item32_t* items, size_t count) const {
     uint32_t totalDuration = 0;
     // 计算总时长（时钟周期）
-    for (size_t i = 0; i < n; i++) {
-        totalDuration += item[i].duration0;
-        totalDuration += item[i].duration1;
+    for (size_t i = 0; i < count; i++) {
+        totalDuration += items[i].duration0;
+        totalDuration += items[i].duration1;
     }
 
     // 格式化输出（用户可见文本汉化）
     std::ostringstream oss;
-    oss << "[原始 " << n << " 个脉冲 | 频率=" << mhz_
+    oss << "[原始 " << count << " 个脉冲 | 频率=" << mhz_
         << " MHz | 时长=" << totalDuration << " 时钟周期]\r\n";
 
     int col = 0;
-    for (size_t i = 0; i < n; i++) {
-        oss << (item[i].level0 ? '高' : '低') << ":" << item[i].duration0
+    for (size_t i = 0; i < count; i++) {
+        oss << (items[i].level0 ? "高" : "低") << ":" << items[i].duration0
             << " | "
-            << (item[i].level1 ? '高' : '低') << ":" << item[i].duration1
+            << (items[i].level1 ? "高" : "低") << ":" << items[i].duration1
             << "   ";
         if (++col % 4 == 0) oss << "\r\n"; // 每4个脉冲换行，提升可读性
     }
     oss << "\n\r";
+    return oss.str();
+}
+
+/**
+ * @brief 零拷贝获取积压缓冲区中的下一帧（必须调用returnRawItems释放）
+ * @param count 输出脉冲数量
+ * @param timestampUs 可选，输出帧被消费任务接收时的时间戳（微秒）
+ * @return 脉冲数组指针，无数据返回nullptr
+ */
+const rmt_item32_t* SubGhzService::receiveRawItems(size_t& count, uint32_t* timestampUs) {
+    count = 0;
+    if (!backlog_) return nullptr;
+
+    size_t rx_size = 0;
+    uint8_t* record = (uint8_t*) xRingbufferReceive(backlog_, &rx_size, 0);
+    if (!record) return nullptr;
+
+    if (timestampUs) {
+        BacklogHeader header;
+        memcpy(&header, record, sizeof(header));
+        *timestampUs = header.timestampUs;
+    }
 
-    vRingbufferReturnItem(rb_, (void*)item); // 释放内存
-    return {oss.str(), n};
+    count = (rx_size - sizeof(BacklogHeader)) / sizeof(rmt_item32_t);
+    return (const rmt_item32_t*)(record + sizeof(BacklogHeader));
+}
+
+/**
+ * @brief 释放receiveRawItems获取的脉冲数据
+ * @param items 脉冲数组指针
+ */
+void SubGhzService::returnRawItems(const rmt_item32_t* items) {
+    if (!backlog_ || !items) return;
+    const uint8_t* record = (const uint8_t*)items - sizeof(BacklogHeader);
+    vRingbufferReturnItem(backlog_, (void*)record);
 }
 
 /**
@@ -268,52 +545,43 @@ std::pair<std::string, size_t> SubGhzService::readRawPulses() {
  */
 std::vector<rmt_item32_t> SubGhzService::readRawFrame() {
     std::vector<rmt_item32_t> frame;
-    if (!rb_) return frame;
 
-    size_t rx_size = 0;
-    rmt_item32_t* item = (rmt_item32_t*) xRingbufferReceive(rb_, &rx_size, 0);
-    if (!item) return frame;
+    size_t n = 0;
+    const rmt_item32_t* items = receiveRawItems(n);
+    if (!items) return frame;
 
-    size_t n = rx_size / sizeof(rmt_item32_t);
-    frame.assign(item, item + n); // 复制脉冲数据
+    frame.assign(items, items + n); // 复制脉冲数据
 
-    vRingbufferReturnItem(rb_, (void*)item);
+    returnRawItems(items);
     return frame;
 }
 
 /**
- * @brief 发送原始帧数据（基于BitBang方式）
+ * @brief 发送原始帧数据（基于RMT发送通道）
  * @param pin 发送引脚
- * @param items RMT脉冲结构体列表
+ * @param items RMT脉冲结构体列表（如嗅探捕获的帧）
  * @param tick_per_us 时钟周期/微秒（用于转换时长）
  * @return 发送成功返回true，失败返回false
+ * @note 边沿由RMT硬件定时，不受中断影响；RMT驱动保持安装直到stopTxBitBang()
  */
 bool SubGhzService::sendRawFrame(int pin, const std::vector<rmt_item32_t>& items, uint32_t tick_per_us) {
-    if (!isConfigured_ || items.empty()) return false;
+    if (!isConfigured_ || items.empty() || !tick_per_us) return false;
 
-    // 启动TX BitBang模式（引脚设为输出）
-    if (!startTxBitBang()) return false;
-
-    // 时钟周期转微秒的工具函数
-    auto ticks_to_us = [tick_per_us](uint32_t ticks) -> uint32_t {
-        if (!tick_per_us) return 0;
-        return (ticks + (tick_per_us/2)) / tick_per_us;
-    };
-
-    // 逐脉冲发送（BitBang）
+    // 转换为带符号时序（微秒），时长0为结束标记
+    std::vector<int32_t> timings;
+    timings.reserve(items.size() * 2);
     for (const auto& it : items) {
-        gpio_set_level((gpio_num_t)pin, it.level0 ? 1 : 0); // 设置电平
-        uint32_t us0 = ticks_to_us(it.duration0);           // 转换时长
-        if (us0) esp_rom_delay_us(us0);                     // 保持电平
+        if (!it.duration0) break;
+        int32_t us0 = (int32_t)((it.duration0 + tick_per_us / 2) / tick_per_us);
+        timings.push_back(it.level0 ? us0 : -us0);
 
-        gpio_set_level((gpio_num_t)pin, it.level1 ? 1 : 0);
-        uint32_t us1 = ticks_to_us(it.duration1);
-        if (us1) esp_rom_delay_us(us1);
+        if (!it.duration1) break;
+        int32_t us1 = (int32_t)((it.duration1 + tick_per_us / 2) / tick_per_us);
+        timings.push_back(it.level1 ? us1 : -us1);
     }
 
-    // 重置引脚为低电平
-    gpio_set_level((gpio_num_t)pin, 0);
-    return true;
+    if (!startRmtTx(pin)) return false;
+    return rmtSendTimings(timings.data(), timings.size(), /*waitDone*/true);
 }
 
 /**
@@ -339,6 +607,9 @@ bool SubGhzService::startTxBitBang() {
 bool SubGhzService::stopTxBitBang() {
     if (!isConfigured_) return false;
 
+    // 释放RMT发送通道（如已安装）
+    stopRmtTx();
+
     // 强制引脚为低电平
     gpio_set_direction((gpio_num_t)gdo0_, GPIO_MODE_OUTPUT);
     gpio_set_level((gpio_num_t)gdo0_, 0);
@@ -357,6 +628,125 @@ bool SubGhzService::stopTxBitBang() {
     return gpio_config(&io) == ESP_OK;
 }
 
+/**
+ * @brief 安装RMT发送通道（已安装则直接返回）
+ * @param pin 发送引脚（CC1101的GDO0，异步串行数据输入）
+ * @return 安装成功返回true，失败返回false
+ * @note 空闲输出低电平；超过一个内存块的数据由驱动在阈值中断中续填
+ */
+bool SubGhzService::startRmtTx(int pin) {
+    if (!isConfigured_) return false;
+    if (rmtTxInstalled_) return true;
+
+    rmt_config_t txconfig;
+    txconfig.rmt_mode = RMT_MODE_TX;                  // TX模式
+    txconfig.channel = RMT_TX_CHANNEL;                // 发送通道
+    txconfig.gpio_num = (gpio_num_t)pin;              // 发送引脚
+    txconfig.clk_div = RMT_CLK_DIV;                   // 1 tick = 1us
+    txconfig.mem_block_num = 1;                       // 内存块数量
+    txconfig.flags = 0;
+    txconfig.tx_config.loop_en = false;               // 不循环
+    txconfig.tx_config.carrier_en = false;            // 无载波（OOK由CC1101调制）
+    txconfig.tx_config.carrier_freq_hz = 0;
+    txconfig.tx_config.carrier_duty_percent = 0;
+    txconfig.tx_config.carrier_level = RMT_CARRIER_LEVEL_HIGH;
+    txconfig.tx_config.idle_output_en = true;         // 空闲时输出
+    txconfig.tx_config.idle_level = RMT_IDLE_LEVEL_LOW; // 空闲低电平
+
+    if (rmt_config(&txconfig) != ESP_OK) return false;
+    if (rmt_driver_install(txconfig.channel, 0, 0) != ESP_OK) return false;
+
+    rmtTxInstalled_ = true;
+    rmtTxPending_ = false;
+    rmtTxActive_ = 0;
+    rmtTxNextStartUs_ = 0;
+    rmtTxCarry_.clear();
+    return true;
+}
+
+/**
+ * @brief 等待发送完成并卸载RMT发送通道
+ */
+void SubGhzService::stopRmtTx() {
+    if (!rmtTxInstalled_) return;
+
+    if (rmtTxPending_) rmt_wait_tx_done(RMT_TX_CHANNEL, portMAX_DELAY);
+    rmt_driver_uninstall(RMT_TX_CHANNEL);
+
+    rmtTxInstalled_ = false;
+    rmtTxPending_ = false;
+    rmtTxNextStartUs_ = 0;
+
+    // 释放发送缓冲区
+    std::vector<rmt_item32_t>().swap(rmtTxItems_[0]);
+    std::vector<rmt_item32_t>().swap(rmtTxItems_[1]);
+    std::vector<int32_t>().swap(rmtTxCarry_);
+}
+
+/**
+ * @brief 等待上一批发送完成，并等到其结尾低电平的时长用完
+ * @note 结尾低电平不写入RMT，期间引脚保持空闲低电平
+ */
+void SubGhzService::waitRmtTxSlot() {
+    if (rmtTxPending_) {
+        rmt_wait_tx_done(RMT_TX_CHANNEL, portMAX_DELAY);
+        rmtTxPending_ = false;
+    }
+    if (rmtTxNextStartUs_ == 0) return;
+
+    // 长的低电平让出CPU，最后不足两个tick时忙等
+    const int64_t tickUs = portTICK_PERIOD_MS * 1000;
+    const int64_t waitUs = rmtTxNextStartUs_ - esp_timer_get_time();
+    if (waitUs > 2 * tickUs) vTaskDelay((waitUs - tickUs) / tickUs);
+    while (esp_timer_get_time() < rmtTxNextStartUs_) {}
+}
+
+/**
+ * @brief 通过RMT发送一批带符号时序（双缓冲）
+ * @param timings 时序（正数=高电平，负数=低电平，单位微秒）
+ * @param count 时序数量
+ * @param waitDone 是否等待本批（含结尾低电平）发送完成
+ * @return 发送成功返回true，失败返回false
+ * @note 上一批仍在发送时打包本批；结尾低电平按时间等待，下一批在其结束时启动
+ */
+bool SubGhzService::rmtSendTimings(const int32_t* timings, size_t count, bool waitDone) {
+    if (!rmtTxInstalled_) return false;
+
+    // 结尾低电平由空闲电平代替，下一批按其时长接续
+    int64_t trailingLowUs = 0;
+    while (count > 0 && timings[count - 1] <= 0) {
+        trailingLowUs -= timings[count - 1];
+        --count;
+    }
+
+    // 打包到空闲缓冲区，另一个缓冲区可能仍在发送
+    auto& items = rmtTxItems_[rmtTxActive_];
+    SubGhzTransformer::toRmtItems(timings, count, RMT_1US_TICKS, items);
+    int64_t itemsUs = 0;
+    for (const auto& it : items) itemsUs += it.duration0 + it.duration1;
+    itemsUs /= RMT_1US_TICKS;
+
+    // 等待上一批及其结尾低电平
+    waitRmtTxSlot();
+
+    const int64_t startUs = esp_timer_get_time();
+    if (!items.empty()) {
+        if (rmt_write_items(RMT_TX_CHANNEL, items.data(), items.size(), false) != ESP_OK) {
+            rmtTxNextStartUs_ = 0;
+            return false;
+        }
+        rmtTxPending_ = true;
+        rmtTxActive_ ^= 1;
+    }
+    rmtTxNextStartUs_ = startUs + itemsUs + trailingLowUs;
+
+    if (waitDone) {
+        waitRmtTxSlot();
+        rmtTxNextStartUs_ = 0;
+    }
+    return true;
+}
+
 /**
  * @brief 发送单个原始脉冲（指定时长和电平）
  * @param pin 发送引脚
@@ -438,6 +828,7 @@ bool SubGhzService::applyScanProfile(float dataRateKbps,
                                   bool packetMode)
 {
     if (!isConfigured_) return false;
+    endHopping();                               // 恢复自动校准
     ELECHOUSE_cc1101.setSidle();                // 进入空闲状态
     ELECHOUSE_cc1101.setCCMode(packetMode ? 0 : 1); // 设置CC模式
     ELECHOUSE_cc1101.setModulation(modulation); // 设置调制方式
@@ -461,6 +852,7 @@ bool SubGhzService::applyScanProfile(float dataRateKbps,
  */
 bool SubGhzService::applyDefaultProfile(float mhz) {
     if (!isConfigured_) return false;
+    endHopping();                               // 恢复自动校准
     ELECHOUSE_cc1101.setSidle();                // 进入空闲状态
     ELECHOUSE_cc1101.setPktFormat(0);           // 数据包格式：标准模式
     ELECHOUSE_cc1101.setLengthConfig(1);        // 可变长度
@@ -486,6 +878,7 @@ bool SubGhzService::applyDefaultProfile(float mhz) {
  */
 bool SubGhzService::applySniffProfile(float mhz) {
     if (!isConfigured_) return false;
+    endHopping();                               // 恢复自动校准
     // CC1101配置为"原始/异步"OOK模式
     ELECHOUSE_cc1101.setSidle();
     ELECHOUSE_cc1101.setMHZ(mhz);
@@ -509,6 +902,7 @@ bool SubGhzService::applySniffProfile(float mhz) {
  */
 bool SubGhzService::applyRawSendProfile(float mhz) {
     if (!isConfigured_) return false;
+    endHopping();                               // 恢复自动校准
     ELECHOUSE_cc1101.setSidle();
     ELECHOUSE_cc1101.setMHZ(mhz);
     ELECHOUSE_cc1101.setModulation(2);   // 调制：OOK/ASK
@@ -532,6 +926,7 @@ bool SubGhzService::applyRawSendProfile(float mhz) {
  */
 bool SubGhzService::applyPresetByName(const std::string& name, float mhz) {
     if (!isConfigured_) return false;
+    endHopping();                               // 恢复自动校准
     ELECHOUSE_cc1101.setSidle();
     ELECHOUSE_cc1101.setMHZ(mhz);
 
@@ -614,16 +1009,15 @@ bool SubGhzService::applyPresetByName(const std::string& name, float mhz) {
  * @return 发送成功返回true，失败返回false
  */
 bool SubGhzService::sendTimingsOOK_(const std::vector<int32_t>& timings) {
-    if (!startTxBitBang()) return false;
-    int level = 1; // 初始电平：高
+    // 交替电平转换为带符号时序，初始电平：高
+    std::vector<int32_t> signedTimings;
+    signedTimings.reserve(timings.size());
+    bool high = true;
     for (int32_t us : timings) {
-        gpio_set_level((gpio_num_t)gdo0_, level); // 设置电平
-        if (us > 0) esp_rom_delay_us((uint32_t)us); // 保持时长
-        level ^= 1; // 翻转电平
+        if (us > 0) signedTimings.push_back(high ? us : -us);
+        high = !high; // 翻转电平
     }
-    gpio_set_level((gpio_num_t)gdo0_, 0); // 重置为低电平
-    stopTxBitBang();                      // 停止BitBang模式
-    return true;
+    return sendTimingsRawSigned_(signedTimings);
 }
 
 /**
@@ -726,11 +1120,9 @@ bool SubGhzService::sendBinRaw_(const std::vector<uint8_t>& bytes,
     const int total_bits = int(bytes.size()) * 8;
     const int limit_bits = total_bits; // 发送全部位
 
-    if (!startTxBitBang()) return false;
-
-    // 初始空闲低电平
-    gpio_set_level((gpio_num_t)gdo0_, 0);
-
+    // 按位生成时序，相同电平合并
+    std::vector<int32_t> timings;
+    timings.reserve(total_bits);
     int sent = 0;
 
     // 从最后一个字节开始发送
@@ -740,16 +1132,13 @@ bool SubGhzService::sendBinRaw_(const std::vector<uint8_t>& bytes,
         // 每个字节按LSB到MSB发送
         for (int i = 0; i < 8 && sent < limit_bits; ++i, ++sent) {
             bool one = (b >> i) & 0x01; // LSB优先
-            gpio_set_level((gpio_num_t)gdo0_, one ? 1 : 0);
-            esp_rom_delay_us((uint32_t)te_us);
+            int32_t t = one ? te_us : -te_us;
+            if (!timings.empty() && ((timings.back() > 0) == one)) timings.back() += t;
+            else timings.push_back(t);
         }
     }
 
-    // 发送完成后恢复低电平
-    gpio_set_level((gpio_num_t)gdo0_, 0);
-
-    stopTxBitBang();
-    return true;
+    return sendTimingsRawSigned_(timings);
 }
 
 /**
@@ -767,24 +1156,66 @@ bool SubGhzService::sendRawTimings(const std::vector<int32_t>& timings) {
  * @return 发送成功返回true，失败返回false
  */
 bool SubGhzService::sendTimingsRawSigned_(const std::vector<int32_t>& timings) {
-    if (!startTxBitBang()) return false;
+    if (!startRmtTx(gdo0_)) return false;
 
-    // 初始空闲低电平
-    gpio_set_level((gpio_num_t)gdo0_, 0);
-
-    // 逐时序发送
-    for (int32_t t : timings) {
-        if (t == 0) continue;          // 跳过0时长
-        bool high = (t > 0);           // 正数=高电平
-        uint32_t us = (uint32_t)(high ? t : -t); // 取绝对值
-        gpio_set_level((gpio_num_t)gdo0_, high ? 1 : 0);
-        if (us) esp_rom_delay_us(us);  // 保持电平
-    }
+    // 整帧一次提交，RMT硬件定时
+    bool ok = rmtSendTimings(timings.data(), timings.size(), /*waitDone*/true);
 
     // 恢复空闲低电平
-    gpio_set_level((gpio_num_t)gdo0_, 0);
     stopTxBitBang();
-    return true;
+    return ok;
+}
+
+/**
+ * @brief 开始流式发送RAW时序（文件边读边发，不保存整个时序）
+ * @param cmd 亚GHz指令（使用其频率和预设）
+ * @return 准备成功返回true，失败返回false
+ * @note 之后调用streamRawTimings()分批发送，最后调用endRawStream()
+ */
+bool SubGhzService::beginRawStream(const SubGhzFileCommand& cmd) {
+    if (!isConfigured_) return false;
+
+    float mhz = cmd.frequency_hz ? (cmd.frequency_hz / 1e6f) : mhz_;
+    tune(mhz);
+
+    if (!applyPresetByName(cmd.preset, mhz)) {
+        if (!applyRawSendProfile(mhz)) return false;
+    }
+
+    return startRmtTx(gdo0_); // 空闲低电平
+}
+
+/**
+ * @brief 发送一批带符号的时序
+ * @param timings 时序（正数=高电平，负数=低电平，单位微秒）
+ * @param count 时序数量
+ * @return 发送成功返回true
+ */
+bool SubGhzService::streamRawTimings(const int32_t* timings, size_t count) {
+    if (!timings) return false;
+
+    // 每批在低电平处交接：最后一个低电平之后的时序留到下一批
+    rmtTxCarry_.insert(rmtTxCarry_.end(), timings, timings + count);
+    size_t cut = rmtTxCarry_.size();
+    while (cut > 0 && rmtTxCarry_[cut - 1] > 0) --cut;
+    if (cut == 0) return true;
+
+    // 不等待：本批发送期间继续读取文件
+    bool ok = rmtSendTimings(rmtTxCarry_.data(), cut, /*waitDone*/false);
+    rmtTxCarry_.erase(rmtTxCarry_.begin(), rmtTxCarry_.begin() + cut);
+    return ok;
+}
+
+/**
+ * @brief 结束流式发送（恢复空闲低电平并释放引脚）
+ */
+void SubGhzService::endRawStream() {
+    // 发送剩余时序
+    if (!rmtTxCarry_.empty()) {
+        rmtSendTimings(rmtTxCarry_.data(), rmtTxCarry_.size(), /*waitDone*/true);
+        rmtTxCarry_.clear();
+    }
+    stopTxBitBang(); // 等待最后一批发送完成
 }
 
 /**
@@ -3,19 +3,24 @@
 #include <Arduino.h>
 #include <vector>
 #include <cstdint>
+#include <atomic>
+#include <unordered_map>
 #include "driver/rmt.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
 #include "ELECHOUSE_CC1101_SRC_DRV.h"
 #include "Data/SugGhzFreqs.h"
 #include "Transformers/SubGhzTransformer.h"
 
 #define RMT_RX_CHANNEL RMT_CHANNEL_6
-#define RMT_TX_CHANNEL RMT_CHANNEL_5
+#define RMT_TX_CHANNEL RMT_CHANNEL_3 // TX capable on ESP32 and ESP32-S3, FastLED allocates from channel 0 up
 #define RMT_CLK_DIV 80
 #define RMT_1US_TICKS (80000000 / RMT_CLK_DIV / 1000000)
 #define RMT_1MS_TICKS (RMT_1US_TICKS * 1000)
 #define RMT_BUFFER_SIZE 8192
+#define SUBGHZ_BACKLOG_PSRAM_SIZE (512 * 1024)
+#define SUBGHZ_BACKLOG_INTERNAL_SIZE (32 * 1024)
 
 #define TEMBED_CC1101_SW0 48
 #define TEMBED_CC1101_SW1 47
@@ -30,21 +35,40 @@ public:
     // Base
     void tune(float mhz);
     int measurePeakRssi(uint32_t holdMs);
+    int measurePeakRssiUs(uint32_t holdUs);
     std::vector<std::string> getSupportedBand() const;
     std::vector<float> getSupportedFreq(const std::string& band) const;
     void setScanBand(const std::string& bandName);
 
+    // Fast hopping, FSCAL values cached per frequency
+    size_t calibrateChannels(const std::vector<float>& freqs);
+    bool hopTo(float mhz);
+    void endHopping();
+
     // RMT raw sniffer
     bool startRawSniffer(int pin);
     std::pair<std::string, size_t> readRawPulses();
     std::vector<rmt_item32_t> readRawFrame();
-    bool isSnifferOverflowing() const;
+    const rmt_item32_t* receiveRawItems(size_t& count, uint32_t* timestampUs = nullptr);
+    void returnRawItems(const rmt_item32_t* items);
+    std::string formatRawPulses(const rmt_item32_t* items, size_t count) const;
+    uint32_t getSnifferOverflowCount() const { return overflowCount_.load(); }
+    size_t getSnifferBacklogSize() const { return backlogSize_; }
     void drainSniffer();
     void stopRawSniffer();
 
     // Raw send
     bool startTxBitBang();
     bool stopTxBitBang();
+
+    // RMT transmit, edges are timed by the peripheral
+    // Writes are double buffered, the next batch is packed while the previous one is sent.
+    // The trailing low of a batch is timed by the CPU as idle level, so the hand-over
+    // to the next batch keeps that low at its length (within a few us) when the next
+    // batch is ready in time, it is stretched otherwise
+    bool startRmtTx(int pin);
+    void stopRmtTx();
+    bool rmtSendTimings(const int32_t* timings, size_t count, bool waitDone);
     bool sendRawFrame(int pin,
                       const std::vector<rmt_item32_t>& items,
                       uint32_t tick_per_us = RMT_1US_TICKS);
@@ -58,6 +82,11 @@ public:
     bool sendTimingsRawSigned_(const std::vector<int32_t>& timings);
     bool send(const SubGhzFileCommand& cmd);
 
+    // Streamed RAW send, timings are pushed batch by batch while the file is read
+    bool beginRawStream(const SubGhzFileCommand& cmd);
+    bool streamRawTimings(const int32_t* timings, size_t count);
+    void endRawStream();
+
     // Profiles
     bool applyDefaultProfile(float mhz = 433.92f);
     bool applySniffProfile(float mhz);
@@ -77,6 +106,44 @@ private:
     bool    ccMode_ = false;
     SubGhzScanBand scanBand_ = SubGhzScanBand::Band387_464;
     RingbufHandle_t rb_ = nullptr;
+
+    // Calibration cache, key is the frequency in kHz
+    struct ChannelCalibration {
+        uint8_t freq[4];    // FSCTRL0, FREQ2, FREQ1, FREQ0
+        uint8_t fscal[3];   // FSCAL3, FSCAL2, FSCAL1
+        uint8_t test0;
+    };
+    std::unordered_map<uint32_t, ChannelCalibration> calCache_;
+    bool    hopping_ = false;
+    uint8_t savedMcsm0_ = 0x18;
+    bool calibrateChannel(float mhz, ChannelCalibration& out);
+
+    // RMT TX double buffer
+    bool    rmtTxInstalled_ = false;
+    bool    rmtTxPending_ = false;
+    uint8_t rmtTxActive_ = 0;
+    std::vector<rmt_item32_t> rmtTxItems_[2];
+    int64_t rmtTxNextStartUs_ = 0;      // end of the previous batch trailing low, 0 if none
+    std::vector<int32_t> rmtTxCarry_;   // streamed timings after the last low, sent with the next batch
+    void waitRmtTxSlot();
+
+    // RMT consumer task, moves frames from the RMT ring to the backlog
+    struct BacklogHeader {
+        uint32_t timestampUs;
+    };
+    RingbufHandle_t backlog_ = nullptr;
+    StaticRingbuffer_t backlogStruct_;
+    uint8_t* backlogStorage_ = nullptr;
+    size_t backlogSize_ = 0;
+    std::atomic<TaskHandle_t> consumerHandle_{nullptr};
+    std::atomic<bool> consumerRunning_{false};
+    SemaphoreHandle_t consumerExited_ = nullptr;   // given by the task right before it deletes itself
+    StaticSemaphore_t consumerExitedStruct_;
+    std::atomic<uint32_t> overflowCount_{0};
+    static void consumerTaskThunk(void* arg);
+    void consumerTask();
+    bool startConsumer();
+    void stopConsumer();
     uint8_t rfSw0_ = TEMBED_CC1101_SW0;
     uint8_t rfSw1_ = TEMBED_CC1101_SW1;
     uint8_t rfSel_ = 2; //  uses 0/1/2 as selections
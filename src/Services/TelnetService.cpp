@@ -1,4 +1,6 @@
 #include "TelnetService.h"
+#include <Arduino.h>
+#include <cerrno>
 
 bool TelnetService::connectTo(const std::string& host, uint16_t port, uint32_t recvTimeoutMs) {
   close(); // just in case
@@ -40,23 +42,35 @@ bool TelnetService::connectTo(const std::string& host, uint16_t port, uint32_t r
 
   freeaddrinfo(res);
   _rx.reserve(512);
+  _raw.reserve(SessionIoManager::RX_MAX_POLL);
+  _io.begin(
+      [this](const char* data, size_t len) { return sendAll(_sock, data, len); },
+      [this](char* buf, size_t cap) {
+        int n = ::recv(_sock, buf, cap, MSG_DONTWAIT);
+        if (n > 0) return n;
+        if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return 0;
+        return -1;
+      });
   return true;
 }
 
 void TelnetService::close() {
   if (_sock >= 0) {
+    _io.flush();
     ::shutdown(_sock, SHUT_RDWR);
     ::close(_sock);
     _sock = -1;
   }
   _rx.clear();
+  _raw.clear();
+  _io.reset();
 }
 
 int TelnetService::sendAll(int s, const void* data, size_t len) {
   const uint8_t* p = static_cast<const uint8_t*>(data);
   size_t sentTotal = 0;
   while (sentTotal < len) {
-    size_t n = ::send(s, p + sentTotal, len - sentTotal, 0);
+    int n = ::send(s, p + sentTotal, len - sentTotal, 0);
     if (n <= 0) return -1;
     sentTotal += n;
   }
@@ -67,18 +81,20 @@ bool TelnetService::writeChar(char c) {
   if (_sock < 0) return false;
   if (c == '\n' || c == '\r') {
     static const char crlf[2] = {'\r','\n'};
-    return sendAll(_sock, crlf, 2) == 2;
+    return _io.write(crlf, 2, millis());
   }
-  return sendAll(_sock, &c, 1) == 1;
+  return _io.write(c, millis());
 }
 
 int TelnetService::writeRaw(const char* data, size_t len) {
   if (_sock < 0 || !data || !len) return -1;
+  if (!_io.flush()) return -1; // keep the order of queued keystrokes
   return sendAll(_sock, data, len);
 }
 
 bool TelnetService::writeLine(const std::string& line) {
   if (_sock < 0) return false;
+  if (!_io.flush()) return false;
   static const char crlf[2] = {'\r','\n'};
   return sendAll(_sock, line.c_str(), line.size()) == (int)line.size()
       && sendAll(_sock, crlf, 2) == 2;
@@ -132,19 +148,17 @@ void TelnetService::doTelnetNegotiation(const uint8_t* buf, int len, std::string
 void TelnetService::poll() {
   if (_sock < 0) return;
 
-  uint8_t buf[512];
-  int n = ::recv(_sock, reinterpret_cast<char*>(buf), sizeof(buf), MSG_DONTWAIT);
-  if (n <= 0) return;
+  _io.poll(millis());
 
-  std::string out;
-  out.reserve(static_cast<size_t>(n));
-  doTelnetNegotiation(buf, n, out);
-
-  if (!out.empty()) _rx.append(out);
+  // Everything waiting, negotiated in one pass
+  if (_io.drain(_raw) == 0) return;
+  doTelnetNegotiation(reinterpret_cast<const uint8_t*>(_raw.data()), static_cast<int>(_raw.size()), _rx);
+  _raw.clear();
 }
 
-std::string TelnetService::readOutputNonBlocking() {
-  std::string out;
-  out.swap(_rx);
-  return out;
+size_t TelnetService::readOutputNonBlocking(std::string& out) {
+  const size_t n = _rx.size();
+  out.append(_rx);
+  _rx.clear();
+  return n;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include "Managers/SessionIoManager.h"
 
 extern "C" {
   #include <lwip/sockets.h>
@@ -16,7 +17,7 @@ public:
   void close();
   bool isConnected() const { return _sock >= 0; }
 
-  // Send a character
+  // Queue a character, sent on newline, size or idle
   bool writeChar(char c);
 
   // Send raw data
@@ -25,11 +26,11 @@ public:
   // Send a line
   bool writeLine(const std::string& line);
 
-  // Read the socket
+  // Send idle keystrokes and read the socket
   void poll();
 
-  // Retrieve and clear the text buffer accumulated by poll()
-  std::string readOutputNonBlocking();
+  // Append and clear the text accumulated by poll(), returns its size
+  size_t readOutputNonBlocking(std::string& out);
 
   // Get the last error message if connection failed
   const std::string& lastError() const { return _lastError; }
@@ -57,6 +58,8 @@ private:
 
 private:
   int         _sock      = -1;
+  SessionIoManager _io;
+  std::string _raw;         // received bytes before negotiation, reused
   std::string _rx;
   std::string _lastError;
 };
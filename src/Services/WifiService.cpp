@@ -1,8 +1,10 @@
 #include "WifiService.h"
+#include <algorithm>
 
 // 静态成员变量定义
-std::vector<std::string> WifiService::sniffLog;          // WiFi嗅探日志容器
-portMUX_TYPE WifiService::sniffMux = portMUX_INITIALIZER_UNLOCKED; // 嗅探日志线程锁
+WifiSniffManager WifiService::sniffer;                    // WiFi嗅探帧环形缓冲区
+WifiChannelManager WifiService::channelHopper;            // 信道跳频调度
+std::mutex WifiService::hopMutex;                         // 跳频统计锁
 
 std::vector<std::array<uint8_t, 6>> WifiService::staList; // Deauth攻击时捕获的STA客户端列表
 uint8_t WifiService::apBSSID[6];                          // 目标AP的BSSID
@@ -339,9 +341,11 @@ std::string WifiService::encryptionTypeToString(wifi_auth_mode_t enc) {
 
 /**
  * @brief 启动WiFi被动嗅探（混杂模式）
- * @note 嗅探所有WiFi帧，记录帧类型、RSSI、信道、MAC、SSID等信息
+ * @param pcap 是否保存PCAP（每帧保留更多负载字节）
+ * @return 环形缓冲区分配、取帧任务启动成功返回true
+ * @note 回调只把帧描述和截断负载写入无锁环形缓冲区，由取帧任务消费，格式化在显示时进行
  */
-void WifiService::startPassiveSniffing() {
+bool WifiService::startPassiveSniffing(bool pcap) {
     disconnect(); // 断开当前WiFi连接
 
     // 重置混杂模式配置
@@ -354,6 +358,15 @@ void WifiService::startPassiveSniffing() {
     }
     delay(300); // 等待硬件稳定
 
+    // 回调未注册时分配，生产者不会看到半初始化的缓冲区
+    bool ok = pcap ? sniffer.begin(SNIFF_PCAP_SLOTS, SNIFF_PCAP_SNAP)
+                   : sniffer.begin(SNIFF_SLOTS, SNIFF_SNAP_LEN);
+    if (!ok || !stations_.begin(SNIFF_TABLE_SLOTS)) return false;
+    if (!startSniffDrain()) {
+        sniffer.end();
+        return false;
+    }
+
     // 重新初始化WiFi并启动混杂模式
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     esp_wifi_init(&cfg);
@@ -361,78 +374,497 @@ void WifiService::startPassiveSniffing() {
 
     esp_wifi_set_promiscuous(true); // 启用混杂模式
     esp_wifi_set_promiscuous_rx_cb(&WifiService::snifferCallback); // 设置嗅探回调
+    return true;
 }
 
 /**
  * @brief 停止WiFi被动嗅探
- * @note 关闭混杂模式，清空嗅探日志，恢复为STA模式
+ * @note 关闭混杂模式，结束PCAP写入并释放环形缓冲区，恢复为STA模式
  */
 void WifiService::stopPassiveSniffing() {
+    stopChannelHopper();
     esp_wifi_set_promiscuous(false);
     esp_wifi_set_promiscuous_rx_cb(nullptr);
+    stopSniffDrain();
+    stopPcapStream();
     esp_wifi_stop();
     esp_wifi_deinit();
-    sniffLog.clear(); // 清空嗅探日志
+    sniffer.end(); // 释放环形缓冲区
     WiFi.mode(WIFI_STA);
     WiFi.disconnect(true);
 }
 
 /**
- * @brief WiFi嗅探回调函数（混杂模式下接收所有帧）
+ * @brief WiFi嗅探回调函数（混杂模式下接收所有帧，运行在WiFi驱动上下文）
  * @param buf 帧数据缓冲区
  * @param 帧类型（未使用）
+ * @note 不分配内存、不加锁，缓冲区满时丢弃并计数
  */
 void WifiService::snifferCallback(void* buf, wifi_promiscuous_pkt_type_t) {
     const wifi_promiscuous_pkt_t* pkt = reinterpret_cast<wifi_promiscuous_pkt_t*>(buf);
-    const uint8_t* payload = pkt->payload;
-    int len = pkt->rx_ctrl.sig_len;
+    const uint16_t sigLen = pkt->rx_ctrl.sig_len;
+
+    WifiSniffManager::Frame frame;
+    frame.timestampUs = pkt->rx_ctrl.timestamp;
+    frame.length = sigLen > 4 ? sigLen - 4 : sigLen; // 去掉FCS
+    frame.captured = frame.length;
+    frame.rssi = pkt->rx_ctrl.rssi;       // 信号强度
+    frame.channel = pkt->rx_ctrl.channel; // 信道
+    if (frame.length >= 2) {
+        extractTypeSubtype(pkt->payload, frame.type, frame.subtype);
+    }
+
+    channelHopper.countFrame(frame.channel); // 按信道计数，供跳频调度使用
+    sniffer.push(frame, pkt->payload);
+}
+
+/**
+ * @brief 启动嗅探取帧任务，环形缓冲区只由该任务消费
+ * @return 启动成功返回true
+ * @note 终端打印再慢也不会让环形缓冲区溢出，PCAP和AP/STA表看到每一帧
+ */
+bool WifiService::startSniffDrain() {
+    stopSniffDrain();
+    {
+        std::lock_guard<std::mutex> lock(sniffMutex_);
+        sniffViewCount_ = 0;
+        sniffDrained_ = 0;
+    }
+
+    // 退出信号量，静态分配
+    if (!drainExited_) drainExited_ = xSemaphoreCreateBinaryStatic(&drainExitedStruct_);
+
+    drainRunning_ = true;
+    TaskHandle_t handle = nullptr;
+    BaseType_t created = xTaskCreatePinnedToCore(
+        &WifiService::drainThunk,
+        "wifi_drain",
+        4096,
+        this,
+        tskIDLE_PRIORITY + 3,   // 高于PCAP写入任务，SD卡写入期间继续取帧
+        &handle,
+        xPortGetCoreID() == 0 ? 1 : 0
+    );
+    drainHandle_ = (created == pdPASS) ? handle : nullptr;
+    if (created != pdPASS) {
+        drainRunning_ = false;
+        return false;
+    }
+    return true;
+}
 
-    int8_t rssi = pkt->rx_ctrl.rssi; // 信号强度
-    uint8_t ch = pkt->rx_ctrl.channel; // 信道
+/**
+ * @brief 停止嗅探取帧任务
+ * @note 任务退出前取完环形缓冲区中剩余的帧，之后再调用stopPcapStream()写入文件
+ */
+void WifiService::stopSniffDrain() {
+    TaskHandle_t drain = drainHandle_.load();
+    if (!drain) return;
+
+    // 先通知再清标志，任务此时不会已退出
+    xTaskNotifyGive(drain);
+    drainRunning_ = false;
+    xSemaphoreTake(drainExited_, portMAX_DELAY);
+}
 
-    uint8_t type = 0, subtype = 0;
-    extractTypeSubtype(payload, type, subtype); // 解析帧类型/子类型
-    std::string typeStr = getFrameTypeName(type, subtype); // 转换为可读名称
-    std::string macStr = formatMac(payload + 10); // 格式化MAC地址
+void WifiService::drainThunk(void* arg) {
+    auto* self = static_cast<WifiService*>(arg);
+    self->drainTask();
+    self->drainHandle_ = nullptr;
+    xSemaphoreGive(self->drainExited_);  // 之后不再访问self
+    vTaskDelete(nullptr);
+}
 
-    // 构建嗅探日志行
-    std::string line = "信道:" + std::to_string(ch) +
-                       " 信号强度:" + std::to_string(rssi) +
-                       " 帧类型:" + typeStr;
+/**
+ * @brief 取帧任务：定时取出环形缓冲区中的帧，退出前再取一次
+ */
+void WifiService::drainTask() {
+    while (drainRunning_.load()) {
+        drainSniffFrames();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SNIFF_DRAIN_MS));
+    }
+    drainSniffFrames();
+}
+
+/**
+ * @brief 取出已捕获的帧：更新AP/STA表、写入PCAP缓冲区，并为终端保留前几帧的副本
+ * @note 只处理调用时已有的帧，持有锁的时间有上限
+ */
+void WifiService::drainSniffFrames() {
+    size_t count = sniffer.pending();
+    bool queued = false;
+
+    WifiSniffManager::Frame frame;
+    const uint8_t* payload = nullptr;
+    const uint32_t now = millis();
+    {
+        std::lock_guard<std::mutex> lock(sniffMutex_);
+        while (count > 0 && (payload = sniffer.peek(frame)) != nullptr) {
+            stations_.ingest(payload, frame.captured, frame.rssi, frame.channel, now);
+            if (sniffViewCount_ < SNIFF_VIEW_SLOTS) {
+                SniffView& view = sniffViews_[sniffViewCount_++];
+                view.frame = frame;
+                view.frame.captured = std::min<size_t>(frame.captured, SNIFF_SNAP_LEN);
+                memcpy(view.payload, payload, view.frame.captured);
+            }
+            if (sniffer.pcapActive()) {
+                sniffer.pcapAppend(frame, payload);
+                queued = true;
+            }
+            sniffer.release();
+            sniffDrained_++;
+            count--;
+        }
+    }
+
+    // 有写满的缓冲区时唤醒写入任务
+    TaskHandle_t writer = pcapWriterHandle_.load();
+    if (queued && writer && sniffer.pcapQueued()) {
+        xTaskNotifyGive(writer);
+    }
+}
+
+/**
+ * @brief 取出终端显示用的帧并格式化
+ * @param lines 输出：格式化后的日志行（最多maxLines条）
+ * @param maxLines 本次最多格式化的行数
+ * @return 上次调用以来取帧任务处理的帧数
+ * @note 锁内只复制帧副本，格式化在锁外进行
+ */
+size_t WifiService::takeSniffLines(std::vector<std::string>& lines, size_t maxLines) {
+    std::vector<SniffView> views;
+    size_t drained = 0;
+    {
+        std::lock_guard<std::mutex> lock(sniffMutex_);
+        views.assign(sniffViews_, sniffViews_ + std::min(sniffViewCount_, maxLines));
+        drained = sniffDrained_;
+        sniffViewCount_ = 0;
+        sniffDrained_ = 0;
+    }
+
+    for (const auto& view : views) {
+        lines.push_back(formatSniffFrame(view.frame, view.payload));
+    }
+    return drained;
+}
+
+/**
+ * @brief 获取AP/STA表的副本（按帧数排序）
+ * @param max 最多返回的行数
+ * @param total 输出：表中设备总数
+ * @param evicted 输出：已淘汰的设备数
+ */
+std::vector<WifiStationManager::Station> WifiService::getStationView(size_t max, size_t& total, uint32_t& evicted) {
+    std::lock_guard<std::mutex> lock(sniffMutex_);
+    total = stations_.size();
+    evicted = stations_.evicted();
+
+    std::vector<WifiStationManager::Station> rows;
+    for (const auto* s : stations_.sorted(max)) rows.push_back(*s);
+    return rows;
+}
+
+/**
+ * @brief 将帧描述格式化为日志行
+ * @param frame 帧描述
+ * @param payload 截断后的帧数据
+ * @return 日志行（信道、信号强度、帧类型、SSID、MAC）
+ */
+std::string WifiService::formatSniffFrame(const WifiSniffManager::Frame& frame, const uint8_t* payload) {
+    std::string line = "信道:" + std::to_string(frame.channel) +
+                       " 信号强度:" + std::to_string(frame.rssi) +
+                       " 帧类型:" + getFrameTypeName(frame.type, frame.subtype);
 
     // 提取SSID（仅管理帧的Probe Req/Beacon帧包含SSID）
-    if (type == 0 && (subtype == 8 || subtype == 4)) {
-        std::string ssid = parseSsidFromPacket(payload, len, type, subtype);
+    if (frame.type == 0 && (frame.subtype == 8 || frame.subtype == 4)) {
+        std::string ssid = parseSsidFromPacket(payload, frame.captured, frame.type, frame.subtype);
         if (!ssid.empty()) {
             line += " SSID:\"" + ssid + "\"";
         }
     }
 
-    line += " MAC:" + macStr;
+    // 发送方地址（addr2）
+    if (frame.captured >= 16) {
+        line += " MAC:" + formatMac(payload + 10);
+    }
+    return line;
+}
+
+/**
+ * @brief 获取嗅探统计（接收、丢弃、PCAP写入）
+ */
+WifiSniffStats WifiService::getSniffStats() const {
+    WifiSniffStats stats;
+    stats.received = sniffer.received();
+    stats.dropped = sniffer.dropped();
+    stats.pcapFrames = sniffer.pcapFrames();
+    stats.pcapDropped = sniffer.pcapDropped();
+    stats.pcapBytes = sniffer.pcapBytes();
+    stats.writeErrors = pcapWriteErrors_.load();
+    return stats;
+}
+
+/**
+ * @brief 开始将嗅探帧写入PCAP文件（双缓冲，写入任务运行在另一核心）
+ * @param file 已打开的可写文件
+ * @return 启动成功返回true
+ */
+bool WifiService::startPcapStream(File file) {
+    stopPcapStream();
+    if (!file) return false;
+
+    pcapFile_ = file;
+    pcapWriteErrors_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(sniffMutex_);  // 取帧任务可能正在运行
+        sniffer.pcapBegin(SNIFF_PCAP_BUFFER);
+    }
+
+    // 退出信号量，静态分配
+    if (!pcapWriterExited_) pcapWriterExited_ = xSemaphoreCreateBinaryStatic(&pcapWriterExitedStruct_);
+
+    pcapRunning_ = true;
+    const BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+    TaskHandle_t handle = nullptr;
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        &WifiService::pcapWriterThunk,
+        "wifi_pcap",
+        4096,
+        this,
+        tskIDLE_PRIORITY + 2,
+        &handle,
+        core
+    );
+    pcapWriterHandle_ = (ok == pdPASS) ? handle : nullptr;
+    if (ok != pdPASS) {
+        pcapRunning_ = false;
+        {
+            std::lock_guard<std::mutex> lock(sniffMutex_);
+            sniffer.pcapEnd();
+        }
+        pcapFile_.close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 停止PCAP写入：等待写入任务退出，写入剩余缓冲区并关闭文件
+ * @note 先调用stopSniffDrain()，环形缓冲区中剩余的帧才会写入文件
+ */
+void WifiService::stopPcapStream() {
+    TaskHandle_t writer = pcapWriterHandle_.load();
+    if (writer) {
+        // 先通知再清标志，任务此时不会已退出
+        xTaskNotifyGive(writer);
+        pcapRunning_ = false;
+        // SD卡写入可能较慢，等任务退出前的信号，之后才能关闭文件和释放缓冲区
+        xSemaphoreTake(pcapWriterExited_, portMAX_DELAY);
+    }
+
+    // 取帧任务仍在运行时不能同时追加
+    std::lock_guard<std::mutex> lock(sniffMutex_);
+    if (!sniffer.pcapActive()) return;
+
+    // 写入队列中的缓冲区，再写入正在填充的缓冲区
+    writePcapQueued();
+    if (sniffer.pcapFlush()) writePcapQueued();
+
+    pcapFile_.flush();
+    pcapFile_.close();
+    sniffer.pcapEnd();
+}
+
+void WifiService::pcapWriterThunk(void* arg) {
+    auto* self = static_cast<WifiService*>(arg);
+    self->pcapWriterTask();
+    self->pcapWriterHandle_ = nullptr;
+    xSemaphoreGive(self->pcapWriterExited_);  // 之后不再访问self
+    vTaskDelete(nullptr);
+}
+
+/**
+ * @brief PCAP写入任务：缓冲区写满后写入SD卡，期间另一缓冲区继续接收帧
+ */
+void WifiService::pcapWriterTask() {
+    while (pcapRunning_.load()) {
+        if (sniffer.pcapQueued()) {
+            writePcapQueued();
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+        }
+    }
+}
+
+void WifiService::writePcapQueued() {
+    const std::vector<uint8_t>* buf = sniffer.pcapQueued();
+    if (!buf) return;
 
-    // 线程安全添加日志（最多存储200条）
-    portENTER_CRITICAL(&sniffMux);
-    if (sniffLog.size() < 200) sniffLog.push_back(line);
-    portEXIT_CRITICAL(&sniffMux);
+    size_t written = pcapFile_.write(buf->data(), buf->size());
+    if (written != buf->size()) pcapWriteErrors_++;
+    sniffer.pcapWritten();
 }
 
 /**
- * @brief 获取并清空嗅探日志（线程安全）
- * @return 当前所有嗅探日志行
+ * @brief 启动信道跳频任务
+ * @param channels 跳频信道集合（固定信道模式仅使用第一个）
+ * @param mode 固定驻留 / 按流量自适应 / 固定信道
+ * @return 启动成功返回true
  */
-std::vector<std::string> WifiService::getSniffLog() {
-    std::vector<std::string> copy;
+bool WifiService::startChannelHopper(const std::vector<uint8_t>& channels, WifiChannelManager::Mode mode) {
+    stopChannelHopper();
+
+    // 信道14仅日本可用，临时切换国家码（1-14），停止跳频时恢复
+    bool needs14 = false;
+    for (uint8_t ch : channels) needs14 |= ch == 14;
+    if (needs14 && !useChannel14Country()) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(hopMutex);
+        if (!channelHopper.begin(channels, mode, millis())) {
+            restoreCountry();
+            return false;
+        }
+    }
 
-    portENTER_CRITICAL(&sniffMux);
-    copy.swap(sniffLog); // 高效交换并清空原日志
-    portEXIT_CRITICAL(&sniffMux);
+    // 退出信号量，静态分配
+    if (!hopperExited_) hopperExited_ = xSemaphoreCreateBinaryStatic(&hopperExitedStruct_);
+
+    hopperRunning_ = true;
+    TaskHandle_t handle = nullptr;
+    BaseType_t created = xTaskCreatePinnedToCore(
+        &WifiService::hopperThunk,
+        "wifi_hop",
+        3072,
+        this,
+        configMAX_PRIORITIES - 3,
+        &handle,
+        xPortGetCoreID() == 0 ? 1 : 0
+    );
+    hopperHandle_ = (created == pdPASS) ? handle : nullptr;
+    if (created != pdPASS) {
+        hopperRunning_ = false;
+        restoreCountry();
+        return false;
+    }
+    return true;
+}
 
-    return copy;
+/**
+ * @brief 停止信道跳频任务
+ * @note 等任务退出后才返回，之后才能关闭WiFi或手动切换信道
+ */
+void WifiService::stopChannelHopper() {
+    TaskHandle_t hopper = hopperHandle_.load();
+    if (hopper) {
+        // 先通知再清标志，任务此时不会已退出
+        xTaskNotifyGive(hopper);
+        hopperRunning_ = false;
+        xSemaphoreTake(hopperExited_, portMAX_DELAY);
+    }
+    restoreCountry();
+}
+
+/**
+ * @brief 切换到允许信道1-14的国家码（JP），原国家码保存以便恢复
+ * @return 设置成功返回true，失败时不能使用信道14
+ */
+bool WifiService::useChannel14Country() {
+    if (countryChanged_) return true;
+    if (esp_wifi_get_country(&savedCountry_) != ESP_OK) return false;
+
+    wifi_country_t jp = savedCountry_;
+    memcpy(jp.cc, "JP", 3);
+    jp.schan = 1;
+    jp.nchan = 14;
+    jp.policy = WIFI_COUNTRY_POLICY_MANUAL;
+    if (esp_wifi_set_country(&jp) != ESP_OK) return false;
+    countryChanged_ = true;
+    return true;
+}
+
+/**
+ * @brief 恢复跳频前的国家码
+ */
+void WifiService::restoreCountry() {
+    if (!countryChanged_) return;
+    esp_wifi_set_country(&savedCountry_);
+    countryChanged_ = false;
+}
+
+/**
+ * @brief 获取各信道统计（帧数、驻留时间、帧率）
+ * @param elapsedMs 输出：跳频开始至今的时间
+ */
+std::vector<WifiChannelManager::ChannelStats> WifiService::getChannelStats(uint32_t& elapsedMs) {
+    std::lock_guard<std::mutex> lock(hopMutex);
+    elapsedMs = channelHopper.elapsedMs(millis());
+    return channelHopper.stats();
+}
+
+void WifiService::hopperThunk(void* arg) {
+    auto* self = static_cast<WifiService*>(arg);
+    self->hopperTask();
+    self->hopperHandle_ = nullptr;
+    xSemaphoreGive(self->hopperExited_);  // 之后不再访问self
+    vTaskDelete(nullptr);
+}
+
+/**
+ * @brief 跳频任务：在当前信道驻留调度给出的时间后切换到下一个信道
+ */
+void WifiService::hopperTask() {
+    uint32_t dwell = 0;
+    uint8_t channel = tuneHopperChannel(dwell);
+
+    while (hopperRunning_.load()) {
+        // 停止时会被提前唤醒
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(dwell));
+        if (!hopperRunning_.load()) break;
+
+        // 上次没有切换成功的信道不计入统计，直接重试
+        if (channel) {
+            uint8_t next = 0;
+            {
+                std::lock_guard<std::mutex> lock(hopMutex);
+                dwell = channelHopper.advance(millis());
+                next = channelHopper.current();
+            }
+            if (next == channel) continue;
+        }
+        channel = tuneHopperChannel(dwell);
+    }
+}
+
+/**
+ * @brief 切换到调度的当前信道，失败的信道跳过且不计入统计
+ * @param dwell 输出：切换到的信道的驻留时间
+ * @return 切换到的信道，集合中所有信道都失败时返回0
+ */
+uint8_t WifiService::tuneHopperChannel(uint32_t& dwell) {
+    size_t tries = 0;
+    {
+        std::lock_guard<std::mutex> lock(hopMutex);
+        tries = channelHopper.stats().size();
+    }
+    for (size_t i = 0; i < tries; ++i) {
+        uint8_t channel = 0;
+        {
+            std::lock_guard<std::mutex> lock(hopMutex);
+            channel = channelHopper.current();
+            dwell = channelHopper.dwellMs();
+        }
+        if (switchChannel(channel)) return channel;
+
+        std::lock_guard<std::mutex> lock(hopMutex);
+        channelHopper.skip(millis());
+    }
+    return 0;
 }
 
 /**
  * @brief 切换WiFi嗅探信道
- * @param channel 目标信道（1-13）
+ * @param channel 目标信道（1-13，国家码为JP时1-14）
  * @return 切换成功返回true，失败返回false
  */
 bool WifiService::switchChannel(uint8_t channel) {
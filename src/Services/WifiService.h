@@ -4,6 +4,13 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <FS.h>
+#include "freertos/semphr.h"
+#include "Managers/WifiSniffManager.h"
+#include "Managers/WifiChannelManager.h"
+#include "Managers/WifiStationManager.h"
 
 extern "C" {
   #include "esp_wifi.h"
@@ -29,6 +36,15 @@ struct SniffedPacket {
     uint8_t type;
 };
 
+struct WifiSniffStats {
+    uint32_t received = 0;      // frames seen by the callback
+    uint32_t dropped = 0;       // ring full
+    uint32_t pcapFrames = 0;
+    uint32_t pcapDropped = 0;   // both PCAP buffers busy
+    uint64_t pcapBytes = 0;
+    uint32_t writeErrors = 0;   // short writes to the card
+};
+
 class WifiService {
 public:
 
@@ -83,9 +99,33 @@ public:
     std::string encryptionTypeToString(wifi_auth_mode_t encryption);
 
     // Sniffing passif
-    void startPassiveSniffing();
+    static constexpr size_t SNIFF_SLOTS        = 128;
+    static constexpr size_t SNIFF_SNAP_LEN     = 96;    // enough for the SSID of a beacon
+    static constexpr size_t SNIFF_PCAP_SLOTS   = 96;
+    static constexpr size_t SNIFF_PCAP_SNAP    = 256;
+    static constexpr size_t SNIFF_PCAP_BUFFER  = 8 * 1024;
+    static constexpr size_t SNIFF_TABLE_SLOTS  = 256;   // 192 access points / stations
+    bool startPassiveSniffing(bool pcap = false);
     void stopPassiveSniffing();
-    std::vector<std::string> getSniffLog();
+
+    static constexpr size_t SNIFF_VIEW_SLOTS   = 16;    // frames kept for the terminal between two pulls
+    static constexpr uint32_t SNIFF_DRAIN_MS   = 5;
+
+    // The drain task empties the ring into the station table and PCAP stream, the UI only formats copies
+    size_t takeSniffLines(std::vector<std::string>& lines, size_t maxLines);
+    std::vector<WifiStationManager::Station> getStationView(size_t max, size_t& total, uint32_t& evicted);
+    void stopSniffDrain();
+    static std::string formatSniffFrame(const WifiSniffManager::Frame& frame, const uint8_t* payload);
+    WifiSniffStats getSniffStats() const;
+
+    // PCAP stream written by a task, the file is closed by stopPcapStream()
+    bool startPcapStream(File file);
+    void stopPcapStream();
+
+    // Channel hopping task, frames are counted per channel by the sniffer callback
+    bool startChannelHopper(const std::vector<uint8_t>& channels, WifiChannelManager::Mode mode);
+    void stopChannelHopper();
+    std::vector<WifiChannelManager::ChannelStats> getChannelStats(uint32_t& elapsedMs);
     bool switchChannel(uint8_t channel);
     static std::string getFrameTypeSubtype(const uint8_t* payload, uint8_t& type, uint8_t& subtype);
     static std::string parseSsidFromPacket(const uint8_t* payload, int len, uint8_t type, uint8_t subtype);
@@ -98,8 +138,9 @@ public:
 
     bool connected;
     static void snifferCallback(void* buf, wifi_promiscuous_pkt_type_t type);
-    static std::vector<std::string> sniffLog;
-    static portMUX_TYPE sniffMux;
+    static WifiSniffManager sniffer;
+    static WifiChannelManager channelHopper;
+    static std::mutex hopMutex;
 
     // --- Client sniffer ---
     static portMUX_TYPE staMux;
@@ -132,4 +173,51 @@ public:
             default:                     return "?";
         }
     }
+
+private:
+    WifiStationManager stations_;
+
+    // Sniff drain task, the only consumer of the ring
+    struct SniffView {
+        WifiSniffManager::Frame frame;
+        uint8_t payload[SNIFF_SNAP_LEN];
+    };
+    std::mutex sniffMutex_;                          // station table, views and PCAP begin / end
+    SniffView sniffViews_[SNIFF_VIEW_SLOTS];
+    size_t sniffViewCount_ = 0;
+    uint32_t sniffDrained_ = 0;                      // frames since the last takeSniffLines()
+    std::atomic<TaskHandle_t> drainHandle_{nullptr};
+    std::atomic<bool> drainRunning_{false};
+    SemaphoreHandle_t drainExited_ = nullptr;        // given by the task right before it deletes itself
+    StaticSemaphore_t drainExitedStruct_;
+    static void drainThunk(void* arg);
+    void drainTask();
+    void drainSniffFrames();
+    bool startSniffDrain();
+
+    // PCAP writer task
+    File pcapFile_;
+    std::atomic<TaskHandle_t> pcapWriterHandle_{nullptr};
+    std::atomic<bool> pcapRunning_{false};
+    SemaphoreHandle_t pcapWriterExited_ = nullptr;   // given by the task right before it deletes itself
+    StaticSemaphore_t pcapWriterExitedStruct_;
+    std::atomic<uint32_t> pcapWriteErrors_{0};
+    static void pcapWriterThunk(void* arg);
+    void pcapWriterTask();
+    void writePcapQueued();
+
+    // Channel hopper task
+    std::atomic<TaskHandle_t> hopperHandle_{nullptr};
+    std::atomic<bool> hopperRunning_{false};
+    SemaphoreHandle_t hopperExited_ = nullptr;      // given by the task right before it deletes itself
+    StaticSemaphore_t hopperExitedStruct_;
+    static void hopperThunk(void* arg);
+    void hopperTask();
+    uint8_t tuneHopperChannel(uint32_t& dwell);
+    bool useChannel14Country();
+    void restoreCountry();
+
+    // Country in effect before a hop set with channel 14, restored by stopChannelHopper()
+    wifi_country_t savedCountry_ = {};
+    bool countryChanged_ = false;
 };
\ No newline at end of file
@@ -26,7 +26,7 @@ void ModbusShell::run(const std::string& host, uint16_t port) {
         return;
     }
 
-    modbusService.begin(reqTimeoutMs, idleTimeoutMs, 4);
+    modbusService.begin(reqTimeoutMs, idleTimeoutMs, PIPELINE_DEPTH);
     terminalView.println("");
 
     bool start = true;
@@ -41,10 +41,11 @@ void ModbusShell::run(const std::string& host, uint16_t port) {
             case 3: cmdReadCoils();           break;
             case 4: cmdWriteCoils();          break;
             case 5: cmdReadDiscreteInputs();  break;
-            case 6: cmdMonitorHolding();      break;
-            case 7: cmdSetUnit();             break;
-            case 8: cmdConnect();             break;
-            case 9: terminalView.println("Modbus 命令行已关闭。\n"); start = false; //汉化
+            case 6: cmdMonitor();             break;
+            case 7: cmdDiscover();            break;
+            case 8: cmdSetUnit();             break;
+            case 9: cmdConnect();             break;
+            case 10: terminalView.println("Modbus 命令行已关闭。\n"); start = false; //汉化
         }
     }
     modbusService.clearCallbacks();
@@ -65,8 +66,9 @@ void ModbusShell::cmdConnect() {
     }
     hostShown = h;
     portShown = p;
+    mapKnown = false;
 
-    modbusService.begin(reqTimeoutMs, idleTimeoutMs, 4);
+    modbusService.begin(reqTimeoutMs, idleTimeoutMs, PIPELINE_DEPTH);
 
     terminalView.println(" ✅ 成功。\n"); //汉化
 }
@@ -148,42 +150,170 @@ void ModbusShell::cmdWriteHolding() {
     }
 }
 
-void ModbusShell::cmdMonitorHolding() {
-    uint16_t addr = userInputManager.readValidatedUint32("起始地址", 0); //汉化
-    uint16_t qty = userInputManager.readValidatedUint32("数量", 8); //汉化
-    uint32_t period = userInputManager.readValidatedUint32("周期 (毫秒)", 500); //汉化
+void ModbusShell::cmdMonitor() {
+    terminalView.println("监视列表：h=保持 i=输入 c=线圈 d=离散，如 h0-7,h100,i0-3,c0-15"); //汉化
+    terminalView.print("监视列表 [" + monitorSpec + "]："); //汉化
+    std::string spec = userInputManager.getLine();
+    if (spec.empty()) spec = monitorSpec;
 
-    terminalView.println("正在监视... 按 [回车] 停止。\n"); //汉化
-
-    std::vector<uint16_t> last;
-    bool stop = false;
-    while (true) {
-        char c = terminalInput.readChar();
-        if (c == '\r' || c == '\n') { terminalView.println("已停止。\n"); break; } //汉化
-
-        clearReply();
-        modbusService.readHolding(unitId, addr, qty);
+    std::vector<ModbusScanManager::Watch> watched;
+    if (!ModbusScanManager::parseWatch(spec, watched)) {
+        terminalView.println("监视列表无效（最多 512 个地址）。\n"); //汉化
+        return;
+    }
+    monitorSpec = spec;
+    monitorPeriod = userInputManager.readValidatedUint32("周期 (毫秒)", monitorPeriod); //汉化
+    monitorGap = userInputManager.readValidatedUint32("合并间隙 (地址)", monitorGap); //汉化
+
+    // 相邻地址合并为一次读取，有映射时只在映射内跨越间隙 //汉化
+    ModbusScanManager::Monitor monitor;
+    monitor.begin(watched, monitorGap, mapKnown ? mapped : nullptr);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%u 个地址，每轮 %u 个请求%s。按 [回车] 停止。\n", //汉化
+             (unsigned)monitor.watched(), (unsigned)monitor.reads().size(),
+             mapKnown ? "（使用扫描映射）" : ""); //汉化
+    terminalView.println(msg);
+
+    std::vector<bool> reported;
+    std::vector<ModbusScanManager::Change> changes;
+    const uint32_t t0 = millis();
+    bool running = true;
+    while (running) {
+        const uint32_t pollStart = millis();
+        std::vector<size_t> refused;
+        reported.resize(monitor.reads().size(), false);
+
+        // 一轮内所有读取流水线发出 //汉化
+        size_t nextRead = 0;
+        changes.clear();
+        running = pipeline(PIPELINE_DEPTH,
+            [&](ModbusScanManager::Read& read, uint32_t& tag) {
+                if (nextRead >= monitor.reads().size()) return false;
+                tag = nextRead;
+                read = monitor.reads()[nextRead++];
+                return true;
+            },
+            [&](uint32_t tag, const ModbusService::Reply* reply) {
+                const auto& read = monitor.reads()[tag];
+                const auto outcome = reply ? outcomeOf(*reply) : ModbusScanManager::Outcome::NoReply;
+                if (outcome == ModbusScanManager::Outcome::Ok) {
+                    monitor.onValues(tag, valuesOf(*reply, read), changes);
+                    reported[tag] = false;
+                    return;
+                }
+                if (outcome == ModbusScanManager::Outcome::BadAddress) refused.push_back(tag);
+                if (reported[tag]) return;
+                reported[tag] = true;
+
+                // 每个读取的错误只显示一次，直到恢复 //汉化
+                char line[128];
+                snprintf(line, sizeof(line), "%c%u-%u：%s", ModbusScanManager::tableLetter(read.table),
+                         (unsigned)read.addr, (unsigned)(read.addr + read.qty - 1),
+                         reply ? reply->error.c_str() : "超时"); //汉化
+                terminalView.println(line);
+            });
+
+        // 显示变化 //汉化
+        for (const auto& c : changes) {
+            char line[128];
+            if (c.first) {
+                snprintf(line, sizeof(line), "[%6lu ms] %c%u = 0x%04X (%u)", (unsigned long)(millis() - t0),
+                         ModbusScanManager::tableLetter(c.table), (unsigned)c.addr, c.after, c.after);
+            } else {
+                snprintf(line, sizeof(line), "[%6lu ms] %c%u: 0x%04X -> 0x%04X (%u -> %u)", (unsigned long)(millis() - t0),
+                         ModbusScanManager::tableLetter(c.table), (unsigned)c.addr, c.before, c.after, c.before, c.after);
+            }
+            terminalView.println(line);
+        }
 
-        // 等待响应并处理用户输入 //汉化
-        const uint32_t t0 = millis();
-        while ((millis() - t0) < reqTimeoutMs) {
-            if (_reply.ready) break;
+        // 跨越间隙的读取被拒绝时，改为只读监视的地址段 //汉化
+        std::sort(refused.rbegin(), refused.rend());
+        for (size_t r : refused) {
+            if (monitor.split(r)) reported.assign(monitor.reads().size(), false);
+        }
 
-            // 按回车停止 //汉化
+        // 等待下一周期 //汉化
+        while (running && (millis() - pollStart) < monitorPeriod) {
             char k = terminalInput.readChar();
-            if (k == '\r' || k == '\n') { 
-                stop = true; 
-                break; 
-            }
-            delay(5);
+            if (k == '\r' || k == '\n') running = false;
+            else delay(5);
         }
+    }
+    terminalView.println("已停止。\n"); //汉化
+}
 
-        if (_reply.ok && _reply.regs != last) {
-            printRegs(_reply.regs, addr);
-            terminalView.println("");
-            last = _reply.regs;
+void ModbusShell::cmdDiscover() {
+    const uint16_t first = std::min<uint32_t>(userInputManager.readValidatedUint32("起始地址", 0), 0xFFFF); //汉化
+    const uint16_t last  = std::min<uint32_t>(userInputManager.readValidatedUint32("结束地址", 999), 0xFFFF); //汉化
+    if (last < first) { terminalView.println("地址范围无效。\n"); return; } //汉化
+
+    terminalView.print("表 (h i c d) [hicd]："); //汉化
+    std::string tables = userInputManager.getLine();
+    if (tables.empty()) tables = "hicd";
+    uint8_t mask = 0;
+    for (char c : tables) {
+        switch (c | 0x20) {
+            case 'c': mask |= 1u << (uint8_t)ModbusScanManager::Table::Coils;    break;
+            case 'd': mask |= 1u << (uint8_t)ModbusScanManager::Table::Discrete; break;
+            case 'h': mask |= 1u << (uint8_t)ModbusScanManager::Table::Holding;  break;
+            case 'i': mask |= 1u << (uint8_t)ModbusScanManager::Table::Input;    break;
         }
     }
+    if (!mask) { terminalView.println("未选择任何表。\n"); return; } //汉化
+
+    const uint32_t window = userInputManager.readValidatedUint32("并发请求数 (1-8)", 4); //汉化
+    const size_t depth = std::max<uint32_t>(1, std::min<uint32_t>(window, PIPELINE_DEPTH));
+
+    terminalView.println("正在扫描... 按 [回车] 取消。\n"); //汉化
+    scanManager.beginDiscovery(mask, first, last);
+
+    const uint32_t t0 = millis();
+    uint32_t shown = 0;
+    const bool finished = pipeline(depth,
+        [&](ModbusScanManager::Read& read, uint32_t& tag) {
+            return scanManager.nextProbe(read, tag);
+        },
+        [&](uint32_t tag, const ModbusService::Reply* reply) {
+            scanManager.onProbe(tag, reply ? outcomeOf(*reply) : ModbusScanManager::Outcome::NoReply);
+
+            // 进度 //汉化
+            if (scanManager.probes() >= shown + 64) {
+                shown = scanManager.probes();
+                terminalView.println("  已发送 " + std::to_string(shown) + " 个请求..."); //汉化
+            }
+        });
+
+    const uint32_t elapsed = millis() - t0;
+    terminalView.println(finished ? "扫描完成：" : "扫描已取消，部分结果：");  //汉化
+
+    for (size_t t = 0; t < ModbusScanManager::TABLES; ++t) {
+        if (!(mask & (1u << t))) continue;
+        const auto table = static_cast<ModbusScanManager::Table>(t);
+        const char letter = ModbusScanManager::tableLetter(table);
+        std::string line = std::string("  ") + ModbusScanManager::tableName(table) + "：";
+
+        if (!scanManager.supported(table)) {
+            terminalView.println(line + "不支持"); //汉化
+            mapped[t].clear();
+            continue;
+        }
+        mapped[t] = scanManager.ranges(table);
+        uint32_t count = 0;
+        for (const auto& r : mapped[t]) count += r.count();
+        terminalView.println(line + std::to_string(count) + " 个地址  " + //汉化
+                             (mapped[t].empty() ? std::string("-") : formatRanges(mapped[t], letter)));
+
+        const auto silent = scanManager.silent(table);
+        if (!silent.empty()) terminalView.println("    无响应：" + formatRanges(silent, letter)); //汉化
+    }
+    mapKnown = finished;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "\n%u 个请求，%u 个无响应，%lu ms，并发 %u。\n", //汉化
+             (unsigned)scanManager.probes(), (unsigned)scanManager.noReply(),
+             (unsigned long)elapsed, (unsigned)depth);
+    terminalView.println(msg);
 }
 
 void ModbusShell::cmdReadInputRegisters() {
@@ -238,6 +368,9 @@ void ModbusShell::cmdReadCoils() {
         }
         return;
     }
+
+    printCoils(_reply.coilBytes, addr, qty);
+    terminalView.println("");
 }
 
 void ModbusShell::cmdWriteCoils() {
@@ -298,15 +431,116 @@ void ModbusShell::cmdReadDiscreteInputs() {
 
 void ModbusShell::installModbusCallbacks() {
   modbusService.setOnReply([this](const ModbusService::Reply& r, uint32_t token){
+    // 流水线请求的响应排队，由 pipeline() 取出 //汉化
+    if (token & ModbusService::TOKEN_CALLER) {
+      std::lock_guard<std::mutex> lock(pipelineMutex);
+      pipelineReplies.emplace_back(token, r);
+      return;
+    }
     _reply.fc       = r.fc;
     _reply.ok       = r.ok;
     _reply.exception= r.exception;
+    _reply.err      = r.err;
+    _reply.byteCount= r.byteCount;
     _reply.error    = r.error;
     _reply.regs     = r.regs;
+    _reply.coilBytes= r.coilBytes;
+    _reply.raw      = r.raw;
     _reply.ready    = true;
   });
 }
 
+bool ModbusShell::pipeline(size_t window, const PipelineNext& next, const PipelineDone& done) {
+    struct Pending { uint32_t token; uint32_t tag; uint32_t sentAt; };
+    std::vector<Pending> pending;
+    std::deque<std::pair<uint32_t, ModbusService::Reply>> replies;
+
+    // 取消后迟到的响应在这里丢弃 //汉化
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        pipelineReplies.clear();
+    }
+
+    while (true) {
+        // 补满窗口 //汉化
+        ModbusScanManager::Read read;
+        uint32_t tag = 0;
+        while (pending.size() < window && next(read, tag)) {
+            const uint32_t token = ModbusService::TOKEN_CALLER | (++pipelineSeq & ~ModbusService::TOKEN_CALLER);
+            Error e = modbusService.readRequest(token, unitId, ModbusScanManager::functionCode(read.table),
+                                                read.addr, read.qty);
+            if (e != SUCCESS) { done(tag, nullptr); continue; }
+            pending.push_back(Pending{token, tag, millis()});
+        }
+        if (pending.empty()) return true;
+
+        char k = terminalInput.readChar();
+        if (k == '\r' || k == '\n') return false;
+
+        {
+            std::lock_guard<std::mutex> lock(pipelineMutex);
+            replies.swap(pipelineReplies);
+        }
+        for (const auto& r : replies) {
+            auto it = std::find_if(pending.begin(), pending.end(),
+                                   [&](const Pending& p) { return p.token == r.first; });
+            if (it == pending.end()) continue;
+            const uint32_t doneTag = it->tag;
+            pending.erase(it);
+            done(doneTag, &r.second);
+        }
+
+        // 客户端自身会超时，这里防止回调丢失 //汉化
+        const uint32_t now = millis();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (now - it->sentAt > reqTimeoutMs + 1000) {
+                const uint32_t lostTag = it->tag;
+                it = pending.erase(it);
+                done(lostTag, nullptr);
+            } else {
+                ++it;
+            }
+        }
+
+        if (replies.empty()) delay(1);
+        replies.clear();
+    }
+}
+
+ModbusScanManager::Outcome ModbusShell::outcomeOf(const ModbusService::Reply& reply) {
+    if (reply.ok) return ModbusScanManager::Outcome::Ok;
+    switch (reply.err) {
+        case ILLEGAL_FUNCTION:     return ModbusScanManager::Outcome::Unsupported;
+        case ILLEGAL_DATA_ADDRESS:
+        case ILLEGAL_DATA_VALUE:   return ModbusScanManager::Outcome::BadAddress;
+        default:                   return ModbusScanManager::Outcome::NoReply;
+    }
+}
+
+std::vector<uint16_t> ModbusShell::valuesOf(const ModbusService::Reply& reply, const ModbusScanManager::Read& read) {
+    if (read.table == ModbusScanManager::Table::Holding || read.table == ModbusScanManager::Table::Input) {
+        return reply.regs;
+    }
+
+    // 线圈按 LSB 优先解包，每位一个值 //汉化
+    std::vector<uint16_t> bits;
+    bits.reserve(read.qty);
+    for (uint16_t i = 0; i < read.qty && (i >> 3) < reply.coilBytes.size(); ++i) {
+        bits.push_back((reply.coilBytes[i >> 3] >> (i & 0x07)) & 0x01);
+    }
+    return bits;
+}
+
+std::string ModbusShell::formatRanges(const std::vector<ModbusScanManager::Range>& ranges, char letter) {
+    std::string out;
+    for (const auto& r : ranges) {
+        if (!out.empty()) out += ",";
+        out += letter + std::to_string(r.first);
+        if (r.last != r.first) out += "-" + std::to_string(r.last);
+    }
+    return out;
+}
+
 bool ModbusShell::waitReply(uint32_t timeoutMs) {
     const uint32_t deadline = millis() + timeoutMs;
     while (millis() < deadline) {
@@ -3,7 +3,11 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include "Services/ModbusService.h"
+#include "Managers/ModbusScanManager.h"
 #include "Interfaces/ITerminalView.h"
 #include "Interfaces/IInput.h"
 #include "Transformers/ArgTransformer.h"
@@ -32,7 +36,8 @@ private:
     void cmdReadCoils();              // FC01
     void cmdWriteCoils();             // FC05 / FC0F
     void cmdReadDiscreteInputs();     // FC02
-    void cmdMonitorHolding();         // FC03 轮询
+    void cmdMonitor();                // FC01-FC04 批量轮询，仅显示变化
+    void cmdDiscover();               // 寄存器映射扫描
 
     // 辅助函数
     void printHeader();
@@ -42,6 +47,14 @@ private:
     bool waitReply(uint32_t timeoutMs);
     void installModbusCallbacks();
 
+    // 流水线读取：window 个请求同时在途，reply 为 nullptr 表示超时或发送失败
+    using PipelineNext = std::function<bool(ModbusScanManager::Read& read, uint32_t& tag)>;
+    using PipelineDone = std::function<void(uint32_t tag, const ModbusService::Reply* reply)>;
+    bool pipeline(size_t window, const PipelineNext& next, const PipelineDone& done);
+    static ModbusScanManager::Outcome outcomeOf(const ModbusService::Reply& reply);
+    static std::vector<uint16_t> valuesOf(const ModbusService::Reply& reply, const ModbusScanManager::Read& read);
+    std::string formatRanges(const std::vector<ModbusScanManager::Range>& ranges, char letter);
+
     ModbusService&     modbusService;
     ITerminalView&     terminalView;
     IInput&            terminalInput;
@@ -55,9 +68,23 @@ private:
     uint32_t    reqTimeoutMs  = 6000;
     uint32_t    idleTimeoutMs = 60000;
     uint32_t    monitorPeriod = 500;
-    
+    uint16_t    monitorGap    = 8;
+    std::string monitorSpec   = "h0-7";
+
+    static constexpr uint32_t PIPELINE_DEPTH = 8;            // maxInflight of the client
+
     ModbusService::Reply _reply;
 
+    // 流水线响应，由 Modbus 回调填充
+    std::mutex pipelineMutex;
+    std::deque<std::pair<uint32_t, ModbusService::Reply>> pipelineReplies;
+    uint32_t pipelineSeq = 0;
+
+    // 最近一次扫描得到的映射，监视时只在映射内跨越间隙
+    ModbusScanManager scanManager;
+    std::vector<ModbusScanManager::Range> mapped[ModbusScanManager::TABLES];
+    bool mapKnown = false;
+
     inline static const char* actions[] = {
         " 📖 读保持寄存器 (FC03)",
         " ✏️  写保持寄存器 (FC06/FC16)",
@@ -65,7 +92,8 @@ private:
         " 🔎 读线圈 (FC01)",
         " ✏️  写线圈 (FC05/FC0F)",
         " 📘 读离散输入 (FC02)",
-        " ⏱️  监视保持寄存器 (FC03 轮询)",
+        " ⏱️  监视寄存器 (批量轮询，仅显示变化)",
+        " 🗺️  扫描寄存器映射 (流水线)",
         " 🆔 设置单元 ID",
         " 🔌 更改目标",
         "🚪 退出命令行"
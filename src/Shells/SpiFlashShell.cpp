@@ -6,14 +6,16 @@ SpiFlashShell::SpiFlashShell(
     IInput& input,
     ArgTransformer& argTransformer,
     UserInputManager& userInputManager,
-    BinaryAnalyzeManager& binaryAnalyzeManager
+    BinaryAnalyzeManager& binaryAnalyzeManager,
+    LittleFsService& littleFsService
 )
     : spiService(spiService),
       terminalView(view),
       terminalInput(input),
       argTransformer(argTransformer),
       userInputManager(userInputManager),
-      binaryAnalyzeManager(binaryAnalyzeManager)
+      binaryAnalyzeManager(binaryAnalyzeManager),
+      littleFsService(littleFsService)
 {
     // 无
 }
@@ -157,64 +159,108 @@ void SpiFlashShell::cmdStrings() {
     if (!checkFlashPresent()) return;
 
     // 验证并解析参数
-    uint8_t minStringLen = userInputManager.readValidatedUint8("字符串最小长度:", 10);
+    StringExtractManager::Options opts;
+    opts.minLen = userInputManager.readValidatedUint8("字符串最小长度:", 10);
+
+    std::vector<std::string> encodings = { " ASCII", " UTF-16LE", " ASCII + UTF-16LE" };
+    int encIndex = userInputManager.readValidatedChoiceIndex("字符串编码", encodings, 0);
+    if (encIndex == 1) opts.encoding = StringExtractManager::Encoding::Utf16Le;
+    else if (encIndex == 2) opts.encoding = StringExtractManager::Encoding::Both;
+
+    terminalView.print("过滤表达式 (支持 ^ $ . *, 留空不过滤): ");
+    opts.filter = userInputManager.getLine();
+    opts.dedupe = userInputManager.readYesNo("去除重复字符串?", true);
+
+    // 可选保存到 LittleFS (SD 卡与 Flash 共用 SPI 总线)
+    std::string path;
+    if (userInputManager.readYesNo("保存结果到 LittleFS 文件?", false)) {
+        if (!littleFsService.mounted()) littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("SPI Flash: LittleFS 未挂载, 仅输出到终端.");
+        } else {
+            std::string fileBase = userInputManager.readSanitizedString("输入文件名", "flash_strings", false);
+            path = "/" + fileBase + ".txt";
+            if (!littleFsService.write(path, "")) {
+                terminalView.println("SPI Flash: 无法创建文件 " + path + ", 仅输出到终端.");
+                path.clear();
+            }
+        }
+    }
+    const bool toFile = !path.empty();
 
     terminalView.println("\nSPI Flash: 正在提取字符串... 按 [ENTER] 停止.\n");
 
-
-    const uint32_t blockSize = 512;
-    uint8_t buffer[blockSize];
-    std::string currentStr;
-    uint32_t currentAddr = 0;
-    uint32_t stringStartAddr = 0;
-    bool inString = false;
-
     // 获取 Flash 大小
     uint8_t id[3];
     spiService.readFlashIdRaw(id);
     const FlashChipInfo* chip = findFlashInfo(id[0], id[1], id[2]);
     uint32_t flashSize = chip ? chip->capacityBytes : spiService.calculateFlashCapacity(id[2]);
 
-    // 分块读取 Flash
-    for (uint32_t addr = 0; addr < flashSize; addr += blockSize) {
-        spiService.readFlashData(addr, buffer, blockSize);
+    // 输出缓冲, 满后追加写入文件
+    const size_t flushThreshold = 3584;
+    std::string outBuf;
+    bool writeFailed = false;
+    if (toFile) outBuf.reserve(flushThreshold + StringExtractManager::MAX_STRING_LEN + 32);
+
+    StringExtractManager extractor;
+    extractor.begin(opts, [&](uint32_t addr, const std::string& str, bool wide) {
+        std::string line = "0x" + argTransformer.toHex(addr, 6) + (wide ? " [UTF-16]: " : ": ") + str;
+        if (!toFile) {
+            terminalView.println(line);
+            return;
+        }
+        outBuf += line;
+        outBuf += '\n';
+        if (outBuf.size() >= flushThreshold) {
+            if (!littleFsService.write(path, outBuf, true)) writeFailed = true;
+            outBuf.clear();
+        }
+    });
 
-        // 读取块
-        for (uint32_t i = 0; i < blockSize; ++i) {
-            uint8_t b = buffer[i];
-            uint32_t absoluteAddr = addr + i;
-
-            if (b >= 32 && b <= 126) {  // 可打印 ASCII
-                if (!inString) {
-                    inString = true;
-                    stringStartAddr = absoluteAddr;
-                }
-                currentStr += static_cast<char>(b);
-            } else {
-                if (inString && currentStr.length() >= minStringLen) {
-                    terminalView.println(
-                        "0x" + argTransformer.toHex(stringStartAddr, 6) + ": " + currentStr
-                    );
-                }
-                currentStr.clear();
-                inString = false;
-            }
+    const uint32_t blockSize = 512;
+    uint8_t buffer[blockSize];
+    uint32_t dotInterval = std::max<uint32_t>(flashSize / blockSize / 30, 1);
+    bool cancelled = false;
 
-            // 如果用户按 ENTER 则退出
-            char c = terminalInput.readChar();
-            if (c == '\r' || c == '\n') {
-                terminalView.println("\nSPI Flash: 用户取消提取.");
-                return;
-            }
+    // 分块读取 Flash, 跨块的字符串由提取器衔接
+    for (uint32_t addr = 0, block = 0; addr < flashSize; addr += blockSize, ++block) {
+        uint32_t len = std::min(blockSize, flashSize - addr);
+        spiService.readFlashData(addr, buffer, len);
+        extractor.feed(addr, buffer, len);
+
+        if (toFile && block % dotInterval == 0) terminalView.print(".");
+
+        if (writeFailed) {
+            terminalView.println("\nSPI Flash: 写入文件失败 " + path);
+            break;
+        }
+
+        // 如果用户按 ENTER 则退出
+        char c = terminalInput.readChar();
+        if (c == '\r' || c == '\n') {
+            cancelled = true;
+            break;
         }
     }
 
     // 处理最后剩余的字符串
-    if (inString && currentStr.length() >= minStringLen) {
-        terminalView.println(
-            "0x" + argTransformer.toHex(stringStartAddr, 6) + ": " + currentStr
-        );
+    extractor.finish();
+    if (toFile && !outBuf.empty() && !writeFailed) {
+        littleFsService.write(path, outBuf, true);
+    }
+
+    const auto& stats = extractor.stats();
+    terminalView.println("");
+    if (cancelled) terminalView.println("SPI Flash: 用户取消提取.");
+    terminalView.println("已扫描 " + std::to_string(stats.bytesScanned) + " 字节, 找到 " +
+                         std::to_string(stats.emitted) + " 个字符串 (重复 " +
+                         std::to_string(stats.duplicates) + ", 过滤 " +
+                         std::to_string(stats.filtered) + ")");
+    if (extractor.dedupeSaturated()) {
+        terminalView.println("去重表已满, " + std::to_string(stats.unremembered) +
+                             " 个字符串未记录, 其中可能有重复");
     }
+    if (toFile && !writeFailed) terminalView.println("结果已保存到 " + path);
 
     terminalView.println("\nSPI Flash: 字符串提取完成.\n");
 }
@@ -6,6 +6,8 @@
 #include "Transformers/ArgTransformer.h"
 #include "Services/SpiService.h"
 #include "Managers/BinaryAnalyzeManager.h"
+#include "Managers/StringExtractManager.h"
+#include "Services/LittleFsService.h"
 #include "Models/TerminalCommand.h"
 #include "States/GlobalState.h"
 
@@ -17,7 +19,8 @@ public:
         IInput& input,
         ArgTransformer& argTransformer,
         UserInputManager& userInputManager,
-        BinaryAnalyzeManager& binaryAnalyzeManager
+        BinaryAnalyzeManager& binaryAnalyzeManager,
+        LittleFsService& littleFsService
     );
 
     void run();
@@ -42,6 +45,7 @@ private:
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
     BinaryAnalyzeManager& binaryAnalyzeManager;
+    LittleFsService& littleFsService;
     GlobalState& state = GlobalState::getInstance();
 
     void cmdProbe();
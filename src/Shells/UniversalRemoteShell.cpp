@@ -1,4 +1,5 @@
 #include "UniversalRemoteShell.h"
+#include <algorithm>
 
 UniversalRemoteShell::UniversalRemoteShell(
     ITerminalView& view,
@@ -60,26 +61,61 @@ void UniversalRemoteShell::run() {
 }
 
 void UniversalRemoteShell::sendCommandGroup(const InfraredCommandStruct* group, size_t size) {
+    if (size == 0) return;
+
+    // Entries of a protocol sent together, in order of first appearance
+    std::vector<InfraredProtocolEnum> protocols;
+    std::vector<size_t> rank(size);
     for (size_t i = 0; i < size; ++i) {
+        auto it = std::find(protocols.begin(), protocols.end(), group[i].proto);
+        rank[i] = it - protocols.begin();
+        if (it == protocols.end()) protocols.push_back(group[i].proto);
+    }
+    std::vector<size_t> order(size);
+    for (size_t i = 0; i < size; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&rank](size_t a, size_t b) {
+        return rank[a] < rank[b];
+    });
 
-        InfraredCommand cmd(group[i].proto, group[i].device, group[i].subdevice, group[i].function);
-        infraredService.sendInfraredCommand(cmd);
-        delay(100);
+    // Double buffer, encoding falls back inline if the encoder task can't start
+    InfraredService::Frame frames[2];
+    infraredService.startEncoder();
+    const InfraredCommandStruct& first = group[order[0]];
+    infraredService.encodeAsync(InfraredCommand(first.proto, first.device, first.subdevice, first.function), frames[0]);
+
+    for (size_t i = 0; i < size; ++i) {
+        const InfraredService::Frame& frame = frames[i & 1];
+        const bool encoded = infraredService.waitEncoded();
+
+        // Next command encoded while this one is on air
+        if (i + 1 < size) {
+            const InfraredCommandStruct& next = group[order[i + 1]];
+            infraredService.encodeAsync(InfraredCommand(next.proto, next.device, next.subdevice, next.function), frames[(i + 1) & 1]);
+        }
+
+        if (encoded) infraredService.sendFrame(frame);
+        const uint32_t sentAt = millis();
 
         // 按回车停止
         char c = terminalInput.readChar();
         if (c == '\n' || c == '\r') {
+            infraredService.stopEncoder();
             terminalView.println(" ⛔ 用户已停止.\n");
             return;
         }
         
         // 显示发送的命令信息
+        const InfraredCommand& cmd = frame.command;
         terminalView.println(
             " ✅ 已发送 协议=" + InfraredProtocolMapper::toString(cmd.getProtocol()) +
             " 设备=" + std::to_string(cmd.getDevice()) +
             " 子设备=" + std::to_string(cmd.getSubdevice()) +
             " 命令=" + std::to_string(cmd.getFunction())
         );
+
+        // Gap between commands, the key check and the log above are part of it
+        while (millis() - sentAt < COMMAND_GAP_MS) delay(1);
     }
+    infraredService.stopEncoder();
     terminalView.println("");
-}
\ No newline at end of file
+}
@@ -20,5 +20,7 @@ private:
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
 
+    static constexpr uint32_t COMMAND_GAP_MS = 100;
+
     void sendCommandGroup(const InfraredCommandStruct* group, size_t size);
 };
@@ -35,13 +35,6 @@ std::vector<InfraredFileRemoteCommand> InfraredRemoteTransformer::transformFromF
 
     InfraredFileRemoteCommand command; 
 
-    const auto trim = [](const std::string& s) -> std::string {
-        size_t i = 0, j = s.size();
-        while (i < j && (s[i]==' '||s[i]=='\t'||s[i]=='\r'||s[i]=='\n')) ++i;
-        while (j > i && (s[j-1]==' '||s[j-1]=='\t'||s[j-1]=='\r'||s[j-1]=='\n')) --j;
-        return (i<j) ? s.substr(i, j-i) : std::string();
-    };
-
     const char* p   = fileContent.c_str();
     const char* end = p + fileContent.size();
 
@@ -73,31 +66,15 @@ std::vector<InfraredFileRemoteCommand> InfraredRemoteTransformer::transformFromF
             command = InfraredFileRemoteCommand(); // reset
             command.functionName = val;
         }
-        else if (key == "type" && val == "raw") {
-            command.protocol = InfraredProtocolEnum::RAW;
-        }
-        else if (key == "protocol") {
-            command.protocol = InfraredProtocolMapper::toEnum(val);
-        }
-        else if (key == "address") {
-            command.address = convertHexToUint16(val, 2);
-        }
-        else if (key == "frequency") {
-            // IRemote attend des kHz
-            command.frequency = std::stoi(val) / 1000;
-        }
-        else if (key == "command") {
-            command.function = convertHexToUint16(val, 1);
-        }
-        else if (key == "duty_cycle") {
-            command.dutyCycle = static_cast<float>(std::atof(val.c_str()));
-        }
         else if (key == "data") {
             size_t size = 0;
             uint16_t* rawData = convertDecToUint16Array(val, size);
             command.rawData = rawData;
             command.rawDataSize = size;
         }
+        else {
+            applyField(key, val, command);
+        }
     }
 
     // push last
@@ -108,6 +85,147 @@ std::vector<InfraredFileRemoteCommand> InfraredRemoteTransformer::transformFromF
     return commands;
 }
 
+void InfraredRemoteTransformer::beginIndex() {
+    index = IndexContext();
+}
+
+bool InfraredRemoteTransformer::feedIndex(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i, ++index.position) {
+        const char c = static_cast<char>(data[i]);
+
+        if (c == '\n') {
+            indexEndLine();
+            index.state = IndexState::Key;
+            index.key.clear();
+            index.value.clear();
+            index.lineStart = index.position + 1;
+            index.firstLine = false;
+            continue;
+        }
+
+        switch (index.state) {
+            case IndexState::Key:
+                if (c == ':') {
+                    // Values are only needed for the file header and the button fields
+                    index.key = trim(index.key);
+                    const bool wanted = index.firstLine || index.key == "name" || index.key == "type";
+                    index.state = wanted ? IndexState::Value : IndexState::Skip;
+                } else if (index.key.size() < INDEX_MAX_KEY) {
+                    index.key.push_back(c);
+                } else {
+                    index.state = IndexState::Skip;
+                }
+                break;
+
+            case IndexState::Value:
+                if (index.value.size() < INDEX_MAX_VALUE) index.value.push_back(c);
+                break;
+
+            case IndexState::Skip:
+                break;
+        }
+    }
+    return true;
+}
+
+std::vector<InfraredRemoteTransformer::ButtonOffset> InfraredRemoteTransformer::endIndex() {
+    // File without a final newline
+    indexEndLine();
+    index.state = IndexState::Key;
+
+    if (!index.buttons.empty()) {
+        ButtonOffset& last = index.buttons.back();
+        last.length = index.position - last.offset;
+    }
+
+    std::vector<ButtonOffset> out;
+    out.swap(index.buttons);
+    return out;
+}
+
+void InfraredRemoteTransformer::indexEndLine() {
+    if (index.state != IndexState::Value) return;
+    const std::string val = trim(index.value);
+
+    if (index.firstLine) {
+        index.valid = index.key == "Filetype" && val.compare(0, 2, "IR") == 0;
+    } else if (index.key == "name") {
+        // The previous button ends where this one starts
+        if (!index.buttons.empty()) {
+            ButtonOffset& prev = index.buttons.back();
+            prev.length = index.lineStart - prev.offset;
+        }
+        ButtonOffset b;
+        b.name = val;
+        b.offset = index.lineStart;
+        index.buttons.push_back(std::move(b));
+    } else if (index.key == "type" && val == "raw" && !index.buttons.empty()) {
+        index.buttons.back().raw = true;
+    }
+    index.state = IndexState::Skip;
+}
+
+bool InfraredRemoteTransformer::parseButton(const std::string& block, InfraredFileRemoteCommand& command, std::vector<uint16_t>& rawStorage) {
+    command = InfraredFileRemoteCommand();
+    rawStorage.clear();
+    bool named = false;
+
+    size_t p = 0;
+    while (p < block.size()) {
+        size_t lineEnd = block.find('\n', p);
+        if (lineEnd == std::string::npos) lineEnd = block.size();
+        const size_t colon = block.find(':', p);
+        const size_t next = lineEnd + 1;
+
+        if (colon != std::string::npos && colon < lineEnd) {
+            const std::string key = trim(block.substr(p, colon - p));
+            if (key == "name") {
+                // Next button, the block was longer than needed
+                if (named) break;
+                command.functionName = trim(block.substr(colon + 1, lineEnd - colon - 1));
+                named = true;
+            } else if (key == "data") {
+                parseDecInto(block.substr(colon + 1, lineEnd - colon - 1), rawStorage);
+                command.rawData = rawStorage.data();
+                command.rawDataSize = rawStorage.size();
+            } else {
+                applyField(key, trim(block.substr(colon + 1, lineEnd - colon - 1)), command);
+            }
+        }
+        p = next;
+    }
+    return named;
+}
+
+std::string InfraredRemoteTransformer::trim(const std::string& s) {
+    size_t i = 0, j = s.size();
+    while (i < j && (s[i]==' '||s[i]=='\t'||s[i]=='\r'||s[i]=='\n')) ++i;
+    while (j > i && (s[j-1]==' '||s[j-1]=='\t'||s[j-1]=='\r'||s[j-1]=='\n')) --j;
+    return (i<j) ? s.substr(i, j-i) : std::string();
+}
+
+void InfraredRemoteTransformer::applyField(const std::string& key, const std::string& val, InfraredFileRemoteCommand& command) {
+    if (key == "type" && val == "raw") {
+        command.protocol = InfraredProtocolEnum::RAW;
+    }
+    else if (key == "protocol") {
+        command.protocol = InfraredProtocolMapper::toEnum(val);
+    }
+    else if (key == "address") {
+        command.address = convertHexToUint16(val, 2);
+    }
+    else if (key == "frequency") {
+        // IRemote attend des kHz
+        command.frequency = std::stoi(val) / 1000;
+    }
+    else if (key == "command") {
+        command.function = convertHexToUint16(val, 1);
+    }
+    else if (key == "duty_cycle") {
+        command.dutyCycle = static_cast<float>(std::atof(val.c_str()));
+    }
+}
+
 std::string InfraredRemoteTransformer::transformToFileFormat(const std::string fileName, const std::vector<InfraredFileRemoteCommand>& cmds) {
     std::ostringstream out;
 
@@ -118,6 +236,13 @@ std::string InfraredRemoteTransformer::transformToFileFormat(const std::string f
     out << "# ";
     out << fileName;
     out << "\n#\n\n";
+    out << transformEntriesToFileFormat(cmds);
+
+    return out.str();
+}
+
+std::string InfraredRemoteTransformer::transformEntriesToFileFormat(const std::vector<InfraredFileRemoteCommand>& cmds) {
+    std::ostringstream out;
 
     for (size_t i = 0; i < cmds.size(); ++i) {
         const auto& c = cmds[i];
@@ -179,15 +304,8 @@ uint16_t InfraredRemoteTransformer::convertHexToUint16(const std::string& hexStr
 }
 
 uint16_t* InfraredRemoteTransformer::convertDecToUint16Array(const std::string& dataString, size_t& arraySize) {
-    std::istringstream iss(dataString);
-    std::string valueStr;
     std::vector<uint16_t> values;
-
-    // Read each value from the string and convert it to uint16_t
-    while (iss >> valueStr) {
-        uint16_t value = static_cast<uint16_t>(std::stoul(valueStr, nullptr, 10));
-        values.push_back(value);
-    }
+    parseDecInto(dataString, values);
 
     arraySize = values.size(); // Store the size of the array
     uint16_t* resultArray = new uint16_t[arraySize];
@@ -200,6 +318,24 @@ uint16_t* InfraredRemoteTransformer::convertDecToUint16Array(const std::string&
     return resultArray;
 }
 
+void InfraredRemoteTransformer::parseDecInto(const std::string& dataString, std::vector<uint16_t>& out) {
+    // Space separated decimal values, no stream or temporary string per value
+    out.clear();
+    uint32_t value = 0;
+    bool inNumber = false;
+    for (char c : dataString) {
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+            inNumber = true;
+        } else if (inNumber) {
+            out.push_back(static_cast<uint16_t>(value));
+            value = 0;
+            inNumber = false;
+        }
+    }
+    if (inNumber) out.push_back(static_cast<uint16_t>(value));
+}
+
 std::string InfraredRemoteTransformer::hexByte(uint8_t b) {
     std::ostringstream oss;
     oss << std::uppercase << std::hex << std::setfill('0')
@@ -11,8 +11,49 @@ public:
     static bool isValidInfraredFile(const std::string& fileContent);
     static std::vector<InfraredFileRemoteCommand> transformFromFileFormat(const std::string& fileContent);
     static std::string transformToFileFormat(const std::string fileName, const std::vector<InfraredFileRemoteCommand>& cmds);
+    // Button entries only, to append to an existing file
+    static std::string transformEntriesToFileFormat(const std::vector<InfraredFileRemoteCommand>& cmds);
     static std::vector<std::string> extractFunctionNames(const std::vector<InfraredFileRemoteCommand>& cmds);
+
+    // Button index, fed chunk by chunk (LittleFsService::readChunks)
+    // Only names and offsets are kept, a button is decoded when it is selected
+    struct ButtonOffset {
+        std::string name;
+        uint32_t    offset = 0;     // start of the "name:" line
+        uint32_t    length = 0;     // up to the next button or the end of the file
+        bool        raw    = false;
+    };
+    void beginIndex();
+    bool feedIndex(const uint8_t* data, size_t len);
+    std::vector<ButtonOffset> endIndex();
+    bool indexLooksValid() const { return index.valid; }
+
+    // Decode the block of one button (LittleFsService::readRange)
+    // Raw timings are written to rawStorage, command.rawData points into it
+    static bool parseButton(const std::string& block, InfraredFileRemoteCommand& command, std::vector<uint16_t>& rawStorage);
+
 private:
+    static constexpr size_t INDEX_MAX_KEY   = 16;
+    static constexpr size_t INDEX_MAX_VALUE = 64;
+
+    enum class IndexState : uint8_t { Key, Value, Skip };
+
+    struct IndexContext {
+        IndexState state = IndexState::Key;
+        std::string key;
+        std::string value;
+        uint32_t    position  = 0;      // bytes fed so far
+        uint32_t    lineStart = 0;
+        bool        firstLine = true;
+        bool        valid     = false;
+        std::vector<ButtonOffset> buttons;
+    };
+    IndexContext index;
+
+    void indexEndLine();
+    static std::string trim(const std::string& s);
+    static void applyField(const std::string& key, const std::string& val, InfraredFileRemoteCommand& command);
+    static void parseDecInto(const std::string& decString, std::vector<uint16_t>& out);
     static uint16_t convertHexToUint16(const std::string& hexString, size_t byteLimit);
     static uint16_t* convertDecToUint16Array(const std::string& decString, size_t& arraySize);
     static std::string hexByte(uint8_t b);
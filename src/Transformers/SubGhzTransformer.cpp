@@ -2,6 +2,7 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 
 bool SubGhzTransformer::isValidSubGhzFile(const std::string& content) {
     if (content.empty()) return false;
@@ -37,84 +38,224 @@ bool SubGhzTransformer::isValidSubGhzFile(const std::string& content) {
 
 std::vector<SubGhzFileCommand> SubGhzTransformer::transformFromFileFormat(const std::string& fileContent,
                                            const std::string& sourcePath) {
-    std::vector<SubGhzFileCommand> out;
-    if (fileContent.empty()) return out;
-
-    std::string protocolStr, presetStr;
-    uint32_t frequency = 0;
-    uint16_t te = 0;
-
-    // Accumulateurs
-    std::vector<int> bitList, bitRawList;
-    std::vector<uint64_t> keyList;
-    std::vector<std::string> rawDataLines;   // pour Protocol: RAW uniquement (timings signés)
-    std::vector<uint8_t>     binRawBytes;    // pour Protocol: BinRAW (octets)
-
-    // Buffer de lecture
-    const char* p   = fileContent.c_str();
-    const char* end = p + fileContent.size();
-
-    while (p < end) {
-        const char* lineStart = p;
-        while (p < end && *p != '\n') ++p;
-        const char* lineEnd = p;
-        if (p < end && *p == '\n') ++p;
-        if (lineEnd > lineStart && *(lineEnd - 1) == '\r') --lineEnd;
-
-        const char* colon = lineStart;
-        while (colon < lineEnd && *colon != ':') ++colon;
-        if (colon == lineEnd) continue;
-
-        std::string key(lineStart, colon - lineStart);
-        std::string val(colon + 1, lineEnd - (colon + 1));
-        trim(key);
-        trim(val);
-        if (key.empty()) continue;
-
-        if (iequals(key, "Protocol")) {
-            protocolStr = val;
-        } else if (iequals(key, "Preset")) {
-            presetStr = val;
-        } else if (iequals(key, "Frequency")) {
-            uint32_t hz = 0; if (parseUint32(val, hz)) frequency = hz;
-        } else if (iequals(key, "TE")) {
-            uint16_t tev = 0; if (parseUint16(val, tev)) te = tev;
-        } else if (iequals(key, "Bit")) {
-            int v = 0; if (parseInt(val, v)) bitList.push_back(v);
-        } else if (iequals(key, "Bit_RAW")) {
-            int v = 0; if (parseInt(val, v)) bitRawList.push_back(v);
-        } else if (iequals(key, "Key")) {
-            uint64_t k = 0; if (parseHexToU64(val, k)) keyList.push_back(k);
-        } else if (iequals(key, "BinRAW")) {
-            auto bytes = parseHexByteStream(val);
-            if (!bytes.empty()) {
-                binRawBytes.insert(binRawBytes.end(), bytes.begin(), bytes.end());
-            }
-        } else if (iequals(key, "RAW_Data") || iequals(key, "Data_RAW")) {
-            // IMPORTANT :
-            // - Bytes if Protocol: BinRAW
-            // - Timings if Protocol: RAW
-            if (iequals(protocolStr, "BinRAW")) {
-                auto bytes = parseHexByteStream(val);
-                if (!bytes.empty()) {
-                    binRawBytes.insert(binRawBytes.end(), bytes.begin(), bytes.end());
-                }
-            } else {
-                rawDataLines.push_back(val);
-            }
+    if (fileContent.empty()) return {};
+
+    // Same parser as the streamed path, timings are collected in memory
+    std::vector<int32_t> timings;
+    beginStream([&](const int32_t* t, size_t n) {
+        timings.insert(timings.end(), t, t + n);
+        return true;
+    }, sourcePath);
+    feedStream(reinterpret_cast<const uint8_t*>(fileContent.data()), fileContent.size());
+    auto out = endStream();
+
+    for (auto& cmd : out) {
+        if (cmd.protocol == SubGhzProtocolEnum::RAW) cmd.raw_timings = std::move(timings);
+    }
+    return out;
+}
+
+/*
+Streaming parser
+*/
+void SubGhzTransformer::beginStream(const TimingSink& sink, const std::string& sourcePath) {
+    stream = StreamContext{};
+    stream.sink = sink;
+    stream.sourcePath = sourcePath;
+    stream.key.reserve(STREAM_MAX_KEY);
+    stream.value.reserve(STREAM_MAX_VALUE);
+    stream.batch.reserve(STREAM_BATCH);
+}
+
+bool SubGhzTransformer::feedStream(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len && !stream.aborted; ++i) {
+        const char c = static_cast<char>(data[i]);
+
+        switch (stream.state) {
+            case StreamState::Key:
+                streamKeyChar(c);
+                break;
+
+            case StreamState::Value:
+                if (c == '\n') { streamEndValue(); stream.state = StreamState::Key; }
+                else if (stream.value.size() < STREAM_MAX_VALUE) stream.value.push_back(c);
+                break;
+
+            case StreamState::Timings:
+                streamTimingChar(c);
+                break;
+
+            case StreamState::HexBytes:
+                streamHexChar(c);
+                break;
+
+            case StreamState::Skip:
+                if (c == '\n') stream.state = StreamState::Key;
+                break;
         }
     }
+    return !stream.aborted;
+}
+
+std::vector<SubGhzFileCommand> SubGhzTransformer::endStream() {
+    // File without a final newline
+    if (stream.state == StreamState::Value) streamEndValue();
+    if (stream.state == StreamState::Timings) streamEndTiming();
+    if (stream.state == StreamState::HexBytes) streamHexChar('\n');
+    streamFlushBatch();
+    stream.state = StreamState::Key;
 
-    // Finalisation (ne crée plus de "compat RAW" quand Protocol != RAW)
-    flushAccumulated(protocolStr, presetStr, frequency, te,
-                     bitList, bitRawList, keyList,
-                     rawDataLines,             // timings pour RAW
-                     binRawBytes,              // octets pour BinRAW
-                     out, sourcePath);
+    std::vector<SubGhzFileCommand> out;
+    if (stream.aborted) return out;
 
+    flushAccumulated(stream.protocolStr, stream.presetStr, stream.frequency, stream.te,
+                     stream.bitList, stream.bitRawList, stream.keyList,
+                     stream.rawCount,
+                     stream.binRawBytes,
+                     out, stream.sourcePath);
     return out;
 }
 
+void SubGhzTransformer::streamKeyChar(char c) {
+    if (c == '\n') {
+        stream.key.clear();
+        stream.firstLine = false;
+        return;
+    }
+    if (c != ':') {
+        if (stream.key.size() >= STREAM_MAX_KEY) { stream.key.clear(); stream.state = StreamState::Skip; return; }
+        stream.key.push_back(c);
+        return;
+    }
+
+    trim(stream.key);
+    if (stream.key.empty()) { stream.state = StreamState::Skip; return; }
+
+    // RAW_Data: bytes for BinRAW, timings otherwise
+    if (iequals(stream.key, "RAW_Data") || iequals(stream.key, "Data_RAW") || iequals(stream.key, "BinRAW")) {
+        const bool bytes = iequals(stream.key, "BinRAW") || iequals(stream.protocolStr, "BinRAW");
+        stream.lineBytes.clear();
+        stream.lineBad = false;
+        stream.inToken = false;
+        stream.state = bytes ? StreamState::HexBytes : StreamState::Timings;
+        stream.key.clear();
+        return;
+    }
+
+    stream.value.clear();
+    stream.state = StreamState::Value;
+}
+
+void SubGhzTransformer::streamEndValue() {
+    std::string& key = stream.key;
+    std::string& val = stream.value;
+    trim(val);
+
+    // First line, "Filetype: Flipper SubGhz ..." (BOM tolerated)
+    if (stream.firstLine) {
+        if (key.size() >= 3 && (unsigned char)key[0] == 0xEF && (unsigned char)key[1] == 0xBB && (unsigned char)key[2] == 0xBF) {
+            key.erase(0, 3);
+        }
+        stream.valid = iequals(key, "Filetype") && startsWith(val, "Flipper SubGhz");
+        stream.firstLine = false;
+    }
+
+    if (iequals(key, "Protocol")) {
+        stream.protocolStr = val;
+    } else if (iequals(key, "Preset")) {
+        stream.presetStr = val;
+    } else if (iequals(key, "Frequency")) {
+        uint32_t hz = 0; if (parseUint32(val, hz)) stream.frequency = hz;
+    } else if (iequals(key, "TE")) {
+        uint16_t tev = 0; if (parseUint16(val, tev)) stream.te = tev;
+    } else if (iequals(key, "Bit")) {
+        int v = 0; if (parseInt(val, v)) stream.bitList.push_back(v);
+    } else if (iequals(key, "Bit_RAW")) {
+        int v = 0; if (parseInt(val, v)) stream.bitRawList.push_back(v);
+    } else if (iequals(key, "Key")) {
+        uint64_t k = 0; if (parseHexToU64(val, k)) stream.keyList.push_back(k);
+    }
+
+    key.clear();
+    val.clear();
+}
+
+void SubGhzTransformer::streamTimingChar(char c) {
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        streamEndTiming();
+        if (c == '\n') {
+            stream.firstLine = false;
+            stream.state = StreamState::Key;
+        }
+        return;
+    }
+
+    if (!stream.inToken) {
+        stream.inToken = true;
+        stream.badToken = false;
+        stream.negative = false;
+        stream.number = 0;
+        if (c == '-' || c == '+') { stream.negative = (c == '-'); return; }
+    }
+
+    if (c < '0' || c > '9') { stream.badToken = true; return; }
+    if (stream.number <= INT32_MAX) stream.number = stream.number * 10 + (c - '0');
+}
+
+void SubGhzTransformer::streamEndTiming() {
+    if (!stream.inToken) return;
+    stream.inToken = false;
+
+    // Same rules as strtol: sign alone or junk drops the token, 0 is ignored
+    if (stream.badToken || stream.number == 0 || stream.number > INT32_MAX) return;
+
+    const int32_t v = static_cast<int32_t>(stream.negative ? -stream.number : stream.number);
+    stream.batch.push_back(v);
+    stream.rawCount++;
+
+    // Hand over on a long low so the next file read lands in a silence
+    const bool full = stream.batch.size() >= STREAM_BATCH;
+    const bool splitHere = v <= -STREAM_SPLIT_GAP_US && stream.batch.size() >= (STREAM_BATCH * 3) / 4;
+    if (full || splitHere) streamFlushBatch();
+}
+
+bool SubGhzTransformer::streamFlushBatch() {
+    if (stream.batch.empty()) return !stream.aborted;
+    if (stream.sink && !stream.sink(stream.batch.data(), stream.batch.size())) stream.aborted = true;
+    stream.batch.clear();
+    return !stream.aborted;
+}
+
+void SubGhzTransformer::streamHexChar(char c) {
+    const bool sep = (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+
+    if (!sep) {
+        if (!stream.inToken) { stream.inToken = true; stream.value.clear(); }
+        if (stream.value.size() < 20) stream.value.push_back(c);
+        else stream.lineBad = true;
+        return;
+    }
+
+    // End of a byte token, a bad token drops the whole line
+    if (stream.inToken) {
+        stream.inToken = false;
+        uint64_t v64 = 0;
+        if (!parseHexToU64(stream.value, v64) || v64 > 0xFFull) stream.lineBad = true;
+        else stream.lineBytes.push_back(static_cast<uint8_t>(v64));
+        stream.value.clear();
+    }
+
+    if (c == '\n') {
+        if (!stream.lineBad) {
+            stream.binRawBytes.insert(stream.binRawBytes.end(), stream.lineBytes.begin(), stream.lineBytes.end());
+        }
+        stream.lineBytes.clear();
+        stream.lineBad = false;
+        stream.firstLine = false;
+        stream.state = StreamState::Key;
+    }
+}
+
 void SubGhzTransformer::flushAccumulated(
     const std::string& protocolStr,
     const std::string& presetStr,
@@ -123,7 +264,7 @@ void SubGhzTransformer::flushAccumulated(
     const std::vector<int>& bitList,
     const std::vector<int>& bitRawList,
     const std::vector<uint64_t>& keyList,
-    const std::vector<std::string>& rawDataLines,
+    uint32_t                        rawCount,
     const std::vector<uint8_t>&     binRawBytes,
     std::vector<SubGhzFileCommand>& out,
     const std::string& sourcePath
@@ -154,17 +295,15 @@ void SubGhzTransformer::flushAccumulated(
 
     // RAW
     if (protocol == SubGhzProtocolEnum::RAW) {
-        if (!rawDataLines.empty()) {
+        if (rawCount > 0) {
             SubGhzFileCommand cmd;
             cmd.protocol      = SubGhzProtocolEnum::RAW;
             cmd.preset        = preset;
             cmd.frequency_hz  = frequency;
             cmd.te_us         = te;
-            cmd.raw_timings   = parseRawTimingsJoined(rawDataLines);
+            cmd.raw_count     = rawCount;
             cmd.source_file   = sourcePath;
-            if (!cmd.raw_timings.empty()) {
-                out.emplace_back(std::move(cmd));
-            }
+            out.emplace_back(std::move(cmd));
         }
         return;
     }
@@ -243,7 +382,7 @@ SubGhzTransformer::extractSummaries(const std::vector<SubGhzFileCommand>& cmds)
            << " @ " << c.frequency_hz << "Hz";
 
         if (c.protocol == SubGhzProtocolEnum::RAW) {
-            os << " timings=" << c.raw_timings.size();
+            os << " timings=" << (c.raw_timings.empty() ? c.raw_count : c.raw_timings.size());
         } else if (c.protocol == SubGhzProtocolEnum::BinRAW) {
             os << " bytes=" << c.bitstream_bytes.size();
         } else {
@@ -256,45 +395,58 @@ SubGhzTransformer::extractSummaries(const std::vector<SubGhzFileCommand>& cmds)
     return out;
 }
 
-std::string SubGhzTransformer::mapPreset(const std::string& presetStr) {
-    std::string p; p = presetStr;
-    return p;
-}
-
-std::vector<int32_t> SubGhzTransformer::parseRawTimingsJoined(const std::vector<std::string>& lines) {
-    std::vector<int32_t> out;
-    out.reserve(1024);
-    for (const auto& lnRaw : lines) {
-        std::string ln = lnRaw;
-        // Replace tabs with spaces for simplification
-        std::replace(ln.begin(), ln.end(), '\t', ' ');
-        std::istringstream iss(ln);
-        std::string tok;
-        while (iss >> tok) {
-            int v=0;
-            if (parseInt(tok, v)) {
-                if (v != 0) { // ignore 0 terminator-style if present
-                    out.push_back(v);
-                }
+void SubGhzTransformer::toRmtItems(const int32_t* timings, size_t count, uint32_t tickPerUs,
+                                   std::vector<rmt_item32_t>& out) {
+    out.clear();
+    if (!timings || count == 0) return;
+    if (tickPerUs == 0) tickPerUs = 1;
+    out.reserve(count / 2 + 1);
+
+    rmt_item32_t item{};
+    bool half = false; // duration0 written, duration1 pending
+
+    for (size_t i = 0; i < count; ++i) {
+        const int32_t t = timings[i];
+        if (t == 0) continue;
+
+        const uint32_t level = t > 0 ? 1 : 0;
+        uint64_t ticks = static_cast<uint64_t>(t > 0 ? t : -static_cast<int64_t>(t)) * tickPerUs;
+
+        // A zero duration ends the transmission, durations are split instead
+        while (ticks > 0) {
+            const uint32_t chunk = ticks > RMT_MAX_TICKS ? RMT_MAX_TICKS : static_cast<uint32_t>(ticks);
+            ticks -= chunk;
+            if (!half) {
+                item.level0 = level;
+                item.duration0 = chunk;
+                half = true;
+            } else {
+                item.level1 = level;
+                item.duration1 = chunk;
+                out.push_back(item);
+                half = false;
             }
         }
     }
-    return out;
-}
 
-std::vector<uint8_t> SubGhzTransformer::parseHexByteStream(const std::string& hexLine) {
-    // Accept "A1 b2 0C" etc
-    std::vector<uint8_t> out;
-    std::istringstream iss(hexLine);
-    std::string tok;
-    while (iss >> tok) {
-        uint64_t v64=0;
-        if (!parseHexToU64(tok, v64) || v64 > 0xFFull) {
-            return {};
+    // Odd count, the last duration is split in two halves of the same level
+    if (half) {
+        const uint32_t d = item.duration0;
+        if (d >= 2) {
+            item.duration0 = d - d / 2;
+            item.level1 = item.level0;
+            item.duration1 = d / 2;
+        } else {
+            item.level1 = 0;
+            item.duration1 = 1;
         }
-        out.push_back(static_cast<uint8_t>(v64));
+        out.push_back(item);
     }
-    return out;
+}
+
+std::string SubGhzTransformer::mapPreset(const std::string& presetStr) {
+    std::string p; p = presetStr;
+    return p;
 }
 
 SubGhzProtocolEnum SubGhzTransformer::detectProtocol(const std::string& protocolStr) {
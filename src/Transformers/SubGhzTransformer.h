@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <sstream>
 #include <cctype>
+#include <functional>
+#include "driver/rmt.h"
 #include "Enums/SubGhzProtocolEnum.h"
 
 struct SubGhzFileCommand {
@@ -18,6 +20,7 @@ struct SubGhzFileCommand {
 
     // RAW
     std::vector<int32_t> raw_timings;       // us
+    uint32_t            raw_count {0};      // timings in the file, raw_timings stays empty when streamed
 
     // BinRAW
     std::vector<uint8_t> bitstream_bytes;   // byte sequence
@@ -37,7 +40,65 @@ public:
     // Extract readable summaries of commands
     std::vector<std::string> extractSummaries(const std::vector<SubGhzFileCommand>& cmds);
 
+    // Streaming parser, fed chunk by chunk (LittleFsService::readChunks)
+    // RAW timings are handed to the sink in batches and never stored, memory stays constant
+    using TimingSink = std::function<bool(const int32_t* timings, size_t count)>;
+    void beginStream(const TimingSink& sink, const std::string& sourcePath = {});
+    bool feedStream(const uint8_t* data, size_t len);
+    std::vector<SubGhzFileCommand> endStream();
+    bool streamLooksValid() const { return stream.valid; }
+
+    // Signed timings (us) to RMT items, long durations split over several halves
+    // Items are always complete so the buffer can be written as is
+    static constexpr uint32_t RMT_MAX_TICKS = 32767;
+    static void toRmtItems(const int32_t* timings, size_t count, uint32_t tickPerUs,
+                           std::vector<rmt_item32_t>& out);
+
 private:
+    static constexpr size_t STREAM_BATCH       = 256;   // timings per sink call
+    static constexpr size_t STREAM_MAX_KEY     = 32;
+    static constexpr size_t STREAM_MAX_VALUE   = 256;
+    static constexpr int32_t STREAM_SPLIT_GAP_US = 2000; // batches are handed over on a long low
+
+    enum class StreamState : uint8_t { Key, Value, Timings, HexBytes, Skip };
+
+    struct StreamContext {
+        StreamState state = StreamState::Key;
+        TimingSink  sink;
+        std::string sourcePath;
+        std::string key;
+        std::string value;
+        bool        firstLine = true;
+        bool        valid     = false;
+        bool        aborted   = false;
+
+        // Accumulated fields
+        std::string protocolStr, presetStr;
+        uint32_t    frequency = 0;
+        uint16_t    te = 0;
+        std::vector<int> bitList, bitRawList;
+        std::vector<uint64_t> keyList;
+        std::vector<uint8_t>  binRawBytes;
+        std::vector<uint8_t>  lineBytes;    // BinRAW bytes of the current line
+        bool        lineBad = false;
+        uint32_t    rawCount = 0;
+
+        // Token being parsed
+        std::vector<int32_t> batch;
+        int64_t     number = 0;
+        bool        negative = false;
+        bool        inToken  = false;
+        bool        badToken = false;
+    };
+    StreamContext stream;
+
+    void streamKeyChar(char c);
+    void streamEndValue();
+    void streamTimingChar(char c);
+    void streamEndTiming();
+    void streamHexChar(char c);
+    bool streamFlushBatch();
+
     // Helpers
     static void trim(std::string& s);
     static std::string trim_copy(const std::string& s);
@@ -51,12 +112,6 @@ private:
     static bool parseHexToU64(const std::string& hex, uint64_t& out);
     std::string mapPreset(const std::string& presetStr);
 
-    // RAW: “123 456 789 …”
-    std::vector<int32_t> parseRawTimingsJoined(const std::vector<std::string>& rawLines);
-
-    // BinRAW: "00 01 02 FF" → octets
-    std::vector<uint8_t> parseHexByteStream(const std::string& hexLine);
-
     // Finalizer
     void flushAccumulated(
         const std::string& protocolStr,
@@ -66,7 +121,7 @@ private:
         const std::vector<int>& bitList,
         const std::vector<int>& bitRawList,
         const std::vector<uint64_t>& keyList,
-        const std::vector<std::string>& rawDataLines,
+        uint32_t                        rawCount,
         const std::vector<uint8_t>&     binRawBytes,
         std::vector<SubGhzFileCommand>& out,
         const std::string& sourcePath
@@ -20,29 +20,62 @@
 // If you do not agree to these conditions, you have no permission to use, copy, modify or distribute this program.
 
 #include "MakeHex.h"
+#include <mutex>
 
-std::vector<float> encodeRemoteCommand(const InfraredCommand& cmd, const char* protocolString, int& frequency) {
+namespace {
 
-    // Adapted from
-    // https://github.com/probonopd/MakeHex/tree/master
-    // By John Fine
+constexpr size_t PROTOCOL_COUNT = sizeof(protocolDefinitions) / sizeof(protocolDefinitions[0]);
+constexpr size_t TEMPLATE_CACHE_SIZE = 16;
 
-    char irp[512] = ""; // IRP string, will contains all necessary infos to generate the IR sequence
-
-    // Device
-    if (cmd.getSubdevice() >= 0)
-        snprintf(irp, sizeof(irp), "Device=%d.%d\nFunction=%d\n", cmd.getDevice(), cmd.getSubdevice(), cmd.getFunction());
-    else
-        snprintf(irp, sizeof(irp), "Device=%d\nFunction=%d\n", cmd.getSubdevice(), cmd.getFunction());
+constexpr int constStrcmp(const char* a, const char* b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    return (unsigned char)*a - (unsigned char)*b;
+}
 
-    // Protocol
-    int p = -1;
-    for (int i = 0; i < 62; i++) {
-        if (strcmp(protocolString, protocolDefinitions[i].name) == 0) {
-            p = i;
-            break;
+// Protocol names sorted at compile time, looked up with a binary search
+struct ProtocolIndex {
+    uint8_t order[PROTOCOL_COUNT] {};
+
+    constexpr ProtocolIndex() {
+        for (size_t i = 0; i < PROTOCOL_COUNT; ++i) order[i] = (uint8_t)i;
+        for (size_t i = 1; i < PROTOCOL_COUNT; ++i) {
+            uint8_t v = order[i];
+            size_t j = i;
+            while (j > 0 && constStrcmp(protocolDefinitions[order[j - 1]].name, protocolDefinitions[v].name) > 0) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = v;
         }
     }
+};
+constexpr ProtocolIndex protocolIndex;
+
+int findProtocol(const char* name) {
+    size_t lo = 0, hi = PROTOCOL_COUNT;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = strcmp(protocolDefinitions[protocolIndex.order[mid]].name, name);
+        if (c == 0) return protocolIndex.order[mid];
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
+
+// Parsed IRP of a protocol, only D, S, F and N change between commands
+struct IrpTemplate {
+    std::string key;
+    std::unique_ptr<IRP> irp;
+    int frequency; // kHz, -1 if the protocol does not define it
+};
+std::vector<IrpTemplate> templateCache; // most recently used last
+std::mutex templateMutex;                // cache and template values, the batch encoder runs on the other core
+
+IrpTemplate* compileTemplate(const InfraredCommand& cmd, const char* protocolString) {
+    // Resolve the protocol name
+    char defines[64] = "";
+    int p = findProtocol(protocolString);
     if (p < 0) {
         // Protocol not found, try for special protocols
         int M = 0;
@@ -50,73 +83,113 @@ std::vector<float> encodeRemoteCommand(const InfraredCommand& cmd, const char* p
         char tempProt[100];
         strncpy(tempProt, protocolString, sizeof(tempProt));
         tempProt[sizeof(tempProt) - 1] = '\0';
-        for (int i = 0; i < strlen(tempProt); i++)
+        for (size_t i = 0; i < strlen(tempProt); i++)
             tempProt[i] = toupper(tempProt[i]); // Convert to uppercase
 
         if (sscanf(tempProt, "RC6-%d-%d", &M, &L) == 2) {
-            char temp[512];
-            snprintf(temp, sizeof(temp), "Define M=%d\nDefine L=%d\n", M, L);
-            strncat(irp, temp, sizeof(irp) - strlen(irp) - 1);
+            snprintf(defines, sizeof(defines), "Define M=%d\nDefine L=%d\n", M, L);
             protocolString = "rc6-M-L";
         } else if (strcmp("NEC", tempProt) == 0) {
             protocolString = "nec2";
         } else if (strcmp("NECX", tempProt) == 0) {
             protocolString = "NECx2";
         }
-
-        // Search again for protocol
-        for (int i = 0; i < 62; i++) {
-            if (strcmp(protocolString, protocolDefinitions[i].name) == 0) {
-                p = i;
-                break;
-            }
-        }
+        p = findProtocol(protocolString);
 
         // Default NEC2 if no protocol found
         // NEC2 for reliabity which continuously sends the full command frame
-        if (p < 0) {
-            protocolString = "nec2";
-            for (int i = 0; i < 62; i++) {
-                if (strcmp(protocolString, protocolDefinitions[i].name) == 0) {
-                    p = i;
-                    break;
-                }
+        if (p < 0) p = findProtocol("nec2");
+    }
+
+    // A subdevice overrides the protocol default for S
+    const bool hasSubdevice = cmd.getSubdevice() >= 0;
+    std::string key = protocolDefinitions[p].name;
+    key += defines;
+    key += hasSubdevice ? "/S" : "";
+
+    for (size_t i = 0; i < templateCache.size(); ++i) {
+        if (templateCache[i].key == key) {
+            // Move to the most recent position
+            if (i + 1 != templateCache.size()) {
+                IrpTemplate hit = std::move(templateCache[i]);
+                templateCache.erase(templateCache.begin() + i);
+                templateCache.push_back(std::move(hit));
             }
-        }  
+            return &templateCache.back();
+        }
     }
 
-    strncat(irp, protocolDefinitions[p].def, sizeof(irp) - strlen(irp) - 1);
+    // IRP string, will contains all necessary infos to generate the IR sequence
+    // Sized to the definition, XMP and Dreambox do not fit in 512 bytes
+    std::string irp = hasSubdevice ? "Device=0.0\n" : "Device=0\n";
+    irp += "Function=0\n";
+    irp += defines;
+    irp += protocolDefinitions[p].def;
+
+    IrpTemplate t;
+    t.key = key;
+    t.irp.reset(new IRP());
+    if (!t.irp->readIrpString(&irp[0])) {
+        // Bad IRP
+        return nullptr;
+    }
 
     // Frequency
+    t.frequency = -1;
     const char* freqStr = strstr(protocolDefinitions[p].def, "Frequency=");
-    if (freqStr != nullptr) {
-        sscanf(freqStr, "Frequency=%d", &frequency);
-        frequency = frequency / 1000; // Convert to kHz for sendRaw
+    if (freqStr != nullptr && sscanf(freqStr, "Frequency=%d", &t.frequency) == 1) {
+        t.frequency = t.frequency / 1000; // Convert to kHz for sendRaw
     }
 
-    // Validate IRP string
-    IRP Irp;
-    if (!Irp.readIrpString(irp)) {
-        // Bad IRP
-        return {};
-    }
+    if (templateCache.size() >= TEMPLATE_CACHE_SIZE) templateCache.erase(templateCache.begin());
+    templateCache.push_back(std::move(t));
+    return &templateCache.back();
+}
+
+const std::vector<float>* generateSequence(const InfraredCommand& cmd, const char* protocolString, int& frequency) {
+    IrpTemplate* t = compileTemplate(cmd, protocolString);
+    if (!t) return nullptr;
+    if (t->frequency >= 0) frequency = t->frequency;
 
     // Set values
-    Irp.m_value['D' - 'A'] = cmd.getDevice();
-    Irp.m_value['S' - 'A'] = cmd.getSubdevice();
-    Irp.m_value['F' - 'A'] = cmd.getFunction();
-    Irp.m_value['N' - 'A'] = -1;
+    IRP& irp = *t->irp;
+    irp.m_value['D' - 'A'] = cmd.getDevice();
+    irp.m_value['S' - 'A'] = cmd.getSubdevice();
+    irp.m_value['F' - 'A'] = cmd.getFunction();
+    irp.m_value['N' - 'A'] = -1;
 
-    // Generate IR sequence
-    int s, r;
-    float* seq = new float[256];
-    Irp.generate(&s, &r, seq);
+    return &irp.generate();
+}
 
-    // Convert to vector for easier handling
-    std::vector<float> result(seq, seq + 2 * (s + r));
-    delete[] seq;
+} // namespace
 
-    return result;
+std::vector<float> encodeRemoteCommand(const InfraredCommand& cmd, const char* protocolString, int& frequency) {
+
+    // Adapted from
+    // https://github.com/probonopd/MakeHex/tree/master
+    // By John Fine
+
+    std::lock_guard<std::mutex> lock(templateMutex);
+    const std::vector<float>* seq = generateSequence(cmd, protocolString, frequency);
+    if (!seq) return {};
+    return *seq;
+}
+
+bool encodeRemoteCommand(const InfraredCommand& cmd, const char* protocolString, int& frequency, std::vector<uint16_t>& out) {
+    // The sequence lives in the shared template, copied out under the lock
+    std::lock_guard<std::mutex> lock(templateMutex);
+    const std::vector<float>* seq = generateSequence(cmd, protocolString, frequency);
+    if (!seq) {
+        out.clear();
+        return false;
+    }
+
+    // Capacity of out is kept between calls
+    out.resize(seq->size());
+    for (size_t i = 0; i < seq->size(); ++i) {
+        out[i] = static_cast<uint16_t>((*seq)[i]);
+    }
+    return true;
 }
 
 unsigned int IRP::reverse(unsigned int Number) {
@@ -137,6 +210,8 @@ IRP::IRP() :
     m_rSuffix(0),
     m_msb(false),
     m_form(0),
+    m_bufr(nullptr),
+    m_next(nullptr),
     m_bitGroup(2)
 {
     memset(m_value, 0, sizeof(m_value));
@@ -180,9 +255,14 @@ void IRP::setDigit(int d) {
 }
 
 bool IRP::readIrpString(char* str) {
+    // Line scratch, only needed while parsing
+    char bufr[1024];
+    m_bufr = bufr;
+
     char* line = strtok(str, "\n");
     while (line != NULL && line[0] != 0) {
-        strcpy(m_bufr, line);
+        strncpy(m_bufr, line, sizeof(bufr) - 1);
+        m_bufr[sizeof(bufr) - 1] = 0;
         line = m_bufr;
 
         Value val;
@@ -256,11 +336,17 @@ bool IRP::readIrpString(char* str) {
         line = strtok(NULL, "\n");
     }
 
-    if (m_device[1] >= 0)
+    if (m_device[1] >= 0) {
+        free((void *)m_def['S' - 'A']);
         m_def['S' - 'A'] = 0;
-    if (m_functions[1] >= 0)
+    }
+    if (m_functions[1] >= 0) {
+        free((void *)m_def['N' - 'A']);
         m_def['N' - 'A'] = 0;
+    }
 
+    m_bufr = nullptr;
+    m_next = nullptr;
     return true;
 }
 
@@ -400,8 +486,21 @@ void IRP::parseVal(Value& result, char*& in, int prec) {
     }
 }
 
+const std::vector<float>& IRP::generate() {
+    int s, r;
+    generateSections(&s, &r);
+    return m_hex;
+}
+
 void IRP::generate(int* s, int* r, float* raw) {
-    m_hex.clear();
+    generateSections(s, r);
+    for (size_t nIndex = 0; nIndex < m_hex.size(); ++nIndex) {
+        raw[nIndex] = m_hex[nIndex];
+    }
+}
+
+void IRP::generateSections(int* s, int* r) {
+    m_hex.clear(); // capacity is kept for the next command
     m_cumulative = 0.0;
     m_pendingBits = (m_msb ? 1 : m_bitGroup);
     int Single = genHex(m_form);
@@ -413,28 +512,8 @@ void IRP::generate(int* s, int* r, float* raw) {
         Single = m_hex.size();
     Single >>= 1;
 
-    int unit;
-    if (m_frequency) {
-        unit = floor(4145146. / m_frequency + 0.5);
-    } else {
-        float mn = m_hex[0];
-        for (int nIndex = 1; nIndex < m_hex.size(); nIndex++)
-            if (mn > m_hex[nIndex])
-                mn = m_hex[nIndex];
-        unit = 4.145146 * .125 * mn + 0.5;
-        unit &= -2;
-    }
-    if (unit <= 0)
-        unit = 1;
-
-    for (int nIndex = 0; nIndex < m_hex.size(); nIndex += 2) {
-        raw[nIndex] = m_hex[nIndex];
-        raw[nIndex + 1] = m_hex[nIndex + 1];
-    }
-
     *s = Single;
     *r = m_hex.size() / 2 - Single;
-    return;
 }
 
 int IRP::genHex(const char* Pattern) {
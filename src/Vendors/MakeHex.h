@@ -27,19 +27,27 @@
 #include <cctype>
 #include <cmath>
 #include <cstdio> 
-#include <vector>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <Data/InfraredProtocolDefinitions.h>
 #include <Models/InfraredCommand.h>
 
 std::vector<float> encodeRemoteCommand(const InfraredCommand& cmd, const char* protocolString, int& frequency);
 
+// Same sequence written to a reusable buffer, each protocol is parsed once and cached
+bool encodeRemoteCommand(const InfraredCommand& cmd, const char* protocolString, int& frequency, std::vector<uint16_t>& out);
+
 class IRP {
 public:
     IRP();
     ~IRP();
+    IRP(const IRP&) = delete;
+    IRP& operator=(const IRP&) = delete;
 
     bool readIrpString(char* str);
     void generate(int* s, int* r, float* raw);
+    const std::vector<float>& generate();
 
 private:
     struct Value {
@@ -51,6 +59,7 @@ private:
     bool match(const char* master);
     void setDigit(int d);
     char* copy();
+    void generateSections(int* s, int* r);
     void getPair(int* result);
     void parseVal(Value& result, char*& in, int prec = 0);
     void genHex(float number);
@@ -68,7 +77,7 @@ private:
     const char* m_rPrefix;
     const char* m_rSuffix;
     const char* m_def[26];
-    char m_bufr[1024];
+    char* m_bufr;
     const char* m_next;
     int m_bitGroup;
     int m_pendingBits;
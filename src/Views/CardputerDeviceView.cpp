@@ -10,4 +10,8 @@ void CardputerDeviceView::drawLogicTrace(uint8_t pin, const std::vector<uint8_t>
 void CardputerDeviceView::drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>& buffer, uint8_t step) {
     M5DeviceView::drawAnalogicTrace(pin, buffer, step);
 }
+
+void CardputerDeviceView::drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) {
+    M5DeviceView::drawWaterfallRow(row, line);
+}
 #endif // DEVICE_CARDPUTER
@@ -22,6 +22,7 @@ public:
     // Only this one is implemented
     void drawLogicTrace(uint8_t pin, const std::vector<uint8_t>& buffer, uint8_t step) override;
     void drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>& buffer, uint8_t step) override;
+    void drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) override;
 };
 
 #endif // DEVICE_CARDPUTER
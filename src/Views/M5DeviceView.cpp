@@ -342,5 +342,27 @@ void M5DeviceView::drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>& bu
     canvas.deleteSprite();
 }
 
+void M5DeviceView::drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) {
+    if (row.empty()) return;
+
+    const int width = M5.Lcd.width();
+    const int height = M5.Lcd.height() - TOP_BAR_SIZE;
+    const int y = TOP_BAR_SIZE + (line % height);
+
+    // Blue (weak) to red (strong)
+    M5.Lcd.startWrite();
+    for (size_t ch = 0; ch < row.size(); ++ch) {
+        int x0 = ch * width / row.size();
+        int x1 = (ch + 1) * width / row.size();
+        uint8_t v = row[ch];
+        uint16_t color = M5.Lcd.color565(v, v < 128 ? v * 2 : (255 - v) * 2, 255 - v);
+        M5.Lcd.drawFastHLine(x0, y, x1 - x0, color);
+    }
+
+    // Cursor on the next line
+    M5.Lcd.drawFastHLine(0, TOP_BAR_SIZE + ((line + 1) % height), width, TEXT_COLOR);
+    M5.Lcd.endWrite();
+}
+
 
 #endif
\ No newline at end of file
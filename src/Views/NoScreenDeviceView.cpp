@@ -20,6 +20,8 @@ void NoScreenDeviceView::drawLogicTrace(uint8_t pin, const std::vector<uint8_t>&
 
 void NoScreenDeviceView::drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>& buffer, uint8_t step) {}
 
+void NoScreenDeviceView::drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) {}
+
 void NoScreenDeviceView::setRotation(uint8_t rotation) {}
 
 void NoScreenDeviceView::topBar(const std::string& title, bool submenu, bool searchBar) {}
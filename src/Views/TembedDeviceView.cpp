@@ -146,6 +146,29 @@ void TembedDeviceView::drawAnalogicTrace(uint8_t pin, const std::vector<uint8_t>
     canvas.deleteSprite();
 }
 
+void TembedDeviceView::drawWaterfallRow(const std::vector<uint8_t>& row, uint16_t line) {
+    if (row.empty()) return;
+
+    const int top = 35;
+    const int width = tft.width();
+    const int height = tft.height() - top;
+    const int y = top + (line % height);
+
+    // Blue (weak) to red (strong)
+    tft.startWrite();
+    for (size_t ch = 0; ch < row.size(); ++ch) {
+        int x0 = ch * width / row.size();
+        int x1 = (ch + 1) * width / row.size();
+        uint8_t v = row[ch];
+        uint16_t color = tft.color565(v, v < 128 ? v * 2 : (255 - v) * 2, 255 - v);
+        tft.drawFastHLine(x0, y, x1 - x0, color);
+    }
+
+    // Cursor on the next line
+    tft.drawFastHLine(0, top + ((line + 1) % height), width, TFT_WHITE);
+    tft.endWrite();
+}
+
 void TembedDeviceView::setRotation(uint8_t rotation) {
     tft.setRotation(rotation);
 }
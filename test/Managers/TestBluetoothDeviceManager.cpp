@@ -0,0 +1,158 @@
+#ifndef TEST_BLUETOOTH_DEVICE_MANAGER_H
+#define TEST_BLUETOOTH_DEVICE_MANAGER_H
+
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "../src/Managers/BluetoothDeviceManager.h"
+
+// Flags AD (general discoverable when connectable) then a name AD of the given type
+static std::vector<uint8_t> bleAdvert(const char* name, bool connectable = true, uint8_t nameType = 0x09) {
+    std::vector<uint8_t> p = { 0x02, 0x01, static_cast<uint8_t>(connectable ? 0x06 : 0x04) };
+    const std::string n = name;
+    p.push_back(static_cast<uint8_t>(n.size() + 1));
+    p.push_back(nameType);
+    p.insert(p.end(), n.begin(), n.end());
+    return p;
+}
+
+static void bleAddr(uint8_t out[6], uint8_t last) {
+    const uint8_t a[6] = { 0xAA, 0xBB, 0xCC, 0x00, 0x00, last };
+    for (int i = 0; i < 6; ++i) out[i] = a[i];
+}
+
+static bool bleHeard(BluetoothDeviceManager& t, uint8_t last, uint32_t nowMs, int8_t rssi = -60,
+                     const char* name = "dev") {
+    uint8_t addr[6];
+    bleAddr(addr, last);
+    const auto p = bleAdvert(name);
+    return t.update(addr, rssi, p.data(), p.size(), nowMs);
+}
+
+static const BluetoothDeviceManager::Device* bleFind(const BluetoothDeviceManager& t, uint8_t last) {
+    uint8_t addr[6];
+    bleAddr(addr, last);
+    return t.find(addr);
+}
+
+void test_bluetooth_device_counters_and_payload() {
+    BluetoothDeviceManager t;
+    t.begin(8, nullptr);
+
+    // New device, same payload again, then a new payload
+    TEST_ASSERT_TRUE(bleHeard(t, 1, 1000, -70, "shortname"));
+    TEST_ASSERT_FALSE(bleHeard(t, 1, 1100, -50, "shortname"));
+    TEST_ASSERT_FALSE(bleHeard(t, 1, 1200, -60, "shortname"));
+    TEST_ASSERT_TRUE(bleHeard(t, 1, 1300, -60, "renamed"));
+
+    const auto* d = bleFind(t, 1);
+    TEST_ASSERT_NOT_NULL(d);
+    TEST_ASSERT_EQUAL_UINT32(4, d->adverts);
+    TEST_ASSERT_EQUAL_UINT32(1, d->payloadChanges);
+    TEST_ASSERT_EQUAL(-70, d->rssiMin);
+    TEST_ASSERT_EQUAL(-50, d->rssiMax);
+    TEST_ASSERT_EQUAL(-60, d->rssiAvg());
+    TEST_ASSERT_EQUAL(100, d->intervalMs);
+    TEST_ASSERT_EQUAL(100, d->minIntervalMs);
+    TEST_ASSERT_EQUAL_STRING("renamed", d->name);
+    TEST_ASSERT_TRUE(d->connectable);
+
+    // A gap longer than any advertising interval does not count as one
+    TEST_ASSERT_FALSE(bleHeard(t, 1, 1300 + BluetoothDeviceManager::MAX_INTERVAL_MS + 1, -60, "renamed"));
+    TEST_ASSERT_EQUAL(100, bleFind(t, 1)->intervalMs);
+
+    // The shortened name does not replace the complete one
+    uint8_t addr[6];
+    bleAddr(addr, 1);
+    const auto shortened = bleAdvert("ren", false, 0x08);
+    TEST_ASSERT_TRUE(t.update(addr, -60, shortened.data(), shortened.size(), 20000));
+    TEST_ASSERT_EQUAL_STRING("renamed", bleFind(t, 1)->name);
+    TEST_ASSERT_FALSE(bleFind(t, 1)->connectable);
+    TEST_ASSERT_EQUAL_UINT32(6, t.adverts());
+}
+
+void test_bluetooth_device_ages_and_evicts() {
+    BluetoothDeviceManager t;
+    t.begin(3, nullptr);
+    bleHeard(t, 1, 0);
+    bleHeard(t, 2, 100);
+    bleHeard(t, 3, 200);
+    bleHeard(t, 1, 300);
+
+    // Full, the device heard the longest ago makes room
+    TEST_ASSERT_TRUE(bleHeard(t, 4, 400));
+    TEST_ASSERT_EQUAL(3, t.size());
+    TEST_ASSERT_EQUAL_UINT32(1, t.evicted());
+    TEST_ASSERT_NULL(bleFind(t, 2));
+    TEST_ASSERT_NOT_NULL(bleFind(t, 1));
+
+    // Stale means strictly older than staleMs
+    TEST_ASSERT_EQUAL(0, t.age(200 + BluetoothDeviceManager::STALE_MS));
+    TEST_ASSERT_EQUAL(1, t.age(200 + BluetoothDeviceManager::STALE_MS + 1));
+    TEST_ASSERT_NULL(bleFind(t, 3));
+    TEST_ASSERT_EQUAL(2, t.age(1000, 100));
+    TEST_ASSERT_EQUAL(0, t.size());
+    TEST_ASSERT_EQUAL_UINT32(3, t.aged());
+
+    // Across the millisecond counter wrap
+    bleHeard(t, 5, 0xFFFFFF00u);
+    TEST_ASSERT_EQUAL(0, t.age(0x100));
+    TEST_ASSERT_EQUAL(1, t.size());
+
+    t.clear();
+    TEST_ASSERT_EQUAL(0, t.size());
+    TEST_ASSERT_EQUAL_UINT32(0, t.evicted());
+    TEST_ASSERT_EQUAL_UINT32(0, t.aged());
+}
+
+void test_bluetooth_device_take_new() {
+    BluetoothDeviceManager t;
+    size_t decodes = 0;
+    t.begin(2, [&](const uint8_t*, size_t len) { decodes++; return "ad " + std::to_string(len); });
+
+    // Discovery order, each device once, with its AD decoded
+    bleHeard(t, 2, 0, -80, "same");
+    bleHeard(t, 1, 10, -40, "same");
+    bleHeard(t, 2, 20, -80, "same");
+    auto rows = t.takeNew();
+    TEST_ASSERT_EQUAL(2, rows.size());
+    TEST_ASSERT_EQUAL(2, rows[0].device.addr[5]);
+    TEST_ASSERT_EQUAL(1, rows[1].device.addr[5]);
+    TEST_ASSERT_EQUAL_UINT32(2, rows[0].device.adverts);
+    TEST_ASSERT_EQUAL_STRING("ad 9", rows[0].ad.c_str());
+    TEST_ASSERT_EQUAL_STRING("ad 9", rows[1].ad.c_str());
+    TEST_ASSERT_EQUAL(1, decodes);     // same payload, decoded once
+    TEST_ASSERT_EQUAL_UINT32(1, t.cacheHits());
+
+    // Known devices are not new again, even with a new payload
+    bleHeard(t, 1, 30, -40, "other");
+    TEST_ASSERT_EQUAL(0, t.takeNew().size());
+
+    // More new devices than the table holds, only the ones still in it are reported
+    bleHeard(t, 3, 40);
+    bleHeard(t, 4, 50);
+    bleHeard(t, 5, 60);
+    rows = t.takeNew();
+    TEST_ASSERT_EQUAL(2, rows.size());
+    TEST_ASSERT_EQUAL(4, rows[0].device.addr[5]);
+    TEST_ASSERT_EQUAL(5, rows[1].device.addr[5]);
+
+    // Aged out before it was taken, then heard again: reported once, as new
+    bleHeard(t, 6, 70);
+    t.age(70 + 1000, 500);
+    TEST_ASSERT_EQUAL(0, t.takeNew().size());
+    bleHeard(t, 6, 2000);
+    rows = t.takeNew();
+    TEST_ASSERT_EQUAL(1, rows.size());
+    TEST_ASSERT_EQUAL(6, rows[0].device.addr[5]);
+    TEST_ASSERT_EQUAL_UINT32(1, rows[0].device.adverts);
+
+    // view() is strongest first and does not consume the new devices
+    bleHeard(t, 7, 2010, -30);
+    const auto view = t.view(5);
+    TEST_ASSERT_EQUAL(2, view.size());
+    TEST_ASSERT_EQUAL(7, view[0].device.addr[5]);
+    TEST_ASSERT_EQUAL(1, t.takeNew().size());
+}
+
+#endif
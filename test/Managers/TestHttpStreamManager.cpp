@@ -0,0 +1,257 @@
+#ifndef TEST_HTTP_STREAM_MANAGER_H
+#define TEST_HTTP_STREAM_MANAGER_H
+
+#include <unity.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Managers/HttpStreamManager.h"
+
+// How the socket hands the body over: 0 random sizes up to 512, otherwise fixed size reads
+static const size_t HTTP_SPLITS[] = { 1, 0, 4096 };
+
+// Feeds the body as it arrives from the socket, returns the emitted lines
+static std::vector<std::string> httpFeed(HttpStreamManager& stream, const std::string& wire, size_t split,
+                                         HttpStreamManager::Mode mode, bool chunked, int64_t contentLength,
+                                         const std::string& filter = "") {
+    std::vector<std::string> lines;
+    stream.begin(mode, chunked, contentLength,
+                 [&lines](const std::string& line) { lines.push_back(line); return true; },
+                 nullptr, filter);
+
+    std::mt19937 rng(static_cast<uint32_t>(wire.size()));
+    size_t off = 0;
+    while (off < wire.size()) {
+        const size_t want = split ? split : 1 + rng() % 512;
+        const size_t n = std::min(want, wire.size() - off);
+        const bool more = stream.feed(reinterpret_cast<const uint8_t*>(wire.data() + off), n);
+        off += n;
+        if (!more) break;
+    }
+    stream.finish();
+    return lines;
+}
+
+// Chunked framing of a body, chunk sizes cycle through `sizes`, every third size line has an extension
+static std::string httpChunked(const std::string& body, const std::vector<size_t>& sizes, const std::string& trailer = "") {
+    std::string out;
+    char head[32];
+    size_t off = 0;
+    for (size_t i = 0; off < body.size(); ++i) {
+        const size_t n = std::min(sizes[i % sizes.size()], body.size() - off);
+        snprintf(head, sizeof(head), i % 3 == 2 ? "%zX;name=\"v\"\r\n" : "%zx\r\n", n);
+        out += head;
+        out.append(body, off, n);
+        out += "\r\n";
+        off += n;
+    }
+    out += "0\r\n";
+    out += trailer;
+    out += "\r\n";
+    return out;
+}
+
+// Search result page with `count` items, and the lines it decodes to
+static std::string httpJsonPage(size_t count, std::vector<std::string>& expected) {
+    std::string body = "{\"total\": " + std::to_string(count) + ", \"results\": [";
+    expected.assign(1, "total = " + std::to_string(count));
+    for (size_t i = 0; i < count; ++i) {
+        const std::string id = std::to_string(i);
+        const std::string p = "results[" + id + "]";
+        if (i) body += ",\n  ";
+        body += "{\"id\":" + id + ",\"score\":-" + id + ".5e-2,\"ok\":" + (i % 2 ? "true" : "false") +
+                ",\"page\":{\"url\":\"http:\\/\\/host\\/p" + id + "\",\"tags\":[\"a\\tb\",null,[]]},\"meta\":{}}";
+        expected.push_back(p + ".id = " + id);
+        expected.push_back(p + ".score = -" + id + ".5e-2");
+        expected.push_back(p + ".ok = " + (i % 2 ? "true" : "false"));
+        expected.push_back(p + ".page.url = \"http://host/p" + id + "\"");
+        expected.push_back(p + ".page.tags[0] = \"a\\tb\"");
+        expected.push_back(p + ".page.tags[1] = null");
+        expected.push_back(p + ".page.tags[2] = []");
+        expected.push_back(p + ".meta = {}");
+    }
+    body += "]}";
+    return body;
+}
+
+void test_http_stream_json_splits() {
+    std::vector<std::string> expected;
+    const std::string body = httpJsonPage(120, expected);
+    TEST_ASSERT_TRUE(body.size() > 3 * 4096);
+
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, body, split, HttpStreamManager::Mode::Json, false, static_cast<int64_t>(body.size()));
+        TEST_ASSERT_EQUAL_STRING("", stream.error().c_str());
+        TEST_ASSERT_TRUE(stream.complete());
+        TEST_ASSERT_EQUAL(expected.size(), lines.size());
+        TEST_ASSERT_TRUE(lines == expected);
+        TEST_ASSERT_TRUE(stream.bodyBytes() == body.size());
+        TEST_ASSERT_EQUAL(0, stream.truncated());
+    }
+
+    // Escapes, surrogate pairs and lone surrogates, a bare number as the whole body
+    const std::string text = "{\"k\\u00e9y\":\"\\\"q\\\" \\u4e2d \\ud83d\\ude00 \\ud800x \\ud800\\u0041\",\"n\":[0,-1.25E+3]}\n42";
+    const std::vector<std::string> textLines = {
+        "k\xC3\xA9y = \"\\\"q\\\" \xE4\xB8\xAD \xF0\x9F\x98\x80 \xEF\xBF\xBDx \xEF\xBF\xBD" "A\"",
+        "n[0] = 0",
+        "n[1] = -1.25E+3",
+        "$ = 42",
+    };
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, text, split, HttpStreamManager::Mode::Json, false, -1);
+        TEST_ASSERT_EQUAL_STRING("", stream.error().c_str());
+        TEST_ASSERT_TRUE(lines == textLines);
+    }
+
+    // A string longer than MAX_TOKEN is cut and marked
+    const std::string longBody = "{\"s\":\"" + std::string(400, 'x') + "\"}";
+    HttpStreamManager cut;
+    const auto cutLines = httpFeed(cut, longBody, 1, HttpStreamManager::Mode::Json, false, -1);
+    TEST_ASSERT_EQUAL(1, cutLines.size());
+    TEST_ASSERT_TRUE(cutLines[0] == "s = \"" + std::string(HttpStreamManager::MAX_TOKEN, 'x') + "...\"");
+    TEST_ASSERT_EQUAL(1, cut.truncated());
+}
+
+void test_http_stream_json_filter_and_ndjson() {
+    std::vector<std::string> expected;
+    const std::string body = httpJsonPage(40, expected);
+
+    std::vector<std::string> urls;
+    for (const auto& line : expected) {
+        if (line.find(".page.url = ") != std::string::npos) urls.push_back(line);
+    }
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, body, split, HttpStreamManager::Mode::Json, false, -1, "results[*].page.url");
+        TEST_ASSERT_EQUAL_STRING("", stream.error().c_str());
+        TEST_ASSERT_TRUE(lines == urls);
+        TEST_ASSERT_EQUAL(expected.size(), stream.values());   // every value is parsed, only matches are emitted
+    }
+
+    HttpStreamManager one;
+    const auto third = httpFeed(one, body, 4096, HttpStreamManager::Mode::Json, false, -1, "$.results[3].id");
+    TEST_ASSERT_EQUAL(1, third.size());
+    TEST_ASSERT_EQUAL_STRING("results[3].id = 3", third[0].c_str());
+
+    // Newline delimited documents, each starts again at the root
+    std::string ndjson;
+    std::vector<std::string> events;
+    for (int i = 0; i < 300; ++i) {
+        ndjson += "{\"seq\":" + std::to_string(i) + ",\"ev\":\"tick\"}\r\n";
+        events.push_back("seq = " + std::to_string(i));
+        events.push_back("ev = \"tick\"");
+    }
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, ndjson, split, HttpStreamManager::Mode::Json, false, -1);
+        TEST_ASSERT_EQUAL_STRING("", stream.error().c_str());
+        TEST_ASSERT_TRUE(lines == events);
+    }
+
+    std::vector<std::string> segments;
+    TEST_ASSERT_TRUE(HttpStreamManager::parseFilter("items[*].id", segments));
+    TEST_ASSERT_EQUAL(3, segments.size());
+    TEST_ASSERT_EQUAL_STRING("*", segments[1].c_str());
+    TEST_ASSERT_FALSE(HttpStreamManager::parseFilter("items[].id", segments));
+    TEST_ASSERT_FALSE(HttpStreamManager::parseFilter("a..b", segments));
+    TEST_ASSERT_FALSE(HttpStreamManager::parseFilter("a.", segments));
+}
+
+void test_http_stream_chunked_splits() {
+    std::vector<std::string> expected;
+    const std::string body = httpJsonPage(60, expected);
+    const std::string wire = httpChunked(body, { 1, 4096, 17, 300, 2 }, "X-Checksum: 1\r\nX-Other: 2\r\n");
+
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, wire + "GET / HTTP/1.1\r\n", split, HttpStreamManager::Mode::Json, true, -1);
+        TEST_ASSERT_EQUAL_STRING("", stream.error().c_str());
+        TEST_ASSERT_TRUE(stream.complete());
+        TEST_ASSERT_TRUE(lines == expected);
+        TEST_ASSERT_TRUE(stream.bodyBytes() == body.size());    // framing and what follows the last chunk left out
+    }
+
+    // Text mode, lines split across chunk boundaries, CRLF stripped, a last line with no newline
+    const std::string text = "first line\r\nsecond\n\nthird without newline";
+    const std::string textWire = httpChunked(text, { 3, 1, 5 });
+    for (size_t split : HTTP_SPLITS) {
+        HttpStreamManager stream;
+        const auto lines = httpFeed(stream, textWire, split, HttpStreamManager::Mode::Text, true, -1);
+        TEST_ASSERT_TRUE(stream.complete());
+        TEST_ASSERT_TRUE(lines == std::vector<std::string>({ "first line", "second", "", "third without newline" }));
+    }
+
+    // Raw mode passes the body through without the framing
+    std::string raw(5000, '\0');
+    for (size_t i = 0; i < raw.size(); ++i) raw[i] = static_cast<char>(i * 7);
+    const std::string rawWire = httpChunked(raw, { 1000, 4096, 1 });
+    for (size_t split : HTTP_SPLITS) {
+        std::string got;
+        HttpStreamManager stream;
+        stream.begin(HttpStreamManager::Mode::Raw, true, -1, nullptr,
+                     [&got](const uint8_t* data, size_t len) { got.append(reinterpret_cast<const char*>(data), len); return true; });
+        std::mt19937 rng(5);
+        for (size_t off = 0; off < rawWire.size();) {
+            const size_t n = std::min(split ? split : 1 + rng() % 512, rawWire.size() - off);
+            stream.feed(reinterpret_cast<const uint8_t*>(rawWire.data() + off), n);
+            off += n;
+        }
+        stream.finish();
+        TEST_ASSERT_FALSE(stream.failed());
+        TEST_ASSERT_TRUE(got == raw);
+    }
+}
+
+void test_http_stream_bad_framing() {
+    std::vector<std::string> expected;
+    const std::string body = httpJsonPage(5, expected);
+    const std::string wire = httpChunked(body, { 64 });
+
+    for (size_t split : HTTP_SPLITS) {
+        // A chunk longer than its size line says
+        std::string overrun = wire;
+        overrun.insert(wire.find("\r\n") + 2 + 64, "x");
+        HttpStreamManager a;
+        httpFeed(a, overrun, split, HttpStreamManager::Mode::Json, true, -1);
+        TEST_ASSERT_TRUE(a.failed());
+
+        // A size line that is not hex
+        HttpStreamManager b;
+        httpFeed(b, "zz\r\n" + wire, split, HttpStreamManager::Mode::Json, true, -1);
+        TEST_ASSERT_TRUE(b.failed());
+
+        // Connection closed before the last chunk
+        HttpStreamManager c;
+        httpFeed(c, wire.substr(0, wire.size() / 2), split, HttpStreamManager::Mode::Text, true, -1);
+        TEST_ASSERT_TRUE(c.failed());
+        TEST_ASSERT_FALSE(c.complete());
+
+        // Content-Length shorter than the JSON, the rest is not read
+        HttpStreamManager d;
+        httpFeed(d, body, split, HttpStreamManager::Mode::Json, false, static_cast<int64_t>(body.size() - 10));
+        TEST_ASSERT_TRUE(d.failed());
+        TEST_ASSERT_TRUE(d.bodyBytes() == body.size() - 10);
+    }
+
+    // A sink asking to stop ends the stream without an error
+    size_t seen = 0;
+    HttpStreamManager stop;
+    stop.begin(HttpStreamManager::Mode::Json, false, -1,
+               [&seen](const std::string&) { return ++seen < 3; });
+    TEST_ASSERT_FALSE(stop.feed(reinterpret_cast<const uint8_t*>(body.data()), body.size()));
+    stop.finish();
+    TEST_ASSERT_TRUE(stop.stopped());
+    TEST_ASSERT_FALSE(stop.failed());
+    TEST_ASSERT_EQUAL(3, seen);
+
+    // Nesting deeper than MAX_DEPTH
+    HttpStreamManager deep;
+    httpFeed(deep, std::string(HttpStreamManager::MAX_DEPTH + 1, '['), 1, HttpStreamManager::Mode::Json, false, -1);
+    TEST_ASSERT_TRUE(deep.failed());
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef TEST_ICMP_SWEEP_MANAGER_H
+#define TEST_ICMP_SWEEP_MANAGER_H
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../src/Managers/ICMPSweepManager.h"
+
+// Echo reply for a request, as the target would answer it
+static std::vector<uint8_t> icmpReplyFor(const uint8_t* request, size_t len, bool withIpHeader = false) {
+    std::vector<uint8_t> reply(request, request + len);
+    reply[0] = 0;
+    reply[2] = reply[3] = 0;
+    const uint16_t sum = ICMPSweepManager::checksum(reply.data(), reply.size());
+    reply[2] = sum >> 8;
+    reply[3] = sum & 0xFF;
+    if (withIpHeader) {
+        uint8_t ip[20] = { 0x45 };
+        ip[9] = 1;
+        reply.insert(reply.begin(), ip, ip + sizeof(ip));
+    }
+    return reply;
+}
+
+struct IcmpSent {
+    std::vector<uint8_t> packet;
+    uint32_t addr = 0;
+};
+
+void test_icmp_sweep_classifies_replies() {
+    ICMPSweepManager sweep;
+    ICMPSweepManager::Config config;
+    config.rounds = 2;
+    config.rate = 1000;
+    config.timeoutMs = 500;
+    const std::vector<uint32_t> targets = { 0x0A000001, 0x0A000002, 0x0A000003 };
+    uint64_t now = 1000000;
+    TEST_ASSERT_TRUE(sweep.begin(config, targets, now));
+
+    // Round robin over the hosts, one request per ms
+    std::vector<IcmpSent> sent;
+    uint8_t buf[64];
+    size_t len = 0;
+    uint32_t addr = 0;
+    TEST_ASSERT_TRUE(sweep.nextRequest(now, buf, sizeof(buf), len, addr));
+    sent.push_back({ std::vector<uint8_t>(buf, buf + len), addr });
+    TEST_ASSERT_FALSE(sweep.nextRequest(now + 999, buf, sizeof(buf), len, addr));
+    while (sent.size() < 6) {
+        now += 1000;
+        TEST_ASSERT_TRUE(sweep.nextRequest(now, buf, sizeof(buf), len, addr));
+        sent.push_back({ std::vector<uint8_t>(buf, buf + len), addr });
+    }
+    TEST_ASSERT_FALSE(sweep.nextRequest(now + 5000, buf, sizeof(buf), len, addr));
+    TEST_ASSERT_EQUAL(ICMPSweepManager::ECHO_HEADER + config.payloadLen, sent[0].packet.size());
+    TEST_ASSERT_EQUAL_UINT32(0, ICMPSweepManager::checksum(sent[0].packet.data(), sent[0].packet.size()));
+    for (size_t i = 0; i < sent.size(); ++i) TEST_ASSERT_EQUAL_UINT32(targets[i % 3], sent[i].addr);
+
+    // Good replies, raw socket style with the IPv4 header in front
+    now += 2000;
+    auto r0 = icmpReplyFor(sent[0].packet.data(), sent[0].packet.size(), true);
+    TEST_ASSERT_EQUAL(0, sweep.onReply(r0.data(), r0.size(), targets[0], now));
+    auto r4 = icmpReplyFor(sent[4].packet.data(), sent[4].packet.size());
+    TEST_ASSERT_EQUAL(1, sweep.onReply(r4.data(), r4.size(), targets[1], now));
+
+    // Duplicate
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(r0.data(), r0.size(), targets[0], now + 10));
+    TEST_ASSERT_EQUAL(1, sweep.hosts()[0].duplicates);
+    TEST_ASSERT_EQUAL(1, sweep.hosts()[0].received);
+
+    // Wrong source, bad checksum, sequence never sent: stray
+    auto r1 = icmpReplyFor(sent[1].packet.data(), sent[1].packet.size());
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(r1.data(), r1.size(), targets[2], now));
+    auto bad = r1;
+    bad.back() ^= 0x40;
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(bad.data(), bad.size(), targets[1], now));
+    auto unsent = r1;
+    unsent[7] = 40;
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(unsent.data(), unsent.size(), targets[1], now));
+    TEST_ASSERT_EQUAL_UINT32(3, sweep.stray());
+
+    // Another ping session or not a reply at all: ignored, not stray
+    auto other = icmpReplyFor(sent[1].packet.data(), sent[1].packet.size());
+    other[4] ^= 0xFF;
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(other.data(), other.size(), targets[1], now));
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(sent[1].packet.data(), sent[1].packet.size(), targets[1], now));
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(r1.data(), 4, targets[1], now));
+    TEST_ASSERT_EQUAL_UINT32(3, sweep.stray());
+
+    // The real reply of host 1 still counts after the strays
+    TEST_ASSERT_EQUAL(1, sweep.onReply(r1.data(), r1.size(), targets[1], now));
+
+    // Late: after the timeout, counted once, later copies are duplicates
+    auto r2 = icmpReplyFor(sent[2].packet.data(), sent[2].packet.size());
+    const uint64_t late = now + 600000;
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(r2.data(), r2.size(), targets[2], late));
+    TEST_ASSERT_EQUAL(1, sweep.hosts()[2].late);
+    TEST_ASSERT_EQUAL(0, sweep.hosts()[2].received);
+    TEST_ASSERT_EQUAL(-1, sweep.onReply(r2.data(), r2.size(), targets[2], late));
+    TEST_ASSERT_EQUAL(1, sweep.hosts()[2].duplicates);
+
+    TEST_ASSERT_EQUAL(2, sweep.responders());
+    TEST_ASSERT_EQUAL(2, sweep.hosts()[1].received);
+    TEST_ASSERT_EQUAL(2, sweep.hosts()[1].sent);
+    TEST_ASSERT_EQUAL_UINT32(3, sweep.overall().count());
+
+    // Not done until the last request times out, unless every request was answered
+    TEST_ASSERT_FALSE(sweep.done(now));
+    TEST_ASSERT_TRUE(sweep.done(sweep.nextEventUs()));
+}
+
+void test_icmp_sweep_rtt_statistics() {
+    ICMPSweepManager sweep;
+    ICMPSweepManager::Config config;
+    config.rounds = 100;
+    config.rate = 100;
+    config.timeoutMs = 2000;
+    uint64_t now = 0;
+    TEST_ASSERT_TRUE(sweep.begin(config, { 0xC0A80001 }, now));
+
+    // 89 replies at 10 ms, 10 at 40 ms, 1 at 200 ms
+    uint8_t buf[64];
+    size_t len = 0;
+    uint32_t addr = 0;
+    for (int i = 0; i < 100; ++i) {
+        now = static_cast<uint64_t>(i) * 10000;
+        TEST_ASSERT_TRUE(sweep.nextRequest(now, buf, sizeof(buf), len, addr));
+        const uint32_t rtt = i == 50 ? 200000 : (i % 10 == 9 ? 40000 : 10000);
+        auto reply = icmpReplyFor(buf, len);
+        TEST_ASSERT_EQUAL(0, sweep.onReply(reply.data(), reply.size(), addr, now + rtt));
+    }
+    TEST_ASSERT_TRUE(sweep.done(now + 1));
+
+    const auto& h = sweep.hosts()[0];
+    TEST_ASSERT_EQUAL(100, h.received);
+    TEST_ASSERT_EQUAL_UINT32(10000, h.minUs);
+    TEST_ASSERT_EQUAL_UINT32(200000, h.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(14900, h.meanUs());
+    TEST_ASSERT_TRUE(h.jitterUs > 0 && h.jitterUs < 30000);
+
+    // Percentiles land in the right bucket, a bucket is 1/4 of a power of two wide
+    const uint32_t p50 = sweep.percentileUs(0, 50.f);
+    const uint32_t p95 = sweep.percentileUs(0, 95.f);
+    const uint32_t p99 = sweep.percentileUs(0, 99.f);
+    TEST_ASSERT_TRUE(p50 >= 10000 * 8 / 10 && p50 <= 10000 * 12 / 10);
+    TEST_ASSERT_TRUE(p95 >= 40000 * 8 / 10 && p95 <= 40000 * 12 / 10);
+    TEST_ASSERT_TRUE(p99 >= 40000 * 8 / 10 && p99 <= 40000 * 12 / 10);
+    TEST_ASSERT_EQUAL_UINT32(200000, sweep.percentileUs(0, 100.f));   // clamped to the max
+    TEST_ASSERT_EQUAL_UINT32(10000, sweep.percentileUs(0, 0.f));      // clamped to the min
+}
+
+void test_icmp_sweep_histogram_buckets() {
+    using H = ICMPSweepManager::Histogram;
+    TEST_ASSERT_EQUAL(0, H::bucket(0));
+    TEST_ASSERT_EQUAL(0, H::bucket(64));
+    TEST_ASSERT_EQUAL(1, H::bucket(80));
+    TEST_ASSERT_EQUAL(4, H::bucket(128));
+    TEST_ASSERT_EQUAL(ICMPSweepManager::HIST_BUCKETS - 1, H::bucket(0xFFFFFFFFu));
+
+    // Every value sits between the bounds of its bucket
+    for (uint32_t us = 64; us < 4000000; us = us * 9 / 8 + 1) {
+        const size_t b = H::bucket(us);
+        TEST_ASSERT_TRUE(H::lower(b) <= us && us < H::lower(b + 1));
+    }
+
+    H empty;
+    TEST_ASSERT_EQUAL_UINT32(0, empty.percentile(50.f));
+
+    H h;
+    for (int i = 0; i < 99; ++i) h.add(1000);
+    h.add(100000);
+    TEST_ASSERT_EQUAL_UINT32(100, h.count());
+    const size_t b = H::bucket(1000);
+    TEST_ASSERT_EQUAL_UINT32((H::lower(b) + H::lower(b + 1)) / 2, h.percentile(99.f));
+    TEST_ASSERT_TRUE(h.percentile(100.f) > 80000);
+
+    // Rounds x hosts must fit the 16 bit sequence
+    ICMPSweepManager sweep;
+    ICMPSweepManager::Config config;
+    config.rounds = 2;
+    TEST_ASSERT_FALSE(sweep.begin(config, std::vector<uint32_t>(40000, 1), 0));
+    TEST_ASSERT_FALSE(sweep.begin(config, {}, 0));
+    TEST_ASSERT_TRUE(sweep.begin(config, std::vector<uint32_t>(32768, 1), 0));
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TEST_INFRARED_LEARN_MANAGER_H
+#define TEST_INFRARED_LEARN_MANAGER_H
+
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "../src/Managers/InfraredLearnManager.h"
+
+using IrOutcome = InfraredLearnManager::Outcome;
+
+// Undecoded capture, NEC style pulse distance timings of a 32 bit code, stretched by pct
+static std::vector<uint16_t> irLearnRaw(uint32_t code, uint32_t pct = 100) {
+    std::vector<uint16_t> t = { 9000, 4500 };
+    for (int b = 0; b < 32; ++b) {
+        t.push_back(560);
+        t.push_back((code >> b) & 1 ? 1690 : 560);
+    }
+    t.push_back(560);
+    t.push_back(40000);
+    for (auto& d : t) d = static_cast<uint16_t>(d * pct / 100);
+    return t;
+}
+
+static IrOutcome irLearnDecoded(InfraredLearnManager& s, uint32_t nowMs, int16_t function, bool repeat = false,
+                                size_t* duplicateOf = nullptr) {
+    const InfraredCommand cmd(InfraredProtocolEnum::_NEC, 4, -1, function);
+    return s.feed(nowMs, cmd, repeat, nullptr, 0, 38, duplicateOf);
+}
+
+static IrOutcome irLearnRawFrame(InfraredLearnManager& s, uint32_t nowMs, const std::vector<uint16_t>& t,
+                                 size_t* duplicateOf = nullptr) {
+    return s.feed(nowMs, InfraredCommand(), false, t.data(), t.size(), 38, duplicateOf);
+}
+
+void test_infrared_learn_segments_presses() {
+    InfraredLearnManager s;
+    s.begin({ "power", "vol_up" });
+    TEST_ASSERT_EQUAL_STRING("power", s.nextName().c_str());
+
+    // A held button, the frame then repeat codes every 110 ms, the gap runs from the last one
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1000, 8) == IrOutcome::Learned);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1110, 8, true) == IrOutcome::Repeat);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1220, 8, true) == IrOutcome::Repeat);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1500, 8) == IrOutcome::Repeat);     // full frame resent while held
+    TEST_ASSERT_EQUAL(1, s.buttons().size());
+
+    // Next press after the gap
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1500 + InfraredLearnManager::PRESS_GAP_MS, 9) == IrOutcome::Learned);
+    TEST_ASSERT_EQUAL(2, s.buttons().size());
+    TEST_ASSERT_EQUAL_STRING("power", s.buttons()[0].name.c_str());
+    TEST_ASSERT_EQUAL_STRING("vol_up", s.buttons()[1].name.c_str());
+    TEST_ASSERT_EQUAL(9, s.buttons()[1].command.getFunction());
+    TEST_ASSERT_TRUE(s.buttons()[1].timings.empty());
+    TEST_ASSERT_EQUAL_STRING("button_3", s.nextName().c_str());
+    TEST_ASSERT_EQUAL_UINT32(5, s.frames());
+    TEST_ASSERT_EQUAL_UINT32(2, s.presses());
+
+    // Millisecond counter wrap inside a press
+    InfraredLearnManager wrap;
+    wrap.begin({});
+    TEST_ASSERT_TRUE(irLearnDecoded(wrap, 0xFFFFFFF0u, 1) == IrOutcome::Learned);
+    TEST_ASSERT_TRUE(irLearnDecoded(wrap, 0x60, 1, true) == IrOutcome::Repeat);
+    TEST_ASSERT_EQUAL_STRING("button_2", wrap.nextName().c_str());
+}
+
+void test_infrared_learn_ignored_frames_open_no_press() {
+    InfraredLearnManager s;
+    s.begin({ "a", "b", "c" });
+
+    // An orphan repeat code, then the real frame right after it is still learned
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1000, 8, true) == IrOutcome::Ignored);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1050, 8) == IrOutcome::Learned);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 1160, 8, true) == IrOutcome::Repeat);
+
+    // Noise too short for a signature, then a raw press within the gap
+    const uint16_t noise[] = { 300, 200, 300 };
+    TEST_ASSERT_TRUE(s.feed(3000, InfraredCommand(), false, noise, 3, 38) == IrOutcome::Ignored);
+    const auto raw = irLearnRaw(0xF708FB04);
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 3100, raw) == IrOutcome::Learned);
+    TEST_ASSERT_TRUE(s.buttons()[1].timings == raw);
+    TEST_ASSERT_TRUE(s.buttons()[1].command.getProtocol() == InfraredProtocolEnum::RAW);
+
+    // Anything within the gap of an accepted press is one of its repeats and keeps it open
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 3300, raw) == IrOutcome::Repeat);
+    TEST_ASSERT_TRUE(s.feed(3500, InfraredCommand(), false, noise, 3, 38) == IrOutcome::Repeat);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 3500 + InfraredLearnManager::PRESS_GAP_MS - 1, 10) == IrOutcome::Repeat);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 3799 + InfraredLearnManager::PRESS_GAP_MS, 10) == IrOutcome::Learned);
+
+    TEST_ASSERT_EQUAL(3, s.buttons().size());
+    TEST_ASSERT_EQUAL_UINT32(3, s.presses());
+    TEST_ASSERT_EQUAL_UINT32(9, s.frames());
+}
+
+void test_infrared_learn_duplicates() {
+    InfraredLearnManager s;
+    s.begin({ "power" });
+    const auto raw = irLearnRaw(0xBF40FF00);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 0, 8) == IrOutcome::Learned);
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 1000, raw) == IrOutcome::Learned);
+
+    // Same decoded command, its repeats belong to the duplicate press
+    size_t dup = 99;
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 2000, 8, false, &dup) == IrOutcome::Duplicate);
+    TEST_ASSERT_EQUAL(0, dup);
+    TEST_ASSERT_TRUE(irLearnDecoded(s, 2110, 8, true) == IrOutcome::Repeat);
+
+    // Another device with the same function is a new button
+    const InfraredCommand other(InfraredProtocolEnum::_NEC, 5, -1, 8);
+    TEST_ASSERT_TRUE(s.feed(3000, other, false, nullptr, 0, 38) == IrOutcome::Learned);
+
+    // The raw button read 5% slower matches within the duplicate score, a different code does not
+    dup = 99;
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 4000, irLearnRaw(0xBF40FF00, 105), &dup) == IrOutcome::Duplicate);
+    TEST_ASSERT_EQUAL(1, dup);
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 5000, irLearnRaw(~0xBF40FF00u)) == IrOutcome::Learned);
+
+    TEST_ASSERT_EQUAL(4, s.buttons().size());
+    TEST_ASSERT_EQUAL_STRING("button_2", s.buttons()[1].name.c_str());
+    TEST_ASSERT_EQUAL_UINT32(6, s.presses());
+
+    // begin() starts a new session
+    s.begin({});
+    TEST_ASSERT_EQUAL(0, s.buttons().size());
+    TEST_ASSERT_TRUE(irLearnRawFrame(s, 5010, raw) == IrOutcome::Learned);
+
+    const auto names = InfraredLearnManager::splitNames(" power , ,vol up,\tmute\t,");
+    TEST_ASSERT_EQUAL(3, names.size());
+    TEST_ASSERT_EQUAL_STRING("power", names[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("vol up", names[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("mute", names[2].c_str());
+}
+
+#endif
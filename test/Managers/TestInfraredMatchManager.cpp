@@ -0,0 +1,207 @@
+#ifndef TEST_INFRARED_MATCH_MANAGER_H
+#define TEST_INFRARED_MATCH_MANAGER_H
+
+#include <unity.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Managers/InfraredMatchManager.h"
+
+// Raw captures as the receiver gives them, mark first, in microseconds
+struct IrCapture {
+    std::mt19937 rng{1};
+    uint32_t jitterPct = 0;             // uniform +-jitterPct of each duration
+    std::vector<uint16_t> timings;
+
+    void push(uint32_t us) {
+        if (jitterPct) {
+            const int32_t span = static_cast<int32_t>(us * jitterPct / 100);
+            us += static_cast<int32_t>(rng() % (2 * span + 1)) - span;
+        }
+        timings.push_back(static_cast<uint16_t>(us > 65535 ? 65535 : us));
+    }
+
+    // NEC frame, 32 bits lsb first, then the gap
+    void nec(uint32_t code, uint32_t gap = 40000) {
+        push(9000);
+        push(4500);
+        for (int b = 0; b < 32; ++b) {
+            push(560);
+            push((code >> b) & 1 ? 1690 : 560);
+        }
+        push(560);
+        push(gap);
+    }
+
+    // Sony SIRC 12 bits, pulse width coding on the marks
+    void sony(uint32_t code) {
+        push(2400);
+        for (int b = 0; b < 12; ++b) {
+            push(600);
+            push((code >> b) & 1 ? 1200 : 600);
+        }
+        push(25000);
+    }
+};
+
+static std::vector<uint16_t> irNec(uint32_t code, uint32_t jitterPct = 0, uint32_t seed = 1) {
+    IrCapture c;
+    c.rng.seed(seed);
+    c.jitterPct = jitterPct;
+    c.nec(code);
+    c.nec(code);                        // a repeat after the gap is not part of the signature
+    return c.timings;
+}
+
+static const uint32_t IR_CODES[] = { 0xF708FB04, 0xE718FB04, 0xBF40FF00, 0xBA45FF00, 0xB946FF00, 0xE619FF00 };
+
+void test_infrared_match_signature() {
+    InfraredMatchManager::Signature sig;
+    const auto frame = irNec(IR_CODES[0]);
+    TEST_ASSERT_TRUE(InfraredMatchManager::signature(frame.data(), frame.size(), sig));
+    TEST_ASSERT_EQUAL(67, sig.levels.size());     // header, 32 bits, stop mark, no gap
+    TEST_ASSERT_EQUAL(InfraredMatchManager::level(9000), sig.levels[0]);
+    TEST_ASSERT_EQUAL(InfraredMatchManager::level(560), sig.levels[66]);
+
+    // The level table round trips within a level step, ~3%
+    for (uint32_t us : {100u, 560u, 1690u, 9000u, 20000u}) {
+        const uint32_t back = InfraredMatchManager::levelUs(InfraredMatchManager::level(us));
+        TEST_ASSERT_TRUE(back * 100 >= us * 97 && back * 100 <= us * 103);
+    }
+
+    // A glitch splitting a space is merged back, same durations and hash
+    auto glitched = frame;
+    glitched[3] = 500;
+    glitched.insert(glitched.begin() + 4, { 30, 30 });
+    InfraredMatchManager::Signature merged;
+    TEST_ASSERT_TRUE(InfraredMatchManager::signature(glitched.data(), glitched.size(), merged));
+    TEST_ASSERT_EQUAL(sig.levels.size(), merged.levels.size());
+    TEST_ASSERT_EQUAL_UINT32(sig.hash, merged.hash);
+
+    // Small jitter rounds to the same base units
+    const auto jittered = irNec(IR_CODES[0], 3, 7);
+    InfraredMatchManager::Signature close;
+    TEST_ASSERT_TRUE(InfraredMatchManager::signature(jittered.data(), jittered.size(), close));
+    TEST_ASSERT_EQUAL_UINT32(sig.hash, close.hash);
+
+    // Another code hashes apart
+    const auto other = irNec(IR_CODES[1]);
+    InfraredMatchManager::Signature different;
+    TEST_ASSERT_TRUE(InfraredMatchManager::signature(other.data(), other.size(), different));
+    TEST_ASSERT_TRUE(sig.hash != different.hash);
+
+    // Too short to recognize
+    const uint16_t tiny[] = { 9000, 4500, 560, 40000 };
+    TEST_ASSERT_FALSE(InfraredMatchManager::signature(tiny, 4, sig));
+    TEST_ASSERT_TRUE(sig.levels.empty());
+    TEST_ASSERT_FALSE(InfraredMatchManager::signature(nullptr, 10, sig));
+}
+
+void test_infrared_match_tolerates_jitter() {
+    InfraredMatchManager index;
+    for (size_t i = 0; i < sizeof(IR_CODES) / sizeof(IR_CODES[0]); ++i) {
+        const auto t = irNec(IR_CODES[i]);
+        TEST_ASSERT_TRUE(index.add("/ir/tv.ir", "btn" + std::to_string(i), t.data(), t.size()));
+    }
+    IrCapture sony;
+    sony.sony(0x095);
+    TEST_ASSERT_TRUE(index.add("/ir/sony.ir", "power", sony.timings.data(), sony.timings.size()));
+    TEST_ASSERT_EQUAL(2, index.files().size());
+    TEST_ASSERT_EQUAL(7, index.entries().size());
+
+    // 20% jitter usually breaks the hash, the length scan still finds the button
+    uint32_t found = 0;
+    const uint32_t runs = 60;
+    for (uint32_t seed = 1; seed <= runs; ++seed) {
+        const size_t want = seed % (sizeof(IR_CODES) / sizeof(IR_CODES[0]));
+        const auto capture = irNec(IR_CODES[want], 20, seed);
+        const auto results = index.match(capture.data(), capture.size());
+        if (!results.empty() && results[0].entry == want) found++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(runs, found);
+
+    // Short durations use the absolute tolerance, 560 read as 660 is still a match
+    auto shifted = irNec(IR_CODES[2]);
+    for (size_t i = 2; i < 66; i += 2) shifted[i] += 100;
+    const auto results = index.match(shifted.data(), shifted.size());
+    TEST_ASSERT_FALSE(results.empty());
+    TEST_ASSERT_EQUAL(2, results[0].entry);
+    TEST_ASSERT_TRUE(results[0].score == 1.f);
+}
+
+void test_infrared_match_scoring_order() {
+    InfraredMatchManager index;
+
+    // Same code stretched by 6%, then the exact one, then one bit apart
+    IrCapture stretched;
+    stretched.nec(IR_CODES[3]);
+    for (auto& t : stretched.timings) t = static_cast<uint16_t>(t * 106 / 100);
+    const auto exact = irNec(IR_CODES[3]);
+    const auto oneBit = irNec(IR_CODES[3] ^ 0x00010000);
+    TEST_ASSERT_TRUE(index.add("/ir/a.ir", "stretched", stretched.timings.data(), stretched.timings.size()));
+    TEST_ASSERT_TRUE(index.add("/ir/a.ir", "exact", exact.data(), exact.size()));
+    TEST_ASSERT_TRUE(index.add("/ir/b.ir", "one bit", oneBit.data(), oneBit.size()));
+    TEST_ASSERT_EQUAL(2, index.files().size());
+    TEST_ASSERT_EQUAL(0, index.entries()[1].file);
+    TEST_ASSERT_EQUAL(1, index.entries()[2].file);
+
+    // Exact capture, the stretched copy rounds to the same base units and shares the hash,
+    // equal scores are ordered by the level error, the one bit entry is not scored
+    auto results = index.match(exact.data(), exact.size());
+    TEST_ASSERT_EQUAL(2, results.size());
+    TEST_ASSERT_EQUAL_STRING("exact", index.entries()[results[0].entry].name.c_str());
+    TEST_ASSERT_EQUAL_STRING("stretched", index.entries()[results[1].entry].name.c_str());
+    TEST_ASSERT_TRUE(results[0].score == 1.f && results[1].score == 1.f);
+    TEST_ASSERT_TRUE(results[0].error == 0.f && results[1].error > 0.f);
+
+    // Off the base unit grid there is no hash hit, every entry of the length is scored
+    // and the full scores come before the one bit difference
+    IrCapture slow;
+    slow.nec(IR_CODES[3]);
+    for (auto& t : slow.timings) t = static_cast<uint16_t>(t * 102 / 100);
+    slow.timings[0] = 9600;             // header off the base unit grid
+    results = index.match(slow.timings.data(), slow.timings.size(), 0.9f, 5);
+    TEST_ASSERT_EQUAL(3, results.size());
+    TEST_ASSERT_TRUE(results[0].score == 1.f && results[1].score == 1.f);
+    TEST_ASSERT_TRUE(results[0].error <= results[1].error);
+    TEST_ASSERT_EQUAL_STRING("one bit", index.entries()[results[2].entry].name.c_str());
+    TEST_ASSERT_TRUE(results[2].score < 1.f && results[2].score > 0.98f);
+
+    // Capped to maxResults
+    TEST_ASSERT_EQUAL(1, index.match(slow.timings.data(), slow.timings.size(), 0.9f, 1).size());
+}
+
+void test_infrared_match_no_match() {
+    InfraredMatchManager index;
+    for (size_t i = 0; i < sizeof(IR_CODES) / sizeof(IR_CODES[0]); ++i) {
+        const auto t = irNec(IR_CODES[i]);
+        index.add("/ir/tv.ir", "btn" + std::to_string(i), t.data(), t.size());
+    }
+
+    // Another protocol, far from every entry's length
+    IrCapture sony;
+    sony.sony(0x095);
+    TEST_ASSERT_TRUE(index.match(sony.timings.data(), sony.timings.size()).empty());
+
+    // Same length, every duration far off
+    std::vector<uint16_t> noise;
+    std::mt19937 rng(3);
+    for (size_t i = 0; i < 67; ++i) noise.push_back(static_cast<uint16_t>(3000 + rng() % 12000));
+    noise.push_back(40000);
+    TEST_ASSERT_TRUE(index.match(noise.data(), noise.size()).empty());
+
+    // Every bit flipped, at least 22 durations off any entry
+    const auto flipped = irNec(~IR_CODES[0]);
+    TEST_ASSERT_TRUE(index.match(flipped.data(), flipped.size()).empty());
+
+    // Too short, and an empty index
+    const uint16_t tiny[] = { 9000, 4500, 560 };
+    TEST_ASSERT_TRUE(index.match(tiny, 3).empty());
+    index.clear();
+    TEST_ASSERT_EQUAL(0, index.entries().size());
+    const auto capture = irNec(IR_CODES[0]);
+    TEST_ASSERT_TRUE(index.match(capture.data(), capture.size()).empty());
+}
+
+#endif
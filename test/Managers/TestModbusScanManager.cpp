@@ -0,0 +1,196 @@
+#ifndef TEST_MODBUS_SCAN_MANAGER_H
+#define TEST_MODBUS_SCAN_MANAGER_H
+
+#include <unity.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../src/Managers/ModbusScanManager.h"
+
+using ScanTable   = ModbusScanManager::Table;
+using ScanOutcome = ModbusScanManager::Outcome;
+using ScanRange   = ModbusScanManager::Range;
+
+// Simulated device: a register map per table, tables it refuses, a block it never answers
+struct SimModbusDevice {
+    std::vector<ScanRange> map[ModbusScanManager::TABLES];
+    bool      unsupported[ModbusScanManager::TABLES] = {};
+    ScanRange dropped{1, 0};            // empty unless set
+
+    ScanOutcome answer(const ModbusScanManager::Read& r) const {
+        const size_t t = static_cast<size_t>(r.table);
+        if (unsupported[t]) return ScanOutcome::Unsupported;
+        const uint32_t first = r.addr;
+        const uint32_t last = static_cast<uint32_t>(r.addr) + r.qty - 1;
+        if (r.table == ScanTable::Holding && dropped.first <= dropped.last &&
+            first <= dropped.last && dropped.first <= last) return ScanOutcome::NoReply;
+        for (const auto& m : map[t]) {
+            if (m.first <= first && last <= m.last) return ScanOutcome::Ok;
+        }
+        return ScanOutcome::BadAddress;
+    }
+};
+
+static SimModbusDevice sampleDevice() {
+    SimModbusDevice dev;
+    dev.map[static_cast<size_t>(ScanTable::Holding)] = {{0, 99}, {200, 209}, {1000, 1299}};
+    dev.map[static_cast<size_t>(ScanTable::Input)]   = {{0, 15}, {700, 703}};
+    dev.map[static_cast<size_t>(ScanTable::Coils)]   = {{0, 63}, {100, 1099}};
+    dev.unsupported[static_cast<size_t>(ScanTable::Discrete)] = true;
+    return dev;
+}
+
+// Virtual clock, every reply comes latency after its request (timeout when dropped), replies due
+// at the same time are handed back newest first. Returns the elapsed time.
+static uint32_t runDiscovery(ModbusScanManager& scan, const SimModbusDevice& dev, size_t window,
+                             uint32_t latency, uint32_t timeout) {
+    struct InFlight { uint32_t id; uint32_t doneAt; ScanOutcome outcome; };
+    std::vector<InFlight> inFlight;
+    uint32_t now = 0;
+
+    while (true) {
+        ModbusScanManager::Read probe;
+        uint32_t id = 0;
+        while (inFlight.size() < window && scan.nextProbe(probe, id)) {
+            const ScanOutcome outcome = dev.answer(probe);
+            inFlight.push_back(InFlight{id, now + (outcome == ScanOutcome::NoReply ? timeout : latency), outcome});
+        }
+        if (inFlight.empty()) break;
+
+        now = inFlight[0].doneAt;
+        for (const auto& f : inFlight) now = std::min(now, f.doneAt);
+        for (size_t i = inFlight.size(); i-- > 0;) {
+            if (inFlight[i].doneAt != now) continue;
+            const InFlight f = inFlight[i];
+            inFlight.erase(inFlight.begin() + i);
+            scan.onProbe(f.id, f.outcome);
+        }
+    }
+    return now;
+}
+
+static bool sameRanges(const std::vector<ScanRange>& a, const std::vector<ScanRange>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].first != b[i].first || a[i].last != b[i].last) return false;
+    }
+    return true;
+}
+
+void test_modbus_scan_discovers_sparse_map() {
+    const SimModbusDevice dev = sampleDevice();
+    ModbusScanManager scan;
+    scan.beginDiscovery(0x0F, 0, 1299);
+    runDiscovery(scan, dev, 8, 20, 1000);
+
+    TEST_ASSERT_TRUE(scan.discoveryDone());
+    TEST_ASSERT_EQUAL_UINT32(0, scan.noReply());
+    TEST_ASSERT_FALSE(scan.supported(ScanTable::Discrete));
+    TEST_ASSERT_TRUE(scan.ranges(ScanTable::Discrete).empty());
+    for (auto t : {ScanTable::Coils, ScanTable::Holding, ScanTable::Input}) {
+        TEST_ASSERT_TRUE(scan.supported(t));
+        TEST_ASSERT_TRUE(sameRanges(dev.map[static_cast<size_t>(t)], scan.ranges(t)));
+    }
+
+    // The map is read back with the fewest requests
+    const auto reads = ModbusScanManager::planRanges(ScanTable::Holding, scan.ranges(ScanTable::Holding));
+    TEST_ASSERT_EQUAL(5, reads.size());     // 0-99, 200-209, 1000-1124, 1125-1249, 1250-1299
+    TEST_ASSERT_EQUAL(1125, reads[3].addr);
+    TEST_ASSERT_EQUAL(125, reads[3].qty);
+}
+
+void test_modbus_scan_reports_silent_blocks() {
+    SimModbusDevice dev = sampleDevice();
+    dev.dropped = ScanRange{1000, 1009};
+    ModbusScanManager scan;
+    scan.beginDiscovery(1u << static_cast<uint8_t>(ScanTable::Holding), 0, 1299);
+    runDiscovery(scan, dev, 4, 20, 1000);
+
+    // The block that timed out is not bisected, only reported
+    TEST_ASSERT_EQUAL_UINT32(1, scan.noReply());
+    const auto silent = scan.silent(ScanTable::Holding);
+    TEST_ASSERT_EQUAL(1, silent.size());
+    TEST_ASSERT_EQUAL(1000, silent[0].first);
+    TEST_ASSERT_EQUAL(1124, silent[0].last);
+    const std::vector<ScanRange> expect = {{0, 99}, {200, 209}, {1125, 1299}};
+    TEST_ASSERT_TRUE(sameRanges(expect, scan.ranges(ScanTable::Holding)));
+}
+
+void test_modbus_scan_pipelining_cuts_round_trips() {
+    const SimModbusDevice dev = sampleDevice();
+    const uint32_t latency = 20;
+
+    ModbusScanManager serial;
+    serial.beginDiscovery(0x0F, 0, 1299);
+    const uint32_t serialMs = runDiscovery(serial, dev, 1, latency, 1000);
+
+    ModbusScanManager piped;
+    piped.beginDiscovery(0x0F, 0, 1299);
+    const uint32_t pipedMs = runDiscovery(piped, dev, 8, latency, 1000);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "ModbusScanManager: window 1 %u probes %u round trips, window 8 %u probes %u round trips",
+             (unsigned)serial.probes(), (unsigned)(serialMs / latency),
+             (unsigned)piped.probes(), (unsigned)(pipedMs / latency));
+    TEST_MESSAGE(msg);
+
+    for (auto t : {ScanTable::Coils, ScanTable::Holding, ScanTable::Input}) {
+        TEST_ASSERT_TRUE(sameRanges(serial.ranges(t), piped.ranges(t)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(serialMs / latency, serial.probes());
+    TEST_ASSERT_TRUE(pipedMs * 4 < serialMs);
+}
+
+void test_modbus_monitor_batches_and_diffs() {
+    std::vector<ModbusScanManager::Watch> watched;
+    TEST_ASSERT_TRUE(ModbusScanManager::parseWatch("h0-3,h6,h200,c0-15", watched));
+    TEST_ASSERT_EQUAL(22, watched.size());
+    TEST_ASSERT_FALSE(ModbusScanManager::parseWatch("h0-3,x5", watched));
+    TEST_ASSERT_FALSE(ModbusScanManager::parseWatch("h9-3", watched));
+    TEST_ASSERT_FALSE(ModbusScanManager::parseWatch("h0-999", watched, 512));
+    TEST_ASSERT_TRUE(ModbusScanManager::parseWatch("h0-3,h6,h200,c0-15", watched));
+
+    // No map, the gap h4-h5 is read through
+    ModbusScanManager::Monitor monitor;
+    monitor.begin(watched, 8);
+    TEST_ASSERT_EQUAL(3, monitor.reads().size());          // c0-15, h0-6, h200
+    TEST_ASSERT_TRUE(monitor.reads()[0].table == ScanTable::Coils);
+    TEST_ASSERT_EQUAL(16, monitor.reads()[0].qty);
+    TEST_ASSERT_EQUAL(0, monitor.reads()[1].addr);
+    TEST_ASSERT_EQUAL(7, monitor.reads()[1].qty);
+
+    // With a map where h5 is not mapped the gap stays unread
+    std::vector<ScanRange> valid[ModbusScanManager::TABLES];
+    valid[static_cast<size_t>(ScanTable::Holding)] = {{0, 4}, {6, 300}};
+    valid[static_cast<size_t>(ScanTable::Coils)] = {{0, 63}};
+    ModbusScanManager::Monitor mapped;
+    mapped.begin(watched, 8, valid);
+    TEST_ASSERT_EQUAL(4, mapped.reads().size());           // c0-15, h0-3, h6, h200
+
+    // First poll reports every value, later polls only what changed
+    std::vector<ModbusScanManager::Change> changes;
+    monitor.onValues(1, {10, 11, 12, 13, 99, 99, 16}, changes);
+    TEST_ASSERT_EQUAL(5, changes.size());
+    TEST_ASSERT_TRUE(changes[0].first);
+    changes.clear();
+    monitor.onValues(1, {10, 11, 42, 13, 0, 0, 16}, changes);   // h4, h5 are not watched
+    TEST_ASSERT_EQUAL(1, changes.size());
+    TEST_ASSERT_EQUAL(2, changes[0].addr);
+    TEST_ASSERT_EQUAL(12, changes[0].before);
+    TEST_ASSERT_EQUAL(42, changes[0].after);
+    TEST_ASSERT_FALSE(changes[0].first);
+
+    // A refused read through the gap is split, the values already seen are kept
+    TEST_ASSERT_TRUE(monitor.split(1));
+    TEST_ASSERT_EQUAL(4, monitor.reads().size());
+    TEST_ASSERT_EQUAL(4, monitor.reads()[1].qty);
+    TEST_ASSERT_EQUAL(6, monitor.reads()[2].addr);
+    TEST_ASSERT_FALSE(monitor.split(2));
+    changes.clear();
+    monitor.onValues(2, {17}, changes);
+    TEST_ASSERT_EQUAL(1, changes.size());
+    TEST_ASSERT_EQUAL(16, changes[0].before);
+}
+
+#endif
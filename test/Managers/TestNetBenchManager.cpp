@@ -0,0 +1,93 @@
+#ifndef TEST_NET_BENCH_MANAGER_H
+#define TEST_NET_BENCH_MANAGER_H
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../src/Managers/NetBenchManager.h"
+
+void test_net_bench_counts_loss_and_reordering() {
+    NetBenchManager::UdpStats stats;
+    // 3 comes late, 6 never comes
+    for (int32_t id : {0, 1, 2, 4, 5, 3, 7}) stats.add(id, 1000 * id, 1000 * id + 500);
+
+    TEST_ASSERT_EQUAL_UINT32(7, stats.received());
+    TEST_ASSERT_EQUAL_UINT32(8, stats.expected());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.lost());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.outOfOrder());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.jitterUs());      // constant transit time
+}
+
+void test_net_bench_jitter_follows_rfc1889() {
+    NetBenchManager::UdpStats stats;
+
+    // One transit change of 1600 us moves the estimate by 1/16
+    stats.add(0, 0, 5000);
+    stats.add(1, 1000, 7600);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.jitterUs());
+
+    // Transit alternating by 1000 us, the estimate settles on 1000 us
+    NetBenchManager::UdpStats alternating;
+    for (int32_t id = 0; id < 400; ++id) {
+        const int64_t sent = 2000LL * id;
+        alternating.add(id, sent, sent + 3000 + (id % 2) * 1000);
+    }
+    TEST_ASSERT_TRUE(alternating.jitterUs() >= 990 && alternating.jitterUs() <= 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, alternating.lost());
+}
+
+void test_net_bench_datagram_and_report_round_trip() {
+    uint8_t buf[NetBenchManager::REPORT_LENGTH + 4];
+
+    NetBenchManager::Datagram d;
+    d.id = -1234;
+    d.sec = 1700000000u;
+    d.usec = 999999;
+    NetBenchManager::encodeDatagram(d, buf);
+    TEST_ASSERT_EQUAL(0xFF, buf[0]);                     // network byte order, negative id
+    NetBenchManager::Datagram back;
+    TEST_ASSERT_TRUE(NetBenchManager::decodeDatagram(buf, NetBenchManager::DATAGRAM_HEADER, back));
+    TEST_ASSERT_EQUAL_INT(-1234, back.id);
+    TEST_ASSERT_EQUAL_UINT32(1700000000u, back.sec);
+    TEST_ASSERT_EQUAL_UINT32(999999, back.usec);
+    TEST_ASSERT_FALSE(NetBenchManager::decodeDatagram(buf, NetBenchManager::DATAGRAM_HEADER - 1, back));
+
+    NetBenchManager::Report report;
+    report.bytes = 5000000000ULL;                       // more than 32 bits
+    report.durationMs = 10250;
+    report.datagrams = 8500;
+    report.lost = 12;
+    report.outOfOrder = 3;
+    report.jitterUs = 1234567;
+    TEST_ASSERT_EQUAL(NetBenchManager::REPORT_LENGTH, NetBenchManager::encodeReport(d, report, buf));
+
+    NetBenchManager::Report got;
+    TEST_ASSERT_TRUE(NetBenchManager::decodeReport(buf, NetBenchManager::REPORT_LENGTH, got));
+    TEST_ASSERT_TRUE(got.bytes == report.bytes);
+    TEST_ASSERT_EQUAL_UINT32(10250, got.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(8500, got.datagrams);
+    TEST_ASSERT_EQUAL_UINT32(12, got.lost);
+    TEST_ASSERT_EQUAL_UINT32(3, got.outOfOrder);
+    TEST_ASSERT_EQUAL_UINT32(1234567, got.jitterUs);
+
+    // Later iperf 2 versions have a 16 byte datagram header in front of the report
+    std::vector<uint8_t> wide(buf, buf + NetBenchManager::DATAGRAM_HEADER);
+    wide.insert(wide.end(), 4, 0);
+    wide.insert(wide.end(), buf + NetBenchManager::DATAGRAM_HEADER, buf + NetBenchManager::REPORT_LENGTH);
+    NetBenchManager::Report shifted;
+    TEST_ASSERT_TRUE(NetBenchManager::decodeReport(wide.data(), wide.size(), shifted));
+    TEST_ASSERT_EQUAL_UINT32(8500, shifted.datagrams);
+    TEST_ASSERT_EQUAL_UINT32(1234567, shifted.jitterUs);
+
+    // A plain datagram echoed back is not a report
+    std::memset(buf + NetBenchManager::DATAGRAM_HEADER, 0, 40);
+    TEST_ASSERT_FALSE(NetBenchManager::decodeReport(buf, NetBenchManager::REPORT_LENGTH, got));
+    TEST_ASSERT_FALSE(NetBenchManager::decodeReport(buf, NetBenchManager::DATAGRAM_HEADER, got));
+}
+
+void test_net_bench_rates() {
+    TEST_ASSERT_TRUE(NetBenchManager::mbps(1250000, 1000) == 10.f);
+    TEST_ASSERT_TRUE(NetBenchManager::mbps(1000, 0) == 0.f);
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef TEST_NMAP_SCAN_MANAGER_H
+#define TEST_NMAP_SCAN_MANAGER_H
+
+#include <unity.h>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include "../src/Managers/NmapScanManager.h"
+
+static uint32_t nmapIp(const char* s) {
+    in_addr a{};
+    inet_pton(AF_INET, s, &a);
+    return a.s_addr;
+}
+
+void test_nmap_expand_hosts() {
+    std::vector<uint32_t> hosts;
+
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.0.0.1", hosts));
+    TEST_ASSERT_EQUAL(1, hosts.size());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.0.0.1"), hosts[0]);
+
+    // Last byte range, inclusive
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("192.168.1.250-255", hosts));
+    TEST_ASSERT_EQUAL(6, hosts.size());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("192.168.1.250"), hosts.front());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("192.168.1.255"), hosts.back());
+
+    // Networks lose their network and broadcast addresses, except /31 and /32
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.1.2.3/30", hosts));
+    TEST_ASSERT_EQUAL(2, hosts.size());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.1.2.1"), hosts[0]);
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.1.2.2"), hosts[1]);
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.1.2.3/31", hosts));
+    TEST_ASSERT_EQUAL(2, hosts.size());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.1.2.2"), hosts[0]);
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.1.2.3/32", hosts));
+    TEST_ASSERT_EQUAL(1, hosts.size());
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.1.2.0/24", hosts));
+    TEST_ASSERT_EQUAL(254, hosts.size());
+
+    // Lists, empty items and duplicates, first occurrence order
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.0.0.3,,10.0.0.1-4,10.0.0.2", hosts));
+    TEST_ASSERT_EQUAL(4, hosts.size());
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.0.0.3"), hosts[0]);
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.0.0.1"), hosts[1]);
+    TEST_ASSERT_EQUAL_UINT32(nmapIp("10.0.0.4"), hosts[3]);
+
+    // Host limit
+    TEST_ASSERT_FALSE(NmapScanManager::expandHosts("10.1.0.0/23", hosts));
+    TEST_ASSERT_FALSE(NmapScanManager::expandHosts("0.0.0.0/0", hosts));
+    TEST_ASSERT_TRUE(NmapScanManager::expandHosts("10.0.0.1-10", hosts, 10));
+    TEST_ASSERT_FALSE(NmapScanManager::expandHosts("10.0.0.1-11", hosts, 10));
+    TEST_ASSERT_FALSE(NmapScanManager::expandHosts("10.0.0.1-10,10.0.1.1", hosts, 10));
+
+    // Malformed
+    for (const char* bad : { "", ",", "10.0.0", "10.0.0.256", "10.0.0.9-3", "10.0.0.1-", "10.0.0.1-256",
+                             "10.0.0.0/33", "10.0.0.0/", "10.0.0.0/8x", "host.local" }) {
+        TEST_ASSERT_FALSE(NmapScanManager::expandHosts(bad, hosts));
+    }
+}
+
+void test_nmap_timeout_follows_rtt() {
+    NmapScanManager scan;
+    NmapScanManager::Config config;
+    config.initialTimeoutMs = 600;
+    config.minTimeoutMs = 100;
+    config.maxTimeoutMs = 1500;
+
+    std::vector<NmapScanManager::Target> targets(4);
+    targets[0].rttHintUs = 0;             // no sample, the initial timeout
+    targets[1].rttHintUs = 20000;         // 20 + 4 * 10 ms, raised to the minimum
+    targets[2].rttHintUs = 300000;        // 300 + 4 * 150 ms
+    targets[3].rttHintUs = 1000000;       // 3 s, capped
+    for (auto& t : targets) t.ports = { 80 };
+    scan.begin(config, targets);
+
+    TEST_ASSERT_EQUAL_UINT32(600, scan.timeoutMs(0));
+    TEST_ASSERT_EQUAL_UINT32(100, scan.timeoutMs(1));
+    TEST_ASSERT_EQUAL_UINT32(900, scan.timeoutMs(2));
+    TEST_ASSERT_EQUAL_UINT32(1500, scan.timeoutMs(3));
+    TEST_ASSERT_EQUAL_UINT32(300000, scan.hosts()[2].srttUs);
+    TEST_ASSERT_EQUAL_UINT32(150000, scan.hosts()[2].rttvarUs);
+    TEST_ASSERT_EQUAL_UINT32(0, scan.hosts()[0].samples);
+
+    // Retries of a port double the timeout, up to the maximum
+    TEST_ASSERT_EQUAL_UINT32(1200, scan.timeoutMs(0, 1));
+    TEST_ASSERT_EQUAL_UINT32(1500, scan.timeoutMs(0, 2));
+    TEST_ASSERT_EQUAL_UINT32(120, scan.timeoutMs(1, 1));     // doubled before the minimum applies
+    TEST_ASSERT_EQUAL_UINT32(960, scan.timeoutMs(1, 200));     // at most 16 times
+
+    // Later samples, srtt += (r - srtt) / 8 and rttvar += (|srtt - r| - rttvar) / 4
+    NmapScanManager::Host h;
+    NmapScanManager::sample(h, 80000);
+    TEST_ASSERT_EQUAL_UINT32(80000, h.srttUs);
+    TEST_ASSERT_EQUAL_UINT32(40000, h.rttvarUs);
+    NmapScanManager::sample(h, 160000);
+    TEST_ASSERT_EQUAL_UINT32(90000, h.srttUs);
+    TEST_ASSERT_EQUAL_UINT32(50000, h.rttvarUs);
+    // A steady path converges on srtt with no variance left
+    for (int i = 0; i < 200; ++i) NmapScanManager::sample(h, 100000);
+    TEST_ASSERT_TRUE(h.srttUs >= 99990 && h.srttUs <= 100000);
+    TEST_ASSERT_TRUE(h.rttvarUs <= 10);
+    TEST_ASSERT_EQUAL_UINT32(202, h.samples);
+
+    // Samples are capped at 10 s
+    NmapScanManager::Host slow;
+    NmapScanManager::sample(slow, 60000000ULL);
+    TEST_ASSERT_EQUAL_UINT32(10000000, slow.srttUs);
+
+    // A maximum below the minimum gives the minimum
+    config.maxTimeoutMs = 50;
+    scan.begin(config, targets);
+    TEST_ASSERT_EQUAL_UINT32(100, scan.timeoutMs(0));
+    TEST_ASSERT_EQUAL_UINT32(100, scan.timeoutMs(3));
+    TEST_ASSERT_EQUAL(4, scan.portsTotal());
+    TEST_ASSERT_EQUAL(0, scan.portsDone());
+}
+
+#endif
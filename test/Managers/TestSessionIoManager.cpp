@@ -0,0 +1,186 @@
+#ifndef TEST_SESSION_IO_MANAGER_H
+#define TEST_SESSION_IO_MANAGER_H
+
+#include <unity.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../src/Managers/SessionIoManager.h"
+
+// Transport recording each send, takes at most maxPerSend bytes, fails from failAt sends on
+struct SessionWire {
+    std::vector<std::string> segments;
+    size_t maxPerSend = 0;
+    int    failAt     = -1;
+    std::string incoming;
+    bool   closeAfter = false;
+
+    SessionIoManager::Sender sender() {
+        return [this](const char* data, size_t len) -> int {
+            if (failAt >= 0 && static_cast<int>(segments.size()) >= failAt) return -1;
+            const size_t n = maxPerSend ? std::min(len, maxPerSend) : len;
+            segments.emplace_back(data, n);
+            return static_cast<int>(n);
+        };
+    }
+
+    SessionIoManager::Receiver receiver() {
+        return [this](char* buf, size_t cap) -> int {
+            if (incoming.empty()) return closeAfter ? -1 : 0;
+            const size_t n = std::min(cap, incoming.size());
+            memcpy(buf, incoming.data(), n);
+            incoming.erase(0, n);
+            return static_cast<int>(n);
+        };
+    }
+
+    std::string sent() const {
+        std::string all;
+        for (const auto& s : segments) all += s;
+        return all;
+    }
+};
+
+void test_session_io_flushes_on_newline_and_size() {
+    SessionWire wire;
+    SessionIoManager io;
+    io.begin(wire.sender(), wire.receiver(), 15, 8);
+
+    // Typed keys wait for the newline
+    for (char c : std::string("ls -l")) TEST_ASSERT_TRUE(io.write(c, 100));
+    TEST_ASSERT_EQUAL(0, wire.segments.size());
+    TEST_ASSERT_EQUAL(5, io.pending());
+    TEST_ASSERT_TRUE(io.write('\n', 101));
+    TEST_ASSERT_EQUAL(1, wire.segments.size());
+    TEST_ASSERT_EQUAL_STRING("ls -l\n", wire.segments[0].c_str());
+    TEST_ASSERT_EQUAL(0, io.pending());
+
+    // Size limit without a newline
+    TEST_ASSERT_TRUE(io.write("abcdefghij", 10, 200));
+    TEST_ASSERT_EQUAL(2, wire.segments.size());
+    TEST_ASSERT_EQUAL_STRING("abcdefghij", wire.segments[1].c_str());
+
+    // A pasted script larger than the queue goes out in TX_CAPACITY pieces
+    SessionWire paste;
+    SessionIoManager big;
+    big.begin(paste.sender(), paste.receiver(), 15, 4096);
+    std::string script(3000, 'x');
+    script.back() = '\n';
+    TEST_ASSERT_TRUE(big.write(script.data(), script.size(), 0));
+    TEST_ASSERT_EQUAL(3, paste.segments.size());
+    TEST_ASSERT_EQUAL(SessionIoManager::TX_CAPACITY, paste.segments[0].size());
+    TEST_ASSERT_TRUE(paste.sent() == script);
+    TEST_ASSERT_EQUAL_UINT32(3, big.sends());
+    TEST_ASSERT_TRUE(big.bytesOut() == script.size());
+}
+
+void test_session_io_flushes_when_idle() {
+    SessionWire wire;
+    SessionIoManager io;
+    io.begin(wire.sender(), wire.receiver(), 15);
+
+    TEST_ASSERT_TRUE(io.write("ab", 2, 1000));
+    TEST_ASSERT_TRUE(io.poll(1014));
+    TEST_ASSERT_EQUAL(0, wire.segments.size());
+    TEST_ASSERT_TRUE(io.write('c', 1010));            // the timer restarts on each key
+    TEST_ASSERT_TRUE(io.poll(1024));
+    TEST_ASSERT_EQUAL(0, wire.segments.size());
+    TEST_ASSERT_TRUE(io.poll(1025));
+    TEST_ASSERT_EQUAL(1, wire.segments.size());
+    TEST_ASSERT_EQUAL_STRING("abc", wire.segments[0].c_str());
+
+    // Nothing queued, nothing sent
+    TEST_ASSERT_TRUE(io.poll(5000));
+    TEST_ASSERT_EQUAL(1, wire.segments.size());
+
+    // Millisecond counter wrap
+    TEST_ASSERT_TRUE(io.write('d', 0xFFFFFFF8u));
+    TEST_ASSERT_TRUE(io.poll(2));
+    TEST_ASSERT_EQUAL(1, wire.segments.size());
+    TEST_ASSERT_TRUE(io.poll(7));
+    TEST_ASSERT_EQUAL(2, wire.segments.size());
+
+    // Line mode, idle 0 keeps bytes until the newline
+    SessionWire lineWire;
+    SessionIoManager line;
+    line.begin(lineWire.sender(), lineWire.receiver(), 0);
+    TEST_ASSERT_TRUE(line.write("partial", 7, 0));
+    TEST_ASSERT_TRUE(line.poll(100000));
+    TEST_ASSERT_EQUAL(0, lineWire.segments.size());
+    TEST_ASSERT_TRUE(line.write('\n', 100001));
+    TEST_ASSERT_EQUAL_STRING("partial\n", lineWire.sent().c_str());
+}
+
+void test_session_io_partial_sends_and_failure() {
+    // A non-blocking transport taking 3 bytes at a time
+    SessionWire wire;
+    wire.maxPerSend = 3;
+    SessionIoManager io;
+    io.begin(wire.sender(), wire.receiver());
+    TEST_ASSERT_TRUE(io.write("echo hi\n", 8, 0));
+    TEST_ASSERT_EQUAL(3, wire.segments.size());
+    TEST_ASSERT_EQUAL_STRING("echo hi\n", wire.sent().c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, io.sends());
+    TEST_ASSERT_TRUE(io.bytesOut() == 8);
+    TEST_ASSERT_EQUAL(0, io.pending());
+
+    // The transport fails half way, the queue is dropped and the manager stays failed
+    SessionWire broken;
+    broken.maxPerSend = 4;
+    broken.failAt = 1;
+    SessionIoManager dead;
+    dead.begin(broken.sender(), broken.receiver());
+    TEST_ASSERT_FALSE(dead.write("exit now\n", 9, 0));
+    TEST_ASSERT_TRUE(dead.failed());
+    TEST_ASSERT_EQUAL(0, dead.pending());
+    TEST_ASSERT_EQUAL_STRING("exit", broken.sent().c_str());
+    TEST_ASSERT_FALSE(dead.write('x', 1));
+    TEST_ASSERT_FALSE(dead.poll(100));
+    TEST_ASSERT_FALSE(dead.flush());
+    TEST_ASSERT_EQUAL(0, dead.pending());
+
+    // reset() clears the failure for a new session
+    broken.failAt = -1;
+    dead.reset();
+    TEST_ASSERT_FALSE(dead.failed());
+    TEST_ASSERT_TRUE(dead.write("ok\n", 3, 0));
+
+    // No sender at all counts as a failed send
+    SessionIoManager none;
+    none.begin(nullptr, nullptr);
+    TEST_ASSERT_FALSE(none.write('\n', 0));
+    TEST_ASSERT_TRUE(none.failed());
+}
+
+void test_session_io_drain() {
+    SessionWire wire;
+    SessionIoManager io;
+    io.begin(wire.sender(), wire.receiver());
+
+    // More than one poll worth is waiting, the rest comes on the next drain
+    wire.incoming = std::string(SessionIoManager::RX_MAX_POLL + 100, 'r');
+    std::string out = "> ";
+    TEST_ASSERT_EQUAL(SessionIoManager::RX_MAX_POLL, io.drain(out));
+    TEST_ASSERT_EQUAL(SessionIoManager::RX_MAX_POLL + 2, out.size());
+    TEST_ASSERT_EQUAL_UINT32(SessionIoManager::RX_MAX_POLL / SessionIoManager::RX_CHUNK, io.reads());
+    out.clear();
+    TEST_ASSERT_EQUAL(100, io.drain(out));
+    TEST_ASSERT_EQUAL(100, out.size());
+    TEST_ASSERT_EQUAL(0, io.drain(out));
+    TEST_ASSERT_EQUAL(100, out.size());
+    TEST_ASSERT_FALSE(io.closed());
+    TEST_ASSERT_TRUE(io.bytesIn() == SessionIoManager::RX_MAX_POLL + 100);
+
+    // Peer closed, what came before is kept
+    wire.incoming = "bye";
+    wire.closeAfter = true;
+    out.clear();
+    TEST_ASSERT_EQUAL(3, io.drain(out));
+    TEST_ASSERT_EQUAL_STRING("bye", out.c_str());
+    TEST_ASSERT_EQUAL(0, io.drain(out));
+    TEST_ASSERT_TRUE(io.closed());
+    TEST_ASSERT_EQUAL(0, io.drain(out));
+}
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef TEST_SIGNAL_LIBRARY_MANAGER_H
+#define TEST_SIGNAL_LIBRARY_MANAGER_H
+
+#include <unity.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "../src/Managers/SignalLibraryManager.h"
+
+// In memory flash, paths are "/" + name
+struct LibraryFs {
+    std::map<std::string, std::string> files;
+    std::map<std::string, uint32_t>    mtimes;
+    std::vector<std::string>           reads;
+    uint32_t                           writes = 0;
+
+    void put(const std::string& name, const std::string& content, uint32_t mtime) {
+        files["/" + name] = content;
+        mtimes["/" + name] = mtime;
+    }
+
+    SignalLibraryManager::Storage storage() {
+        SignalLibraryManager::Storage s;
+        s.readAll = [this](const std::string& path, std::string& out) {
+            auto it = files.find(path);
+            if (it == files.end()) return false;
+            out = it->second;
+            return true;
+        };
+        s.write = [this](const std::string& path, const std::string& text) {
+            files[path] = text;
+            writes++;
+            return true;
+        };
+        s.list = [this]() {
+            std::vector<SignalLibraryManager::FileStat> out;
+            for (const auto& f : files) {
+                out.push_back({f.first.substr(1), static_cast<uint32_t>(f.second.size()), mtimes[f.first]});
+            }
+            return out;
+        };
+        s.read = [this](const std::string& name, const SignalLibraryManager::ChunkSink& sink) {
+            auto it = files.find("/" + name);
+            if (it == files.end()) return false;
+            reads.push_back(name);
+            const auto* data = reinterpret_cast<const uint8_t*>(it->second.data());
+            for (size_t off = 0; off < it->second.size(); off += 5) {       // odd chunks on purpose
+                const size_t n = it->second.size() - off < 5 ? it->second.size() - off : 5;
+                if (!sink(data + off, n)) return false;
+            }
+            return true;
+        };
+        return s;
+    }
+};
+
+static const char* LIBRARY_SUB =
+    "Filetype: Flipper SubGhz Key File\n"
+    "Version: 1\n"
+    "Frequency: 433920000\n"
+    "Preset: FuriHalSubGhzPresetOok650Async\n"
+    "Protocol: Princeton\n"
+    "Bit: 24\n"
+    "Key: 00 00 00 00 00 12 34 56\n";
+
+static const char* LIBRARY_RAW =
+    "Filetype: Flipper SubGhz RAW File\n"
+    "Frequency: 315000000\n"
+    "Protocol: RAW\n"
+    "RAW_Data: 500 -1000 500 -1000\n"
+    "RAW_Data: 2000 -3000\n";
+
+static const char* LIBRARY_IR =
+    "Filetype: IR signals file\n"
+    "Version: 1\n"
+    "#\n"
+    "name: Power\n"
+    "type: parsed\n"
+    "protocol: NEC\n"
+    "address: 04 00 00 00\n"
+    "command: 08 00 00 00\n"
+    "#\n"
+    "name: Vol_up\n"
+    "type: parsed\n"
+    "protocol: NEC\n"
+    "address: 04 00 00 00\n"
+    "command: 02 00 00 00\n";
+
+static const SignalLibraryManager::Entry* libraryEntry(const SignalLibraryManager& library, const char* file) {
+    for (const auto& e : library.entries()) {
+        if (e.file == file) return &e;
+    }
+    return nullptr;
+}
+
+void test_signal_library_indexes_and_saves() {
+    LibraryFs fs;
+    fs.put("gate.sub", LIBRARY_SUB, 100);
+    fs.put("capture.sub", LIBRARY_RAW, 100);
+    fs.put("tv.ir", LIBRARY_IR, 100);
+    fs.put("notes.txt", "not a capture", 100);
+
+    SignalLibraryManager library;
+    TEST_ASSERT_EQUAL(3, library.sync(fs.storage()));
+    TEST_ASSERT_EQUAL(3, library.entries().size());
+    TEST_ASSERT_EQUAL(1, fs.writes);
+    TEST_ASSERT_FALSE(library.dirty());
+    TEST_ASSERT_TRUE(fs.files.count(SignalLibraryManager::INDEX_PATH) == 1);
+
+    const auto* gate = libraryEntry(library, "gate.sub");
+    TEST_ASSERT_NOT_NULL(gate);
+    TEST_ASSERT_TRUE(gate->kind == SignalLibraryManager::Kind::SubGhz);
+    TEST_ASSERT_EQUAL_STRING("Princeton", gate->protocol.c_str());
+    TEST_ASSERT_EQUAL_UINT32(433920000, gate->frequencyHz);
+    TEST_ASSERT_EQUAL(24, gate->bits);
+
+    const auto* raw = libraryEntry(library, "capture.sub");
+    TEST_ASSERT_NOT_NULL(raw);
+    TEST_ASSERT_EQUAL_STRING("RAW", raw->protocol.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8000, raw->durationUs);
+
+    const auto* tv = libraryEntry(library, "tv.ir");
+    TEST_ASSERT_NOT_NULL(tv);
+    TEST_ASSERT_TRUE(tv->kind == SignalLibraryManager::Kind::Infrared);
+    TEST_ASSERT_EQUAL_STRING("NEC", tv->protocol.c_str());
+    TEST_ASSERT_EQUAL(2, tv->signals);
+}
+
+void test_signal_library_rereads_changed_files_only() {
+    LibraryFs fs;
+    fs.put("gate.sub", LIBRARY_SUB, 100);
+    fs.put("capture.sub", LIBRARY_RAW, 100);
+    fs.put("tv.ir", LIBRARY_IR, 100);
+
+    SignalLibraryManager first;
+    first.sync(fs.storage());
+    fs.reads.clear();
+
+    // Nothing changed, nothing read or written
+    SignalLibraryManager second;
+    TEST_ASSERT_EQUAL(0, second.sync(fs.storage()));
+    TEST_ASSERT_EQUAL(0, fs.reads.size());
+    TEST_ASSERT_EQUAL(1, fs.writes);
+    TEST_ASSERT_EQUAL(3, second.entries().size());
+
+    // One touched, one removed, one added
+    fs.put("tv.ir", std::string(LIBRARY_IR) + "#\nname: Mute\ntype: parsed\nprotocol: NEC\n", 200);
+    fs.files.erase("/capture.sub");
+    fs.put("copy.sub", LIBRARY_SUB, 300);
+
+    SignalLibraryManager third;
+    TEST_ASSERT_EQUAL(3, third.sync(fs.storage()));
+    TEST_ASSERT_EQUAL(2, fs.reads.size());
+    TEST_ASSERT_EQUAL(2, fs.writes);
+    TEST_ASSERT_NULL(libraryEntry(third, "capture.sub"));
+    TEST_ASSERT_EQUAL(3, libraryEntry(third, "tv.ir")->signals);
+
+    // Same content under two names
+    TEST_ASSERT_EQUAL(libraryEntry(third, "gate.sub")->hash, libraryEntry(third, "copy.sub")->hash);
+    TEST_ASSERT_EQUAL(1, third.duplicateCount(SignalLibraryManager::Kind::SubGhz));
+    TEST_ASSERT_EQUAL(1, third.filter(SignalLibraryManager::Kind::SubGhz, "", true).size());
+    TEST_ASSERT_EQUAL(2, third.filter(SignalLibraryManager::Kind::SubGhz, "433", false).size());
+}
+
+void test_signal_library_hides_duplicates_among_matches() {
+    LibraryFs fs;
+    fs.put("a_gate.sub", LIBRARY_SUB, 100);
+    fs.put("b_garage.sub", LIBRARY_SUB, 100);
+    fs.put("c_noted.sub", std::string("# copied from the remote\n") + LIBRARY_SUB, 100);
+
+    SignalLibraryManager library;
+    library.sync(fs.storage());
+    const auto kind = SignalLibraryManager::Kind::SubGhz;
+
+    // The earlier copy does not match, the later one is still listed
+    auto found = library.filter(kind, "garage", true);
+    TEST_ASSERT_EQUAL(1, found.size());
+    TEST_ASSERT_EQUAL_STRING("b_garage.sub", library.entries()[found[0]].file.c_str());
+    found = library.filter(kind, "ga", true);
+    TEST_ASSERT_EQUAL(1, found.size());
+    TEST_ASSERT_EQUAL_STRING("a_gate.sub", library.entries()[found[0]].file.c_str());
+
+    // Same hash, comments ignored, but a different size: not merged
+    TEST_ASSERT_EQUAL(libraryEntry(library, "a_gate.sub")->hash, libraryEntry(library, "c_noted.sub")->hash);
+    TEST_ASSERT_EQUAL(1, library.duplicateCount(kind));
+    TEST_ASSERT_EQUAL(2, library.filter(kind, "", true).size());
+    TEST_ASSERT_EQUAL(3, library.filter(kind, "", false).size());
+}
+
+void test_signal_library_rebuilds_unknown_catalog() {
+    LibraryFs fs;
+    fs.put("gate.sub", LIBRARY_SUB, 100);
+    fs.files[SignalLibraryManager::INDEX_PATH] = "# some other format\nS\t1\n";
+
+    SignalLibraryManager library;
+    TEST_ASSERT_EQUAL(1, library.sync(fs.storage()));
+    TEST_ASSERT_EQUAL(1, library.entries().size());
+
+    // Saved in the current format, loads back the same
+    SignalLibraryManager reloaded;
+    TEST_ASSERT_TRUE(reloaded.load(fs.files[SignalLibraryManager::INDEX_PATH]));
+    TEST_ASSERT_EQUAL(1, reloaded.entries().size());
+    TEST_ASSERT_EQUAL_STRING(library.serialize().c_str(), reloaded.serialize().c_str());
+}
+
+#endif
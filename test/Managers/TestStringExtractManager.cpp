@@ -0,0 +1,208 @@
+#ifndef TEST_STRING_EXTRACT_MANAGER_H
+#define TEST_STRING_EXTRACT_MANAGER_H
+
+#include <unity.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../src/Managers/StringExtractManager.h"
+
+// Distinct 12 char strings separated by a NUL
+static std::vector<uint8_t> stringImage(size_t count) {
+    std::vector<uint8_t> image;
+    char buf[16];
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(buf, sizeof(buf), "string%06u", static_cast<unsigned>(i));
+        image.insert(image.end(), buf, buf + 12);
+        image.push_back(0);
+    }
+    return image;
+}
+
+struct StringExtractHit {
+    uint32_t    address;
+    std::string text;
+    bool        wide;
+};
+
+static std::vector<uint8_t> stringWide(const char* text) {
+    std::vector<uint8_t> out;
+    for (const char* c = text; *c; ++c) {
+        out.push_back(static_cast<uint8_t>(*c));
+        out.push_back(0x00);
+    }
+    return out;
+}
+
+// Feed the image in two blocks cut at split, hits are collected
+static std::vector<StringExtractHit> stringExtractSplit(const StringExtractManager::Options& opts,
+                                                        const std::vector<uint8_t>& image, uint32_t base,
+                                                        size_t split) {
+    std::vector<StringExtractHit> hits;
+    StringExtractManager extractor;
+    extractor.begin(opts, [&](uint32_t address, const std::string& str, bool wide) {
+        hits.push_back({ address, str, wide });
+    });
+    extractor.feed(base, image.data(), split);
+    extractor.feed(base + split, image.data() + split, image.size() - split);
+    extractor.finish();
+    return hits;
+}
+
+void test_string_extract_dedupe_grows_past_initial_table() {
+    StringExtractManager extractor;
+    StringExtractManager::Options opts;
+    size_t sunk = 0;
+    extractor.begin(opts, [&](uint32_t, const std::string&, bool) { sunk++; });
+
+    // Twice the initial capacity, then all of it again
+    const auto image = stringImage(StringExtractManager::DEDUPE_SLOTS * 2);
+    extractor.feed(0, image.data(), image.size());
+    extractor.feed(0x100000, image.data(), image.size());
+    extractor.finish();
+
+    const auto& stats = extractor.stats();
+    TEST_ASSERT_EQUAL_UINT32(StringExtractManager::DEDUPE_SLOTS * 2, stats.emitted);
+    TEST_ASSERT_EQUAL_UINT32(StringExtractManager::DEDUPE_SLOTS * 2, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.unremembered);
+    TEST_ASSERT_FALSE(extractor.dedupeSaturated());
+    TEST_ASSERT_TRUE(extractor.dedupeSlots() > StringExtractManager::DEDUPE_SLOTS);
+    TEST_ASSERT_EQUAL(stats.emitted, sunk);
+}
+
+void test_string_extract_dedupe_saturation_is_counted() {
+    StringExtractManager extractor;
+    StringExtractManager::Options opts;
+    opts.dedupeMaxSlots = StringExtractManager::DEDUPE_SLOTS;   // no growth
+    extractor.begin(opts, nullptr);
+
+    const size_t capacity = StringExtractManager::DEDUPE_SLOTS * 3 / 4;
+    const auto image = stringImage(capacity + 100);
+    extractor.feed(0, image.data(), image.size());
+    extractor.feed(0x100000, image.data(), image.size());
+    extractor.finish();
+
+    // Remembered strings are still dropped, the rest is emitted twice and counted
+    const auto& stats = extractor.stats();
+    TEST_ASSERT_TRUE(extractor.dedupeSaturated());
+    TEST_ASSERT_EQUAL_UINT32(capacity, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(200, stats.unremembered);
+    TEST_ASSERT_EQUAL_UINT32(capacity + 200, stats.emitted);
+}
+
+void test_string_extract_dedupe_resets_on_begin() {
+    StringExtractManager extractor;
+    StringExtractManager::Options opts;
+    opts.dedupeMaxSlots = StringExtractManager::DEDUPE_SLOTS;
+    const auto image = stringImage(StringExtractManager::DEDUPE_SLOTS);
+
+    extractor.begin(opts, nullptr);
+    extractor.feed(0, image.data(), image.size());
+    extractor.finish();
+    TEST_ASSERT_TRUE(extractor.dedupeSaturated());
+
+    extractor.begin(opts, nullptr);
+    extractor.feed(0, image.data(), 13 * 10);
+    extractor.finish();
+    TEST_ASSERT_FALSE(extractor.dedupeSaturated());
+    TEST_ASSERT_EQUAL_UINT32(10, extractor.stats().emitted);
+    TEST_ASSERT_EQUAL_UINT32(0, extractor.stats().duplicates);
+}
+
+void test_string_extract_utf16le_across_feeds() {
+    StringExtractManager::Options opts;
+    opts.encoding = StringExtractManager::Encoding::Utf16Le;
+
+    // One string on each address parity, separated by bytes that are not a code unit
+    std::vector<uint8_t> image = stringWide("WideString01");
+    image.push_back(0xFF);
+    const auto odd = stringWide("OddLaneText9");
+    image.insert(image.end(), odd.begin(), odd.end());
+    image.push_back(0xFF);
+    image.push_back(0xFF);
+
+    // Every cut, odd ones leave a low byte pending for the next feed
+    for (size_t split = 0; split <= image.size(); ++split) {
+        const auto hits = stringExtractSplit(opts, image, 0x2000, split);
+        TEST_ASSERT_EQUAL(2, hits.size());
+        TEST_ASSERT_EQUAL_UINT32(0x2000, hits[0].address);
+        TEST_ASSERT_EQUAL_STRING("WideString01", hits[0].text.c_str());
+        TEST_ASSERT_TRUE(hits[0].wide);
+        TEST_ASSERT_EQUAL_UINT32(0x2000 + 25, hits[1].address);
+        TEST_ASSERT_EQUAL_STRING("OddLaneText9", hits[1].text.c_str());
+        TEST_ASSERT_TRUE(hits[1].wide);
+    }
+
+    // A gap between the blocks drops the pending byte, the halves are too short alone
+    StringExtractManager extractor;
+    size_t sunk = 0;
+    extractor.begin(opts, [&](uint32_t, const std::string&, bool) { sunk++; });
+    extractor.feed(0x2000, image.data(), 9);
+    extractor.feed(0x3000 + 9, image.data() + 9, 15);
+    extractor.finish();
+    TEST_ASSERT_EQUAL(0, sunk);
+}
+
+void test_string_extract_ascii_run_across_blocks() {
+    StringExtractManager::Options opts;
+    const std::string text = std::string("\x01" "cross-block-ascii") + '\0' + "tail";
+    const std::vector<uint8_t> image(text.begin(), text.end());
+
+    for (size_t split = 0; split <= image.size(); ++split) {
+        const auto hits = stringExtractSplit(opts, image, 0x400, split);
+        TEST_ASSERT_EQUAL(1, hits.size());
+        TEST_ASSERT_EQUAL_UINT32(0x401, hits[0].address);
+        TEST_ASSERT_EQUAL_STRING("cross-block-ascii", hits[0].text.c_str());
+        TEST_ASSERT_FALSE(hits[0].wide);
+    }
+
+    // Blocks that do not follow each other are not joined
+    std::vector<StringExtractHit> hits;
+    StringExtractManager extractor;
+    extractor.begin(opts, [&](uint32_t address, const std::string& str, bool wide) {
+        hits.push_back({ address, str, wide });
+    });
+    const uint8_t a[] = { 'f', 'i', 'r', 's', 't', 'h', 'a', 'l', 'f' };
+    const uint8_t b[] = { 's', 'e', 'c', 'o', 'n', 'd', 'h', 'a', 'l', 'f' };
+    extractor.feed(0, a, sizeof(a));
+    extractor.feed(0x100, b, sizeof(b));
+    extractor.finish();
+    TEST_ASSERT_EQUAL(2, hits.size());
+    TEST_ASSERT_EQUAL_STRING("firsthalf", hits[0].text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0x100, hits[1].address);
+    TEST_ASSERT_EQUAL_STRING("secondhalf", hits[1].text.c_str());
+}
+
+void test_string_extract_min_length_cutoff() {
+    StringExtractManager::Options opts;
+    opts.minLen = 5;
+    opts.encoding = StringExtractManager::Encoding::Both;
+    opts.dedupe = false;
+
+    // Four chars are dropped, five are kept, in both encodings
+    const std::string ascii = std::string("abcd") + '\0' + "abcde" + '\0';
+    std::vector<uint8_t> image(ascii.begin(), ascii.end());
+    for (const char* w : { "wxyz", "vwxyz" }) {
+        const auto wide = stringWide(w);
+        image.push_back(0x01);
+        image.push_back(0x01);
+        image.insert(image.end(), wide.begin(), wide.end());
+    }
+
+    const auto hits = stringExtractSplit(opts, image, 0, image.size() / 2);
+    TEST_ASSERT_EQUAL(2, hits.size());
+    TEST_ASSERT_EQUAL_STRING("abcde", hits[0].text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(5, hits[0].address);
+    TEST_ASSERT_FALSE(hits[0].wide);
+    TEST_ASSERT_EQUAL_STRING("vwxyz", hits[1].text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(11 + 2 + 8 + 2, hits[1].address);
+    TEST_ASSERT_TRUE(hits[1].wide);
+
+    // A zero minimum behaves as one
+    opts.minLen = 0;
+    opts.encoding = StringExtractManager::Encoding::Ascii;
+    const std::vector<uint8_t> single = { 0x00, 'x', 0x00 };
+    TEST_ASSERT_EQUAL(1, stringExtractSplit(opts, single, 0, 1).size());
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef TEST_SUBGHZ_DECODE_MANAGER_H
+#define TEST_SUBGHZ_DECODE_MANAGER_H
+
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Managers/SubGhzDecodeManager.h"
+
+// Synthetic captures, signed durations in us as Flipper RAW_Data
+struct DecodeCapture {
+    std::mt19937 rng{1};
+    uint32_t jitterPct = 0;             // uniform +-jitterPct of each width
+    std::vector<int32_t> durations;
+
+    void push(bool high, uint32_t us) {
+        if (jitterPct) {
+            const int32_t span = static_cast<int32_t>(us * jitterPct / 100);
+            us += static_cast<int32_t>(rng() % (2 * span + 1)) - span;
+        }
+        if (us == 0) us = 1;
+        durations.push_back(high ? static_cast<int32_t>(us) : -static_cast<int32_t>(us));
+    }
+
+    // Two width coding, the packet silence replaces the last low
+    void pairs(const char* bits, uint32_t te, uint32_t longUnits, bool startLowHigh, uint32_t gapUnits, int repeats) {
+        for (int r = 0; r < repeats; ++r) {
+            if (startLowHigh) push(true, te);
+            for (const char* b = bits; *b; ++b) {
+                const bool one = *b == '1';
+                if (startLowHigh) {
+                    push(false, one ? te * longUnits : te);
+                    push(true, one ? te : te * longUnits);
+                } else {
+                    push(true, one ? te * longUnits : te);
+                    push(false, one ? te : te * longUnits);
+                }
+            }
+            push(false, te * gapUnits);
+        }
+    }
+
+    // IEEE 802.3 Manchester, leading low half lost before the first edge
+    void manchester(const char* bits, uint32_t te) {
+        std::vector<uint8_t> halves;
+        for (const char* b = bits; *b; ++b) {
+            halves.push_back(*b == '1' ? 0 : 1);
+            halves.push_back(*b == '1' ? 1 : 0);
+        }
+        size_t i = 0;
+        while (i < halves.size() && halves[i] == 0) ++i;
+        while (i < halves.size()) {
+            size_t j = i;
+            while (j < halves.size() && halves[j] == halves[i]) ++j;
+            push(halves[i] != 0, te * static_cast<uint32_t>(j - i));
+            i = j;
+        }
+    }
+
+    // Random widths, no coding
+    void noise(size_t count) {
+        for (size_t i = 0; i < count; ++i) push(i % 2 == 0, 50 + rng() % 3000);
+    }
+};
+
+static const char* DECODE_BITS24   = "101100111000101011110001";
+static const char* DECODE_TRISTATE = "000011110101001100000101";   // PT2262 symbols 0, 1, F
+static const char* DECODE_BITS12   = "101100111010";
+static const char* DECODE_BITS31   = "1011001110001010111100011100101";
+
+static const SubGhzDecodeManager::DecodeResult* decodeBest(SubGhzDecodeManager& decoder, const DecodeCapture& c) {
+    const auto& results = decoder.decode(c.durations.data(), c.durations.size());
+    return results.empty() ? nullptr : &results[0];
+}
+
+void test_subghz_decode_pair_protocols() {
+    struct Case {
+        const char* protocol;
+        const char* bits;
+        uint32_t    te;
+        uint32_t    longUnits;
+        bool        startLowHigh;
+        uint32_t    gapUnits;
+    };
+    const Case cases[] = {
+        { "EV1527",    DECODE_BITS24,   320, 3, false, 31 },
+        { "Princeton", DECODE_TRISTATE, 350, 3, false, 31 },
+        { "CAME",      DECODE_BITS24,   320, 2, true,  47 },
+        { "Nice FLO",  DECODE_BITS12,   700, 2, true,  36 },
+        { "Holtek",    DECODE_BITS12,   320, 2, true,  36 },
+    };
+
+    SubGhzDecodeManager decoder;
+    for (const auto& k : cases) {
+        DecodeCapture c;
+        c.pairs(k.bits, k.te, k.longUnits, k.startLowHigh, k.gapUnits, 3);
+        const auto& results = decoder.decode(c.durations.data(), c.durations.size());
+        TEST_ASSERT_FALSE(results.empty());
+
+        // Ranked first, 12 bit Holtek and CAME share their timings and tie
+        const SubGhzDecodeManager::DecodeResult* match = nullptr;
+        for (const auto& r : results) {
+            if (!strcmp(r.protocol, k.protocol)) { match = &r; break; }
+        }
+        TEST_ASSERT_NOT_NULL(match);
+        TEST_ASSERT_TRUE(match->confidence == results[0].confidence);
+        TEST_ASSERT_TRUE(match->confidence >= 0.9f);
+        TEST_ASSERT_EQUAL_STRING(k.bits, match->bits.c_str());
+        TEST_ASSERT_EQUAL_UINT32(k.te, match->teUs);
+        TEST_ASSERT_EQUAL(3, match->repeats);
+    }
+
+    // Runner-ups of the same coding stay below the matching protocol
+    DecodeCapture came;
+    came.pairs(DECODE_BITS24, 320, 2, true, 47, 3);
+    const auto& results = decoder.decode(came.durations.data(), came.durations.size());
+    TEST_ASSERT_TRUE(results.size() >= 2);
+    TEST_ASSERT_EQUAL_STRING("CAME", results[0].protocol);
+    TEST_ASSERT_TRUE(results[1].confidence < results[0].confidence);
+}
+
+void test_subghz_decode_manchester() {
+    SubGhzDecodeManager decoder;
+    DecodeCapture c;
+    c.manchester(DECODE_BITS31, 500);
+
+    const auto* best = decodeBest(decoder, c);
+    TEST_ASSERT_NOT_NULL(best);
+    TEST_ASSERT_EQUAL_STRING("Manchester", best->protocol);
+    TEST_ASSERT_EQUAL_STRING(DECODE_BITS31, best->bits.c_str());
+    TEST_ASSERT_EQUAL_UINT32(500, best->teUs);
+    TEST_ASSERT_EQUAL_STRING("59C578E5", SubGhzDecodeManager::bitsToHex(best->bits).c_str());
+}
+
+void test_subghz_decode_tolerates_jitter() {
+    SubGhzDecodeManager decoder;
+    uint32_t decoded = 0;
+    const uint32_t runs = 50;
+
+    for (uint32_t seed = 1; seed <= runs; ++seed) {
+        DecodeCapture c;
+        c.rng.seed(seed);
+        c.jitterPct = 20;
+        c.pairs(DECODE_BITS24, 320, 3, false, 31, 4);
+
+        const auto* best = decodeBest(decoder, c);
+        if (best && !strcmp(best->protocol, "EV1527") && best->bits == DECODE_BITS24) decoded++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(runs, decoded);
+
+    DecodeCapture m;
+    m.jitterPct = 15;
+    m.manchester(DECODE_BITS31, 500);
+    const auto* best = decodeBest(decoder, m);
+    TEST_ASSERT_NOT_NULL(best);
+    TEST_ASSERT_EQUAL_STRING(DECODE_BITS31, best->bits.c_str());
+}
+
+void test_subghz_decode_noisy_captures() {
+    SubGhzDecodeManager decoder;
+
+    // Pure noise gives nothing worth showing
+    DecodeCapture noise;
+    noise.noise(100);
+    const auto& results = decoder.decode(noise.durations.data(), noise.durations.size());
+    for (const auto& r : results) TEST_ASSERT_TRUE(r.confidence < 0.5f);
+
+    // Noise bursts around the packets, split off by the packet silences
+    DecodeCapture c;
+    c.jitterPct = 8;
+    c.noise(20);
+    c.push(false, 320 * 31);
+    c.pairs(DECODE_BITS12, 320, 2, true, 47, 3);
+    c.noise(20);
+
+    const auto* best = decodeBest(decoder, c);
+    TEST_ASSERT_NOT_NULL(best);
+    TEST_ASSERT_EQUAL_STRING("CAME", best->protocol);
+    TEST_ASSERT_EQUAL_STRING(DECODE_BITS12, best->bits.c_str());
+
+    // Too short to decode
+    const int32_t tiny[] = { 300, -900, 300 };
+    TEST_ASSERT_EQUAL(0, decoder.decode(tiny, 3).size());
+}
+
+void test_subghz_decode_bits_to_hex() {
+    TEST_ASSERT_EQUAL_STRING("B38AF1", SubGhzDecodeManager::bitsToHex(DECODE_BITS24).c_str());
+    TEST_ASSERT_EQUAL_STRING("B3A", SubGhzDecodeManager::bitsToHex(DECODE_BITS12).c_str());
+    TEST_ASSERT_EQUAL_STRING("5", SubGhzDecodeManager::bitsToHex("101").c_str());     // left padded
+    TEST_ASSERT_EQUAL_STRING("", SubGhzDecodeManager::bitsToHex("").c_str());
+}
+
+void test_subghz_decode_throughput() {
+    std::vector<DecodeCapture> corpus(5);
+    corpus[0].jitterPct = 8;
+    corpus[0].pairs(DECODE_BITS24, 320, 3, false, 31, 4);
+    corpus[1].jitterPct = 8;
+    corpus[1].pairs(DECODE_TRISTATE, 350, 3, false, 31, 3);
+    corpus[2].jitterPct = 8;
+    corpus[2].pairs(DECODE_BITS24, 320, 2, true, 47, 3);
+    corpus[3].jitterPct = 8;
+    corpus[3].manchester(DECODE_BITS31, 500);
+    corpus[4].noise(100);
+
+    SubGhzDecodeManager decoder;
+    const uint32_t count = 100000;
+    size_t results = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < count; ++n) {
+        const auto& c = corpus[n % corpus.size()];
+        results += decoder.decode(c.durations.data(), c.durations.size()).size();
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "SubGhzDecodeManager: %lu frames/s",
+             static_cast<unsigned long>(us ? count * 1000000ULL / us : 0));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(results >= count);
+}
+
+#endif
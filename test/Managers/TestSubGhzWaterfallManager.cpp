@@ -0,0 +1,78 @@
+#ifndef TEST_SUBGHZ_WATERFALL_MANAGER_H
+#define TEST_SUBGHZ_WATERFALL_MANAGER_H
+
+#include <unity.h>
+#include <cstdint>
+#include "../src/Managers/SubGhzWaterfallManager.h"
+
+// Sweep k reads -100 + k dBm on channel 0, one more dB per channel
+static void waterfallSweep(SubGhzWaterfallManager& w, int k, uint32_t nowMs) {
+    for (size_t ch = 0; ch < w.channels(); ++ch) w.setCell(ch, -100 + k + static_cast<int>(ch));
+    w.commitRow(nowMs);
+}
+
+void test_subghz_waterfall_rows_newest_first_across_wrap() {
+    SubGhzWaterfallManager w;
+    TEST_ASSERT_TRUE(w.begin(4, 3));
+    TEST_ASSERT_EQUAL(16, w.memoryBytes());   // three rows and the one being measured
+    TEST_ASSERT_NULL(w.row(0));
+
+    waterfallSweep(w, 0, 0);
+    TEST_ASSERT_EQUAL(1, w.rows());
+    TEST_ASSERT_EQUAL(-100, SubGhzWaterfallManager::decode(w.row(0)[0]));
+    TEST_ASSERT_NULL(w.row(1));
+
+    // Five sweeps in a ring of three, the two oldest are overwritten
+    for (int k = 1; k < 5; ++k) waterfallSweep(w, k, k * 100);
+    TEST_ASSERT_EQUAL(3, w.rows());
+    TEST_ASSERT_EQUAL_UINT32(5, w.sweeps());
+    for (size_t age = 0; age < 3; ++age) {
+        const uint8_t* r = w.row(age);
+        TEST_ASSERT_NOT_NULL(r);
+        for (size_t ch = 0; ch < 4; ++ch) {
+            TEST_ASSERT_EQUAL(-100 + 4 - static_cast<int>(age) + static_cast<int>(ch), SubGhzWaterfallManager::decode(r[ch]));
+        }
+    }
+    TEST_ASSERT_NULL(w.row(3));
+
+    // The row being measured reuses the oldest slot and does not show until committed
+    w.setCell(0, -20);
+    TEST_ASSERT_EQUAL(-96, SubGhzWaterfallManager::decode(w.row(0)[0]));
+    TEST_ASSERT_EQUAL(-98, SubGhzWaterfallManager::decode(w.row(2)[0]));
+    w.commitRow(500);
+    TEST_ASSERT_EQUAL(-20, SubGhzWaterfallManager::decode(w.row(0)[0]));
+    TEST_ASSERT_EQUAL(-128, SubGhzWaterfallManager::decode(w.row(0)[1]));   // cleared, not left from sweep 2
+    TEST_ASSERT_EQUAL(-97, SubGhzWaterfallManager::decode(w.row(2)[0]));
+
+    TEST_ASSERT_EQUAL(-20, w.peakDbm(0, 3));
+    TEST_ASSERT_EQUAL(-93, w.peakDbm(3, 3));
+    TEST_ASSERT_EQUAL(-128, w.peakDbm(3, 1));
+    TEST_ASSERT_TRUE(w.sweepsPerSecond() > 9.99f && w.sweepsPerSecond() < 10.01f);
+}
+
+void test_subghz_waterfall_begin_fails_without_memory() {
+    SubGhzWaterfallManager w;
+    TEST_ASSERT_FALSE(w.begin(0, 16));
+    TEST_ASSERT_FALSE(w.begin(SIZE_MAX, 2));        // channels x depth overflows
+    TEST_ASSERT_FALSE(w.begin(SIZE_MAX / 4, 2));    // half the address space
+
+    // A failed begin leaves an empty history that ignores writes
+    TEST_ASSERT_EQUAL(0, w.channels());
+    TEST_ASSERT_EQUAL(0, w.memoryBytes());
+    w.setCell(0, -50);
+    w.commitRow(10);
+    TEST_ASSERT_NULL(w.row(0));
+    TEST_ASSERT_EQUAL_UINT32(0, w.sweeps());
+
+    TEST_ASSERT_TRUE(w.begin(8, 16));
+    TEST_ASSERT_EQUAL(136, w.memoryBytes());
+    waterfallSweep(w, 0, 0);
+    TEST_ASSERT_EQUAL(1, w.rows());
+
+    // begin() again starts an empty history
+    TEST_ASSERT_TRUE(w.begin(2, 4));
+    TEST_ASSERT_EQUAL(0, w.rows());
+    TEST_ASSERT_NULL(w.row(0));
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TEST_WIFI_CHANNEL_MANAGER_H
+#define TEST_WIFI_CHANNEL_MANAGER_H
+
+#include <unity.h>
+#include <vector>
+#include "../src/Managers/WifiChannelManager.h"
+
+void test_wifi_channel_parse_sets() {
+    std::vector<uint8_t> channels;
+    TEST_ASSERT_TRUE(WifiChannelManager::parseChannels("jp", channels));
+    TEST_ASSERT_EQUAL(14, channels.size());
+    TEST_ASSERT_EQUAL(14, channels.back());
+    TEST_ASSERT_TRUE(WifiChannelManager::parseChannels("1-3,6,3,11", channels));
+    TEST_ASSERT_EQUAL(5, channels.size());
+    TEST_ASSERT_FALSE(WifiChannelManager::parseChannels("1,15", channels));
+    TEST_ASSERT_FALSE(WifiChannelManager::parseChannels("6-1", channels));
+}
+
+void test_wifi_channel_skip_credits_nothing() {
+    WifiChannelManager hopper;
+    TEST_ASSERT_TRUE(hopper.begin({1, 6, 14}, WifiChannelManager::Mode::Fixed, 0));
+    TEST_ASSERT_EQUAL(1, hopper.current());
+
+    // 100 ms on channel 1 with 10 frames
+    for (int i = 0; i < 10; ++i) hopper.countFrame(1);
+    hopper.advance(100);
+    TEST_ASSERT_EQUAL(6, hopper.current());
+
+    // Channel 6 refused, the radio stays on 1 and its frames wait for channel 1's next dwell
+    for (int i = 0; i < 3; ++i) hopper.countFrame(1);
+    hopper.skip(101);
+    TEST_ASSERT_EQUAL(14, hopper.current());
+    hopper.countFrame(14);
+    hopper.advance(201);
+
+    const auto& stats = hopper.stats();
+    TEST_ASSERT_EQUAL_UINT32(10, stats[0].frames);
+    TEST_ASSERT_EQUAL_UINT32(100, stats[0].dwellMs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[1].frames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[1].dwellMs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[1].visits);
+    TEST_ASSERT_EQUAL_UINT32(1, stats[1].failed);
+    TEST_ASSERT_EQUAL_UINT32(1, stats[2].frames);
+    TEST_ASSERT_EQUAL_UINT32(100, stats[2].dwellMs);     // from the skip, not from the last advance
+    TEST_ASSERT_EQUAL_UINT32(1, stats[2].visits);
+
+    // Back on channel 1, the frames seen while 6 was tried are counted there
+    TEST_ASSERT_EQUAL(1, hopper.current());
+    hopper.advance(301);
+    TEST_ASSERT_EQUAL_UINT32(13, stats[0].frames);
+
+    // A pinned channel that keeps failing stays current
+    WifiChannelManager pinned;
+    TEST_ASSERT_TRUE(pinned.begin({14}, WifiChannelManager::Mode::Pinned, 0));
+    TEST_ASSERT_EQUAL_UINT32(WifiChannelManager::PINNED_DWELL_MS, pinned.skip(10));
+    TEST_ASSERT_EQUAL(14, pinned.current());
+    TEST_ASSERT_EQUAL_UINT32(0, pinned.stats()[0].visits);
+    TEST_ASSERT_EQUAL_UINT32(1, pinned.stats()[0].failed);
+}
+
+#endif
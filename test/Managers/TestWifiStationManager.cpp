@@ -0,0 +1,180 @@
+#ifndef TEST_WIFI_STATION_MANAGER_H
+#define TEST_WIFI_STATION_MANAGER_H
+
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../src/Managers/WifiStationManager.h"
+
+// 802.11 header sent by mac, with an SSID element for beacons and probe requests
+static std::vector<uint8_t> buildFrame(uint8_t type, uint8_t subtype, uint8_t flags,
+                                       const uint8_t mac[6], const char* ssid = nullptr) {
+    std::vector<uint8_t> f(24, 0);
+    f[0] = static_cast<uint8_t>((type << 2) | (subtype << 4));
+    f[1] = flags;
+    memset(&f[4], 0xFF, 6);
+    memcpy(&f[10], mac, 6);
+    memcpy(&f[16], mac, 6);
+    if (ssid) {
+        if (subtype == 8 || subtype == 5) f.resize(36, 0);   // timestamp, interval, capabilities
+        f.push_back(0);
+        f.push_back(static_cast<uint8_t>(strlen(ssid)));
+        f.insert(f.end(), ssid, ssid + strlen(ssid));
+    }
+    return f;
+}
+
+static void macOf(uint32_t n, uint8_t mac[6]) {
+    const uint8_t m[6] = {0x24, 0x0A, 0xC4, uint8_t(n >> 16), uint8_t(n >> 8), uint8_t(n)};
+    memcpy(mac, m, 6);
+}
+
+void test_wifi_station_aggregates_rssi_and_types() {
+    WifiStationManager table;
+    table.begin(64);
+
+    uint8_t ap[6], sta[6];
+    macOf(1, ap);
+    macOf(2, sta);
+
+    auto beacon = buildFrame(0, 8, 0, ap, "HomeNet");
+    TEST_ASSERT_TRUE(table.ingest(beacon.data(), beacon.size(), -40, 6, 100));
+    TEST_ASSERT_TRUE(table.ingest(beacon.data(), beacon.size(), -60, 6, 200));
+    auto data = buildFrame(2, 0, 0x02, ap);                  // from DS
+    TEST_ASSERT_TRUE(table.ingest(data.data(), data.size(), -50, 6, 300));
+
+    auto probe = buildFrame(0, 4, 0, sta, "Cafe");
+    TEST_ASSERT_TRUE(table.ingest(probe.data(), probe.size(), -70, 1, 400));
+    auto ack = std::vector<uint8_t>(10, 0);                  // no transmitter address
+    TEST_ASSERT_FALSE(table.ingest(ack.data(), ack.size(), -70, 1, 500));
+
+    const auto* a = table.find(ap);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_TRUE(a->ap);
+    TEST_ASSERT_EQUAL_STRING("HomeNet", a->ssid);
+    TEST_ASSERT_EQUAL_UINT32(2, a->frames[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, a->frames[2]);
+    TEST_ASSERT_EQUAL_INT(-60, a->rssiMin);
+    TEST_ASSERT_EQUAL_INT(-40, a->rssiMax);
+    TEST_ASSERT_EQUAL_INT(-50, a->rssiAvg());
+    TEST_ASSERT_EQUAL_UINT32(100, a->firstMs);
+    TEST_ASSERT_EQUAL_UINT32(300, a->lastMs);
+
+    const auto* s = table.find(sta);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_FALSE(s->ap);
+    TEST_ASSERT_EQUAL_STRING("Cafe", s->ssid);
+
+    // Hidden SSID does not erase the known name
+    auto hidden = buildFrame(0, 8, 0, ap, "");
+    table.ingest(hidden.data(), hidden.size(), -45, 6, 600);
+    TEST_ASSERT_EQUAL_STRING("HomeNet", table.find(ap)->ssid);
+
+    auto order = table.sorted(10);
+    TEST_ASSERT_EQUAL(2, order.size());
+    TEST_ASSERT_TRUE(order[0] == table.find(ap));
+}
+
+void test_wifi_station_evicts_least_recent() {
+    WifiStationManager table;
+    table.begin(16);                                         // 12 entries
+    TEST_ASSERT_EQUAL(12, table.capacity());
+
+    uint8_t mac[6];
+    for (uint32_t i = 0; i < 12; ++i) {
+        macOf(i, mac);
+        table.touch(mac, i);
+    }
+
+    // 0 is refreshed, 1 becomes the oldest
+    macOf(0, mac);
+    table.touch(mac, 100);
+    macOf(99, mac);
+    table.touch(mac, 101);
+
+    TEST_ASSERT_EQUAL(12, table.size());
+    TEST_ASSERT_EQUAL_UINT32(1, table.evicted());
+    macOf(1, mac);
+    TEST_ASSERT_NULL(table.find(mac));
+    for (uint32_t i : {0u, 2u, 11u, 99u}) {
+        macOf(i, mac);
+        TEST_ASSERT_NOT_NULL(table.find(mac));
+    }
+}
+
+void test_wifi_station_caps_slots_below_link_sentinel() {
+    WifiStationManager table;
+    table.begin(1 << 20);
+    TEST_ASSERT_EQUAL(WifiStationManager::MAX_SLOTS * 3 / 4, table.capacity());
+
+    // Full table, the highest slot indices are linked and evicted like any other
+    uint8_t mac[6];
+    const uint32_t total = static_cast<uint32_t>(table.capacity()) + 10;
+    for (uint32_t i = 0; i < total; ++i) {
+        macOf(i, mac);
+        TEST_ASSERT_NOT_NULL(table.touch(mac, i));
+    }
+    TEST_ASSERT_EQUAL(table.capacity(), table.size());
+    TEST_ASSERT_EQUAL_UINT32(10, table.evicted());
+    for (uint32_t i : {0u, 9u}) {
+        macOf(i, mac);
+        TEST_ASSERT_NULL(table.find(mac));
+    }
+    for (uint32_t i : {10u, total - 1}) {
+        macOf(i, mac);
+        TEST_ASSERT_NOT_NULL(table.find(mac));
+    }
+    TEST_ASSERT_EQUAL(5, table.sorted(5).size());
+}
+
+void test_wifi_station_stays_consistent_under_churn() {
+    WifiStationManager table;
+    table.begin(64);
+
+    // Many more MACs than slots, every entry left must still be found
+    uint8_t mac[6];
+    uint32_t seed = 1;
+    for (uint32_t n = 0; n < 20000; ++n) {
+        seed = seed * 1103515245u + 12345u;
+        macOf((seed >> 8) % 500, mac);
+        TEST_ASSERT_NOT_NULL(table.touch(mac, n));
+    }
+    TEST_ASSERT_EQUAL(table.capacity(), table.size());
+
+    size_t found = 0;
+    for (uint32_t i = 0; i < 500; ++i) {
+        macOf(i, mac);
+        if (table.find(mac)) found++;
+    }
+    TEST_ASSERT_EQUAL(table.size(), found);
+}
+
+void test_wifi_station_throughput() {
+    WifiStationManager table;
+    table.begin(256);
+
+    std::vector<std::vector<uint8_t>> frames;
+    uint8_t mac[6];
+    for (uint32_t i = 0; i < 300; ++i) {
+        macOf(i, mac);
+        frames.push_back(i % 10 == 0 ? buildFrame(0, 8, 0, mac, "BenchNet") : buildFrame(2, 0, 0x01, mac));
+    }
+
+    const uint32_t count = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < count; ++n) {
+        const auto& f = frames[(n * 7919u) % frames.size()];
+        table.ingest(f.data(), f.size(), -50, 6, n);
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "WifiStationManager: %lu frames/s, %u evictions",
+             static_cast<unsigned long>(us ? count * 1000000ULL / us : 0), static_cast<unsigned>(table.evicted()));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(table.capacity(), table.size());
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef TEST_INFRARED_REMOTE_TRANSFORMER_H
+#define TEST_INFRARED_REMOTE_TRANSFORMER_H
+
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Transformers/InfraredRemoteTransformer.h"
+
+// .ir file with `buttons` entries, every other one raw with 60 to 250 timings
+static std::string irRemoteFile(size_t buttons, std::vector<std::vector<uint16_t>>& raws) {
+    std::mt19937 rng(11);
+    std::vector<InfraredFileRemoteCommand> cmds(buttons);
+    raws.assign(buttons, {});
+    for (size_t i = 0; i < buttons; ++i) {
+        InfraredFileRemoteCommand& c = cmds[i];
+        c = InfraredFileRemoteCommand();
+        c.functionName = "Button_" + std::to_string(i);
+        if (i % 2) {
+            const size_t count = 60 + rng() % 191;
+            for (size_t k = 0; k < count; ++k) raws[i].push_back(static_cast<uint16_t>(300 + rng() % 9000));
+            c.protocol = InfraredProtocolEnum::RAW;
+            c.frequency = 38;
+            c.dutyCycle = 0.33f;
+            c.rawData = raws[i].data();
+            c.rawDataSize = raws[i].size();
+        } else {
+            c.protocol = _48_NEC1;
+            c.address = static_cast<uint16_t>(rng() & 0xFF);
+            c.function = static_cast<uint8_t>(rng());
+        }
+    }
+    return InfraredRemoteTransformer::transformToFileFormat("bench", cmds);
+}
+
+static std::vector<InfraredRemoteTransformer::ButtonOffset> irIndex(InfraredRemoteTransformer& t, const std::string& file, size_t chunk) {
+    t.beginIndex();
+    for (size_t off = 0; off < file.size(); off += chunk) {
+        const size_t n = std::min(chunk, file.size() - off);
+        t.feedIndex(reinterpret_cast<const uint8_t*>(file.data() + off), n);
+    }
+    return t.endIndex();
+}
+
+static void irFreeCommands(std::vector<InfraredFileRemoteCommand>& cmds) {
+    for (auto& c : cmds) delete[] c.rawData;
+    cmds.clear();
+}
+
+void test_infrared_index_matches_whole_file_parse() {
+    std::vector<std::vector<uint16_t>> raws;
+    const std::string file = irRemoteFile(40, raws);
+    auto whole = InfraredRemoteTransformer::transformFromFileFormat(file);
+    TEST_ASSERT_EQUAL(40, whole.size());
+
+    for (size_t chunk : {size_t(1), size_t(7), size_t(4096)}) {
+        InfraredRemoteTransformer t;
+        const auto buttons = irIndex(t, file, chunk);
+        TEST_ASSERT_TRUE(t.indexLooksValid());
+        TEST_ASSERT_EQUAL(whole.size(), buttons.size());
+
+        std::vector<uint16_t> storage;
+        for (size_t i = 0; i < buttons.size(); ++i) {
+            const auto& b = buttons[i];
+            TEST_ASSERT_EQUAL_STRING(whole[i].functionName.c_str(), b.name.c_str());
+            TEST_ASSERT_EQUAL(i % 2 == 1, b.raw);
+
+            // What LittleFsService::readRange returns for the button
+            InfraredFileRemoteCommand cmd;
+            TEST_ASSERT_TRUE(InfraredRemoteTransformer::parseButton(file.substr(b.offset, b.length), cmd, storage));
+            TEST_ASSERT_EQUAL_STRING(whole[i].functionName.c_str(), cmd.functionName.c_str());
+            TEST_ASSERT_EQUAL(whole[i].protocol, cmd.protocol);
+            if (b.raw) {
+                TEST_ASSERT_EQUAL(raws[i].size(), cmd.rawDataSize);
+                TEST_ASSERT_TRUE(std::vector<uint16_t>(cmd.rawData, cmd.rawData + cmd.rawDataSize) == raws[i]);
+                TEST_ASSERT_EQUAL_INT(38, cmd.frequency);
+            } else {
+                TEST_ASSERT_EQUAL_UINT32(whole[i].address, cmd.address);
+                TEST_ASSERT_EQUAL_UINT32(whole[i].function, cmd.function);
+            }
+        }
+    }
+
+    // A longer range than the button still stops at the next name
+    InfraredRemoteTransformer t;
+    const auto buttons = irIndex(t, file, 4096);
+    InfraredFileRemoteCommand cmd;
+    std::vector<uint16_t> storage;
+    TEST_ASSERT_TRUE(InfraredRemoteTransformer::parseButton(file.substr(buttons[1].offset, buttons[1].length * 3), cmd, storage));
+    TEST_ASSERT_EQUAL(raws[1].size(), cmd.rawDataSize);
+
+    // Not an IR file
+    const std::string sub = "Filetype: Flipper SubGhz RAW File\nname: x\n";
+    irIndex(t, sub, 4096);
+    TEST_ASSERT_FALSE(t.indexLooksValid());
+    irFreeCommands(whole);
+}
+
+void test_infrared_index_large_file() {
+    std::vector<std::vector<uint16_t>> raws;
+    const std::string file = irRemoteFile(6000, raws);
+    const uint32_t rounds = 5;
+
+    // Before, the whole file parsed into commands
+    size_t wholeBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        auto cmds = InfraredRemoteTransformer::transformFromFileFormat(file);
+        wholeBytes = cmds.capacity() * sizeof(InfraredFileRemoteCommand);
+        for (const auto& c : cmds) wholeBytes += c.functionName.capacity() + c.rawDataSize * sizeof(uint16_t);
+        irFreeCommands(cmds);
+    }
+    auto wholeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // After, names and offsets in 4 KB chunks, then one button decoded
+    InfraredRemoteTransformer t;
+    std::vector<InfraredRemoteTransformer::ButtonOffset> buttons;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) buttons = irIndex(t, file, 4096);
+    auto indexUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL(6000, buttons.size());
+
+    size_t indexBytes = buttons.capacity() * sizeof(InfraredRemoteTransformer::ButtonOffset);
+    for (const auto& b : buttons) indexBytes += b.name.capacity();
+
+    InfraredFileRemoteCommand cmd;
+    std::vector<uint16_t> storage;
+    const auto& last = buttons.back();
+    start = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(InfraredRemoteTransformer::parseButton(file.substr(last.offset, last.length), cmd, storage));
+    auto selectUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(storage == raws.back());
+
+    const uint64_t total = static_cast<uint64_t>(file.size()) * rounds;
+    char msg[192];
+    snprintf(msg, sizeof(msg),
+             "InfraredRemoteTransformer: %lu KB file, whole parse %lu KB/s %lu KB held, index %lu KB/s %lu KB held, one button %lu us",
+             static_cast<unsigned long>(file.size() / 1024),
+             static_cast<unsigned long>(wholeUs ? total * 1000000ULL / 1024 / wholeUs : 0),
+             static_cast<unsigned long>(wholeBytes / 1024),
+             static_cast<unsigned long>(indexUs ? total * 1000000ULL / 1024 / indexUs : 0),
+             static_cast<unsigned long>(indexBytes / 1024),
+             static_cast<unsigned long>(selectUs));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(indexBytes * 2 < wholeBytes);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef TEST_SUBGHZ_TRANSFORMER_H
+#define TEST_SUBGHZ_TRANSFORMER_H
+
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Transformers/SubGhzTransformer.h"
+
+static const char* SUB_RAW_HEADER =
+    "Filetype: Flipper SubGhz RAW File\n"
+    "Version: 1\n"
+    "Frequency: 433920000\n"
+    "Preset: FuriHalSubGhzPresetOok650Async\n"
+    "Protocol: RAW\n";
+
+// RAW file of about `bytes`, lines of 512 timings, every 64th low is a long silence
+static std::string subRawFile(size_t bytes, std::vector<int32_t>& timings) {
+    std::mt19937 rng(7);
+    std::string file = SUB_RAW_HEADER;
+    timings.clear();
+    while (file.size() < bytes) {
+        file += "RAW_Data:";
+        for (int i = 0; i < 512; ++i) {
+            int32_t v = static_cast<int32_t>(100 + rng() % 1500);
+            if (i & 1) v = (i % 64 == 63) ? -12000 : -v;
+            timings.push_back(v);
+            file += ' ';
+            file += std::to_string(v);
+        }
+        file += '\n';
+    }
+    return file;
+}
+
+// Streams `file` in chunks of `chunk` bytes, timings are collected
+static std::vector<SubGhzFileCommand> subStream(const std::string& file, size_t chunk,
+                                                std::vector<int32_t>& out, size_t& maxBatch) {
+    SubGhzTransformer transformer;
+    out.clear();
+    maxBatch = 0;
+    transformer.beginStream([&](const int32_t* t, size_t n) {
+        out.insert(out.end(), t, t + n);
+        if (n > maxBatch) maxBatch = n;
+        return true;
+    }, "/bench.sub");
+    for (size_t off = 0; off < file.size(); off += chunk) {
+        const size_t n = file.size() - off < chunk ? file.size() - off : chunk;
+        if (!transformer.feedStream(reinterpret_cast<const uint8_t*>(file.data()) + off, n)) break;
+    }
+    return transformer.endStream();
+}
+
+void test_subghz_stream_matches_whole_file_parse() {
+    const std::string file = std::string(SUB_RAW_HEADER) +
+                             "RAW_Data: 100 -200 300 -4000 x5 -0 +7\r\n"
+                             "RAW_Data: 12 -13";
+    SubGhzTransformer transformer;
+    const auto whole = transformer.transformFromFileFormat(file, "/a.sub");
+    TEST_ASSERT_EQUAL(1, whole.size());
+
+    // Same timings whatever the chunk boundaries
+    for (size_t chunk : { static_cast<size_t>(1), static_cast<size_t>(7), static_cast<size_t>(4096) }) {
+        std::vector<int32_t> timings;
+        size_t maxBatch = 0;
+        const auto cmds = subStream(file, chunk, timings, maxBatch);
+        TEST_ASSERT_EQUAL(1, cmds.size());
+        TEST_ASSERT_TRUE(cmds[0].protocol == SubGhzProtocolEnum::RAW);
+        TEST_ASSERT_EQUAL_UINT32(433920000, cmds[0].frequency_hz);
+        TEST_ASSERT_TRUE(cmds[0].raw_timings.empty());
+        TEST_ASSERT_EQUAL(whole[0].raw_timings.size(), cmds[0].raw_count);
+        TEST_ASSERT_TRUE(timings == whole[0].raw_timings);
+    }
+}
+
+void test_subghz_stream_multi_megabyte_file() {
+    std::vector<int32_t> expected;
+    const std::string file = subRawFile(4u << 20, expected);
+
+    std::vector<int32_t> timings;
+    size_t maxBatch = 0;
+    auto start = std::chrono::steady_clock::now();
+    const auto cmds = subStream(file, 4096, timings, maxBatch);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char msg[112];
+    snprintf(msg, sizeof(msg), "SubGhzTransformer: %lu KB/s streamed in 4 KB chunks, largest batch %u",
+             static_cast<unsigned long>(us ? file.size() * 1000000ULL / 1024 / us : 0), static_cast<unsigned>(maxBatch));
+    TEST_MESSAGE(msg);
+
+    // Nothing is held, batches stay bounded, every timing comes out once
+    TEST_ASSERT_EQUAL(1, cmds.size());
+    TEST_ASSERT_EQUAL(expected.size(), cmds[0].raw_count);
+    TEST_ASSERT_TRUE(timings == expected);
+    TEST_ASSERT_TRUE(maxBatch <= 256);
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef TEST_MAKE_HEX_H
+#define TEST_MAKE_HEX_H
+
+#include <unity.h>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/Vendors/MakeHex.h"
+#include "../src/Data/UniversalRemoteCommands.h"
+
+struct MakeHexCase {
+    InfraredCommand cmd;
+    std::string protocol;
+};
+
+// Every universal remote command, the ordering the universal remote sends them
+static std::vector<MakeHexCase> makeHexCorpus() {
+    std::vector<MakeHexCase> corpus;
+    auto add = [&](const InfraredCommandStruct* list, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            corpus.push_back({ InfraredCommand(list[i].proto, list[i].device, list[i].subdevice, list[i].function),
+                               InfraredProtocolMapper::toString(list[i].proto) });
+        }
+    };
+    add(universalOnOff, sizeof(universalOnOff) / sizeof(universalOnOff[0]));
+    add(universalMute, sizeof(universalMute) / sizeof(universalMute[0]));
+    add(universalPlay, sizeof(universalPlay) / sizeof(universalPlay[0]));
+    add(universalPause, sizeof(universalPause) / sizeof(universalPause[0]));
+    add(universalVolUp, sizeof(universalVolUp) / sizeof(universalVolUp[0]));
+    add(universalVolDown, sizeof(universalVolDown) / sizeof(universalVolDown[0]));
+    add(universalChannelUp, sizeof(universalChannelUp) / sizeof(universalChannelUp[0]));
+    add(universalChannelDown, sizeof(universalChannelDown) / sizeof(universalChannelDown[0]));
+    return corpus;
+}
+
+static int makeHexFindLinear(const char* name) {
+    for (size_t i = 0; i < sizeof(protocolDefinitions) / sizeof(protocolDefinitions[0]); ++i) {
+        if (strcmp(protocolDefinitions[i].name, name) == 0) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Per protocol digest of the universal remote corpus, produced by the encoder before the
+// template cache (vector<float> encodeRemoteCommand, timings cast to uint16_t).
+// FNV-1a 32 over frequency, sequence length and timings, in corpus order.
+struct MakeHexBaseline {
+    const char* protocol;
+    uint32_t    commands;
+    uint32_t    pulses;
+    uint32_t    digest;
+};
+
+static const MakeHexBaseline MAKE_HEX_BASELINE[] = {
+    { "NECx2", 39, 2652, 0x2C9F85DCu },
+    { "Samsung32", 8, 544, 0x46B017C5u },
+    { "Samsung20", 20, 880, 0xFE8F5DB5u },
+    { "Samsung36", 5, 390, 0x73DF001Au },
+    { "nec1", 470, 33840, 0x1D7830F5u },
+    { "rc5", 137, 2992, 0xE5F4228Du },
+    { "sony20", 21, 882, 0x98ADF1B1u },
+    { "nec2", 55, 3740, 0x92D1C576u },
+    { "rc6", 24, 934, 0x67C8129Fu },
+    { "fujitsu", 4, 400, 0xC3AD038Eu },
+    { "aiwa", 42, 3864, 0x152F0AADu },
+    { "panasonic", 55, 5500, 0x184B094Bu },
+    { "jvc", 45, 1620, 0x5CA8DF31u },
+    { "denon", 11, 704, 0xA98E4FD0u },
+    { "Mitsubishi", 19, 646, 0x1864644Au },
+    { "sharp", 20, 1280, 0x39B35745u },
+    { "rc6-6-20", 2, 100, 0x5C3DAF11u },
+    { "sony12", 61, 1586, 0x39693662u },
+    { "apple", 2, 136, 0xFBD564E1u },
+    { "logitech", 3, 204, 0x46CE5A42u },
+    { "bose", 11, 748, 0x4EDE7692u },
+    { "directv", 6, 408, 0xED60C579u },
+    { "mce", 46, 3030, 0x123A80C3u },
+    { "zenith", 4, 272, 0xEAACB021u },
+    { "rca", 18, 936, 0x826FB089u },
+    { "grundig16", 2, 136, 0xCF1136A1u },
+    { "Tivo-Nec1", 11, 792, 0x82B05AD8u },
+    { "streamzap", 11, 292, 0x3F5EF62Eu },
+    { "pioneer", 12, 816, 0x0A57AD55u },
+    { "akai", 8, 544, 0x96E504B5u },
+    { "Thomson", 11, 286, 0x72495BCBu },
+    { "XMP", 3, 162, 0xF7BB616Au },
+    { "zaptor_56", 3, 204, 0x4C76A8BEu },
+    { "barco", 3, 204, 0x369B8562u },
+    { "f12", 2, 96, 0xD0922675u },
+    { "NECx1", 28, 2072, 0x4181F381u },
+    { "Teac-K", 1, 104, 0x3EEC1185u },
+    { "recs80_45", 19, 456, 0x6D2E425Au },
+    { "Proton", 13, 494, 0x7A011025u },
+    { "sony15", 12, 384, 0x14F55D84u },
+    { "Nokia32", 8, 288, 0xE3376361u },
+    { "blaupunkt", 3, 128, 0x6D8AF1C7u },
+    { "jvc_two_frames", 2, 140, 0xD0B40A22u },
+    { "DishPlayer_Network", 6, 216, 0xE17371E8u },
+    { "GI_cable", 2, 80, 0xFBA62F75u },
+    { "replay", 2, 136, 0x1C1A3479u },
+    { "emerson", 1, 52, 0xC7B8CF80u },
+    { "Dgtec", 1, 52, 0x5491DD2Cu },
+    { "Denon-K", 1, 100, 0x704FABCFu },
+    { "GI4dtv", 1, 28, 0x40E2B581u },
+};
+
+static void makeHexMix(uint32_t& h, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) h = (h ^ ((v >> (8 * i)) & 0xFF)) * 16777619u;
+}
+
+// Uncached encode, linear lookup and a fresh IRP parse per command, the throughput reference
+static bool makeHexEncodeUncached(const InfraredCommand& cmd, const char* protocolString, int& frequency, std::vector<uint16_t>& out) {
+    char defines[64] = "";
+    int p = makeHexFindLinear(protocolString);
+    if (p < 0) {
+        int M = 0;
+        int L = 0;
+        char tempProt[100];
+        strncpy(tempProt, protocolString, sizeof(tempProt));
+        tempProt[sizeof(tempProt) - 1] = '\0';
+        for (size_t i = 0; i < strlen(tempProt); i++) tempProt[i] = toupper(tempProt[i]);
+
+        if (sscanf(tempProt, "RC6-%d-%d", &M, &L) == 2) {
+            snprintf(defines, sizeof(defines), "Define M=%d\nDefine L=%d\n", M, L);
+            protocolString = "rc6-M-L";
+        } else if (strcmp("NEC", tempProt) == 0) {
+            protocolString = "nec2";
+        } else if (strcmp("NECX", tempProt) == 0) {
+            protocolString = "NECx2";
+        }
+        p = makeHexFindLinear(protocolString);
+        if (p < 0) p = makeHexFindLinear("nec2");
+    }
+
+    std::string irpText = cmd.getSubdevice() >= 0 ? "Device=0.0\n" : "Device=0\n";
+    irpText += "Function=0\n";
+    irpText += defines;
+    irpText += protocolDefinitions[p].def;
+
+    IRP irp;
+    if (!irp.readIrpString(&irpText[0])) {
+        out.clear();
+        return false;
+    }
+    const char* freqStr = strstr(protocolDefinitions[p].def, "Frequency=");
+    int hz = 0;
+    if (freqStr != nullptr && sscanf(freqStr, "Frequency=%d", &hz) == 1) frequency = hz / 1000;
+
+    irp.m_value['D' - 'A'] = cmd.getDevice();
+    irp.m_value['S' - 'A'] = cmd.getSubdevice();
+    irp.m_value['F' - 'A'] = cmd.getFunction();
+    irp.m_value['N' - 'A'] = -1;
+    const std::vector<float>& seq = irp.generate();
+    out.resize(seq.size());
+    for (size_t i = 0; i < seq.size(); ++i) out[i] = static_cast<uint16_t>(seq[i]);
+    return true;
+}
+
+void test_make_hex_matches_baseline_timings() {
+    const auto corpus = makeHexCorpus();
+    TEST_ASSERT_TRUE(corpus.size() > 100);
+
+    std::vector<MakeHexBaseline> got;
+    std::vector<uint16_t> out;
+    for (const auto& c : corpus) {
+        int freq = 38;
+        TEST_ASSERT_TRUE(encodeRemoteCommand(c.cmd, c.protocol.c_str(), freq, out));
+
+        MakeHexBaseline* row = nullptr;
+        for (auto& r : got) if (c.protocol == r.protocol) row = &r;
+        if (!row) {
+            got.push_back({ c.protocol.c_str(), 0, 0, 2166136261u });
+            row = &got.back();
+        }
+        row->commands++;
+        row->pulses += out.size();
+        makeHexMix(row->digest, static_cast<uint32_t>(freq), 4);
+        makeHexMix(row->digest, static_cast<uint32_t>(out.size()), 4);
+        for (uint16_t t : out) makeHexMix(row->digest, t, 2);
+    }
+
+    const size_t count = sizeof(MAKE_HEX_BASELINE) / sizeof(MAKE_HEX_BASELINE[0]);
+    TEST_ASSERT_EQUAL(count, got.size());
+    for (size_t i = 0; i < count; ++i) {
+        const auto& base = MAKE_HEX_BASELINE[i];
+        TEST_ASSERT_EQUAL_STRING(base.protocol, got[i].protocol);
+        TEST_ASSERT_EQUAL_UINT32(base.commands, got[i].commands);
+        if (strcmp(base.protocol, "XMP") == 0) {
+            // The old encoder cut the XMP definition at 512 bytes and lost its repeat frame
+            TEST_ASSERT_TRUE(got[i].pulses > base.pulses);
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT32(base.pulses, got[i].pulses);
+        TEST_ASSERT_EQUAL_UINT32(base.digest, got[i].digest);
+    }
+
+    // Same protocol, different values, the cached template must not keep the old ones
+    int freq = 38;
+    std::vector<uint16_t> a, b;
+    TEST_ASSERT_TRUE(encodeRemoteCommand(InfraredCommand(_NEC, 4, -1, 8), "nec1", freq, a));
+    TEST_ASSERT_TRUE(encodeRemoteCommand(InfraredCommand(_NEC, 4, -1, 9), "nec1", freq, b));
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_TRUE(makeHexEncodeUncached(InfraredCommand(_NEC, 4, -1, 8), "nec1", freq, b));
+    TEST_ASSERT_TRUE(a == b);
+}
+
+void test_make_hex_concurrent_encoders() {
+    const auto corpus = makeHexCorpus();
+    std::vector<std::vector<uint16_t>> expected(corpus.size());
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        int freq = 38;
+        encodeRemoteCommand(corpus[i].cmd, corpus[i].protocol.c_str(), freq, expected[i]);
+    }
+
+    // The batch encoder task and the sender share the template cache, opposite orders keep it churning
+    auto run = [&](bool reverse, size_t& mismatches) {
+        std::vector<uint16_t> out;
+        for (uint32_t r = 0; r < 3; ++r) {
+            for (size_t k = 0; k < corpus.size(); ++k) {
+                const size_t i = reverse ? corpus.size() - 1 - k : k;
+                int freq = 38;
+                encodeRemoteCommand(corpus[i].cmd, corpus[i].protocol.c_str(), freq, out);
+                if (out != expected[i]) mismatches++;
+            }
+        }
+    };
+    size_t forward = 0, backward = 0;
+    std::thread other(run, true, std::ref(backward));
+    run(false, forward);
+    other.join();
+    TEST_ASSERT_EQUAL(0, forward);
+    TEST_ASSERT_EQUAL(0, backward);
+}
+
+void test_make_hex_encode_throughput() {
+    const auto corpus = makeHexCorpus();
+    const uint32_t rounds = 20;
+    const uint32_t count = rounds * static_cast<uint32_t>(corpus.size());
+    std::vector<uint16_t> out;
+    size_t pulses = 0;
+    int freq = 38;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (const auto& c : corpus) {
+            makeHexEncodeUncached(c.cmd, c.protocol.c_str(), freq, out);
+            pulses += out.size();
+        }
+    }
+    auto beforeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (const auto& c : corpus) {
+            encodeRemoteCommand(c.cmd, c.protocol.c_str(), freq, out);
+            pulses -= out.size();
+        }
+    }
+    auto afterUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "MakeHex: %lu encodes/s uncached, %lu encodes/s cached (%lu commands)",
+             static_cast<unsigned long>(beforeUs ? count * 1000000ULL / beforeUs : 0),
+             static_cast<unsigned long>(afterUs ? count * 1000000ULL / afterUs : 0),
+             static_cast<unsigned long>(corpus.size()));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(0, pulses);
+}
+
+#endif
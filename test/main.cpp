@@ -1,8 +1,89 @@
 #include <unity.h>
+#include "Managers/TestWifiStationManager.cpp"
+#include "Managers/TestWifiChannelManager.cpp"
+#include "Managers/TestBluetoothDeviceManager.cpp"
+#include "Managers/TestModbusScanManager.cpp"
+#include "Managers/TestNetBenchManager.cpp"
+#include "Managers/TestStringExtractManager.cpp"
+#include "Managers/TestSubGhzDecodeManager.cpp"
+#include "Managers/TestSubGhzWaterfallManager.cpp"
+#include "Managers/TestSignalLibraryManager.cpp"
+#include "Managers/TestInfraredMatchManager.cpp"
+#include "Managers/TestInfraredLearnManager.cpp"
+#include "Managers/TestICMPSweepManager.cpp"
+#include "Managers/TestNmapScanManager.cpp"
+#include "Managers/TestSessionIoManager.cpp"
+#include "Managers/TestHttpStreamManager.cpp"
+#include "Transformers/TestSubGhzTransformer.cpp"
+#include "Transformers/TestInfraredRemoteTransformer.cpp"
+#include "Vendors/TestMakeHex.cpp"
 
 void setup() {
     UNITY_BEGIN();
     // Tests
+    RUN_TEST(test_wifi_station_aggregates_rssi_and_types);
+    RUN_TEST(test_wifi_station_evicts_least_recent);
+    RUN_TEST(test_wifi_station_caps_slots_below_link_sentinel);
+    RUN_TEST(test_wifi_station_stays_consistent_under_churn);
+    RUN_TEST(test_wifi_station_throughput);
+    RUN_TEST(test_wifi_channel_parse_sets);
+    RUN_TEST(test_wifi_channel_skip_credits_nothing);
+    RUN_TEST(test_bluetooth_device_counters_and_payload);
+    RUN_TEST(test_bluetooth_device_ages_and_evicts);
+    RUN_TEST(test_bluetooth_device_take_new);
+    RUN_TEST(test_modbus_scan_discovers_sparse_map);
+    RUN_TEST(test_modbus_scan_reports_silent_blocks);
+    RUN_TEST(test_modbus_scan_pipelining_cuts_round_trips);
+    RUN_TEST(test_modbus_monitor_batches_and_diffs);
+    RUN_TEST(test_net_bench_counts_loss_and_reordering);
+    RUN_TEST(test_net_bench_jitter_follows_rfc1889);
+    RUN_TEST(test_net_bench_datagram_and_report_round_trip);
+    RUN_TEST(test_net_bench_rates);
+    RUN_TEST(test_string_extract_dedupe_grows_past_initial_table);
+    RUN_TEST(test_string_extract_dedupe_saturation_is_counted);
+    RUN_TEST(test_string_extract_dedupe_resets_on_begin);
+    RUN_TEST(test_string_extract_utf16le_across_feeds);
+    RUN_TEST(test_string_extract_ascii_run_across_blocks);
+    RUN_TEST(test_string_extract_min_length_cutoff);
+    RUN_TEST(test_subghz_decode_pair_protocols);
+    RUN_TEST(test_subghz_decode_manchester);
+    RUN_TEST(test_subghz_decode_tolerates_jitter);
+    RUN_TEST(test_subghz_decode_noisy_captures);
+    RUN_TEST(test_subghz_decode_bits_to_hex);
+    RUN_TEST(test_subghz_decode_throughput);
+    RUN_TEST(test_subghz_waterfall_rows_newest_first_across_wrap);
+    RUN_TEST(test_subghz_waterfall_begin_fails_without_memory);
+    RUN_TEST(test_subghz_stream_matches_whole_file_parse);
+    RUN_TEST(test_subghz_stream_multi_megabyte_file);
+    RUN_TEST(test_signal_library_indexes_and_saves);
+    RUN_TEST(test_signal_library_rereads_changed_files_only);
+    RUN_TEST(test_signal_library_hides_duplicates_among_matches);
+    RUN_TEST(test_signal_library_rebuilds_unknown_catalog);
+    RUN_TEST(test_infrared_match_signature);
+    RUN_TEST(test_infrared_match_tolerates_jitter);
+    RUN_TEST(test_infrared_match_scoring_order);
+    RUN_TEST(test_infrared_match_no_match);
+    RUN_TEST(test_infrared_learn_segments_presses);
+    RUN_TEST(test_infrared_learn_ignored_frames_open_no_press);
+    RUN_TEST(test_infrared_learn_duplicates);
+    RUN_TEST(test_icmp_sweep_classifies_replies);
+    RUN_TEST(test_icmp_sweep_rtt_statistics);
+    RUN_TEST(test_icmp_sweep_histogram_buckets);
+    RUN_TEST(test_nmap_expand_hosts);
+    RUN_TEST(test_nmap_timeout_follows_rtt);
+    RUN_TEST(test_session_io_flushes_on_newline_and_size);
+    RUN_TEST(test_session_io_flushes_when_idle);
+    RUN_TEST(test_session_io_partial_sends_and_failure);
+    RUN_TEST(test_session_io_drain);
+    RUN_TEST(test_http_stream_json_splits);
+    RUN_TEST(test_http_stream_json_filter_and_ndjson);
+    RUN_TEST(test_http_stream_chunked_splits);
+    RUN_TEST(test_http_stream_bad_framing);
+    RUN_TEST(test_infrared_index_matches_whole_file_parse);
+    RUN_TEST(test_infrared_index_large_file);
+    RUN_TEST(test_make_hex_matches_baseline_timings);
+    RUN_TEST(test_make_hex_concurrent_encoders);
+    RUN_TEST(test_make_hex_encode_throughput);
     UNITY_END();
 }
 
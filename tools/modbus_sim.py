@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Modbus TCP device simulator for the Modbus shell (register map scan and monitor).
+
+    python3 tools/modbus_sim.py [--port 5020] [--latency 20]
+
+Map: holding 0-99, 200-209, 1000-1299, 4000; input 0-15, 3000-3003;
+coils 0-63, 100-1099; discrete inputs answer ILLEGAL FUNCTION.
+Holding 1005, input 2 and coil 120 change every 200 ms for the monitor.
+Requests are answered after --latency ms each, pipelined requests overlap,
+replies keep their order.
+"""
+import argparse
+import asyncio
+import struct
+
+
+def span(*pairs):
+    out = set()
+    for first, last in pairs:
+        out.update(range(first, last + 1))
+    return out
+
+
+VALID = {
+    1: span((0, 63), (100, 1099)),
+    3: span((0, 99), (200, 209), (1000, 1299), (4000, 4000)),
+    4: span((0, 15), (3000, 3003)),
+}
+holding = {a: a & 0xFFFF for a in VALID[3]}
+inputs = {a: 0 for a in VALID[4]}
+coils = {a: a % 3 == 0 for a in VALID[1]}
+
+
+async def ticker():
+    n = 0
+    while True:
+        await asyncio.sleep(0.2)
+        n += 1
+        holding[1005] = (holding[1005] + 1) & 0xFFFF
+        inputs[2] = n & 0xFFFF
+        if n % 2 == 0:
+            coils[120] = not coils[120]
+
+
+def exception(fc, code):
+    return struct.pack(">BB", fc | 0x80, code)
+
+
+def answer(fc, addr, qty):
+    if fc not in VALID:
+        return exception(fc, 0x01)
+    limit = 2000 if fc in (1, 2) else 125
+    if qty < 1 or qty > limit:
+        return exception(fc, 0x03)
+    if any(a not in VALID[fc] for a in range(addr, addr + qty)):
+        return exception(fc, 0x02)
+
+    if fc in (3, 4):
+        table = holding if fc == 3 else inputs
+        data = b"".join(struct.pack(">H", table[a]) for a in range(addr, addr + qty))
+        return struct.pack(">BB", fc, len(data)) + data
+
+    packed = bytearray((qty + 7) // 8)
+    for i, a in enumerate(range(addr, addr + qty)):
+        if coils[a]:
+            packed[i // 8] |= 1 << (i % 8)
+    return struct.pack(">BB", fc, len(packed)) + bytes(packed)
+
+
+def serve(latency, stats):
+    async def client(reader, writer):
+        loop = asyncio.get_running_loop()
+        last = 0.0
+        try:
+            while True:
+                tid, _, length, unit = struct.unpack(">HHHB", await reader.readexactly(7))
+                pdu = await reader.readexactly(length - 1)
+                if len(pdu) >= 5:
+                    fc, addr, qty = struct.unpack(">BHH", pdu[:5])
+                    reply = answer(fc, addr, qty)
+                else:
+                    reply = exception(pdu[0] if pdu else 0, 0x03)
+                stats["requests"] += 1
+
+                frame = struct.pack(">HHHB", tid, 0, len(reply) + 1, unit) + reply
+                due = max(loop.time() + latency, last + 0.0003)
+                last = due
+                loop.call_at(due, writer.write, frame)
+        except (asyncio.IncompleteReadError, ConnectionResetError):
+            pass
+        finally:
+            print(f"client closed, {stats['requests']} requests so far")
+
+    return client
+
+
+async def main():
+    parser = argparse.ArgumentParser(description="Modbus TCP device simulator")
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=5020)
+    parser.add_argument("--latency", type=float, default=20.0, help="reply delay in ms")
+    args = parser.parse_args()
+
+    stats = {"requests": 0}
+    asyncio.create_task(ticker())
+    server = await asyncio.start_server(serve(args.latency / 1000.0, stats), args.host, args.port)
+    print(f"Modbus simulator on {args.host}:{args.port}, latency {args.latency} ms")
+    async with server:
+        await server.serve_forever()
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
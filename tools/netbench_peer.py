@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""
+Host peer for the `bench` command, speaks the iperf 2 wire format.
+
+Device sends, host receives:
+    python3 tools/netbench_peer.py -s            # then: bench tcp send <host ip>
+    python3 tools/netbench_peer.py -s -u         # then: bench udp send <host ip> -b 20
+
+Device receives, host sends:
+    bench tcp recv                               # then: netbench_peer.py -c <device ip>
+    bench udp recv                               # then: netbench_peer.py -c <device ip> -u -b 20
+
+iperf 2 works as well in place of this script (iperf -s [-u], iperf -c <ip> [-u -b 20M]).
+"""
+import argparse
+import socket
+import struct
+import sys
+import time
+
+REPORT_VERSION1 = 0x80000000
+DATAGRAM = struct.Struct(">iII")                    # id, tv_sec, tv_usec
+REPORT = struct.Struct(">iIIIIiiiii")               # after the datagram header
+FIN_TRIES = 10
+FIN_WAIT = 0.25
+
+
+def mbps(nbytes, seconds):
+    return nbytes * 8 / seconds / 1e6 if seconds > 0 else 0.0
+
+
+def interval_line(start, end, nbytes, extra=""):
+    return f"[{start:5.1f}-{end:5.1f} s] {nbytes / 1024:9.1f} KB  {mbps(nbytes, end - start):7.2f} Mbit/s{extra}"
+
+
+def set_window(sock, option, size):
+    if size:
+        sock.setsockopt(socket.SOL_SOCKET, option, size)
+    return sock.getsockopt(socket.SOL_SOCKET, option)
+
+
+class UdpStats:
+    """Loss by sequence number, RFC 1889 jitter from transit time differences."""
+
+    def __init__(self):
+        self.max_id = -1
+        self.received = 0
+        self.lost = 0
+        self.out_of_order = 0
+        self.jitter = 0.0
+        self.last_transit = None
+
+    def add(self, seq, sent, arrival):
+        transit = arrival - sent
+        if self.last_transit is not None:
+            self.jitter += (abs(transit - self.last_transit) - self.jitter) / 16
+        self.last_transit = transit
+        self.received += 1
+        if seq > self.max_id:
+            if seq > self.max_id + 1:
+                self.lost += seq - self.max_id - 1
+            self.max_id = seq
+        else:
+            self.out_of_order += 1
+            if self.lost:
+                self.lost -= 1
+
+
+def tcp_server(args):
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    window = set_window(srv, socket.SO_RCVBUF, args.window)
+    srv.bind(("", args.port))
+    srv.listen(1)
+    print(f"TCP server on port {args.port}, receive buffer {window} bytes")
+    while True:
+        conn, peer = srv.accept()
+        print(f"connection from {peer[0]}:{peer[1]}")
+        total = 0
+        start = last = time.monotonic()
+        mark = 0
+        with conn:
+            while True:
+                data = conn.recv(65536)
+                now = time.monotonic()
+                if not data:
+                    break
+                total += len(data)
+                if now - last >= args.interval:
+                    print(interval_line(last - start, now - start, total - mark))
+                    last, mark = now, total
+        elapsed = time.monotonic() - start
+        print(f"total {total} bytes in {elapsed:.2f} s: {mbps(total, elapsed):.2f} Mbit/s\n")
+        if args.once:
+            return
+
+
+def udp_server(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    window = set_window(sock, socket.SO_RCVBUF, args.window)
+    sock.bind(("", args.port))
+    print(f"UDP server on port {args.port}, receive buffer {window} bytes")
+    while True:
+        stats = UdpStats()
+        peer = None
+        total = mark = 0
+        start = last = None
+        lost_mark = 0
+        while True:
+            data, addr = sock.recvfrom(65536)
+            now = time.time()
+            if len(data) < DATAGRAM.size:
+                continue
+            seq, sec, usec = DATAGRAM.unpack_from(data)
+            if peer is None:
+                if seq < 0:
+                    continue
+                peer, start, last = addr, now, now
+                print(f"datagrams from {addr[0]}:{addr[1]}")
+            if addr != peer:
+                continue
+            if seq < 0:
+                break
+            stats.add(seq, sec + usec / 1e6, now)
+            total += len(data)
+            if now - last >= args.interval:
+                print(interval_line(last - start, now - start, total - mark,
+                                    f"  jitter {stats.jitter * 1e3:6.3f} ms  lost {stats.lost - lost_mark}"))
+                last, mark, lost_mark = now, total, stats.lost
+
+        elapsed = time.time() - start
+        jitter_us = int(stats.jitter * 1e6)
+        report = DATAGRAM.pack(seq, sec, usec) + REPORT.pack(
+            REPORT_VERSION1 - (1 << 32), total >> 32, total & 0xFFFFFFFF,
+            int(elapsed), int((elapsed % 1) * 1e6), stats.lost, stats.out_of_order,
+            stats.max_id + 1, jitter_us // 1000000, jitter_us % 1000000)
+        sock.sendto(report, peer)
+
+        # The sender repeats its final datagram until the report arrives
+        sock.settimeout(2 * FIN_WAIT)
+        try:
+            while True:
+                data, addr = sock.recvfrom(65536)
+                if addr == peer and len(data) >= DATAGRAM.size and DATAGRAM.unpack_from(data)[0] < 0:
+                    sock.sendto(report, peer)
+        except socket.timeout:
+            pass
+        sock.settimeout(None)
+
+        expected = stats.max_id + 1
+        loss = 100.0 * stats.lost / expected if expected else 0.0
+        print(f"total {total} bytes in {elapsed:.2f} s: {mbps(total, elapsed):.2f} Mbit/s, "
+              f"jitter {stats.jitter * 1e3:.3f} ms, lost {stats.lost}/{expected} ({loss:.1f}%), "
+              f"out of order {stats.out_of_order}\n")
+        if args.once:
+            return
+
+
+def tcp_client(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    window = set_window(sock, socket.SO_SNDBUF, args.window)
+    sock.connect((args.client, args.port))
+    print(f"TCP to {args.client}:{args.port}, {args.length} byte writes, send buffer {window} bytes")
+    buf = bytes(args.length)        # zero filled, the receiver reads no options from the header
+    total = mark = 0
+    start = last = time.monotonic()
+    end = start + args.time
+    while True:
+        now = time.monotonic()
+        if now >= end:
+            break
+        total += sock.send(buf)
+        if now - last >= args.interval:
+            print(interval_line(last - start, now - start, total - mark))
+            last, mark = now, total
+    sock.shutdown(socket.SHUT_WR)
+    sock.close()
+    elapsed = time.monotonic() - start
+    print(f"total {total} bytes in {elapsed:.2f} s: {mbps(total, elapsed):.2f} Mbit/s")
+
+
+def udp_client(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    window = set_window(sock, socket.SO_SNDBUF, args.window)
+    sock.connect((args.client, args.port))
+    rate = args.bandwidth * 1e6
+    gap = args.length * 8 / rate if rate else 0.0
+    print(f"UDP to {args.client}:{args.port}, {args.length} byte datagrams at "
+          f"{args.bandwidth or 'max'} Mbit/s, send buffer {window} bytes")
+
+    payload = bytearray(args.length)
+    seq = total = mark = 0
+    start = last = time.monotonic()
+    due = start
+    end = start + args.time
+    while True:
+        now = time.monotonic()
+        if now >= end:
+            break
+        if now < due:
+            time.sleep(min(due - now, 0.001))
+            continue
+        wall = time.time()
+        DATAGRAM.pack_into(payload, 0, seq, int(wall), int((wall % 1) * 1e6))
+        try:
+            total += sock.send(payload)
+            seq += 1
+        except (BlockingIOError, OSError):
+            pass
+        due += gap
+        if now - last >= args.interval:
+            print(interval_line(last - start, now - start, total - mark))
+            last, mark = now, total
+    elapsed = time.monotonic() - start
+    print(f"sent {seq} datagrams, {total} bytes in {elapsed:.2f} s: {mbps(total, elapsed):.2f} Mbit/s")
+
+    sock.settimeout(FIN_WAIT)
+    for _ in range(FIN_TRIES):
+        wall = time.time()
+        DATAGRAM.pack_into(payload, 0, -max(seq, 1), int(wall), int((wall % 1) * 1e6))
+        sock.send(payload)
+        try:
+            data = sock.recv(1024)
+        except socket.timeout:
+            continue
+        report = decode_report(data)
+        if report:
+            nbytes, seconds, lost, ooo, datagrams, jitter = report
+            loss = 100.0 * lost / datagrams if datagrams else 0.0
+            print(f"receiver: {nbytes} bytes in {seconds:.2f} s: {mbps(nbytes, seconds):.2f} Mbit/s, "
+                  f"jitter {jitter * 1e3:.3f} ms, lost {lost}/{datagrams} ({loss:.1f}%), out of order {ooo}")
+            return
+    print("no report from the receiver")
+
+
+def decode_report(data):
+    # iperf 2.0 puts the report after a 12 byte datagram header, later versions after 16
+    for base in (DATAGRAM.size, DATAGRAM.size + 4):
+        if len(data) < base + REPORT.size:
+            continue
+        f = REPORT.unpack_from(data, base)
+        if f[0] & REPORT_VERSION1:
+            nbytes = (f[1] << 32) | f[2]
+            return nbytes, f[3] + f[4] / 1e6, f[5], f[6], f[7], f[8] + f[9] / 1e6
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Throughput peer for the bench command (iperf 2 format)")
+    role = parser.add_mutually_exclusive_group(required=True)
+    role.add_argument("-s", "--server", action="store_true", help="receive")
+    role.add_argument("-c", "--client", metavar="HOST", help="send to HOST")
+    parser.add_argument("-u", "--udp", action="store_true")
+    parser.add_argument("-p", "--port", type=int, default=5001)
+    parser.add_argument("-t", "--time", type=float, default=10.0, help="seconds to send")
+    parser.add_argument("-i", "--interval", type=float, default=1.0)
+    parser.add_argument("-l", "--length", type=int, default=0, help="write or datagram size")
+    parser.add_argument("-w", "--window", type=int, default=0, help="socket buffer in bytes")
+    parser.add_argument("-b", "--bandwidth", type=float, default=10.0, help="UDP Mbit/s, 0 for max")
+    parser.add_argument("--once", action="store_true", help="server exits after one test")
+    args = parser.parse_args()
+    if not args.length:
+        args.length = 1470 if args.udp else 8192
+    args.length = max(args.length, DATAGRAM.size + REPORT.size if args.udp else 1)
+
+    try:
+        if args.server:
+            (udp_server if args.udp else tcp_server)(args)
+        else:
+            (udp_client if args.udp else tcp_client)(args)
+    except KeyboardInterrupt:
+        pass
+    except OSError as e:
+        print(f"error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()